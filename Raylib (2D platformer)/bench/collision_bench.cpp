@@ -0,0 +1,234 @@
+// collision_bench.cpp
+// Swept tile collision (CollisionCheck) against the previous three-sample destination
+// check: cost at normal speeds, and correctness against a pixel-stepping reference at
+// speeds above TILE_SIZE pixels per step, where the three-sample check tunnels.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -Isrc bench/collision_bench.cpp src/physics.cpp -o collision_bench
+#include "physics.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//------------------------------------------------------------------------------------
+// Previous collision: three samples at the destination only
+//------------------------------------------------------------------------------------
+static void SampledHorizontalBlocks(Entity *instance)
+{
+    float xVel = instance->velocity.x * deltaTimeFrame + instance->hsp;
+    int xsp = (int)ttc_abs(xVel) * ttc_sign(xVel);
+    instance->hitOnWall = false;
+
+    int side;
+    if (xsp > 0) side = instance->width / 2 - 1;
+    else if (xsp < 0) side = -instance->width / 2;
+    else return;
+
+    int x = (int)instance->position.x;
+    int y = (int)instance->position.y;
+    int mid = -instance->height / 2;
+    int top = -instance->height + 1;
+
+    int b = MapGetTileWorld(x + side + xsp, y) > EMPTY;
+    int m = MapGetTileWorld(x + side + xsp, y + mid) > EMPTY;
+    int t = MapGetTileWorld(x + side + xsp, y + top) > EMPTY;
+
+    if (b || m || t)
+    {
+        if (xsp > 0) x = ((x + side + xsp) & ~TILE_ROUND) - 1 - side;
+        else x = ((x + side + xsp) & ~TILE_ROUND) + TILE_SIZE - side;
+
+        instance->position.x = (float)x;
+        instance->velocity.x = 0.0f;
+        instance->hsp = 0.0f;
+        instance->hitOnWall = true;
+    }
+}
+
+static void SampledVerticalBlocks(Entity *instance)
+{
+    float yVel = instance->velocity.y * deltaTimeFrame + instance->vsp;
+    int ysp = (int)ttc_abs(yVel) * ttc_sign(yVel);
+    instance->hitOnCeiling = false;
+    instance->hitOnFloor = false;
+
+    int side;
+    if (ysp > 0) side = 0;
+    else if (ysp < 0) side = -instance->height + 1;
+    else return;
+
+    int x = (int)instance->position.x;
+    int y = (int)instance->position.y;
+    int xl = -instance->width / 2;
+    int xr = instance->width / 2 - 1;
+
+    int c = MapGetTileWorld(x, y + side + ysp) > EMPTY;
+    int l = MapGetTileWorld(x + xl, y + side + ysp) > EMPTY;
+    int r = MapGetTileWorld(x + xr, y + side + ysp) > EMPTY;
+
+    if (c || l || r)
+    {
+        if (ysp > 0)
+        {
+            y = ((y + side + ysp) & ~TILE_ROUND) - 1 - side;
+            instance->hitOnFloor = true;
+        }
+        else
+        {
+            y = ((y + side + ysp) & ~TILE_ROUND) + TILE_SIZE - side;
+            instance->hitOnCeiling = true;
+        }
+
+        instance->position.y = (float)y;
+        instance->velocity.y = 0.0f;
+        instance->vsp = 0.0f;
+    }
+}
+
+static void SampledCollisionCheck(Entity *instance)
+{
+    SampledHorizontalBlocks(instance);
+    SampledVerticalBlocks(instance);
+}
+
+//------------------------------------------------------------------------------------
+// Reference: move one pixel at a time and stop before the box touches a solid tile
+//------------------------------------------------------------------------------------
+static bool BoxSolid(int x, int y, int width, int height)
+{
+    for (int py = y - height + 1; py <= y; py++)
+    {
+        for (int px = x - width / 2; px <= x + width / 2 - 1; px++)
+        {
+            if (MapGetTileWorld(px, py) > EMPTY) return true;
+        }
+    }
+    return false;
+}
+
+static void ReferenceMove(Entity *instance)
+{
+    int x = (int)instance->position.x;
+    int y = (int)instance->position.y;
+    int xsp = (int)(instance->velocity.x * deltaTimeFrame + instance->hsp);
+    int ysp = (int)(instance->velocity.y * deltaTimeFrame + instance->vsp);
+
+    // Horizontal first. Like CollisionCheck, the vertical pass then starts from the
+    // resolved column if a wall was hit and from the starting column otherwise.
+    int dx = (xsp > 0) ? 1 : -1;
+    int movedX = x;
+    int i = 0;
+    for (; i != xsp && !BoxSolid(movedX + dx, y, instance->width, instance->height); i += dx) movedX += dx;
+    bool hitWall = (i != xsp);
+
+    int columnX = hitWall ? movedX : x;
+    int dy = (ysp > 0) ? 1 : -1;
+    for (int j = 0; j != ysp && !BoxSolid(columnX, y + dy, instance->width, instance->height); j += dy) y += dy;
+
+    instance->position = { (float)movedX, (float)y };
+}
+
+// Apply the step the way EntityMoveUpdate does after CollisionCheck
+static void Integrate(Entity *instance)
+{
+    int xsp = (int)(instance->velocity.x * deltaTimeFrame + instance->hsp);
+    int ysp = (int)(instance->velocity.y * deltaTimeFrame + instance->vsp);
+    instance->position.x += xsp;
+    instance->position.y += ysp;
+}
+
+// Random free spots in the level with velocity up to maxStep pixels per step
+static std::vector<Entity> MakeStates(int count, float maxStep, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> px(0, TILE_MAP_WIDTH * TILE_SIZE - 1);
+    std::uniform_int_distribution<int> py(0, TILE_MAP_HEIGHT * TILE_SIZE - 1);
+    std::uniform_real_distribution<float> step(-maxStep, maxStep);
+
+    std::vector<Entity> states;
+    while ((int)states.size() < count)
+    {
+        Entity e{};
+        PlayerInit(&e, nullptr);
+        e.position = { (float)px(rng), (float)py(rng) };
+        if (BoxSolid((int)e.position.x, (int)e.position.y, e.width, e.height)) continue;
+
+        e.velocity = { step(rng) / deltaTimeFrame, step(rng) / deltaTimeFrame };
+        states.push_back(e);
+    }
+    return states;
+}
+
+template <typename Fn>
+static double TimeCollision(const std::vector<Entity> &states, int rounds, Fn collide)
+{
+    volatile float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (const Entity &state : states)
+        {
+            Entity e = state;
+            collide(&e);
+            sink = sink + e.position.x;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((double)states.size() * rounds);
+}
+
+int main(void)
+{
+    deltaTimeFrame = PHYSICS_DT;
+    MapInit();
+
+    // Normal speeds: max run speed is ~1.6 px/step, max fall speed ~6.6 px/step
+    std::vector<Entity> normal = MakeStates(100000, 6.5f, 1);
+
+    int differences = 0;
+    for (const Entity &state : normal)
+    {
+        Entity sampled = state;
+        Entity swept = state;
+        SampledCollisionCheck(&sampled);
+        CollisionCheck(&swept);
+        if (sampled.position.x != swept.position.x || sampled.position.y != swept.position.y) differences++;
+    }
+
+    double sampledNs = TimeCollision(normal, 20, SampledCollisionCheck);
+    double sweptNs = TimeCollision(normal, 20, CollisionCheck);
+
+    printf("normal speeds (<= 6.5 px/step), %zu states\n", normal.size());
+    printf("  three-sample check: %6.2f ns/entity\n", sampledNs);
+    printf("  swept check       : %6.2f ns/entity\n", sweptNs);
+    printf("  results differing : %d\n", differences);
+
+    // Fast movers: up to three tiles per step
+    std::vector<Entity> fast = MakeStates(100000, 3.0f * TILE_SIZE, 2);
+
+    int sampledWrong = 0;
+    int sweptWrong = 0;
+    for (const Entity &state : fast)
+    {
+        Entity reference = state;
+        ReferenceMove(&reference);
+
+        Entity sampled = state;
+        SampledCollisionCheck(&sampled);
+        Integrate(&sampled);
+
+        Entity swept = state;
+        CollisionCheck(&swept);
+        Integrate(&swept);
+
+        if (sampled.position.x != reference.position.x || sampled.position.y != reference.position.y) sampledWrong++;
+        if (swept.position.x != reference.position.x || swept.position.y != reference.position.y) sweptWrong++;
+    }
+
+    printf("fast speeds (<= %d px/step), %zu states\n", 3 * TILE_SIZE, fast.size());
+    printf("  three-sample wrong: %d\n", sampledWrong);
+    printf("  swept wrong       : %d\n", sweptWrong);
+
+    return (differences == 0 && sweptWrong == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
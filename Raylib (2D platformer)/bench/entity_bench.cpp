@@ -0,0 +1,148 @@
+// entity_bench.cpp
+// Compares the per-entity (AoS) EntityMoveUpdate path against EntityBatchUpdate (SoA),
+// serial and with its blocks spread over a job system.
+// Build from the project folder:
+//   g++ -O3 -fno-trapping-math -std=c++14 -pthread -Isrc -I../common bench/entity_bench.cpp src/physics.cpp
+//       src/entity_batch.cpp ../common/job_system.cpp -o entity_bench
+#include "physics.h"
+#include "entity_batch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+constexpr int ENTITY_COUNT = 10000;
+constexpr int FRAME_COUNT  = 600;
+
+// Same movement values as the player, spawned in the open interior of the level
+static Entity BenchEntity(std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> column(2, TILE_MAP_WIDTH - 3);
+    std::uniform_int_distribution<int> row(1, 4);
+
+    Entity e{};
+    PlayerInit(&e, nullptr);
+    e.position.x = (float)(column(rng) * TILE_SIZE + TILE_SIZE / 2);
+    e.position.y = (float)(row(rng) * TILE_SIZE + TILE_SIZE - 1);
+    return e;
+}
+
+// Deterministic pseudo-input so both paths see identical controls
+static uint32_t BenchHash(uint32_t frame, uint32_t id)
+{
+    uint32_t h = frame * 0x9E3779B1u ^ (id + 0x7F4A7C15u) * 0x85EBCA6Bu;
+    h ^= h >> 15; h *= 0x2C1B3C6Du; h ^= h >> 12;
+    return h;
+}
+
+static void BenchInput(int frame, int id, float *right, float *left, bool *jump)
+{
+    // Hold each decision for 16 frames so actors actually run and jump
+    uint32_t h = BenchHash((uint32_t)frame / 16, (uint32_t)id);
+    *right = (float)((h & 3) == 1);
+    *left  = (float)((h & 3) == 2);
+    *jump  = ((h >> 2) & 7) == 0;
+}
+
+int main(void)
+{
+    deltaTimeFrame = PHYSICS_DT;
+    MapInit();
+
+    std::mt19937 rng(1234);
+    std::vector<Entity> entities;
+    std::vector<Input> inputs(ENTITY_COUNT);
+    EntityBatch batch, jobBatch;
+
+    entities.reserve(ENTITY_COUNT);
+    EntityBatchReserve(&batch, ENTITY_COUNT);
+    for (int i = 0; i < ENTITY_COUNT; i++)
+    {
+        entities.push_back(BenchEntity(rng));
+        entities.back().control = &inputs[i];
+        EntityBatchAdd(&batch, entities.back());
+    }
+    jobBatch = batch;
+
+    // Per-entity path
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        for (int i = 0; i < ENTITY_COUNT; i++)
+        {
+            BenchInput(frame, i, &inputs[i].right, &inputs[i].left, &inputs[i].jump);
+            EntityMoveUpdate(&entities[i]);
+        }
+    }
+    double aosSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Batched path
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        for (int i = 0; i < ENTITY_COUNT; i++)
+        {
+            bool jump;
+            BenchInput(frame, i, &batch.inputRight[i], &batch.inputLeft[i], &jump);
+            batch.inputJump[i] = jump;
+        }
+        EntityBatchUpdate(&batch);
+    }
+    double soaSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Batched path on jobs, at least two workers so the blocks really are shared
+    JobSystem jobs;
+    JobSystemInit(&jobs, std::max(2, (int)std::thread::hardware_concurrency()));
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        for (int i = 0; i < ENTITY_COUNT; i++)
+        {
+            bool jump;
+            BenchInput(frame, i, &jobBatch.inputRight[i], &jobBatch.inputLeft[i], &jump);
+            jobBatch.inputJump[i] = jump;
+        }
+        EntityBatchUpdate(&jobBatch, &jobs);
+    }
+    double jobSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int workers = jobs.workerCount;
+    JobSystemShutdown(&jobs);
+
+    // Both paths must land every actor on the same pixel
+    int mismatches = 0;
+    for (int i = 0; i < ENTITY_COUNT; i++)
+    {
+        if (entities[i].position.x != batch.positionX[i] || entities[i].position.y != batch.positionY[i] ||
+            entities[i].velocity.x != batch.velocityX[i] || entities[i].velocity.y != batch.velocityY[i])
+        {
+            mismatches++;
+        }
+    }
+
+    // The job split must not change a bit
+    int jobMismatches = 0;
+    for (int i = 0; i < ENTITY_COUNT; i++)
+    {
+        if (jobBatch.positionX[i] != batch.positionX[i] || jobBatch.positionY[i] != batch.positionY[i] ||
+            jobBatch.velocityX[i] != batch.velocityX[i] || jobBatch.velocityY[i] != batch.velocityY[i] ||
+            jobBatch.hsp[i] != batch.hsp[i] || jobBatch.vsp[i] != batch.vsp[i] ||
+            jobBatch.isGrounded[i] != batch.isGrounded[i] || jobBatch.isJumping[i] != batch.isJumping[i])
+        {
+            jobMismatches++;
+        }
+    }
+
+    double updates = (double)ENTITY_COUNT * FRAME_COUNT;
+    printf("entities: %d, frames: %d\n", ENTITY_COUNT, FRAME_COUNT);
+    printf("AoS EntityMoveUpdate : %8.2f ns/entity  %8.3f ms/frame\n", aosSeconds * 1e9 / updates, aosSeconds * 1e3 / FRAME_COUNT);
+    printf("SoA EntityBatchUpdate: %8.2f ns/entity  %8.3f ms/frame\n", soaSeconds * 1e9 / updates, soaSeconds * 1e3 / FRAME_COUNT);
+    printf("SoA on %2d workers    : %8.2f ns/entity  %8.3f ms/frame\n", workers, jobSeconds * 1e9 / updates, jobSeconds * 1e3 / FRAME_COUNT);
+    printf("speedup: %.2fx, on jobs %.2fx\n", aosSeconds / soaSeconds, aosSeconds / jobSeconds);
+    printf("mismatched entities: %d, on jobs: %d\n", mismatches, jobMismatches);
+
+    return (mismatches == 0 && jobMismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,178 @@
+// level_gen_bench.cpp
+// Generation throughput of LevelGenerate from the default 20x12 size up to 100k x 1k
+// tiles, single threaded and on all hardware threads. Also checks that the thread
+// count does not change the level, and on the smaller sizes that every coin can be
+// reached from the spawn point over the jump-aware navigation graph.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -pthread -Isrc bench/level_gen_bench.cpp src/level_gen.cpp src/nav.cpp src/physics.cpp -o level_gen_bench
+#include "physics.h"
+#include "level_gen.h"
+#include "nav.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+struct BenchSize {
+    int width;
+    int height;
+    bool checkReach;
+};
+
+constexpr BenchSize BENCH_SIZES[] = {
+    { 20, 12, true },
+    { 256, 64, true },
+    { 2048, 48, true },
+    { 4096, 200, false },
+    { 20000, 500, false },
+    { 100000, 1000, false },
+};
+constexpr int REACH_SEEDS = 8;
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t LevelHash(const LevelGenResult &result)
+{
+    uint64_t hash = STATE_HASH_SEED;
+    for (int8_t tile : tiles)
+    {
+        hash ^= (uint8_t)tile;
+        hash *= 1099511628211ull;
+    }
+    for (const Vector2 &coin : result.coins)
+    {
+        hash ^= (uint64_t)(coin.x * 7 + coin.y * 131071);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Breadth-first over the graph edges from the spawn node; returns unreachable coins
+static int UnreachableCoins(const LevelGenResult &result, const Entity *mover, int *nodeCount, int *reachedCount)
+{
+    NavGraph graph;
+    NavGraphBuild(&graph, mover);
+
+    int start = NavFindNode(&graph, result.spawn.x, result.spawn.y);
+    std::vector<uint8_t> reached(graph.nodes.size(), 0);
+    std::vector<int> queue;
+    if (start != NAV_NO_NODE)
+    {
+        reached[start] = 1;
+        queue.push_back(start);
+    }
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        for (const NavEdge &edge : graph.nodes[queue[head]].edges)
+        {
+            if (!reached[edge.to])
+            {
+                reached[edge.to] = 1;
+                queue.push_back(edge.to);
+            }
+        }
+    }
+
+    *nodeCount = 0;
+    for (const NavNode &node : graph.nodes) *nodeCount += node.active;
+    *reachedCount = (int)queue.size();
+
+    int unreachable = 0;
+    for (const Vector2 &coin : result.coins)
+    {
+        // The coin sits a body height above the floor it is collected from
+        int node = NavFindNode(&graph, coin.x + COIN_SIZE * 0.5f, coin.y + COIN_SIZE);
+        if (node == NAV_NO_NODE || !reached[node])
+        {
+            if (unreachable < 5) printf("  unreachable coin at tile %d,%d\n", (int)coin.x / TILE_SIZE, (int)coin.y / TILE_SIZE);
+            unreachable++;
+        }
+    }
+    return unreachable;
+}
+
+int main(void)
+{
+    deltaTimeFrame = PHYSICS_DT;
+
+    Entity mover;
+    PlayerInit(&mover, nullptr);
+    int hardwareThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+    bool ok = true;
+    printf("%d hardware threads\n", hardwareThreads);
+    printf("%8s %6s %8s %9s %10s %10s %10s %8s\n", "width", "height", "regions", "coins", "1 thread", "threads", "Mtiles/s",
+           "speedup");
+    for (const BenchSize &size : BENCH_SIZES)
+    {
+        LevelGenParams params;
+        params.width = size.width;
+        params.height = size.height;
+        params.seed = 7;
+
+        // Untimed first run, so both timings see the tile buffer already allocated
+        LevelGenResult single, parallel;
+        params.threads = 1;
+        LevelGenerate(params, &mover, &single);
+        auto start = std::chrono::steady_clock::now();
+        LevelGenerate(params, &mover, &single);
+        double singleSeconds = Seconds(start);
+        uint64_t singleHash = LevelHash(single);
+
+        params.threads = hardwareThreads;
+        start = std::chrono::steady_clock::now();
+        LevelGenerate(params, &mover, &parallel);
+        double parallelSeconds = Seconds(start);
+
+        double tileCount = (double)size.width * size.height;
+        printf("%8d %6d %8d %9zu %8.2fms %8.2fms %10.1f %7.2fx\n", size.width, size.height, parallel.regions,
+               parallel.coins.size(), singleSeconds * 1e3, parallelSeconds * 1e3, tileCount / parallelSeconds / 1e6,
+               singleSeconds / parallelSeconds);
+
+        if (LevelHash(parallel) != singleHash)
+        {
+            printf("FAIL: %dx%d differs between 1 and %d threads\n", size.width, size.height, hardwareThreads);
+            ok = false;
+        }
+    }
+
+    printf("\n");
+    for (const BenchSize &size : BENCH_SIZES)
+    {
+        if (!size.checkReach) continue;
+
+        int coins = 0, unreachable = 0, nodes = 0, reached = 0;
+        for (uint32_t seed = 1; seed <= REACH_SEEDS; seed++)
+        {
+            LevelGenParams params;
+            params.width = size.width;
+            params.height = size.height;
+            params.seed = seed;
+
+            LevelGenResult result;
+            LevelGenerate(params, &mover, &result);
+
+            int nodeCount, reachedCount;
+            unreachable += UnreachableCoins(result, &mover, &nodeCount, &reachedCount);
+            coins += (int)result.coins.size();
+            nodes += nodeCount;
+            reached += reachedCount;
+        }
+        printf("%dx%d, %d seeds: %d coins, %d unreachable, %.1f%% of floor nodes reachable\n", size.width, size.height,
+               REACH_SEEDS, coins, unreachable, nodes ? 100.0 * reached / nodes : 0.0);
+        if (unreachable > 0) ok = false;
+    }
+
+    LevelGenResult limits;
+    LevelGenerate(LevelGenParams(), &mover, &limits);
+    printf("jump limits: ledges up to %d tiles, pits up to %d tiles\n", limits.riseRows, limits.gapColumns);
+
+    if (!ok) return EXIT_FAILURE;
+    printf("\nOK: levels are thread-count independent and every coin is reachable\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,306 @@
+// nav_bench.cpp
+// Path queries per second on a large generated level: one A* search per query against
+// the shared flow-field cache many chasing agents read from. Also checks that cached
+// paths are as short as A* ones and that incremental updates after tile edits give the
+// same graph as a full rebuild.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -Isrc bench/nav_bench.cpp src/nav.cpp src/physics.cpp -o nav_bench
+#include "physics.h"
+#include "nav.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <vector>
+
+constexpr int BENCH_MAP_WIDTH  = 2048;
+constexpr int BENCH_MAP_HEIGHT = 48;
+constexpr int PAIR_COUNT   = 4000;
+constexpr int CHASE_RANGE  = 64;     // Tiles between an agent and the player it chases
+constexpr int AGENT_COUNT  = 1000;
+constexpr int PLAYER_COUNT = 4;
+constexpr int FRAME_COUNT  = 300;
+constexpr int EDIT_COUNT   = 200;
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void SetTile(int x, int y, int tile)
+{
+    if (x >= 0 && x < mapWidth && y >= 0 && y < mapHeight) tiles[x + y * mapWidth] = (int8_t)tile;
+}
+
+// Rolling ground with pits and slopes, platforms at jump height above it and a second
+// layer above some of those, so routes need walks, jumps and falls
+static void BuildLevel(unsigned int seed)
+{
+    MapResize(BENCH_MAP_WIDTH, BENCH_MAP_HEIGHT);
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> feature(0, 9);
+    std::uniform_int_distribution<int> length(2, 7);
+    std::uniform_int_distribution<int> lift(2, 3);
+
+    int g = BENCH_MAP_HEIGHT - 10;
+    int x = 1;
+    while (x < BENCH_MAP_WIDTH - 1)
+    {
+        int f = feature(rng);
+        int run = length(rng);
+
+        if (f == 0)
+        {
+            // Pit, narrow enough to jump over
+            x += std::min(run, 2);
+            continue;
+        }
+        if (f == 1 && g > 24)
+        {
+            SetTile(x, g - 1, SLOPE_RIGHT);
+            for (int y = g; y < BENCH_MAP_HEIGHT; y++) SetTile(x, y, BLOCK);
+            g--;
+            x++;
+            continue;
+        }
+        if (f == 2 && g < BENCH_MAP_HEIGHT - 4)
+        {
+            SetTile(x, g, SLOPE_LEFT);
+            for (int y = g + 1; y < BENCH_MAP_HEIGHT; y++) SetTile(x, y, BLOCK);
+            g++;
+            x++;
+            continue;
+        }
+
+        int platform = g - 1 - lift(rng);
+        int top = platform - 1 - lift(rng);
+        for (int i = 0; i < run && x < BENCH_MAP_WIDTH - 1; i++, x++)
+        {
+            for (int y = g; y < BENCH_MAP_HEIGHT; y++) SetTile(x, y, BLOCK);
+            if (f >= 7 && i > 0) SetTile(x, platform, (f == 7) ? ONE_WAY : BLOCK);
+            if (f == 9 && i > 1 && i < run - 1) SetTile(x, top, BLOCK);
+        }
+    }
+
+    for (int y = 0; y < BENCH_MAP_HEIGHT; y++)
+    {
+        SetTile(0, y, BLOCK);
+        SetTile(BENCH_MAP_WIDTH - 1, y, BLOCK);
+    }
+}
+
+static std::vector<int> ActiveNodes(const NavGraph &graph)
+{
+    std::vector<int> ids;
+    for (int id = 0; id < (int)graph.nodes.size(); id++)
+    {
+        if (graph.nodes[id].active) ids.push_back(id);
+    }
+    return ids;
+}
+
+// Random node within CHASE_RANGE columns of another one
+static int NearbyNode(const NavGraph &graph, int id, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> offset(-CHASE_RANGE, CHASE_RANGE);
+    for (;;)
+    {
+        int x = graph.nodes[id].x + offset(rng);
+        if (x < 0 || x >= mapWidth || graph.columns[x].empty()) continue;
+
+        const std::vector<int> &column = graph.columns[x];
+        return column[rng() % column.size()];
+    }
+}
+
+// Nodes and edges by tile position, independent of node ids
+typedef std::tuple<int, int, int, int, int, float> EdgeKey;
+
+static std::vector<EdgeKey> GraphKeys(const NavGraph &graph)
+{
+    std::vector<EdgeKey> keys;
+    for (const NavNode &node : graph.nodes)
+    {
+        if (!node.active) continue;
+        keys.emplace_back(node.x, node.row, -1, -1, -1, 0.0f);
+        for (const NavEdge &edge : node.edges)
+        {
+            const NavNode &to = graph.nodes[edge.to];
+            keys.emplace_back(node.x, node.row, to.x, to.row, edge.type, edge.cost);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+static bool SameCost(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-3f * std::max(1.0f, a);
+}
+
+// Cached answers against A* for the given pairs, returns the number that disagree
+static int CheckPairs(NavGraph *graph, NavPathCache *cache, const std::vector<std::pair<int, int>> &pairs)
+{
+    std::vector<int> searched;
+    std::vector<int> cached;
+    int wrong = 0;
+
+    for (const std::pair<int, int> &pair : pairs)
+    {
+        bool foundSearched = NavFindPath(graph, pair.first, pair.second, &searched);
+        bool foundCached = NavCachedPath(cache, graph, pair.first, pair.second, &cached);
+
+        if (foundSearched != foundCached) wrong++;
+        else if (foundSearched && !SameCost(NavPathCost(graph, searched), NavPathCost(graph, cached))) wrong++;
+    }
+    return wrong;
+}
+
+int main(void)
+{
+    BuildLevel(11);
+
+    Entity mover{};
+    PlayerInit(&mover, nullptr);
+
+    NavGraph graph;
+    auto start = std::chrono::steady_clock::now();
+    NavGraphBuild(&graph, &mover);
+    double buildSeconds = Seconds(start);
+
+    std::vector<int> active = ActiveNodes(graph);
+    int jumps = 0;
+    int falls = 0;
+    for (int id : active)
+    {
+        for (const NavEdge &edge : graph.nodes[id].edges)
+        {
+            jumps += (edge.type == NAV_JUMP);
+            falls += (edge.type == NAV_FALL);
+        }
+    }
+
+    printf("map %dx%d: %zu nodes, %d edges (%d jumps, %d falls), %zu arcs, build %.2f ms\n",
+           mapWidth, mapHeight, active.size(), NavEdgeCount(&graph), jumps, falls, graph.arcs.size(), buildSeconds * 1e3);
+
+    // Chase queries: start and goal within CHASE_RANGE tiles of each other
+    std::mt19937 rng(5);
+    std::vector<std::pair<int, int>> pairs(PAIR_COUNT);
+    for (std::pair<int, int> &pair : pairs)
+    {
+        pair.first = active[rng() % active.size()];
+        pair.second = NearbyNode(graph, pair.first, rng);
+    }
+
+    std::vector<int> path;
+    long pathNodes = 0;
+    int found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const std::pair<int, int> &pair : pairs)
+    {
+        found += NavFindPath(&graph, pair.first, pair.second, &path);
+        pathNodes += (long)path.size();
+    }
+    double searchSeconds = Seconds(start);
+
+    // Agents chasing a few players: every agent asks for its full path every frame, the
+    // players move to a neighbouring node every 10 frames
+    std::vector<int> players(PLAYER_COUNT);
+    for (int &p : players) p = active[rng() % active.size()];
+    std::vector<int> agents(AGENT_COUNT);
+    for (int i = 0; i < AGENT_COUNT; i++) agents[i] = NearbyNode(graph, players[i % PLAYER_COUNT], rng);
+
+    NavPathCache cache;
+    NavPathCacheInit(&cache, 8);
+
+    long cachedQueries = 0;
+    long cachedNodes = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        if (frame % 10 == 0)
+        {
+            for (int &p : players)
+            {
+                const std::vector<NavEdge> &edges = graph.nodes[p].edges;
+                if (!edges.empty()) p = edges[rng() % edges.size()].to;
+            }
+        }
+
+        for (int i = 0; i < AGENT_COUNT; i++)
+        {
+            NavCachedPath(&cache, &graph, agents[i], players[i % PLAYER_COUNT], &path);
+            cachedNodes += (long)path.size();
+            cachedQueries++;
+        }
+    }
+    double cachedSeconds = Seconds(start);
+    int cachedMisses = cache.misses;
+
+    // Next node only, what an agent's steering actually reads each frame
+    long nextQueries = 0;
+    long nextSink = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        for (int i = 0; i < AGENT_COUNT; i++)
+        {
+            nextSink += NavNextNode(&cache, &graph, agents[i], players[i % PLAYER_COUNT]);
+            nextQueries++;
+        }
+    }
+    double nextSeconds = Seconds(start);
+
+    printf("A* per query    : %10.0f queries/s (%d of %d found, %.1f nodes/path)\n",
+           PAIR_COUNT / searchSeconds, found, PAIR_COUNT, (double)pathNodes / PAIR_COUNT);
+    printf("cached full path: %10.0f queries/s (%d goal searches for %ld queries, %.1f nodes/path)\n",
+           cachedQueries / cachedSeconds, cachedMisses, cachedQueries, (double)cachedNodes / cachedQueries);
+    printf("cached next node: %10.0f queries/s (checksum %ld)\n", nextQueries / nextSeconds, nextSink);
+
+    NavPathCache checkCache;
+    NavPathCacheInit(&checkCache, 8);
+    int wrong = CheckPairs(&graph, &checkCache, pairs);
+    printf("cached vs A* path cost mismatches: %d\n", wrong);
+
+    // Tile edits near the ground, each followed by an incremental update
+    std::uniform_int_distribution<int> editX(1, BENCH_MAP_WIDTH - 2);
+    std::uniform_int_distribution<int> editY(BENCH_MAP_HEIGHT - 20, BENCH_MAP_HEIGHT - 2);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EDIT_COUNT; i++)
+    {
+        int ex = editX(rng);
+        int ey = editY(rng);
+        SetTile(ex, ey, (tiles[ex + ey * mapWidth] == EMPTY) ? BLOCK : EMPTY);
+        NavGraphUpdate(&graph, ex, ex);
+    }
+    double updateSeconds = Seconds(start);
+
+    NavGraph rebuilt;
+    NavGraphBuild(&rebuilt, &mover);
+    bool sameGraph = (GraphKeys(graph) == GraphKeys(rebuilt));
+    printf("incremental update: %.1f us per edit, matches full rebuild: %s\n",
+           updateSeconds * 1e6 / EDIT_COUNT, sameGraph ? "yes" : "no");
+
+    // Cached fields must notice the edits too
+    active = ActiveNodes(graph);
+    for (std::pair<int, int> &pair : pairs)
+    {
+        pair.first = active[rng() % active.size()];
+        pair.second = NearbyNode(graph, pair.first, rng);
+    }
+    int wrongAfterEdits = CheckPairs(&graph, &checkCache, pairs);
+    printf("after edits, cached vs A* mismatches: %d\n", wrongAfterEdits);
+
+    // A cache asked for no fields still keeps one to build into
+    NavPathCache oneField;
+    NavPathCacheInit(&oneField, 0);
+    std::vector<std::pair<int, int>> somePairs(pairs.begin(), pairs.begin() + 64);
+    int wrongOneField = CheckPairs(&graph, &oneField, somePairs);
+    printf("zero-field cache vs A* mismatches: %d (%zu fields)\n", wrongOneField, oneField.fields.size());
+
+    return (wrong == 0 && sameGraph && wrongAfterEdits == 0 && wrongOneField == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
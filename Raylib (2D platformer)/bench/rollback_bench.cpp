@@ -0,0 +1,226 @@
+// rollback_bench.cpp
+// Two rollback peers over the loopback transport at several delays and loss rates.
+// Every confirmed frame of both peers is checked against a reference run with the
+// true inputs, and the cost of a worst-case (ROLLBACK_MAX_FRAMES) rollback is timed
+// against the 60 Hz frame budget.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -Isrc bench/rollback_bench.cpp src/rollback.cpp src/loopback.cpp src/physics.cpp src/spatial_hash.cpp src/replay.cpp -o rollback_bench
+#include "rollback.h"
+#include "loopback.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+constexpr int FRAME_COUNT = 20000;
+constexpr double FRAME_BUDGET_US = 1e6 / 60.0;
+
+// Held buttons like replay_cli's generator, one script per player
+static std::vector<uint8_t> MakeScript(unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> hold(5, 40);
+    std::uniform_int_distribution<int> bits(0, 31);
+
+    std::vector<uint8_t> script;
+    while ((int)script.size() < FRAME_COUNT)
+    {
+        uint8_t buttons = (uint8_t)bits(rng);
+        for (int i = hold(rng); i > 0 && (int)script.size() < FRAME_COUNT; i--) script.push_back(buttons);
+    }
+    return script;
+}
+
+static double Percentile(std::vector<double> samples, double p)
+{
+    if (samples.empty()) return 0.0;
+    size_t index = std::min(samples.size() - 1, (size_t)(p * (double)samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+struct RunResult {
+    bool ok = true;
+    int frames = 0;
+    int ticks = 0;
+    long rollbacks = 0;
+    long resimulated = 0;
+    long stalls = 0;
+    int deepest = 0;
+    std::vector<double> tickUs;
+};
+
+// Both peers run until each has confirmed every frame; any confirmed state that
+// differs from the reference is a desync
+static RunResult RunSession(const std::vector<uint8_t> scripts[NET_PLAYERS], const std::vector<uint64_t> &reference,
+                            int delay, int loss)
+{
+    static RollbackSession peers[NET_PLAYERS];
+    LoopbackTransport transport;
+    LoopbackInit(&transport, delay, 1, loss, 99);
+
+    int checked[NET_PLAYERS];
+    for (int p = 0; p < NET_PLAYERS; p++)
+    {
+        RollbackInit(&peers[p], p);
+        checked[p] = -1;
+    }
+
+    RunResult result;
+    result.tickUs.reserve(FRAME_COUNT * 2);
+    while (checked[0] < FRAME_COUNT - 1 || checked[1] < FRAME_COUNT - 1)
+    {
+        for (int p = 0; p < NET_PLAYERS; p++)
+        {
+            RollbackSession *peer = &peers[p];
+
+            auto start = std::chrono::steady_clock::now();
+            NetPacket packet;
+            while (LoopbackReceive(&transport, p, &packet)) RollbackReceive(peer, packet);
+            if (peer->state.frame < FRAME_COUNT) RollbackAdvance(peer, scripts[p][peer->state.frame]);
+            result.tickUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+            RollbackMakePacket(peer, &packet);
+            LoopbackSend(&transport, 1 - p, packet);
+
+            int confirmed = RollbackConfirmedFrame(peer);
+            for (int f = checked[p] + 1; f <= confirmed; f++)
+            {
+                if (NetGameStateHash(RollbackStateAt(peer, f + 1)) != reference[f + 1])
+                {
+                    printf("FAIL: peer %d desynced at frame %d (delay %d, loss %d%%)\n", p, f, delay, loss);
+                    result.ok = false;
+                    return result;
+                }
+            }
+            checked[p] = std::max(checked[p], confirmed);
+        }
+
+        LoopbackTick(&transport);
+        if (++result.ticks > FRAME_COUNT * 20)
+        {
+            printf("FAIL: no progress (delay %d, loss %d%%)\n", delay, loss);
+            result.ok = false;
+            return result;
+        }
+    }
+
+    for (int p = 0; p < NET_PLAYERS; p++)
+    {
+        result.rollbacks += peers[p].rollbacks;
+        result.resimulated += peers[p].resimulatedFrames;
+        result.stalls += peers[p].stalls;
+        result.deepest = std::max(result.deepest, peers[p].deepestRollback);
+    }
+    result.frames = FRAME_COUNT;
+    return result;
+}
+
+// Rollback of ROLLBACK_MAX_FRAMES on every frame, the most a peer can ever do in one tick
+static double WorstCaseRollbackUs(const std::vector<uint8_t> scripts[NET_PLAYERS])
+{
+    static RollbackSession session;
+    RollbackInit(&session, 0);
+
+    NetPacket packet;
+    packet.count = 1;
+
+    const int frames = 4000;
+    double totalUs = 0.0;
+    for (int f = 0; f < frames; f++)
+    {
+        packet.firstFrame = f;
+        packet.buttons[0] = scripts[1][f];
+        RollbackReceive(&session, packet);
+        if (f >= ROLLBACK_MAX_FRAMES) session.rollbackFrame = f - ROLLBACK_MAX_FRAMES;
+
+        auto start = std::chrono::steady_clock::now();
+        RollbackAdvance(&session, scripts[0][f]);
+        totalUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    return totalUs / frames;
+}
+
+int main(void)
+{
+    deltaTimeFrame = PHYSICS_DT;
+    MapInit();
+
+    std::vector<uint8_t> scripts[NET_PLAYERS] = { MakeScript(11), MakeScript(12) };
+
+    // Reference: state at the start of every frame with the true inputs
+    std::vector<uint64_t> reference;
+    {
+        NetGameState state;
+        NetGameStateInit(&state);
+        SpatialHash coinHash;
+        SpatialHashInit(&coinHash, 64);
+        for (int i = 0; i < MAX_COINS; i++) SpatialHashInsert(&coinHash, COIN_POSITIONS[i].x, COIN_POSITIONS[i].y, COIN_SIZE, COIN_SIZE);
+        std::vector<int> candidates;
+
+        reference.push_back(NetGameStateHash(&state));
+        for (int f = 0; f < FRAME_COUNT; f++)
+        {
+            uint8_t buttons[NET_PLAYERS] = { scripts[0][f], scripts[1][f] };
+            NetGameStateStep(&state, buttons, &coinHash, &candidates);
+            reference.push_back(NetGameStateHash(&state));
+        }
+        printf("reference: %d frames, score %d / %d\n", FRAME_COUNT, state.score[0], state.score[1]);
+    }
+
+    // Snapshot copy and plain step cost
+    {
+        static RollbackSession session;
+        RollbackInit(&session, 0);
+        const int reps = 200000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; i++) session.snapshots[i % ROLLBACK_RING] = session.state;
+        double snapshotNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reps;
+
+        NetGameState state;
+        NetGameStateInit(&state);
+        start = std::chrono::steady_clock::now();
+        for (int f = 0; f < FRAME_COUNT; f++)
+        {
+            uint8_t buttons[NET_PLAYERS] = { scripts[0][f], scripts[1][f] };
+            NetGameStateStep(&state, buttons, &session.coinHash, &session.coinCandidates);
+        }
+        double stepNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / FRAME_COUNT;
+        printf("snapshot (%zu bytes): %.1f ns, step: %.1f ns\n", sizeof(NetGameState), snapshotNs, stepNs);
+    }
+
+    double worstUs = WorstCaseRollbackUs(scripts);
+    printf("rollback of %d frames + 1 step: %.2f us (%.4f%% of a %.1f us frame)\n\n", ROLLBACK_MAX_FRAMES, worstUs,
+           100.0 * worstUs / FRAME_BUDGET_US, FRAME_BUDGET_US);
+
+    printf("%5s %5s %10s %9s %9s %7s %10s %10s %10s\n", "delay", "loss", "rollbacks", "avgDepth", "maxDepth", "stalls",
+           "tick avg", "tick p99", "tick max");
+
+    const int delays[] = { 0, 2, 4, 8 };
+    const int losses[] = { 0, 5, 20 };
+    bool ok = true;
+    for (int delay : delays)
+    {
+        for (int loss : losses)
+        {
+            RunResult r = RunSession(scripts, reference, delay, loss);
+            if (!r.ok)
+            {
+                ok = false;
+                continue;
+            }
+
+            double sum = 0.0;
+            for (double us : r.tickUs) sum += us;
+            printf("%5d %4d%% %10ld %9.2f %9d %7ld %8.2fus %8.2fus %8.2fus\n", delay, loss, r.rollbacks,
+                   r.rollbacks ? (double)r.resimulated / r.rollbacks : 0.0, r.deepest, r.stalls, sum / r.tickUs.size(),
+                   Percentile(r.tickUs, 0.99), *std::max_element(r.tickUs.begin(), r.tickUs.end()));
+        }
+    }
+
+    if (!ok) return EXIT_FAILURE;
+    printf("\nOK: every confirmed frame matches the reference on both peers\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+// spatial_hash_bench.cpp
+// Query cost of the SpatialHash broadphase against the linear CoinUpdate scan as the
+// object count grows (constant density: the level grows with the object count).
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -Isrc bench/spatial_hash_bench.cpp src/spatial_hash.cpp -o spatial_hash_bench
+#include "physics.h"
+#include "spatial_hash.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct BenchObject {
+    float x, y, width, height;
+    float vx, vy;
+};
+
+// Same test as raylib's CheckCollisionRecs
+static bool Overlaps(const BenchObject &a, float x, float y, float width, float height)
+{
+    return (a.x < x + width) && (a.x + a.width > x) && (a.y < y + height) && (a.y + a.height > y);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(void)
+{
+    const int counts[] = { 100, 1000, 10000, 100000 };
+    const int QUERIES = 20000;
+    const int MOVE_FRAMES = 20;
+
+    printf("%10s %14s %14s %14s %12s\n", "objects", "linear ns/q", "hash ns/q", "move ns/obj", "candidates");
+
+    for (int count : counts)
+    {
+        // About one 4x4 pickup per 4 tiles, like a dense coin trail
+        float side = std::sqrt((float)count * 4.0f) * TILE_SIZE;
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> pos(0.0f, side);
+        std::uniform_real_distribution<float> vel(-2.0f, 2.0f);
+
+        std::vector<BenchObject> objects(count);
+        SpatialHash hash;
+        SpatialHashInit(&hash, count * 2);
+        for (BenchObject &o : objects)
+        {
+            o = { pos(rng), pos(rng), 4.0f, 4.0f, vel(rng), vel(rng) };
+            SpatialHashInsert(&hash, o.x, o.y, o.width, o.height);
+        }
+
+        // Player sized query boxes
+        std::vector<BenchObject> queries(QUERIES);
+        for (BenchObject &q : queries) q = { pos(rng), pos(rng), 8.0f, 16.0f, 0.0f, 0.0f };
+
+        // Linear scan, as CoinUpdate does today
+        long linearHits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const BenchObject &q : queries)
+        {
+            for (const BenchObject &o : objects)
+            {
+                if (Overlaps(o, q.x, q.y, q.width, q.height)) linearHits++;
+            }
+        }
+        double linearSeconds = Seconds(start);
+
+        // Broadphase then the same exact test on candidates only
+        std::vector<int> candidates;
+        long hashHits = 0;
+        long candidateCount = 0;
+        start = std::chrono::steady_clock::now();
+        for (const BenchObject &q : queries)
+        {
+            candidates.clear();
+            candidateCount += SpatialHashQuery(&hash, q.x, q.y, q.width, q.height, &candidates);
+            for (int id : candidates)
+            {
+                if (Overlaps(objects[id], q.x, q.y, q.width, q.height)) hashHits++;
+            }
+        }
+        double hashSeconds = Seconds(start);
+
+        // Incremental updates with every object moving each frame
+        start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < MOVE_FRAMES; frame++)
+        {
+            for (int id = 0; id < count; id++)
+            {
+                BenchObject &o = objects[id];
+                o.x += o.vx;
+                o.y += o.vy;
+                SpatialHashMove(&hash, id, o.x, o.y);
+            }
+        }
+        double moveSeconds = Seconds(start);
+
+        printf("%10d %14.1f %14.1f %14.1f %12.2f\n", count,
+               linearSeconds * 1e9 / QUERIES, hashSeconds * 1e9 / QUERIES,
+               moveSeconds * 1e9 / ((double)count * MOVE_FRAMES), (double)candidateCount / QUERIES);
+
+        if (linearHits != hashHits)
+        {
+            printf("hit mismatch: linear %ld, hash %ld\n", linearHits, hashHits);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
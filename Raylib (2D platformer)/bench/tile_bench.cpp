@@ -0,0 +1,249 @@
+// tile_bench.cpp
+// Collision throughput on a large generated level mixing every tile shape (slopes,
+// half blocks, one-way platforms, walls), against the same level built from BLOCK
+// tiles only. Also checks the per-entity and batched paths agree on the mixed level.
+// Build from the project folder:
+//   g++ -O3 -fno-trapping-math -std=c++14 -pthread -Isrc -I../common bench/tile_bench.cpp src/physics.cpp src/entity_batch.cpp
+//       ../common/job_system.cpp -o tile_bench
+#include "physics.h"
+#include "entity_batch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+constexpr int BENCH_MAP_WIDTH  = 4096;
+constexpr int BENCH_MAP_HEIGHT = 64;
+constexpr int ENTITY_COUNT = 20000;
+constexpr int FRAME_COUNT  = 300;
+
+static void SetTile(int x, int y, int tile)
+{
+    if (x >= 0 && x < mapWidth && y >= 0 && y < mapHeight) tiles[x + y * mapWidth] = (int8_t)tile;
+}
+
+static void FillBelow(int x, int row)
+{
+    for (int y = row; y < mapHeight; y++) SetTile(x, y, BLOCK);
+}
+
+// Rolling ground made of flat runs, 45 and 22.5 degree slopes and half block bumps,
+// with one-way platforms and walls on top. groundRow[x] is the first ground row.
+static void BuildMixedMap(unsigned int seed, std::vector<int> *groundRow)
+{
+    MapResize(BENCH_MAP_WIDTH, BENCH_MAP_HEIGHT);
+    groundRow->assign(BENCH_MAP_WIDTH, 0);
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> feature(0, 9);
+    std::uniform_int_distribution<int> runLength(2, 6);
+
+    int g = BENCH_MAP_HEIGHT - 16;
+    int x = 0;
+    while (x < BENCH_MAP_WIDTH)
+    {
+        int f = feature(rng);
+        bool canRise = g > 20;
+        bool canFall = g < BENCH_MAP_HEIGHT - 6;
+
+        if (f == 0 && canRise)
+        {
+            SetTile(x, g - 1, SLOPE_RIGHT); FillBelow(x, g);
+            (*groundRow)[x++] = --g;
+        }
+        else if (f == 1 && canFall)
+        {
+            SetTile(x, g, SLOPE_LEFT); FillBelow(x, g + 1);
+            (*groundRow)[x++] = g++;
+        }
+        else if (f == 2 && canRise && x + 1 < BENCH_MAP_WIDTH)
+        {
+            SetTile(x, g - 1, SLOPE_RIGHT_LOW); FillBelow(x, g); (*groundRow)[x++] = g - 1;
+            SetTile(x, g - 1, SLOPE_RIGHT_HIGH); FillBelow(x, g); (*groundRow)[x++] = g - 1;
+            g--;
+        }
+        else if (f == 3 && canFall && x + 1 < BENCH_MAP_WIDTH)
+        {
+            SetTile(x, g, SLOPE_LEFT_HIGH); FillBelow(x, g + 1); (*groundRow)[x++] = g;
+            SetTile(x, g, SLOPE_LEFT_LOW); FillBelow(x, g + 1); (*groundRow)[x++] = g;
+            g++;
+        }
+        else if (f == 4)
+        {
+            SetTile(x, g - 1, HALF_BLOCK); FillBelow(x, g);
+            (*groundRow)[x++] = g - 1;
+        }
+        else
+        {
+            // Flat run, sometimes with a one-way platform or a wall on it
+            int run = runLength(rng);
+            int extra = feature(rng);
+            for (int i = 0; i < run && x < BENCH_MAP_WIDTH; i++, x++)
+            {
+                FillBelow(x, g);
+                (*groundRow)[x] = g;
+                if (extra < 3) SetTile(x, g - 4, ONE_WAY);
+                if (extra == 3 && i == run - 1) { SetTile(x, g - 1, BLOCK); SetTile(x, g - 2, BLOCK); }
+            }
+        }
+    }
+
+    // Closed sides so actors stay in the level
+    for (int y = 0; y < BENCH_MAP_HEIGHT; y++)
+    {
+        SetTile(0, y, BLOCK);
+        SetTile(BENCH_MAP_WIDTH - 1, y, BLOCK);
+    }
+}
+
+// Same layout with every shape turned into a full block and one-way platforms removed
+static void FlattenToBlocks(void)
+{
+    for (int8_t &tile : tiles)
+    {
+        if (tile == ONE_WAY) tile = EMPTY;
+        else if (tile > EMPTY) tile = BLOCK;
+    }
+}
+
+// Deterministic pseudo-input so both paths see identical controls
+static uint32_t BenchHash(uint32_t frame, uint32_t id)
+{
+    uint32_t h = frame * 0x9E3779B1u ^ (id + 0x7F4A7C15u) * 0x85EBCA6Bu;
+    h ^= h >> 15; h *= 0x2C1B3C6Du; h ^= h >> 12;
+    return h;
+}
+
+static void BenchInput(int frame, int id, float *right, float *left, bool *jump)
+{
+    // Hold each decision for 32 frames so actors walk over slopes and platforms
+    uint32_t h = BenchHash((uint32_t)frame / 32, (uint32_t)id);
+    *right = (float)((h & 3) != 2);
+    *left  = (float)((h & 3) == 2);
+    *jump  = ((h >> 2) & 7) == 0;
+}
+
+// Actors dropped a few tiles above the ground across the whole level
+static std::vector<Entity> SpawnEntities(const std::vector<int> &groundRow, std::vector<Input> *inputs)
+{
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> column(2, BENCH_MAP_WIDTH - 3);
+
+    std::vector<Entity> entities(ENTITY_COUNT);
+    inputs->assign(ENTITY_COUNT, Input{});
+    for (int i = 0; i < ENTITY_COUNT; i++)
+    {
+        int c = column(rng);
+        PlayerInit(&entities[i], &(*inputs)[i]);
+        entities[i].position.x = (float)(c * TILE_SIZE + TILE_SIZE / 2);
+        entities[i].position.y = (float)((groundRow[c] - 5) * TILE_SIZE + TILE_SIZE - 1);
+    }
+    return entities;
+}
+
+static double RunEntities(std::vector<Entity> *entities, std::vector<Input> *inputs)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        for (int i = 0; i < ENTITY_COUNT; i++)
+        {
+            BenchInput(frame, i, &(*inputs)[i].right, &(*inputs)[i].left, &(*inputs)[i].jump);
+            EntityMoveUpdate(&(*entities)[i]);
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double RunBatch(EntityBatch *batch)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        for (int i = 0; i < ENTITY_COUNT; i++)
+        {
+            bool jump;
+            BenchInput(frame, i, &batch->inputRight[i], &batch->inputLeft[i], &jump);
+            batch->inputJump[i] = jump;
+        }
+        EntityBatchUpdate(batch);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double TimeGroundChecks(std::vector<Entity> *entities, int rounds)
+{
+    volatile int sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (Entity &e : *entities)
+        {
+            GroundCheck(&e);
+            sink = sink + e.isGrounded;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((double)entities->size() * rounds);
+}
+
+int main(void)
+{
+    deltaTimeFrame = PHYSICS_DT;
+
+    std::vector<int> groundRow;
+    BuildMixedMap(7, &groundRow);
+
+    int counts[TILE_TYPE_COUNT + 1] = {};
+    for (int8_t tile : tiles) counts[tile + 1]++;
+    printf("map %dx%d tiles: empty %d, block %d, half %d, slope45 %d, slope22 %d, one-way %d\n",
+           mapWidth, mapHeight, counts[EMPTY + 1], counts[BLOCK + 1], counts[HALF_BLOCK + 1],
+           counts[SLOPE_RIGHT + 1] + counts[SLOPE_LEFT + 1],
+           counts[SLOPE_RIGHT_LOW + 1] + counts[SLOPE_RIGHT_HIGH + 1] + counts[SLOPE_LEFT_HIGH + 1] + counts[SLOPE_LEFT_LOW + 1],
+           counts[ONE_WAY + 1]);
+
+    // Mixed level, per-entity and batched
+    std::vector<Input> inputs;
+    std::vector<Entity> entities = SpawnEntities(groundRow, &inputs);
+
+    EntityBatch batch;
+    EntityBatchReserve(&batch, ENTITY_COUNT);
+    for (const Entity &e : entities) EntityBatchAdd(&batch, e);
+
+    double mixedSeconds = RunEntities(&entities, &inputs);
+    double batchSeconds = RunBatch(&batch);
+
+    int grounded = 0;
+    int mismatches = 0;
+    for (int i = 0; i < ENTITY_COUNT; i++)
+    {
+        grounded += entities[i].isGrounded;
+        if (entities[i].position.x != batch.positionX[i] || entities[i].position.y != batch.positionY[i] ||
+            entities[i].velocity.x != batch.velocityX[i] || entities[i].velocity.y != batch.velocityY[i])
+        {
+            mismatches++;
+        }
+    }
+
+    // Ground checks alone from the end states, where most actors stand on some shape
+    double mixedGroundNs = TimeGroundChecks(&entities, 20);
+
+    // Same layout, blocks only
+    FlattenToBlocks();
+    std::vector<Entity> blockEntities = SpawnEntities(groundRow, &inputs);
+    double blockSeconds = RunEntities(&blockEntities, &inputs);
+    double blockGroundNs = TimeGroundChecks(&blockEntities, 20);
+
+    double updates = (double)ENTITY_COUNT * FRAME_COUNT;
+    printf("entities: %d, frames: %d\n", ENTITY_COUNT, FRAME_COUNT);
+    printf("                      step ns/entity   ground check ns\n");
+    printf("blocks only, AoS    : %10.2f %18.2f\n", blockSeconds * 1e9 / updates, blockGroundNs);
+    printf("mixed tiles, AoS    : %10.2f %18.2f\n", mixedSeconds * 1e9 / updates, mixedGroundNs);
+    printf("mixed tiles, SoA    : %10.2f\n", batchSeconds * 1e9 / updates);
+    printf("grounded at end: %d of %d\n", grounded, ENTITY_COUNT);
+    printf("mismatched entities: %d\n", mismatches);
+
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,390 @@
+// entity_batch.cpp
+#include "entity_batch.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------------------
+// Storage
+//------------------------------------------------------------------------------------
+void EntityBatchReserve(EntityBatch *batch, int capacity)
+{
+    batch->positionX.reserve(capacity);
+    batch->positionY.reserve(capacity);
+    batch->velocityX.reserve(capacity);
+    batch->velocityY.reserve(capacity);
+    batch->direction.reserve(capacity);
+    batch->hsp.reserve(capacity);
+    batch->vsp.reserve(capacity);
+
+    batch->width.reserve(capacity);
+    batch->height.reserve(capacity);
+    batch->maxSpd.reserve(capacity);
+    batch->acc.reserve(capacity);
+    batch->dcc.reserve(capacity);
+    batch->gravity.reserve(capacity);
+    batch->jumpImpulse.reserve(capacity);
+    batch->jumpRelease.reserve(capacity);
+
+    batch->isGrounded.reserve(capacity);
+    batch->isJumping.reserve(capacity);
+    batch->isStanding.reserve(capacity);
+    batch->hitOnFloor.reserve(capacity);
+    batch->hitOnCeiling.reserve(capacity);
+    batch->hitOnWall.reserve(capacity);
+
+    batch->inputRight.reserve(capacity);
+    batch->inputLeft.reserve(capacity);
+    batch->inputJump.reserve(capacity);
+
+    batch->xsp.reserve(capacity);
+    batch->ysp.reserve(capacity);
+}
+
+int EntityBatchAdd(EntityBatch *batch, const Entity &entity)
+{
+    batch->positionX.push_back(entity.position.x);
+    batch->positionY.push_back(entity.position.y);
+    batch->velocityX.push_back(entity.velocity.x);
+    batch->velocityY.push_back(entity.velocity.y);
+    batch->direction.push_back(entity.direction);
+    batch->hsp.push_back(entity.hsp);
+    batch->vsp.push_back(entity.vsp);
+
+    batch->width.push_back(entity.width);
+    batch->height.push_back(entity.height);
+    batch->maxSpd.push_back(entity.maxSpd);
+    batch->acc.push_back(entity.acc);
+    batch->dcc.push_back(entity.dcc);
+    batch->gravity.push_back(entity.gravity);
+    batch->jumpImpulse.push_back(entity.jumpImpulse);
+    batch->jumpRelease.push_back(entity.jumpRelease);
+
+    batch->isGrounded.push_back(entity.isGrounded);
+    batch->isJumping.push_back(entity.isJumping);
+    batch->isStanding.push_back(entity.isStanding);
+    batch->hitOnFloor.push_back(entity.hitOnFloor);
+    batch->hitOnCeiling.push_back(entity.hitOnCeiling);
+    batch->hitOnWall.push_back(entity.hitOnWall);
+
+    const bool hasControl = (entity.control != nullptr);
+    batch->inputRight.push_back(hasControl ? entity.control->right : 0.0f);
+    batch->inputLeft.push_back(hasControl ? entity.control->left : 0.0f);
+    batch->inputJump.push_back(hasControl ? entity.control->jump : false);
+
+    batch->xsp.push_back(0);
+    batch->ysp.push_back(0);
+
+    return batch->count++;
+}
+
+void EntityBatchClear(EntityBatch *batch)
+{
+    int capacity = (int)batch->positionX.capacity();
+    *batch = EntityBatch{};
+    EntityBatchReserve(batch, capacity);
+}
+
+// Copy one actor back out into an Entity (control pointer is left untouched)
+void EntityBatchStore(const EntityBatch *batch, int index, Entity *entity)
+{
+    entity->position = { batch->positionX[index], batch->positionY[index] };
+    entity->velocity = { batch->velocityX[index], batch->velocityY[index] };
+    entity->direction = batch->direction[index];
+    entity->hsp = batch->hsp[index];
+    entity->vsp = batch->vsp[index];
+
+    entity->width = batch->width[index];
+    entity->height = batch->height[index];
+    entity->maxSpd = batch->maxSpd[index];
+    entity->acc = batch->acc[index];
+    entity->dcc = batch->dcc[index];
+    entity->gravity = batch->gravity[index];
+    entity->jumpImpulse = batch->jumpImpulse[index];
+    entity->jumpRelease = batch->jumpRelease[index];
+
+    entity->isGrounded = batch->isGrounded[index];
+    entity->isJumping = batch->isJumping[index];
+    entity->isStanding = batch->isStanding[index];
+    entity->hitOnFloor = batch->hitOnFloor[index];
+    entity->hitOnCeiling = batch->hitOnCeiling[index];
+    entity->hitOnWall = batch->hitOnWall[index];
+
+    if (entity->control != nullptr)
+    {
+        entity->control->right = batch->inputRight[index];
+        entity->control->left = batch->inputLeft[index];
+        entity->control->jump = batch->inputJump[index];
+    }
+}
+
+//------------------------------------------------
+// Batched physics functions
+// Same math as the per-entity functions in physics.cpp, one phase at a time
+//------------------------------------------------
+// Blocks [begin, end) of a JobParallelFor
+static void UpdateBlocks(void *user, int begin, int end)
+{
+    EntityBatch *batch = (EntityBatch *)user;
+
+    // Run all phases over one block at a time so its arrays stay in L1 between phases
+    for (int block = begin; block < end; block++)
+    {
+        int first = block*ENTITY_BATCH_BLOCK;
+        int last = std::min(first + ENTITY_BATCH_BLOCK, batch->count);
+
+        BatchGroundCheck(batch, first, last);
+        BatchGetDirection(batch, first, last);
+        BatchMoveCalc(batch, first, last);
+        BatchGravityCalc(batch, first, last);
+        BatchCollisionHorizontalBlocks(batch, first, last);
+        BatchCollisionVerticalBlocks(batch, first, last);
+        BatchApplyMovement(batch, first, last);
+    }
+}
+
+void EntityBatchUpdate(EntityBatch *batch, JobSystem *jobs)
+{
+    int blocks = (batch->count + ENTITY_BATCH_BLOCK - 1)/ENTITY_BATCH_BLOCK;
+    if (jobs == nullptr) UpdateBlocks(batch, 0, blocks);
+    else JobParallelFor(jobs, blocks, 1, UpdateBlocks, batch);
+}
+
+// Kernels take __restrict pointers as parameters, the form GCC and Clang trust for
+// aliasing. The select-only phases vectorize at -O3 (GCC also wants -fno-trapping-math
+// to if-convert the float selects); the tile sampling phases stay scalar.
+static void GroundCheckKernel(int n, const float *__restrict posX, const float *__restrict posY,
+                              const int *__restrict width, uint8_t *__restrict grounded,
+                              uint8_t *__restrict standing)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int x = (int)posX[i];
+        int y = (int)posY[i];
+        bool onSurface;
+
+        grounded[i] = GroundProbe(x - width[i] / 2, x + width[i] / 2 - 1, y, &onSurface);
+        standing[i] = onSurface;
+    }
+}
+
+static void GetDirectionKernel(int n, const float *__restrict right, const float *__restrict left,
+                               float *__restrict direction)
+{
+    for (int i = 0; i < n; i++)
+    {
+        direction[i] = right[i] - left[i];
+    }
+}
+
+static void MoveCalcKernel(int n, float dt, const float *__restrict direction, const float *__restrict maxSpd,
+                           const float *__restrict acc, const float *__restrict dcc, float *__restrict velX)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float vx = velX[i];
+        float dir = direction[i];
+        float top = maxSpd[i];
+
+        // Accelerating towards direction
+        float accel = vx + dir * acc[i] * dt;
+        accel = accel < -top ? -top : accel;
+        accel = accel > top ? top : accel;
+
+        // Decelerating towards zero
+        float step = dcc[i] * dt;
+        float slower = vx - step;
+        float faster = vx + step;
+        float decel = vx > 0.0f ? slower : faster;
+        float absVx = vx < 0.0f ? -vx : vx;
+        decel = absVx < step ? 0.0f : decel;
+
+        float absDir = dir < 0.0f ? -dir : dir;
+        velX[i] = absDir > 0.0f ? accel : decel;
+    }
+}
+
+static void GravityCalcKernel(int n, float dt, const float *__restrict gravity, const float *__restrict jumpImpulse,
+                              const float *__restrict jumpRelease, float *__restrict velY, uint8_t *__restrict grounded,
+                              uint8_t *__restrict jumping, uint8_t *__restrict jumpHeld)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float vy = velY[i];
+        float impulse = jumpImpulse[i];
+        float cut = jumpRelease[i];
+        int g = grounded[i];
+        int j = jumping[i];
+        int held = jumpHeld[i];
+
+        // Grounded: landing clears the jump, otherwise a held jump starts one
+        int land = g & j;
+        int start = g & (j ^ 1) & held;
+        // Airborne: releasing jump early cuts the rise to jumpRelease
+        int release = (g ^ 1) & j & (held ^ 1);
+
+        vy = start ? impulse : vy;
+        vy = (release && vy < cut) ? cut : vy;
+
+        jumping[i] = start | (j & (land ^ 1) & (release ^ 1));
+        grounded[i] = g & (start ^ 1);
+        jumpHeld[i] = held & (land ^ 1);
+
+        vy += gravity[i] * dt;
+        velY[i] = vy > -impulse ? -impulse : vy;
+    }
+}
+
+// Whole pixels moved this step; (int) truncates toward zero like abs * sign
+static void PixelStepKernel(int n, float dt, const float *__restrict velocity, const float *__restrict carry,
+                            int *__restrict step)
+{
+    for (int i = 0; i < n; i++)
+    {
+        step[i] = (int)(velocity[i] * dt + carry[i]);
+    }
+}
+
+static void CollisionHorizontalKernel(int n, const int *__restrict xsp, const float *__restrict posY,
+                                      const int *__restrict width, const int *__restrict height,
+                                      const uint8_t *__restrict standing, float *__restrict posX,
+                                      float *__restrict velX, float *__restrict hsp, uint8_t *__restrict hitOnWall)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int move = xsp[i];
+        int side = move > 0 ? width[i] / 2 - 1 : -width[i] / 2;
+        int x = (int)posX[i];
+        int y = (int)posY[i];
+        int top = y - height[i] + 1;
+        int stepUp = standing[i] ? MAX_STEP_UP : 0;
+
+        int column = (move != 0) ? SweepWalls(x + side, x + side + move, top, y, stepUp) : SWEEP_NO_HIT;
+        hitOnWall[i] = (column != SWEEP_NO_HIT);
+
+        if (hitOnWall[i])
+        {
+            // Same in-column rule as CollisionHorizontalBlocks
+            bool inColumn = (column == TileFloor(x + side)) && (SweepWalls(x + side, x + side, top, y, stepUp) == SWEEP_NO_HIT);
+
+            if (!inColumn) posX[i] = (float)(move > 0 ? column * TILE_SIZE - 1 - side : column * TILE_SIZE + TILE_SIZE - side);
+            velX[i] = 0.0f;
+            hsp[i] = 0.0f;
+        }
+    }
+}
+
+static void CollisionVerticalKernel(int n, const int *__restrict ysp, const int *__restrict xsp,
+                                    const float *__restrict posX, const int *__restrict width,
+                                    const int *__restrict height, const uint8_t *__restrict grounded,
+                                    const uint8_t *__restrict standing, const uint8_t *__restrict hitOnWall,
+                                    float *__restrict posY,
+                                    float *__restrict velY, float *__restrict vsp,
+                                    uint8_t *__restrict hitOnFloor, uint8_t *__restrict hitOnCeiling)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int move = ysp[i];
+        int x = (int)posX[i];
+        int y = (int)posY[i];
+        int xl = x - width[i] / 2;
+        int xr = x + width[i] / 2 - 1;
+
+        int row = SWEEP_NO_HIT;
+        int floor = SWEEP_NO_HIT;
+
+        if (move < 0)
+        {
+            int head = y - height[i] + 1;
+            row = SweepCeilings(head, head + move, xl, xr);
+        }
+        else
+        {
+            bool following = false;
+
+            // Slope following first, see CollisionVerticalBlocks; a wall hit already zeroed the x move
+            int dx = hitOnWall[i] ? 0 : xsp[i];
+            if ((grounded[i] & standing[i]) && dx != 0)
+            {
+                int destY = y + move;
+                int ground = FindFloor(xl + dx, xr + dx, destY - MAX_STEP_UP + 1, destY + MAX_STEP_UP + 1);
+                following = (ground >= destY - MAX_STEP_UP + 1);
+                if (following && ground != destY + 1) floor = ground;
+            }
+
+            if (!following && move > 0) floor = FindFloor(xl, xr, y + 1, y + move);
+        }
+
+        hitOnFloor[i] = (floor != SWEEP_NO_HIT);
+        hitOnCeiling[i] = (row != SWEEP_NO_HIT);
+
+        if (hitOnFloor[i] | hitOnCeiling[i])
+        {
+            posY[i] = (float)(hitOnFloor[i] ? floor - 1 : row * TILE_SIZE + TILE_SIZE + height[i] - 1);
+            velY[i] = 0.0f;
+            vsp[i] = 0.0f;
+        }
+    }
+}
+
+static void ApplyMovementKernel(int n, float dt, float limit, const float *__restrict velocity,
+                                float *__restrict carry, float *__restrict position)
+{
+    for (int i = 0; i < n; i++)
+    {
+        // Velocity together including last frame sub-pixel value
+        int sp = (int)(velocity[i] * dt + carry[i]);
+        carry[i] = velocity[i] * dt - sp;
+
+        float p = position[i] + sp;
+        p = p < 0.0f ? 0.0f : p;
+        position[i] = p > limit ? limit : p;
+    }
+}
+
+void BatchGroundCheck(EntityBatch *batch, int begin, int end)
+{
+    GroundCheckKernel(end - begin, &batch->positionX[begin], &batch->positionY[begin],
+                      &batch->width[begin], &batch->isGrounded[begin], &batch->isStanding[begin]);
+}
+
+void BatchGetDirection(EntityBatch *batch, int begin, int end)
+{
+    GetDirectionKernel(end - begin, &batch->inputRight[begin], &batch->inputLeft[begin], &batch->direction[begin]);
+}
+
+void BatchMoveCalc(EntityBatch *batch, int begin, int end)
+{
+    MoveCalcKernel(end - begin, deltaTimeFrame, &batch->direction[begin], &batch->maxSpd[begin],
+                   &batch->acc[begin], &batch->dcc[begin], &batch->velocityX[begin]);
+}
+
+void BatchGravityCalc(EntityBatch *batch, int begin, int end)
+{
+    GravityCalcKernel(end - begin, deltaTimeFrame, &batch->gravity[begin], &batch->jumpImpulse[begin],
+                      &batch->jumpRelease[begin], &batch->velocityY[begin], &batch->isGrounded[begin],
+                      &batch->isJumping[begin], &batch->inputJump[begin]);
+}
+
+void BatchCollisionHorizontalBlocks(EntityBatch *batch, int begin, int end)
+{
+    PixelStepKernel(end - begin, deltaTimeFrame, &batch->velocityX[begin], &batch->hsp[begin], &batch->xsp[begin]);
+    CollisionHorizontalKernel(end - begin, &batch->xsp[begin], &batch->positionY[begin], &batch->width[begin],
+                              &batch->height[begin], &batch->isStanding[begin], &batch->positionX[begin], &batch->velocityX[begin], &batch->hsp[begin],
+                              &batch->hitOnWall[begin]);
+}
+
+void BatchCollisionVerticalBlocks(EntityBatch *batch, int begin, int end)
+{
+    PixelStepKernel(end - begin, deltaTimeFrame, &batch->velocityY[begin], &batch->vsp[begin], &batch->ysp[begin]);
+    CollisionVerticalKernel(end - begin, &batch->ysp[begin], &batch->xsp[begin], &batch->positionX[begin],
+                            &batch->width[begin], &batch->height[begin], &batch->isGrounded[begin],
+                            &batch->isStanding[begin], &batch->hitOnWall[begin], &batch->positionY[begin], &batch->velocityY[begin],
+                            &batch->vsp[begin], &batch->hitOnFloor[begin], &batch->hitOnCeiling[begin]);
+}
+
+void BatchApplyMovement(EntityBatch *batch, int begin, int end)
+{
+    ApplyMovementKernel(end - begin, deltaTimeFrame, mapWidth * (float)TILE_SIZE,
+                        &batch->velocityX[begin], &batch->hsp[begin], &batch->positionX[begin]);
+    ApplyMovementKernel(end - begin, deltaTimeFrame, mapHeight * (float)TILE_SIZE,
+                        &batch->velocityY[begin], &batch->vsp[begin], &batch->positionY[begin]);
+}
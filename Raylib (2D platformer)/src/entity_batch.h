@@ -0,0 +1,76 @@
+// entity_batch.h
+#pragma once
+#include "physics.h"
+#include "job_system.h"
+#include <vector>
+#include <cstdint>
+
+// Actors processed per pass of all phases (fits the block's arrays in L1)
+constexpr int ENTITY_BATCH_BLOCK = 256;
+
+//----------------------------------------------------------------------------------
+// Structure-of-arrays storage for many actors sharing the Entity movement model.
+// Every field of Entity gets its own contiguous array so each physics phase runs
+// as one tight loop over all actors instead of chasing Entity pointers.
+//----------------------------------------------------------------------------------
+struct EntityBatch {
+    int count = 0;
+
+    // State
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> direction;
+    // Carry stored subpixel values
+    std::vector<float> hsp;
+    std::vector<float> vsp;
+
+    // Movement parameters
+    std::vector<int> width;
+    std::vector<int> height;
+    std::vector<float> maxSpd;
+    std::vector<float> acc;
+    std::vector<float> dcc;
+    std::vector<float> gravity;
+    std::vector<float> jumpImpulse;
+    std::vector<float> jumpRelease;
+
+    // Flags, one byte per actor so loops stay branch free
+    std::vector<uint8_t> isGrounded;
+    std::vector<uint8_t> isJumping;
+    std::vector<uint8_t> isStanding;
+    std::vector<uint8_t> hitOnFloor;
+    std::vector<uint8_t> hitOnCeiling;
+    std::vector<uint8_t> hitOnWall;
+
+    // Control, written by the player input or AI before each update
+    std::vector<float> inputRight;
+    std::vector<float> inputLeft;
+    std::vector<uint8_t> inputJump;
+
+    // Per-step scratch: whole pixels moved this step
+    std::vector<int> xsp;
+    std::vector<int> ysp;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+void EntityBatchReserve(EntityBatch *batch, int capacity);
+int EntityBatchAdd(EntityBatch *batch, const Entity &entity);
+void EntityBatchClear(EntityBatch *batch);
+void EntityBatchStore(const EntityBatch *batch, int index, Entity *entity);
+
+// Runs the EntityMoveUpdate phases over every actor in the batch. Actors do not touch
+// each other, so with jobs the blocks are spread over its workers, same result.
+void EntityBatchUpdate(EntityBatch *batch, JobSystem *jobs = nullptr);
+
+// Single phases over actors [begin, end)
+void BatchGroundCheck(EntityBatch *batch, int begin, int end);
+void BatchGetDirection(EntityBatch *batch, int begin, int end);
+void BatchMoveCalc(EntityBatch *batch, int begin, int end);
+void BatchGravityCalc(EntityBatch *batch, int begin, int end);
+void BatchCollisionHorizontalBlocks(EntityBatch *batch, int begin, int end);
+void BatchCollisionVerticalBlocks(EntityBatch *batch, int begin, int end);
+void BatchApplyMovement(EntityBatch *batch, int begin, int end);
@@ -0,0 +1,342 @@
+// level_gen.cpp
+#include "level_gen.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Ground surface rows inside a stratum (0 is its top row). At least five rows of air
+// stay above the ground, room for the body, a platform and a jump under the ceiling.
+constexpr int GROUND_BASE = 7;         // Surface at region borders, so regions join
+constexpr int GROUND_LOWEST = LEVEL_STRATUM_ROWS - 2;
+
+// Columns kept flat at the start and end of a region, and around a ladder
+constexpr int EDGE_FLAT = 3;
+constexpr int LADDER_WIDTH = 3;
+
+// Pixels kept in reserve against the jump arc, for subpixel carry and late presses
+constexpr int ARC_MARGIN = 4;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Fixed-size work item: one region across all strata
+struct RegionJob {
+    int x0 = 0;                        // Columns [x0, x1)
+    int x1 = 0;
+    std::vector<Vector2> coins;
+};
+
+// Small splitmix64 generator, cheap to seed per region and stratum
+struct LevelRng {
+    uint64_t state;
+
+    uint64_t Next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [lo, hi], multiply-shift instead of a 64-bit modulo per draw
+    int Range(int lo, int hi)
+    {
+        return lo + (int)(((Next() >> 32) * (uint64_t)(hi - lo + 1)) >> 32);
+    }
+
+    bool Percent(int chance)
+    {
+        return Range(0, 99) < chance;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static LevelRng RegionRng(uint32_t seed, int region, int stratum, int stream)
+{
+    LevelRng rng{ ((uint64_t)seed << 32) ^ ((uint64_t)region << 12) ^ ((uint64_t)stratum << 2) ^ (uint64_t)stream };
+    rng.Next();
+    return rng;
+}
+
+static void SetTile(int x, int y, int tile)
+{
+    tiles[x + (size_t)y * mapWidth] = (int8_t)tile;
+}
+
+// Same stepping as Jump and GravityCalc with jump held: highest rise and the distance
+// covered at maxSpd until the feet are back at the takeoff height
+static void JumpLimits(const Entity *mover, int *riseRows, int *gapColumns)
+{
+    float y = 0.0f;
+    float velocity = mover->jumpImpulse;
+    float apex = 0.0f;
+    int steps = 0;
+    do
+    {
+        y += velocity * PHYSICS_DT;
+        velocity += mover->gravity * PHYSICS_DT;
+        apex = std::min(apex, y);
+        steps++;
+    } while (y < 0.0f && steps < 1000);
+
+    float distance = steps * mover->maxSpd * PHYSICS_DT;
+    *riseRows = std::max(1, (int)((-apex - ARC_MARGIN) / TILE_SIZE));
+    *gapColumns = std::max(0, (int)((distance - mover->width - ARC_MARGIN) / TILE_SIZE));
+}
+
+// First row of stratum s (counted from the bottom) and its row count; the top stratum
+// also takes the rows left over
+static void StratumRows(int s, int strata, int *top, int *rows)
+{
+    int bottom = mapHeight - 2 - s * LEVEL_STRATUM_ROWS;
+    *top = bottom - LEVEL_STRATUM_ROWS + 1;
+    if (s == strata - 1) *top = 1;
+    *rows = bottom - *top + 1;
+}
+
+// Ladder column of the shaft from stratum s up to s + 1, flat ground is kept around it
+// on both strata
+static int LadderColumn(uint32_t seed, int region, int s, const RegionJob &job)
+{
+    LevelRng rng = RegionRng(seed, region, s, 1);
+    int lo = job.x0 + EDGE_FLAT + 1;
+    int hi = job.x1 - EDGE_FLAT - LADDER_WIDTH - 1;
+    return (hi > lo) ? rng.Range(lo, hi) : lo;
+}
+
+//------------------------------------------------------------------------------------
+// Region layout
+//------------------------------------------------------------------------------------
+static void GenerateRegion(const LevelGenParams &params, const LevelGenResult &limits, int region,
+                           RegionJob *job)
+{
+    const int width = job->x1 - job->x0;
+    const int strata = limits.strata;
+    const int stepRows = std::max(1, std::min(limits.riseRows - 1, GROUND_BASE - 5));
+    const int groundHighest = GROUND_BASE - stepRows;
+
+    // Per stratum surface row (stratum-local) of every column, kept for the ladders
+    std::vector<int> surface((size_t)width * strata);
+    std::vector<uint8_t> locked(width);
+    std::vector<uint8_t> sloped(width);
+
+    // Borders belong to the regions that contain them
+    for (int x = job->x0; x < job->x1; x++)
+    {
+        SetTile(x, 0, BLOCK);
+        SetTile(x, mapHeight - 1, BLOCK);
+    }
+    if (job->x0 == 1) for (int y = 0; y < mapHeight; y++) SetTile(0, y, BLOCK);
+    if (job->x1 == mapWidth - 1) for (int y = 0; y < mapHeight; y++) SetTile(mapWidth - 1, y, BLOCK);
+
+    for (int s = 0; s < strata; s++)
+    {
+        LevelRng rng = RegionRng(params.seed, region, s, 0);
+        int top, rows;
+        StratumRows(s, strata, &top, &rows);
+        // Ground rows are counted from the nominal top, spare rows of the top stratum
+        // only add air
+        int origin = top + rows - LEVEL_STRATUM_ROWS;
+        int *h = &surface[(size_t)s * width];
+
+        // Flat at the region edges and around the ladders up from and into this stratum
+        std::fill(locked.begin(), locked.end(), 0);
+        std::fill(sloped.begin(), sloped.end(), 0);
+        for (int i = 0; i < std::min(EDGE_FLAT, width); i++)
+        {
+            locked[i] = 1;
+            locked[width - 1 - i] = 1;
+        }
+        for (int t = s - 1; t <= s; t++)
+        {
+            if (t < 0 || t >= strata - 1) continue;
+            int c = LadderColumn(params.seed, region, t, *job) - job->x0;
+            for (int i = std::max(0, c - 1); i <= std::min(width - 1, c + LADDER_WIDTH); i++) locked[i] = 1;
+        }
+
+        // Rolling ground: runs of 2-8 columns, each a bounded step up or down from the
+        // last, with pits no wider than a running jump
+        int level = GROUND_BASE;
+        int run = 0;
+        for (int i = 0; i < width; i++)
+        {
+            if (locked[i])
+            {
+                // Locked runs sit at the border height; the step into one is bounded
+                // since the ground never leaves [groundHighest, GROUND_BASE + 1]
+                if (i < EDGE_FLAT || i >= width - EDGE_FLAT) level = GROUND_BASE;
+                h[i] = level;
+                run = 0;
+                continue;
+            }
+
+            if (run == 0)
+            {
+                run = rng.Range(2, 8);
+                int pit = rng.Range(1, std::max(1, limits.gapColumns));
+                bool pitFits = limits.gapColumns > 0 && i + pit < width && !locked[i + pit] && rng.Percent(15);
+                if (pitFits)
+                {
+                    int depth = std::min(stepRows, GROUND_LOWEST - level);
+                    if (depth > 0)
+                    {
+                        for (int k = 0; k < pit; k++) h[i + k] = level + depth;
+                        i += pit - 1;
+                        run = 0;
+                        continue;
+                    }
+                }
+                level = std::max(groundHighest, std::min(GROUND_BASE + 1, level + rng.Range(-stepRows, stepRows)));
+            }
+            h[i] = level;
+            run--;
+        }
+
+        // Fill below the surface row by row, the tiles are row-major and a column walk
+        // would touch a cache line per tile on wide levels
+        int highestRow = origin + *std::min_element(h, h + width);
+        for (int y = highestRow; y < top + rows; y++)
+        {
+            int8_t *row = &tiles[job->x0 + (size_t)y * mapWidth];
+            for (int i = 0; i < width; i++)
+            {
+                row[i] = (int8_t)((y >= origin + h[i]) ? BLOCK : EMPTY);
+            }
+        }
+
+        // 45 degree slopes on single-row steps between runs of at least two columns
+        for (int i = 0; i < width; i++)
+        {
+            int x = job->x0 + i;
+            if (locked[i] || i < 2 || i + 1 >= width) continue;
+            if (h[i - 1] == h[i] + 1 && h[i + 1] == h[i] && h[i - 2] == h[i - 1] && rng.Percent(50))
+            {
+                SetTile(x, origin + h[i], SLOPE_RIGHT);
+                sloped[i] = 1;
+            }
+        }
+        for (int i = width - 3; i >= 1; i--)
+        {
+            if (locked[i] || sloped[i] || sloped[i + 1]) continue;
+            if (h[i + 1] == h[i] + 1 && h[i - 1] == h[i] && h[i + 2] == h[i + 1] && rng.Percent(50))
+            {
+                SetTile(job->x0 + i, origin + h[i], SLOPE_LEFT);
+                sloped[i] = 1;
+            }
+        }
+
+        // One-way platforms a standing jump above the highest ground under them, so
+        // they are reached straight from below
+        for (int i = 1; i + 3 < width; i++)
+        {
+            if (!rng.Percent(12)) continue;
+            int length = rng.Range(3, 6);
+            if (i + length >= width) continue;
+
+            bool clear = true;
+            int highest = LEVEL_STRATUM_ROWS;
+            for (int k = i; k < i + length; k++)
+            {
+                clear = clear && !locked[k];
+                highest = std::min(highest, h[k]);
+            }
+            int row = highest - limits.riseRows;
+            if (!clear || row < 2) continue;
+
+            for (int k = i; k < i + length; k++)
+            {
+                SetTile(job->x0 + k, origin + row, ONE_WAY);
+                if (rng.Percent(params.coinPercent))
+                {
+                    job->coins.push_back({ (float)((job->x0 + k) * TILE_SIZE + 6), (float)((origin + row - 1) * TILE_SIZE + 6) });
+                }
+            }
+            i += length + 2;
+        }
+
+        // Sparse coins on flat ground
+        for (int i = 0; i < width; i++)
+        {
+            if (sloped[i] || !rng.Percent(params.coinPercent / 8)) continue;
+            job->coins.push_back({ (float)((job->x0 + i) * TILE_SIZE + 6), (float)((origin + h[i] - 1) * TILE_SIZE + 6) });
+        }
+    }
+
+    // Ladders: open the ground of the stratum above into a one-way landing and stack
+    // one-way rungs under it, no further apart than a standing jump
+    for (int s = 0; s + 1 < strata; s++)
+    {
+        int c = LadderColumn(params.seed, region, s, *job);
+        int i = c - job->x0;
+
+        int topBelow, rowsBelow, topAbove, rowsAbove;
+        StratumRows(s, strata, &topBelow, &rowsBelow);
+        StratumRows(s + 1, strata, &topAbove, &rowsAbove);
+        int ground = topBelow + rowsBelow - LEVEL_STRATUM_ROWS + surface[(size_t)s * width + i];
+        int landing = topAbove + rowsAbove - LEVEL_STRATUM_ROWS + surface[(size_t)(s + 1) * width + i];
+
+        for (int x = c; x < c + LADDER_WIDTH; x++)
+        {
+            SetTile(x, landing, ONE_WAY);
+            for (int y = landing + 1; y < topAbove + rowsAbove; y++) SetTile(x, y, EMPTY);
+        }
+
+        int span = ground - landing;
+        int rungs = (span + limits.riseRows - 1) / limits.riseRows;
+        for (int k = 1; k < rungs; k++)
+        {
+            int y = ground - (span * k + rungs / 2) / rungs;
+            for (int x = c; x < c + LADDER_WIDTH; x++) SetTile(x, y, ONE_WAY);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void LevelGenerate(const LevelGenParams &params, const Entity *mover, LevelGenResult *result)
+{
+    int width = std::max(LEVEL_MIN_WIDTH, std::min(LEVEL_MAX_WIDTH, params.width));
+    int height = std::max(LEVEL_MIN_HEIGHT, std::min(LEVEL_MAX_HEIGHT, params.height));
+    MapResize(width, height);
+
+    JumpLimits(mover, &result->riseRows, &result->gapColumns);
+    result->strata = std::max(1, (height - 2) / LEVEL_STRATUM_ROWS);
+
+    // Inner columns split into equal regions, the last one takes the remainder
+    int inner = width - 2;
+    result->regions = std::max(1, inner / LEVEL_REGION_COLUMNS);
+    std::vector<RegionJob> jobs(result->regions);
+    for (int r = 0; r < result->regions; r++)
+    {
+        jobs[r].x0 = 1 + r * LEVEL_REGION_COLUMNS;
+        jobs[r].x1 = (r == result->regions - 1) ? width - 1 : jobs[r].x0 + LEVEL_REGION_COLUMNS;
+    }
+
+    // Regions only write their own columns, workers just take the next one
+    int threads = params.threads > 0 ? params.threads : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, result->regions));
+
+    std::atomic<int> nextRegion(0);
+    auto worker = [&]() {
+        for (int r = nextRegion++; r < result->regions; r = nextRegion++) GenerateRegion(params, *result, r, &jobs[r]);
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool) thread.join();
+
+    // Coins in region order, whatever order the regions finished in
+    result->coins.clear();
+    for (const RegionJob &job : jobs) result->coins.insert(result->coins.end(), job.coins.begin(), job.coins.end());
+
+    int spawnX = 1 + 1;
+    int spawnRow = mapHeight - 2 - LEVEL_STRATUM_ROWS + 1 + GROUND_BASE;
+    result->spawn = { (float)(spawnX * TILE_SIZE + TILE_SIZE / 2), (float)(spawnRow * TILE_SIZE - 1) };
+}
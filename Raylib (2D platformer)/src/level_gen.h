@@ -0,0 +1,55 @@
+// level_gen.h
+#pragma once
+#include "physics.h"
+#include <vector>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Accepted level sizes in tiles, larger or smaller requests are clamped
+constexpr int LEVEL_MIN_WIDTH  = TILE_MAP_WIDTH;
+constexpr int LEVEL_MIN_HEIGHT = TILE_MAP_HEIGHT;
+constexpr int LEVEL_MAX_WIDTH  = 100000;
+constexpr int LEVEL_MAX_HEIGHT = 1000;
+
+// Columns of one region, the unit of parallel work. The last region also takes the
+// remainder, so regions are LEVEL_REGION_COLUMNS to twice that wide.
+constexpr int LEVEL_REGION_COLUMNS = 256;
+
+// Rows of one stratum, a band of rolling ground with platforms above it. Strata are
+// stacked bottom up and joined by one-way ladders; the top one gets the spare rows.
+constexpr int LEVEL_STRATUM_ROWS = 10;
+
+//----------------------------------------------------------------------------------
+// Seeded generator for large test levels. Every region of every stratum is laid out
+// from its own seed, so the result does not depend on the thread count, and each one
+// takes a fixed number of passes over its tiles (no retries), so the time only grows
+// with the level size. Ground steps, pits and ladder rungs are bounded by the jump
+// arc of the mover the level is made for.
+//----------------------------------------------------------------------------------
+struct LevelGenParams {
+    int width = TILE_MAP_WIDTH;
+    int height = TILE_MAP_HEIGHT;
+    uint32_t seed = 1;
+    int threads = 0;                   // 0: one per hardware thread
+    int coinPercent = 40;              // Chance of a coin above each platform tile
+};
+
+struct LevelGenResult {
+    Vector2 spawn{0.0f, 0.0f};         // Feet position, bottom stratum on the left
+    std::vector<Vector2> coins;        // Top-left corners, like COIN_POSITIONS
+
+    int regions = 0;
+    int strata = 0;
+    // Limits taken from the jump arc
+    int riseRows = 0;                  // Highest ledge reachable from standing, in tiles
+    int gapColumns = 0;                // Widest pit cleared with a running jump
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Replaces the current tiles (MapResize) with a generated level sized for 'mover'
+// (set up by PlayerInit). Same params and mover give the same tiles and coins.
+void LevelGenerate(const LevelGenParams &params, const Entity *mover, LevelGenResult *result);
@@ -0,0 +1,55 @@
+// loopback.cpp
+#include "loopback.h"
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void LoopbackInit(LoopbackTransport *transport, int delay, int jitter, int lossPercent, unsigned int seed)
+{
+    transport->delay = delay;
+    transport->jitter = jitter;
+    transport->lossPercent = lossPercent;
+    transport->tick = 0;
+    transport->rng.seed(seed);
+    transport->inFlight[0].clear();
+    transport->inFlight[1].clear();
+    transport->sent = 0;
+    transport->dropped = 0;
+}
+
+void LoopbackTick(LoopbackTransport *transport)
+{
+    transport->tick++;
+}
+
+void LoopbackSend(LoopbackTransport *transport, int toPeer, const NetPacket &packet)
+{
+    transport->sent++;
+
+    std::uniform_int_distribution<int> percent(0, 99);
+    if (percent(transport->rng) < transport->lossPercent)
+    {
+        transport->dropped++;
+        return;
+    }
+
+    std::uniform_int_distribution<int> extra(0, transport->jitter);
+    transport->inFlight[toPeer].push_back({ packet, transport->tick + transport->delay + extra(transport->rng) });
+}
+
+bool LoopbackReceive(LoopbackTransport *transport, int peer, NetPacket *packet)
+{
+    std::vector<LoopbackPacket> &queue = transport->inFlight[peer];
+
+    // Few packets are ever in flight, a scan is enough
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        if (queue[i].deliverTick <= transport->tick)
+        {
+            *packet = queue[i].packet;
+            queue.erase(queue.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,56 @@
+// loopback.h
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <random>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Inputs one packet carries; older unacknowledged inputs ride along so a lost packet
+// is covered by the next one
+constexpr int NET_PACKET_INPUTS = 32;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct NetPacket {
+    int firstFrame = 0;                // Frame of buttons[0]
+    int count = 0;
+    uint8_t buttons[NET_PACKET_INPUTS] = {};
+    int ackFrame = -1;                 // Last frame of the receiver's input the sender has
+};
+
+struct LoopbackPacket {
+    NetPacket packet;
+    int deliverTick = 0;
+};
+
+//----------------------------------------------------------------------------------
+// In-process stand-in for a UDP socket pair between two peers. Packets arrive after
+// 'delay' ticks plus up to 'jitter' more, may be dropped with 'lossPercent' chance
+// and, with jitter, may arrive out of order, like datagrams.
+//----------------------------------------------------------------------------------
+struct LoopbackTransport {
+    int delay = 0;
+    int jitter = 0;
+    int lossPercent = 0;
+    int tick = 0;
+
+    std::mt19937 rng;
+    std::vector<LoopbackPacket> inFlight[2];   // Per receiving peer
+
+    long sent = 0;
+    long dropped = 0;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+void LoopbackInit(LoopbackTransport *transport, int delay, int jitter, int lossPercent, unsigned int seed);
+// Advances the simulated clock by one tick (one physics step on both peers)
+void LoopbackTick(LoopbackTransport *transport);
+
+void LoopbackSend(LoopbackTransport *transport, int toPeer, const NetPacket &packet);
+// Pops one packet that has arrived for the peer, false when there is none
+bool LoopbackReceive(LoopbackTransport *transport, int peer, NetPacket *packet);
@@ -0,0 +1,631 @@
+// nav.cpp
+#include "nav.h"
+#include <algorithm>
+#include <cstdlib>
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Columns either side of a changed column whose edges can see it: arcs travel at most
+// NAV_MAX_REACH tiles, falls start one tile over, plus the body overhang
+constexpr int NAV_UPDATE_MARGIN = NAV_MAX_REACH + 2;
+
+static int TileAt(int x, int y)
+{
+    if ((unsigned)x >= (unsigned)mapWidth || (unsigned)y >= (unsigned)mapHeight) return EMPTY;
+    return tiles[x + y * mapWidth];
+}
+
+// Highest solid height of a tile under pixel columns [a, b] of it
+static int SpanHeight(int tile, int a, int b)
+{
+    const TileShape &shape = GetTileShape(tile);
+    return std::max(shape.height[a], shape.height[b]);
+}
+
+// Top pixel of tile (x, row) in one of its pixel columns
+static int ColumnSurface(int x, int row, int column)
+{
+    return row * TILE_SIZE + TILE_SIZE - GetTileShape(TileAt(x, row)).height[column];
+}
+
+// Top pixel of the body standing on tile (x, row) with its centre at pixel column px
+static int StandSurface(const NavGraph *graph, int x, int row, int px)
+{
+    int a = std::max(px - graph->bodyWidth / 2 - x * TILE_SIZE, 0);
+    int b = std::min(px + graph->bodyWidth / 2 - 1 - x * TILE_SIZE, TILE_ROUND);
+    return row * TILE_SIZE + TILE_SIZE - SpanHeight(TileAt(x, row), a, b);
+}
+
+// A floor tile with nothing solid where the body goes when standing on it
+static bool IsStandable(const NavGraph *graph, int x, int row)
+{
+    int tile = TileAt(x, row);
+    if (tile == EMPTY || row < 1) return false;
+
+    int top = StandSurface(graph, x, row, x * TILE_SIZE + TILE_SIZE / 2) - graph->bodyHeight;
+    if (top < 0) return false;
+
+    for (int r = TileFloor(top); r < row; r++)
+    {
+        int above = TileAt(x, r);
+        if (above != EMPTY && above != ONE_WAY) return false;
+    }
+    return true;
+}
+
+// Body with feet at (px, py) overlaps a solid part of some tile. One-way tiles never
+// block, shapes only when the feet are below their top under the body.
+static bool BodyBlocked(const NavGraph *graph, int px, int py)
+{
+    int left = px - graph->bodyWidth / 2;
+    int right = px + graph->bodyWidth / 2 - 1;
+
+    for (int r = TileFloor(py - graph->bodyHeight + 1); r <= TileFloor(py); r++)
+    {
+        for (int c = TileFloor(left); c <= TileFloor(right); c++)
+        {
+            int tile = TileAt(c, r);
+            if (tile == EMPTY || tile == ONE_WAY) continue;
+
+            int a = std::max(left - c * TILE_SIZE, 0);
+            int b = std::min(right - c * TILE_SIZE, TILE_ROUND);
+            int h = SpanHeight(tile, a, b);
+            if (h > 0 && py >= r * TILE_SIZE + TILE_SIZE - h) return true;
+        }
+    }
+    return false;
+}
+
+static int NodeAt(const NavGraph *graph, int x, int row)
+{
+    if ((unsigned)x >= (unsigned)graph->columns.size()) return NAV_NO_NODE;
+
+    for (int id : graph->columns[x])
+    {
+        if (graph->nodes[id].row == row) return id;
+    }
+    return NAV_NO_NODE;
+}
+
+// Feet offsets per step of one arc, integrated like EntityMoveUpdate (velocity, then the
+// integer part of velocity * dt with the subpixel carry). After NAV_MAX_REACH tiles the
+// mover stops steering and drops straight down.
+static void TraceArc(NavArc *arc, const Entity *mover, int maxDrop)
+{
+    const float dt = PHYSICS_DT;
+    const int reach = NAV_MAX_REACH * TILE_SIZE;
+    const float target = arc->speed * mover->maxSpd;
+
+    // Falls and running jumps leave at their speed, delayed jumps from standing still
+    float vx = (arc->delay == 0) ? arc->dir * target : 0.0f;
+    float vy = arc->jump ? mover->jumpImpulse : 0.0f;
+    float hsp = 0.0f;
+    float vsp = 0.0f;
+    int x = 0;
+    int y = 0;
+
+    arc->steps.clear();
+    for (int i = 0; y <= maxDrop; i++)
+    {
+        if (std::abs(x) >= reach)
+        {
+            vx = 0.0f;
+            hsp = 0.0f;
+        }
+        else if (i >= arc->delay)
+        {
+            vx = ttc_clamp(vx + arc->dir * mover->acc * dt, -target, target);
+        }
+
+        vy += mover->gravity * dt;
+        if (vy > -mover->jumpImpulse) vy = -mover->jumpImpulse;
+
+        float xVel = vx * dt + hsp;
+        int xsp = (int)ttc_abs(xVel) * ttc_sign(xVel);
+        hsp = vx * dt - xsp;
+
+        float yVel = vy * dt + vsp;
+        int ysp = (int)ttc_abs(yVel) * ttc_sign(yVel);
+        vsp = vy * dt - ysp;
+
+        x += xsp;
+        y += ysp;
+        arc->steps.push_back({ (int16_t)x, (int16_t)y });
+    }
+}
+
+static void AddArc(NavGraph *graph, int dir, float speed, int delay, bool jump)
+{
+    NavArc arc;
+    arc.dir = dir;
+    arc.speed = speed;
+    arc.delay = delay;
+    arc.jump = jump;
+    graph->arcs.push_back(arc);
+}
+
+static void BuildArcs(NavGraph *graph, const Entity *mover)
+{
+    graph->arcs.clear();
+
+    // Straight up, for one-way platforms overhead
+    AddArc(graph, 0, 0.0f, 0, true);
+
+    const float speeds[] = { 0.25f, 0.5f, 1.0f };
+    for (int dir = -1; dir <= 1; dir += 2)
+    {
+        for (float speed : speeds)
+        {
+            AddArc(graph, dir, speed, 0, true);
+            AddArc(graph, dir, speed, NAV_JUMP_DELAY, true);
+        }
+        AddArc(graph, dir, 0.25f, 0, false);
+        AddArc(graph, dir, 1.0f, 0, false);
+    }
+
+    // Long enough to fall from the top of the level out of the bottom
+    int maxDrop = std::min(mapHeight * TILE_SIZE + mover->height, 32000);
+    for (NavArc &arc : graph->arcs) TraceArc(&arc, mover, maxDrop);
+}
+
+// Keeps the cheapest way to each target
+static void AddEdge(NavNode *node, int to, float cost, int type, int arc)
+{
+    for (NavEdge &edge : node->edges)
+    {
+        if (edge.to == to)
+        {
+            if (cost < edge.cost) edge = { to, cost, (uint8_t)type, (uint8_t)arc };
+            return;
+        }
+    }
+    node->edges.push_back({ to, cost, (uint8_t)type, (uint8_t)arc });
+}
+
+// Surfaces meeting at the tile border are close enough to walk (or step) across
+static int WalkNeighbour(const NavGraph *graph, const NavNode &node, int dir)
+{
+    int nx = node.x + dir;
+    int edgeSurface = ColumnSurface(node.x, node.row, (dir > 0) ? TILE_ROUND : 0);
+
+    for (int row = node.row - 1; row <= node.row + 1; row++)
+    {
+        int id = NodeAt(graph, nx, row);
+        if (id == NAV_NO_NODE) continue;
+
+        int nextSurface = ColumnSurface(nx, row, (dir > 0) ? 0 : TILE_ROUND);
+        if (std::abs(nextSurface - edgeSurface) <= MAX_STEP_UP) return id;
+    }
+    return NAV_NO_NODE;
+}
+
+// Replays one arc from (px, py) and returns the node it lands on, or NAV_NO_NODE when
+// it hits something first or leaves the level. *steps receives the steps taken.
+static int FollowArc(const NavGraph *graph, const NavArc &arc, int from, int px, int py, int *steps)
+{
+    const int levelWidth = mapWidth * TILE_SIZE;
+    const int levelHeight = mapHeight * TILE_SIZE;
+    const int halfWidth = graph->bodyWidth / 2;
+
+    if (BodyBlocked(graph, px, py)) return NAV_NO_NODE;
+
+    int prevX = px;
+    int prevY = py;
+    for (int i = 0; i < (int)arc.steps.size(); i++)
+    {
+        int x = px + arc.steps[i].dx;
+        int y = py + arc.steps[i].dy;
+        if ((unsigned)x >= (unsigned)levelWidth || y >= levelHeight) return NAV_NO_NODE;
+
+        // Walls first like CollisionCheck: a side hit leaves the arc
+        if (BodyBlocked(graph, x, prevY)) return NAV_NO_NODE;
+
+        // Landing: same floor test as CollisionVerticalBlocks, which still sees the body
+        // at the column it started the step in
+        if (y > prevY)
+        {
+            int floor = FindFloor(prevX - halfWidth, prevX + halfWidth - 1, prevY + 1, y);
+            if (floor != SWEEP_NO_HIT)
+            {
+                int row = TileFloor(floor);
+                int id = NodeAt(graph, TileFloor(x), row);
+                if (id == NAV_NO_NODE) id = NodeAt(graph, TileFloor(prevX - halfWidth), row);
+                if (id == NAV_NO_NODE) id = NodeAt(graph, TileFloor(prevX + halfWidth - 1), row);
+
+                *steps = i + 1;
+                return (id == from) ? NAV_NO_NODE : id;
+            }
+        }
+
+        if (BodyBlocked(graph, x, y)) return NAV_NO_NODE;
+        prevX = x;
+        prevY = y;
+    }
+    return NAV_NO_NODE;
+}
+
+static void ComputeEdges(NavGraph *graph, int id)
+{
+    NavNode &node = graph->nodes[id];
+    node.edges.clear();
+
+    const float stepPixels = graph->walkCost / TILE_SIZE;
+    const int centreX = node.x * TILE_SIZE + TILE_SIZE / 2;
+
+    bool walkable[2];
+    for (int side = 0; side < 2; side++)
+    {
+        int to = WalkNeighbour(graph, node, side ? 1 : -1);
+        walkable[side] = (to != NAV_NO_NODE);
+        if (walkable[side]) AddEdge(&node, to, graph->walkCost, NAV_WALK, 0);
+    }
+
+    for (int a = 0; a < (int)graph->arcs.size(); a++)
+    {
+        const NavArc &arc = graph->arcs[a];
+        int px = centreX;
+        float approach = 0.0f;
+
+        if (!arc.jump)
+        {
+            // Walking off only makes sense where there is no floor to walk onto
+            if (walkable[arc.dir > 0]) continue;
+            px = (arc.dir > 0) ? node.x * TILE_SIZE + TILE_SIZE + graph->bodyWidth / 2
+                               : node.x * TILE_SIZE - graph->bodyWidth / 2 - 1;
+            approach = std::abs(px - centreX) * stepPixels;
+        }
+        int py = StandSurface(graph, node.x, node.row, arc.jump ? px : px - arc.dir * graph->bodyWidth) - 1;
+
+        int steps = 0;
+        int to = FollowArc(graph, arc, id, px, py, &steps);
+        if (to == NAV_NO_NODE) continue;
+
+        // Never cheaper than walking the same distance, which keeps the A* estimate exact
+        const NavNode &target = graph->nodes[to];
+        float cost = std::max(approach + steps, std::abs(target.x - node.x) * graph->walkCost);
+        AddEdge(&graph->nodes[id], to, cost, arc.jump ? NAV_JUMP : NAV_FALL, a);
+    }
+}
+
+static int AllocateNode(NavGraph *graph)
+{
+    if (!graph->freeNodes.empty())
+    {
+        int id = graph->freeNodes.back();
+        graph->freeNodes.pop_back();
+        return id;
+    }
+
+    graph->nodes.emplace_back();
+    return (int)graph->nodes.size() - 1;
+}
+
+// Matches the column's node list to the tiles, keeping the ids of nodes that remain
+static void ScanColumn(NavGraph *graph, int x)
+{
+    std::vector<int> &column = graph->columns[x];
+    std::vector<int> kept;
+
+    for (int row = 1; row < mapHeight; row++)
+    {
+        if (!IsStandable(graph, x, row)) continue;
+
+        int id = NodeAt(graph, x, row);
+        if (id == NAV_NO_NODE)
+        {
+            id = AllocateNode(graph);
+            NavNode &node = graph->nodes[id];
+            node.x = x;
+            node.row = row;
+            node.active = true;
+        }
+        graph->nodes[id].feetY = StandSurface(graph, x, row, x * TILE_SIZE + TILE_SIZE / 2) - 1;
+        kept.push_back(id);
+    }
+
+    for (int id : column)
+    {
+        if (std::find(kept.begin(), kept.end(), id) != kept.end()) continue;
+
+        NavNode &node = graph->nodes[id];
+        node.active = false;
+        node.edges.clear();
+        graph->freeNodes.push_back(id);
+    }
+
+    column.swap(kept);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void NavGraphBuild(NavGraph *graph, const Entity *mover)
+{
+    graph->bodyWidth = mover->width;
+    graph->bodyHeight = mover->height;
+    graph->walkCost = TILE_SIZE / (mover->maxSpd * PHYSICS_DT);
+    BuildArcs(graph, mover);
+
+    graph->nodes.clear();
+    graph->freeNodes.clear();
+    graph->columns.assign(mapWidth, std::vector<int>());
+
+    for (int x = 0; x < mapWidth; x++) ScanColumn(graph, x);
+    for (int id = 0; id < (int)graph->nodes.size(); id++) ComputeEdges(graph, id);
+
+    graph->version++;
+}
+
+void NavGraphUpdate(NavGraph *graph, int x0, int x1)
+{
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, mapWidth - 1);
+    if (x0 > x1) return;
+
+    for (int x = x0; x <= x1; x++) ScanColumn(graph, x);
+
+    // Every edge into or out of the rebuilt columns starts within the margin
+    int first = std::max(x0 - NAV_UPDATE_MARGIN, 0);
+    int last = std::min(x1 + NAV_UPDATE_MARGIN, mapWidth - 1);
+    for (int x = first; x <= last; x++)
+    {
+        for (int id : graph->columns[x]) ComputeEdges(graph, id);
+    }
+
+    graph->version++;
+}
+
+int NavFindNode(const NavGraph *graph, float x, float y)
+{
+    int column = TileFloor((int)x);
+    if ((unsigned)column >= (unsigned)graph->columns.size()) return NAV_NO_NODE;
+
+    // Columns are sorted top to bottom, the first floor at or under the feet wins
+    for (int id : graph->columns[column])
+    {
+        if (graph->nodes[id].feetY >= (int)y - MAX_STEP_UP) return id;
+    }
+    return NAV_NO_NODE;
+}
+
+const NavEdge *NavFindEdge(const NavGraph *graph, int from, int to)
+{
+    for (const NavEdge &edge : graph->nodes[from].edges)
+    {
+        if (edge.to == to) return &edge;
+    }
+    return nullptr;
+}
+
+int NavEdgeCount(const NavGraph *graph)
+{
+    int count = 0;
+    for (const NavNode &node : graph->nodes)
+    {
+        if (node.active) count += (int)node.edges.size();
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------------
+// Path queries
+//------------------------------------------------------------------------------------
+static bool QueuedAfter(const NavQueued &a, const NavQueued &b)
+{
+    return a.priority > b.priority;
+}
+
+static void Push(std::vector<NavQueued> *open, float priority, int node)
+{
+    open->push_back({ priority, node });
+    std::push_heap(open->begin(), open->end(), QueuedAfter);
+}
+
+static NavQueued Pop(std::vector<NavQueued> *open)
+{
+    std::pop_heap(open->begin(), open->end(), QueuedAfter);
+    NavQueued top = open->back();
+    open->pop_back();
+    return top;
+}
+
+bool NavFindPath(NavGraph *graph, int start, int goal, std::vector<int> *path)
+{
+    path->clear();
+    if (start == NAV_NO_NODE || goal == NAV_NO_NODE) return false;
+
+    size_t count = graph->nodes.size();
+    if (graph->searchStamp.size() < count)
+    {
+        graph->searchStamp.resize(count, 0);
+        graph->searchCost.resize(count);
+        graph->searchParent.resize(count);
+    }
+
+    // Stamp wrap-around: reset so stale stamps cannot match
+    if (++graph->searchId == 0)
+    {
+        std::fill(graph->searchStamp.begin(), graph->searchStamp.end(), 0);
+        graph->searchId = 1;
+    }
+    const uint32_t stamp = graph->searchId;
+
+    // Horizontal distance at maxSpd, no edge is cheaper than that
+    const int goalX = graph->nodes[goal].x;
+    auto estimate = [&](int id) { return std::abs(graph->nodes[id].x - goalX) * graph->walkCost; };
+
+    std::vector<NavQueued> &open = graph->searchOpen;
+    open.clear();
+    graph->searchStamp[start] = stamp;
+    graph->searchCost[start] = 0.0f;
+    graph->searchParent[start] = NAV_NO_NODE;
+    Push(&open, estimate(start), start);
+
+    while (!open.empty())
+    {
+        NavQueued top = Pop(&open);
+        int id = top.node;
+        if (id == goal) break;
+        // Stale entry, the node was reached cheaper since
+        if (top.priority > graph->searchCost[id] + estimate(id)) continue;
+
+        for (const NavEdge &edge : graph->nodes[id].edges)
+        {
+            float cost = graph->searchCost[id] + edge.cost;
+            if (graph->searchStamp[edge.to] == stamp && cost >= graph->searchCost[edge.to]) continue;
+
+            graph->searchStamp[edge.to] = stamp;
+            graph->searchCost[edge.to] = cost;
+            graph->searchParent[edge.to] = id;
+            Push(&open, cost + estimate(edge.to), edge.to);
+        }
+    }
+
+    if (graph->searchStamp[goal] != stamp) return false;
+
+    for (int id = goal; id != NAV_NO_NODE; id = graph->searchParent[id]) path->push_back(id);
+    std::reverse(path->begin(), path->end());
+    return true;
+}
+
+float NavPathCost(const NavGraph *graph, const std::vector<int> &path)
+{
+    float cost = 0.0f;
+    for (size_t i = 1; i < path.size(); i++) cost += NavFindEdge(graph, path[i - 1], path[i])->cost;
+    return cost;
+}
+
+void NavPathCacheInit(NavPathCache *cache, int fieldCount)
+{
+    // A miss always needs a field to build into
+    cache->fields.assign(fieldCount > 1 ? fieldCount : 1, NavFlowField());
+    cache->useCounter = 0;
+    cache->reverseVersion = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+// Incoming edge lists of every node, flattened
+static void BuildReverse(NavPathCache *cache, const NavGraph *graph)
+{
+    int count = (int)graph->nodes.size();
+    cache->reverseStart.assign(count + 1, 0);
+
+    for (const NavNode &node : graph->nodes)
+    {
+        if (!node.active) continue;
+        for (const NavEdge &edge : node.edges) cache->reverseStart[edge.to + 1]++;
+    }
+    for (int i = 0; i < count; i++) cache->reverseStart[i + 1] += cache->reverseStart[i];
+
+    cache->reverseFrom.resize(cache->reverseStart[count]);
+    cache->reverseCost.resize(cache->reverseStart[count]);
+
+    std::vector<int> fill(cache->reverseStart.begin(), cache->reverseStart.end() - 1);
+    for (int id = 0; id < count; id++)
+    {
+        const NavNode &node = graph->nodes[id];
+        if (!node.active) continue;
+        for (const NavEdge &edge : node.edges)
+        {
+            int slot = fill[edge.to]++;
+            cache->reverseFrom[slot] = id;
+            cache->reverseCost[slot] = edge.cost;
+        }
+    }
+
+    cache->reverseVersion = graph->version;
+}
+
+// Dijkstra from the goal over incoming edges: cost and next hop for every node at once
+static void BuildField(NavPathCache *cache, const NavGraph *graph, NavFlowField *field, int goal)
+{
+    if (cache->reverseVersion != graph->version) BuildReverse(cache, graph);
+
+    size_t count = graph->nodes.size();
+    field->goal = goal;
+    field->version = graph->version;
+    field->next.assign(count, NAV_NO_NODE);
+    field->cost.assign(count, -1.0f);
+
+    std::vector<NavQueued> &open = cache->open;
+    open.clear();
+    field->cost[goal] = 0.0f;
+    Push(&open, 0.0f, goal);
+
+    while (!open.empty())
+    {
+        NavQueued top = Pop(&open);
+        int id = top.node;
+        if (top.priority > field->cost[id]) continue;
+
+        for (int i = cache->reverseStart[id]; i < cache->reverseStart[id + 1]; i++)
+        {
+            int from = cache->reverseFrom[i];
+            float cost = top.priority + cache->reverseCost[i];
+            if (field->cost[from] >= 0.0f && cost >= field->cost[from]) continue;
+
+            field->cost[from] = cost;
+            field->next[from] = id;
+            Push(&open, cost, from);
+        }
+    }
+}
+
+static const NavFlowField *GetField(NavPathCache *cache, const NavGraph *graph, int goal)
+{
+    NavFlowField *field = nullptr;
+    for (NavFlowField &f : cache->fields)
+    {
+        if (f.goal == goal)
+        {
+            field = &f;
+            break;
+        }
+    }
+
+    if (field != nullptr && field->version == graph->version)
+    {
+        cache->hits++;
+    }
+    else
+    {
+        // Reuse a stale field of the same goal, otherwise the least recently used one
+        if (field == nullptr)
+        {
+            if (cache->fields.empty()) cache->fields.resize(1);     // Never initialized
+            field = &cache->fields[0];
+            for (NavFlowField &f : cache->fields)
+            {
+                if (f.lastUse < field->lastUse) field = &f;
+            }
+        }
+
+        BuildField(cache, graph, field, goal);
+        cache->misses++;
+    }
+
+    field->lastUse = ++cache->useCounter;
+    return field;
+}
+
+bool NavCachedPath(NavPathCache *cache, const NavGraph *graph, int start, int goal, std::vector<int> *path)
+{
+    path->clear();
+    if (start == NAV_NO_NODE || goal == NAV_NO_NODE) return false;
+
+    const NavFlowField *field = GetField(cache, graph, goal);
+    if (field->cost[start] < 0.0f) return false;
+
+    for (int id = start; id != NAV_NO_NODE; id = field->next[id]) path->push_back(id);
+    return true;
+}
+
+int NavNextNode(NavPathCache *cache, const NavGraph *graph, int start, int goal)
+{
+    if (start == NAV_NO_NODE || goal == NAV_NO_NODE) return NAV_NO_NODE;
+    if (start == goal) return goal;
+
+    return GetField(cache, graph, goal)->next[start];
+}
@@ -0,0 +1,143 @@
+// nav.h
+#pragma once
+#include "physics.h"
+#include <vector>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int NAV_NO_NODE = -1;
+
+// Ways to get from one node to another
+constexpr int NAV_WALK = 0;
+constexpr int NAV_JUMP = 1;
+constexpr int NAV_FALL = 2;            // Walk off the edge and drop
+
+// Horizontal tiles an arc may travel before the mover stops steering sideways. Also
+// bounds how far a tile change can affect edges, see NavGraphUpdate.
+constexpr int NAV_MAX_REACH = 6;
+
+// Steps a jump holds still before steering, for ledges right above the takeoff
+constexpr int NAV_JUMP_DELAY = 12;
+
+//----------------------------------------------------------------------------------
+// Jump-aware platform graph. Nodes are the tiles an actor can stand on (a floor with
+// room for the body above it), edges are walks to the neighbour tile and jump or fall
+// arcs. Arcs are traced once from the mover's maxSpd, acc, gravity and jumpImpulse
+// with the same integer stepping as EntityMoveUpdate, then replayed from every node
+// against the tile map. Edge costs are physics steps.
+//----------------------------------------------------------------------------------
+struct NavEdge {
+    int to = NAV_NO_NODE;
+    float cost = 0.0f;
+    uint8_t type = NAV_WALK;
+    uint8_t arc = 0;                   // Index into NavGraph::arcs for jumps and falls
+};
+
+struct NavNode {
+    int x = 0;                         // Tile of the floor the actor stands on
+    int row = 0;
+    int feetY = 0;                     // Feet pixel row when standing at the tile centre
+    bool active = false;
+    std::vector<NavEdge> edges;
+};
+
+// Offsets of the feet from the takeoff point after each physics step
+struct NavArcStep {
+    int16_t dx;
+    int16_t dy;
+};
+
+// Input that reproduces an arc: arrive at 'speed' (fraction of maxSpd) towards 'dir',
+// hold jump (if any), and keep steering. Delayed jumps start standing still and only
+// steer after 'delay' steps.
+struct NavArc {
+    int dir = 0;
+    float speed = 0.0f;
+    int delay = 0;
+    bool jump = false;
+    std::vector<NavArcStep> steps;
+};
+
+// Open list entry of the searches, kept as a binary heap
+struct NavQueued {
+    float priority;
+    int node;
+};
+
+struct NavGraph {
+    // Mover the graph was built for
+    int bodyWidth = 0;
+    int bodyHeight = 0;
+    float walkCost = 0.0f;             // Steps to cross one tile at maxSpd
+    std::vector<NavArc> arcs;
+
+    std::vector<NavNode> nodes;
+    std::vector<int> freeNodes;
+    // Node ids per tile column, top to bottom
+    std::vector<std::vector<int>> columns;
+
+    // Bumped by every build or update, path caches compare against it
+    uint32_t version = 0;
+
+    // A* scratch, stamped like SpatialHash queries so a search does not clear it
+    std::vector<uint32_t> searchStamp;
+    std::vector<float> searchCost;
+    std::vector<int> searchParent;
+    std::vector<NavQueued> searchOpen;
+    uint32_t searchId = 0;
+};
+
+// Every goal gets a backward search over the whole graph, after which any number of
+// agents read their next node or full path without searching again
+struct NavFlowField {
+    int goal = NAV_NO_NODE;
+    uint32_t version = 0;
+    uint32_t lastUse = 0;
+    std::vector<int> next;             // Next node towards goal, NAV_NO_NODE if unreachable
+    std::vector<float> cost;           // Steps left to goal
+};
+
+// Path cache shared by all agents moving on one graph
+struct NavPathCache {
+    std::vector<NavFlowField> fields;
+    uint32_t useCounter = 0;
+
+    // Incoming edges in one flat array per graph version, for the backward searches
+    uint32_t reverseVersion = 0;
+    std::vector<int> reverseStart;
+    std::vector<int> reverseFrom;
+    std::vector<float> reverseCost;
+    std::vector<NavQueued> open;
+
+    int hits = 0;
+    int misses = 0;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Builds the graph for the current tiles and the movement values of 'mover' (set up
+// by PlayerInit)
+void NavGraphBuild(NavGraph *graph, const Entity *mover);
+// Call after changing tiles in columns [x0, x1]: rebuilds the nodes of those columns
+// and the edges of nodes within NAV_MAX_REACH + 2 columns of them
+void NavGraphUpdate(NavGraph *graph, int x0, int x1);
+
+// Node the actor with feet at (x, y) stands on or will land on first, or NAV_NO_NODE
+int NavFindNode(const NavGraph *graph, float x, float y);
+const NavEdge *NavFindEdge(const NavGraph *graph, int from, int to);
+int NavEdgeCount(const NavGraph *graph);
+
+// Single A* search, nothing kept between calls. Fills path with the node ids from
+// start to goal and returns false when goal cannot be reached.
+bool NavFindPath(NavGraph *graph, int start, int goal, std::vector<int> *path);
+float NavPathCost(const NavGraph *graph, const std::vector<int> &path);
+
+// fieldCount goals (at least one) are kept, the least recently used one is replaced
+void NavPathCacheInit(NavPathCache *cache, int fieldCount);
+// Same result as NavFindPath (an equally short path), served from the goal's field
+bool NavCachedPath(NavPathCache *cache, const NavGraph *graph, int start, int goal, std::vector<int> *path);
+// Only the next node towards goal, what an agent needs each frame
+int NavNextNode(NavPathCache *cache, const NavGraph *graph, int start, int goal);
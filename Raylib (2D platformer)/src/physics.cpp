@@ -0,0 +1,395 @@
+// physics.cpp
+#include "physics.h"
+#include <cstring>
+
+//------------------------------------------------------------------------------------
+// Shared physics state
+//------------------------------------------------------------------------------------
+float deltaTimeFrame = PHYSICS_DT;
+
+int mapWidth = 0;
+int mapHeight = 0;
+std::vector<int8_t> tiles;
+
+//------------------------------------------------------------------------------------
+// Tile shapes: solid height in pixels per column, left to right
+//------------------------------------------------------------------------------------
+static_assert(TILE_SIZE == 16, "TILE_SHAPES holds 16 columns per tile");
+
+const TileShape TILE_SHAPES[TILE_TYPE_COUNT + 1] = {
+    // EMPTY
+    {{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, false},
+    // BLOCK
+    {{ 16,16,16,16,16,16,16,16,16,16,16,16,16,16,16,16 }, false},
+    // HALF_BLOCK
+    {{ 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8 }, false},
+    // SLOPE_RIGHT
+    {{ 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,16 }, false},
+    // SLOPE_LEFT
+    {{ 16,15,14,13,12,11,10, 9, 8, 7, 6, 5, 4, 3, 2, 1 }, false},
+    // SLOPE_RIGHT_LOW
+    {{ 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8 }, false},
+    // SLOPE_RIGHT_HIGH
+    {{ 9, 9,10,10,11,11,12,12,13,13,14,14,15,15,16,16 }, false},
+    // SLOPE_LEFT_HIGH
+    {{ 16,16,15,15,14,14,13,13,12,12,11,11,10,10, 9, 9 }, false},
+    // SLOPE_LEFT_LOW
+    {{ 8, 8, 7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1 }, false},
+    // ONE_WAY
+    {{ 16,16,16,16,16,16,16,16,16,16,16,16,16,16,16,16 }, true},
+};
+
+//------------------------------------------------------------------------------------
+// Level setup
+//------------------------------------------------------------------------------------
+const Vector2 COIN_POSITIONS[MAX_COINS] = {
+    {1*16+6, 7*16+6},
+    {3*16+6, 5*16+6},
+    {4*16+6, 5*16+6},
+    {5*16+6, 5*16+6},
+    {8*16+6, 3*16+6},
+    {9*16+6, 3*16+6},
+    {10*16+6, 3*16+6},
+    {13*16+6, 4*16+6},
+    {14*16+6, 4*16+6},
+    {15*16+6, 4*16+6},
+};
+
+// Every tile starts EMPTY
+void MapResize(int width, int height)
+{
+    mapWidth = width;
+    mapHeight = height;
+    tiles.assign((size_t)width * height, (int8_t)EMPTY);
+}
+
+void MapInit(void)
+{
+    MapResize(TILE_MAP_WIDTH, TILE_MAP_HEIGHT);
+
+    for (int y = 0; y < TILE_MAP_HEIGHT; y++)
+    {
+        for (int x = 0; x < TILE_MAP_WIDTH; x++)
+        {
+            if (y == 0 || x == 0 || y == TILE_MAP_HEIGHT-1 || x == TILE_MAP_WIDTH-1)
+            {
+                tiles[x + y * TILE_MAP_WIDTH] = BLOCK;
+            }
+            else
+            {
+                tiles[x + y * TILE_MAP_WIDTH] = EMPTY;
+            }
+        }
+    }
+
+    // Manual platforms
+    tiles[3 + 8*TILE_MAP_WIDTH]  = BLOCK;
+    tiles[4 + 8*TILE_MAP_WIDTH]  = BLOCK;
+    tiles[5 + 8*TILE_MAP_WIDTH]  = BLOCK;
+
+    tiles[8 + 6*TILE_MAP_WIDTH]  = BLOCK;
+    tiles[9 + 6*TILE_MAP_WIDTH]  = BLOCK;
+    tiles[10 + 6*TILE_MAP_WIDTH] = BLOCK;
+
+    tiles[13 + 7*TILE_MAP_WIDTH] = BLOCK;
+    tiles[14 + 7*TILE_MAP_WIDTH] = BLOCK;
+    tiles[15 + 7*TILE_MAP_WIDTH] = BLOCK;
+
+    tiles[1 + 10*TILE_MAP_WIDTH] = BLOCK;
+}
+
+void PlayerInit(Entity *instance, Input *control)
+{
+    instance->position.x = (float)(TILE_SIZE * TILE_MAP_WIDTH) * 0.5f;
+    instance->position.y = TILE_MAP_HEIGHT * TILE_SIZE - 16.0f - 1;
+    instance->direction = 1.0f;
+
+    instance->maxSpd = 1.5625f * 60;
+    instance->acc = 0.118164f * 60 * 60;
+    instance->dcc = 0.113281f * 60 * 60;
+    instance->gravity = 0.363281f * 60 * 60;
+    instance->jumpImpulse = -6.5625f * 60;
+    instance->jumpRelease = instance->jumpImpulse * 0.2f;
+    instance->velocity = {0.0f, 0.0f};
+    instance->hsp = 0.0f;
+    instance->vsp = 0.0f;
+
+    instance->width = 8;
+    instance->height = 16;
+
+    instance->isGrounded = false;
+    instance->isJumping = false;
+    instance->isStanding = false;
+
+    instance->control = control;
+}
+
+//------------------------------------------------------------------------------------
+// State hashing (FNV-1a over the exact bits, so any drift changes the hash)
+//------------------------------------------------------------------------------------
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t HashFloat(uint64_t hash, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return HashBytes(hash, &bits, sizeof(bits));
+}
+
+uint64_t EntityStateHash(const Entity *instance, uint64_t hash)
+{
+    hash = HashFloat(hash, instance->position.x);
+    hash = HashFloat(hash, instance->position.y);
+    hash = HashFloat(hash, instance->velocity.x);
+    hash = HashFloat(hash, instance->velocity.y);
+    hash = HashFloat(hash, instance->hsp);
+    hash = HashFloat(hash, instance->vsp);
+
+    unsigned char flags = (unsigned char)(instance->isGrounded | instance->isJumping << 1 | instance->hitOnFloor << 2 |
+                                          instance->hitOnCeiling << 3 | instance->hitOnWall << 4);
+    return HashBytes(hash, &flags, sizeof(flags));
+}
+
+//------------------------------------------------
+// Physics functions
+//------------------------------------------------
+void EntityMoveUpdate(Entity *instance)
+{
+    GroundCheck(instance);
+    GetDirection(instance);
+    MoveCalc(instance);
+    GravityCalc(instance);
+    CollisionCheck(instance);
+
+    // Horizontal velocity together including last frame sub-pixel value
+    float xVel = instance->velocity.x * deltaTimeFrame + instance->hsp;
+    int xsp = (int)ttc_abs(xVel) * ttc_sign(xVel);
+    instance->hsp = instance->velocity.x * deltaTimeFrame - xsp;
+
+    // Vertical velocity together including last frame sub-pixel value
+    float yVel = instance->velocity.y * deltaTimeFrame + instance->vsp;
+    int ysp = (int)ttc_abs(yVel) * ttc_sign(yVel);
+    instance->vsp = instance->velocity.y * deltaTimeFrame - ysp;
+
+    instance->position.x += xsp;
+    instance->position.y += ysp;
+
+    instance->position.x = ttc_clamp(instance->position.x, 0.0f, mapWidth * (float)TILE_SIZE);
+    instance->position.y = ttc_clamp(instance->position.y, 0.0f, mapHeight * (float)TILE_SIZE);
+}
+
+void GetDirection(Entity *instance)
+{
+    instance->direction = (instance->control->right - instance->control->left);
+}
+
+void GroundCheck(Entity *instance)
+{
+    int x = (int)instance->position.x;
+    int y = (int)instance->position.y;
+    int xl = x - instance->width / 2;
+    int xr = x + instance->width / 2 - 1;
+
+    // Solid pixel right under the feet anywhere across the body, from the shape table
+    instance->isGrounded = GroundProbe(xl, xr, y, &instance->isStanding);
+}
+
+void MoveCalc(Entity *instance)
+{
+    float deadZone = 0.0f;
+    if (ttc_abs(instance->direction) > deadZone)
+    {
+        instance->velocity.x += instance->direction * instance->acc * deltaTimeFrame;
+        instance->velocity.x = ttc_clamp(instance->velocity.x, -instance->maxSpd, instance->maxSpd);
+    }
+    else
+    {
+        float xsp = instance->velocity.x;
+        if (ttc_abs(0 - xsp) < instance->dcc * deltaTimeFrame) instance->velocity.x = 0;
+        else if (xsp > 0) instance->velocity.x -= instance->dcc * deltaTimeFrame;
+        else instance->velocity.x += instance->dcc * deltaTimeFrame;
+    }
+}
+
+void Jump(Entity *instance)
+{
+    instance->velocity.y = instance->jumpImpulse;
+    instance->isJumping = true;
+    instance->isGrounded = false;
+}
+
+void GravityCalc(Entity *instance)
+{
+    if (instance->isGrounded)
+    {
+        if (instance->isJumping)
+        {
+            instance->isJumping = false;
+            instance->control->jump = false;
+        }
+        else if (!instance->isJumping && instance->control->jump)
+        {
+            Jump(instance);
+        }
+    }
+    else
+    {
+        if (instance->isJumping)
+        {
+            if (!instance->control->jump)
+            {
+                instance->isJumping = false;
+
+                if (instance->velocity.y < instance->jumpRelease)
+                {
+                    instance->velocity.y = instance->jumpRelease;
+                }
+            }
+        }
+    }
+
+    instance->velocity.y += instance->gravity * deltaTimeFrame;
+
+    if (instance->velocity.y > -instance->jumpImpulse)
+    {
+        instance->velocity.y = -instance->jumpImpulse;
+    }
+}
+
+void CollisionCheck(Entity *instance)
+{
+    CollisionHorizontalBlocks(instance);
+    CollisionVerticalBlocks(instance);
+}
+
+void CollisionHorizontalBlocks(Entity *instance)
+{
+    float xVel = instance->velocity.x * deltaTimeFrame + instance->hsp;
+    int xsp = (int)ttc_abs(xVel) * ttc_sign(xVel);
+
+    instance->hitOnWall = false;
+
+    int side;
+    if (xsp > 0) side = instance->width / 2 - 1;
+    else if (xsp < 0) side = -instance->width / 2;
+    else return;
+
+    int x = (int)instance->position.x;
+    int y = (int)instance->position.y;
+    int top = -instance->height + 1;
+
+    // Bodies standing on the ground at the start of the step (also the one they jump
+    // off) step onto low faces. One clipped into a corner is grounded but not standing,
+    // that one is pushed back out.
+    int stepUp = instance->isStanding ? MAX_STEP_UP : 0;
+
+    // Every column the leading side crosses, over the full height, so no speed can tunnel
+    int column = SweepWalls(x + side, x + side + xsp, y + top, y, stepUp);
+
+    if (column != SWEEP_NO_HIT)
+    {
+        // A shape rising inside the column the side is already in stops the body where
+        // it is; otherwise it is moved against the column border
+        bool inColumn = (column == TileFloor(x + side)) && (SweepWalls(x + side, x + side, y + top, y, stepUp) == SWEEP_NO_HIT);
+
+        if (inColumn) x = (int)instance->position.x;
+        else if (xsp > 0) x = column * TILE_SIZE - 1 - side;
+        else x = column * TILE_SIZE + TILE_SIZE - side;
+
+        instance->position.x = (float)x;
+        instance->velocity.x = 0.0f;
+        instance->hsp = 0.0f;
+
+        instance->hitOnWall = true;
+    }
+}
+
+void CollisionVerticalBlocks(Entity *instance)
+{
+    float yVel = instance->velocity.y * deltaTimeFrame + instance->vsp;
+    int ysp = (int)ttc_abs(yVel) * ttc_sign(yVel);
+    instance->hitOnCeiling = false;
+    instance->hitOnFloor = false;
+
+    int x = (int)instance->position.x;
+    int y = (int)instance->position.y;
+    int xl = -instance->width / 2;
+    int xr = instance->width / 2 - 1;
+
+    if (ysp < 0)
+    {
+        // Every row the head crosses, over the full width
+        int side = -instance->height + 1;
+        int row = SweepCeilings(y + side, y + side + ysp, x + xl, x + xr);
+
+        if (row != SWEEP_NO_HIT)
+        {
+            instance->position.y = (float)(row * TILE_SIZE + TILE_SIZE - side);
+            instance->velocity.y = 0.0f;
+            instance->vsp = 0.0f;
+            instance->hitOnCeiling = true;
+        }
+        return;
+    }
+
+    int floor = SWEEP_NO_HIT;
+    bool following = false;
+
+    // Walking on slopes: keep the feet on the surface under the column the body moves to,
+    // up or down by at most MAX_STEP_UP pixels. On flat ground, or without moving across,
+    // this is the surface the body stands on, same as the landing test below finds.
+    float xVel = instance->velocity.x * deltaTimeFrame + instance->hsp;
+    int xsp = (int)ttc_abs(xVel) * ttc_sign(xVel);
+
+    if (instance->isGrounded && instance->isStanding && xsp != 0)
+    {
+        int destX = x + xsp;
+        int destY = y + ysp;
+
+        int ground = FindFloor(destX + xl, destX + xr, destY - MAX_STEP_UP + 1, destY + MAX_STEP_UP + 1);
+        following = (ground >= destY - MAX_STEP_UP + 1);
+        if (following && ground != destY + 1) floor = ground;
+    }
+
+    // Otherwise the first floor surface between the feet and where they end up this step
+    if (!following && ysp > 0) floor = FindFloor(x + xl, x + xr, y + 1, y + ysp);
+
+    if (floor != SWEEP_NO_HIT)
+    {
+        instance->position.y = (float)(floor - 1);
+        instance->velocity.y = 0.0f;
+        instance->vsp = 0.0f;
+        instance->hitOnFloor = true;
+    }
+}
+
+// Return sign of the float as int (-1, 0, 1)
+int ttc_sign(float x)
+{
+    if (x < 0.0f) return -1;
+    else if (x < 0.0001f) return 0;
+    else return 1;
+}
+
+// Return absolute value of float
+float ttc_abs(float x)
+{
+    return (x < 0.0f) ? -x : x;
+}
+
+// Clamp value between min and max
+float ttc_clamp(float value, float min, float max)
+{
+    const float res = value < min ? min : value;
+    return res > max ? max : res;
+}
+
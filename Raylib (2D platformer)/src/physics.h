@@ -0,0 +1,319 @@
+// physics.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Vector2 matches raylib's definition. When drawing, include raylib.h before this
+// header (same guard raymath.h uses), so the physics stays usable without a window.
+//----------------------------------------------------------------------------------
+#if !defined(RL_VECTOR2_TYPE)
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+#define RL_VECTOR2_TYPE
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Tile collision types, each one is a row of the TILE_SHAPES height table
+constexpr int EMPTY = -1;
+constexpr int BLOCK = 0;
+constexpr int HALF_BLOCK = 1;        // Lower half solid
+constexpr int SLOPE_RIGHT = 2;       // 45 degrees, floor rises to the right
+constexpr int SLOPE_LEFT = 3;        // 45 degrees, floor rises to the left
+constexpr int SLOPE_RIGHT_LOW = 4;   // 22.5 degrees rising right over two tiles, lower tile
+constexpr int SLOPE_RIGHT_HIGH = 5;
+constexpr int SLOPE_LEFT_HIGH = 6;   // 22.5 degrees rising left over two tiles, higher tile
+constexpr int SLOPE_LEFT_LOW = 7;
+constexpr int ONE_WAY = 8;           // Thin platform, only solid when landed on from above
+constexpr int TILE_TYPE_COUNT = 9;
+
+// Default level size, MapResize sets the size actually in use
+constexpr int TILE_MAP_WIDTH  = 20;
+constexpr int TILE_MAP_HEIGHT = 12;
+
+// Pixels a grounded body walks up (slopes, small steps) instead of being stopped
+constexpr int MAX_STEP_UP = 4;
+
+// Pickups of the default level, COIN_SIZE pixels square
+constexpr int MAX_COINS = 10;
+constexpr float COIN_SIZE = 4.0f;
+
+// Fixed simulation step, physics never sees the render frame time
+constexpr float PHYSICS_DT = 1.0f / 60.0f;
+constexpr int MAX_PHYSICS_STEPS = 8;       // Steps per rendered frame before dropping time
+
+// Tile size constants
+constexpr int TILE_SIZE  = 16;
+constexpr int TILE_ROUND = TILE_SIZE - 1;  // Used in bitwise operation | TILE_SIZE - 1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct Input {
+    float right = 0.0f;
+    float left  = 0.0f;
+    float up    = 0.0f;
+    float down  = 0.0f;
+    bool  jump  = false;
+};
+
+// Collision shape of a tile type: solid pixels counted from the tile bottom for each
+// column. Every mask is flat or monotone across the tile, so the highest point under
+// any run of columns is at one of its two ends.
+struct TileShape {
+    uint8_t height[TILE_SIZE];
+    bool oneWay;
+};
+
+struct Entity {
+    int width = 0;
+    int height = 0;
+
+    Vector2 position{0.0f, 0.0f};
+    float direction = 0.0f;
+    float maxSpd = 0.0f;
+    float acc = 0.0f;
+    float dcc = 0.0f;
+    float gravity = 0.0f;
+    float jumpImpulse = 0.0f;
+    float jumpRelease = 0.0f;
+    Vector2 velocity{0.0f, 0.0f};
+    // Carry stored subpixel values
+    float hsp = 0.0f;
+    float vsp = 0.0f;
+
+    bool isGrounded = false;
+    bool isJumping = false;
+    // Grounded with nothing overlapping the feet, only then slopes and steps are followed
+    bool isStanding = false;
+    // Flags for detecting collision
+    bool hitOnFloor = false;
+    bool hitOnCeiling = false;
+    bool hitOnWall = false;
+
+    Input *control = nullptr;
+};
+
+//------------------------------------------------------------------------------------
+// Shared physics state
+//------------------------------------------------------------------------------------
+extern float deltaTimeFrame;
+
+// Row-major tile types, mapWidth * mapHeight entries
+extern int mapWidth;
+extern int mapHeight;
+extern std::vector<int8_t> tiles;
+
+// Indexed by tile type + 1 so EMPTY has a row of its own
+extern const TileShape TILE_SHAPES[TILE_TYPE_COUNT + 1];
+
+// Top-left corners of the default level's coins
+extern const Vector2 COIN_POSITIONS[MAX_COINS];
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+void MapResize(int width, int height);
+void MapInit(void);
+void PlayerInit(Entity *instance, Input *control);
+
+// Seed for EntityStateHash (FNV-1a offset basis)
+constexpr uint64_t STATE_HASH_SEED = 14695981039346656037ull;
+uint64_t EntityStateHash(const Entity *instance, uint64_t hash);
+
+void EntityMoveUpdate(Entity *instance);
+void GetDirection(Entity *instance);
+void GroundCheck(Entity *instance);
+void MoveCalc(Entity *instance);
+void Jump(Entity *instance);
+void GravityCalc(Entity *instance);
+void CollisionCheck(Entity *instance);
+void CollisionHorizontalBlocks(Entity *instance);
+void CollisionVerticalBlocks(Entity *instance);
+
+// Utility helpers
+int ttc_sign(float x);
+float ttc_abs(float x);
+float ttc_clamp(float value, float min, float max);
+
+//------------------------------------------------------------------------------------
+// Map queries, inline so the per-entity and batched loops avoid a call per sample
+//------------------------------------------------------------------------------------
+inline int MapGetTileWorld(int x, int y)
+{
+    // Unsigned compare also rejects negative coordinates
+    if ((unsigned)x >= (unsigned)(mapWidth * TILE_SIZE)) return EMPTY;
+    if ((unsigned)y >= (unsigned)(mapHeight * TILE_SIZE)) return EMPTY;
+
+    return tiles[x / TILE_SIZE + (y / TILE_SIZE) * mapWidth];
+}
+
+// Tile index of a world pixel, rounding down for negative pixels too
+inline int TileFloor(int v)
+{
+    return (v & ~TILE_ROUND) / TILE_SIZE;
+}
+
+inline const TileShape &GetTileShape(int tile)
+{
+    return TILE_SHAPES[tile + 1];
+}
+
+//------------------------------------------------------------------------------------
+// Swept collision, one axis at a time (1D DDA over the tile lines the leading edge
+// enters). Each returns the first tile line that stops the body, or SWEEP_NO_HIT.
+//------------------------------------------------------------------------------------
+constexpr int SWEEP_NO_HIT = -0x7fffffff;
+
+// Leading edge moves from 'from' to 'to' pixels, the body covers rows [top, bottom].
+// A tile stops it when the face being entered (first column moving right, last moving
+// left) overlaps the body; while the edge stays inside one tile column its destination
+// column counts, since shapes can rise inside a tile. Faces in the feet row whose top
+// is less than stepUp pixels above the feet are walked onto instead, the vertical pass
+// then lifts the body.
+inline int SweepWalls(int from, int to, int top, int bottom, int stepUp)
+{
+    int step = (to > from) ? 1 : -1;
+    int start = TileFloor(from);
+    int end = TileFloor(to);
+
+    int face = (step > 0) ? 0 : TILE_ROUND;
+    if (start == end) face = to & TILE_ROUND;
+    else start += step;
+
+    const int feetRow = TileFloor(bottom);
+
+    // Rows outside the map are never solid, so clip the span once
+    int lo = TileFloor(top);
+    int hi = feetRow;
+    if (lo < 0) lo = 0;
+    if (hi > mapHeight - 1) hi = mapHeight - 1;
+    if (lo > hi) return SWEEP_NO_HIT;
+
+    for (int t = start; ; t += step)
+    {
+        if ((unsigned)t < (unsigned)mapWidth)
+        {
+            const int8_t *tile = &tiles[t + lo * mapWidth];
+            for (int r = lo; r <= hi; r++, tile += mapWidth)
+            {
+                if (*tile == EMPTY) continue;
+
+                const TileShape &shape = GetTileShape(*tile);
+                int faceHeight = shape.oneWay ? 0 : shape.height[face];
+                int faceTop = r * TILE_SIZE + TILE_SIZE - faceHeight;
+                int reach = (r == feetRow) ? stepUp : 0;
+
+                if (faceHeight > 0 && bottom >= faceTop + reach) return t;
+            }
+        }
+        if (t == end) break;
+    }
+
+    return SWEEP_NO_HIT;
+}
+
+// Head moves up from 'from' to 'to' pixels over columns [spanMin, spanMax]. Every
+// shape is solid along its bottom edge, so any row entered with a tile but EMPTY or
+// ONE_WAY stops it; inside one row only a head ending in the solid part is stopped.
+inline int SweepCeilings(int from, int to, int spanMin, int spanMax)
+{
+    const int first = TileFloor(spanMin);
+    const int last = TileFloor(spanMax);
+    int start = TileFloor(from);
+    int end = TileFloor(to);
+
+    int lo = first < 0 ? 0 : first;
+    int hi = last > mapWidth - 1 ? mapWidth - 1 : last;
+    if (lo > hi) return SWEEP_NO_HIT;
+
+    if (start == end)
+    {
+        if ((unsigned)end >= (unsigned)mapHeight) return SWEEP_NO_HIT;
+
+        const int8_t *tile = &tiles[end * mapWidth + lo];
+        for (int c = lo; c <= hi; c++, tile++)
+        {
+            const TileShape &shape = GetTileShape(*tile);
+            int a = (c == first) ? (spanMin & TILE_ROUND) : 0;
+            int b = (c == last) ? (spanMax & TILE_ROUND) : TILE_ROUND;
+            int h = shape.height[a] > shape.height[b] ? shape.height[a] : shape.height[b];
+
+            if (!shape.oneWay && h > 0 && to >= end * TILE_SIZE + TILE_SIZE - h) return end;
+        }
+        return SWEEP_NO_HIT;
+    }
+
+    for (int t = start - 1; ; t--)
+    {
+        if ((unsigned)t < (unsigned)mapHeight)
+        {
+            const int8_t *tile = &tiles[t * mapWidth + lo];
+            for (int c = lo; c <= hi; c++, tile++)
+            {
+                if (*tile > EMPTY && *tile != ONE_WAY) return t;
+            }
+        }
+        if (t == end) break;
+    }
+
+    return SWEEP_NO_HIT;
+}
+
+// Top pixel of the first floor surface at or above toY under columns [spanMin,
+// spanMax], scanning the rows from fromY down, or SWEEP_NO_HIT. Heights come from the
+// shape table, two lookups per tile. Solid tiles in those rows count even when their
+// surface is above fromY (the body is pushed out on top); one-way tiles only count
+// when their surface is at or below fromY, i.e. the body came from above.
+inline int FindFloor(int spanMin, int spanMax, int fromY, int toY)
+{
+    const int first = TileFloor(spanMin);
+    const int last = TileFloor(spanMax);
+
+    int lo = first < 0 ? 0 : first;
+    int hi = last > mapWidth - 1 ? mapWidth - 1 : last;
+    int rowFirst = TileFloor(fromY);
+    int rowLast = TileFloor(toY);
+    if (rowFirst < 0) rowFirst = 0;
+    if (rowLast > mapHeight - 1) rowLast = mapHeight - 1;
+    if (lo > hi) return SWEEP_NO_HIT;
+
+    for (int r = rowFirst; r <= rowLast; r++)
+    {
+        const int rowTop = r * TILE_SIZE;
+        int best = toY + 1;
+        const int8_t *tile = &tiles[r * mapWidth + lo];
+        for (int c = lo; c <= hi; c++, tile++)
+        {
+            if (*tile == EMPTY) continue;
+            // Nothing in a row is higher than a block, and the row is above toY
+            if (*tile == BLOCK) return rowTop;
+
+            const TileShape &shape = GetTileShape(*tile);
+            int a = (c == first) ? (spanMin & TILE_ROUND) : 0;
+            int b = (c == last) ? (spanMax & TILE_ROUND) : TILE_ROUND;
+            int h = shape.height[a] > shape.height[b] ? shape.height[a] : shape.height[b];
+
+            int surface = rowTop + TILE_SIZE - h;
+            if (shape.oneWay && surface < fromY) continue;
+            if (surface < best) best = surface;
+        }
+        if (best <= toY) return best;
+    }
+
+    return SWEEP_NO_HIT;
+}
+
+// Ground test for feet at row y. Grounded: a solid pixel right below the feet.
+// Standing: grounded with the feet row free; a body clipped into a corner is grounded
+// but not standing.
+inline bool GroundProbe(int spanMin, int spanMax, int y, bool *standing)
+{
+    bool grounded = (FindFloor(spanMin, spanMax, y + 1, y + 1) != SWEEP_NO_HIT);
+    *standing = grounded && (FindFloor(spanMin, spanMax, y, y) == SWEEP_NO_HIT);
+    return grounded;
+}
@@ -0,0 +1,91 @@
+// replay.cpp
+#include "replay.h"
+#include <cstdio>
+#include <cstring>
+
+static const char *REPLAY_HEADER = "PLATFORMER_REPLAY 1";
+
+uint8_t InputPack(const Input &input)
+{
+    uint8_t bits = 0;
+    if (input.right > 0.0f) bits |= 1;
+    if (input.left > 0.0f)  bits |= 2;
+    if (input.up > 0.0f)    bits |= 4;
+    if (input.down > 0.0f)  bits |= 8;
+    if (input.jump)         bits |= 16;
+    return bits;
+}
+
+Input InputUnpack(uint8_t bits)
+{
+    Input input;
+    input.right = (bits & 1) ? 1.0f : 0.0f;
+    input.left  = (bits & 2) ? 1.0f : 0.0f;
+    input.up    = (bits & 4) ? 1.0f : 0.0f;
+    input.down  = (bits & 8) ? 1.0f : 0.0f;
+    input.jump  = (bits & 16) != 0;
+    return input;
+}
+
+bool ReplayLoad(const char *fileName, Replay *replay)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == nullptr) return false;
+
+    char line[64];
+    if (fgets(line, sizeof(line), file) == nullptr || strncmp(line, REPLAY_HEADER, strlen(REPLAY_HEADER)) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    replay->frames.clear();
+    unsigned int bits;
+    while (fscanf(file, "%u", &bits) == 1)
+    {
+        replay->frames.push_back(InputUnpack((uint8_t)bits));
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool ReplaySave(const char *fileName, const Replay *replay)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == nullptr) return false;
+
+    fprintf(file, "%s\n", REPLAY_HEADER);
+    for (const Input &input : replay->frames)
+    {
+        fprintf(file, "%u\n", (unsigned int)InputPack(input));
+    }
+
+    return fclose(file) == 0;
+}
+
+ReplayResult ReplayRun(const Replay *replay, std::vector<uint64_t> *stepHashes)
+{
+    Entity player{};
+    Input control{};
+
+    deltaTimeFrame = PHYSICS_DT;
+    MapInit();
+    PlayerInit(&player, &control);
+
+    ReplayResult result;
+    for (const Input &input : replay->frames)
+    {
+        // Recorded frames hold the input as it was right before the step
+        control = input;
+        EntityMoveUpdate(&player);
+
+        if (stepHashes != nullptr) stepHashes->push_back(EntityStateHash(&player, STATE_HASH_SEED));
+        result.steps++;
+    }
+
+    result.finalHash = EntityStateHash(&player, STATE_HASH_SEED);
+    result.finalState = player;
+    result.finalState.control = nullptr;
+    return result;
+}
@@ -0,0 +1,33 @@
+// replay.h
+#pragma once
+#include "physics.h"
+#include <vector>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Recorded input, one Input per fixed physics step. Files are plain text: a header
+// line, then one bitmask per step (1 right, 2 left, 4 up, 8 down, 16 jump).
+//----------------------------------------------------------------------------------
+struct Replay {
+    std::vector<Input> frames;
+};
+
+// Outcome of running a replay through the headless physics
+struct ReplayResult {
+    int steps = 0;
+    uint64_t finalHash = 0;
+    Entity finalState{};
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+uint8_t InputPack(const Input &input);
+Input InputUnpack(uint8_t bits);
+
+bool ReplayLoad(const char *fileName, Replay *replay);
+bool ReplaySave(const char *fileName, const Replay *replay);
+
+// Resets the level and player, then steps once per recorded frame at PHYSICS_DT.
+// stepHashes (optional) receives the state hash after every step.
+ReplayResult ReplayRun(const Replay *replay, std::vector<uint64_t> *stepHashes);
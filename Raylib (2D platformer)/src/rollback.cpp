@@ -0,0 +1,223 @@
+// rollback.cpp
+#include "rollback.h"
+#include "replay.h"
+#include <algorithm>
+
+static_assert(MAX_COINS <= 32, "coinsVisible holds one bit per coin");
+static_assert((ROLLBACK_RING & (ROLLBACK_RING - 1)) == 0 && ROLLBACK_RING > ROLLBACK_MAX_FRAMES, "snapshot ring size");
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Same FNV-1a step as EntityStateHash, for the fields outside the players
+static uint64_t HashWord(uint64_t hash, uint32_t word)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= (word >> (i * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint8_t PredictRemote(const RollbackSession *session)
+{
+    // Players hold buttons for many frames, the last known input is the best guess
+    if (session->remoteFrame < 0) return 0;
+    return session->inputs[session->remoteFrame % ROLLBACK_INPUT_RING][1 - session->localPlayer];
+}
+
+// Snapshot, then step. Frames past remoteFrame get a fresh prediction every time they
+// run, so after a rollback they use the newest remote input.
+static void SimulateFrame(RollbackSession *session)
+{
+    int frame = session->state.frame;
+    uint8_t *buttons = session->inputs[frame % ROLLBACK_INPUT_RING];
+    if (frame > session->remoteFrame) buttons[1 - session->localPlayer] = PredictRemote(session);
+
+    session->snapshots[frame % ROLLBACK_RING] = session->state;
+    NetGameStateStep(&session->state, buttons, &session->coinHash, &session->coinCandidates);
+}
+
+//------------------------------------------------------------------------------------
+// Game state
+//------------------------------------------------------------------------------------
+void NetGameStateInit(NetGameState *state)
+{
+    state->frame = 0;
+    for (int i = 0; i < NET_PLAYERS; i++)
+    {
+        state->controls[i] = Input{};
+        PlayerInit(&state->players[i], &state->controls[i]);
+        state->heldButtons[i] = 0;
+        state->score[i] = 0;
+    }
+
+    // Second player starts two tiles to the right
+    state->players[1].position.x += 2 * TILE_SIZE;
+    state->coinsVisible = (MAX_COINS == 32) ? 0xffffffffu : (1u << MAX_COINS) - 1;
+}
+
+void NetGameStateStep(NetGameState *state, const uint8_t buttons[NET_PLAYERS], SpatialHash *coinHash,
+                      std::vector<int> *coinCandidates)
+{
+    for (int i = 0; i < NET_PLAYERS; i++)
+    {
+        // Directions follow the buttons, jump latches like InputUpdate: set on the press,
+        // cleared on the release or by the physics on landing
+        Input pressed = InputUnpack(buttons[i]);
+        Input &control = state->controls[i];
+        control.right = pressed.right;
+        control.left = pressed.left;
+        control.up = pressed.up;
+        control.down = pressed.down;
+
+        bool wasHeld = (state->heldButtons[i] & 16) != 0;
+        if (pressed.jump && !wasHeld) control.jump = true;
+        else if (!pressed.jump && wasHeld) control.jump = false;
+        state->heldButtons[i] = buttons[i];
+
+        // Snapshots are copies, point the entity at this state's control
+        Entity &player = state->players[i];
+        player.control = &control;
+        EntityMoveUpdate(&player);
+
+        // Pickups, same overlap test as CoinUpdate
+        float x = player.position.x - player.width * 0.5f;
+        float y = player.position.y - player.height + 1;
+
+        coinCandidates->clear();
+        SpatialHashQuery(coinHash, x, y, (float)player.width, (float)player.height, coinCandidates);
+        for (int id : *coinCandidates)
+        {
+            uint32_t bit = 1u << id;
+            const Vector2 &coin = COIN_POSITIONS[id];
+            if ((state->coinsVisible & bit) && coin.x < x + player.width && coin.x + COIN_SIZE > x &&
+                coin.y < y + player.height && coin.y + COIN_SIZE > y)
+            {
+                state->coinsVisible &= ~bit;
+                state->score[i]++;
+            }
+        }
+    }
+
+    state->frame++;
+}
+
+uint64_t NetGameStateHash(const NetGameState *state)
+{
+    uint64_t hash = HashWord(STATE_HASH_SEED, (uint32_t)state->frame);
+    for (int i = 0; i < NET_PLAYERS; i++)
+    {
+        hash = EntityStateHash(&state->players[i], hash);
+        hash = HashWord(hash, (uint32_t)state->controls[i].jump | (uint32_t)state->heldButtons[i] << 8);
+        hash = HashWord(hash, (uint32_t)state->score[i]);
+    }
+    return HashWord(hash, state->coinsVisible);
+}
+
+//------------------------------------------------------------------------------------
+// Session
+//------------------------------------------------------------------------------------
+void RollbackInit(RollbackSession *session, int localPlayer)
+{
+    session->localPlayer = localPlayer;
+    NetGameStateInit(&session->state);
+
+    std::fill(&session->inputs[0][0], &session->inputs[0][0] + ROLLBACK_INPUT_RING * NET_PLAYERS, 0);
+    session->remoteFrame = -1;
+    session->remoteAck = -1;
+    session->rollbackFrame = -1;
+
+    // A fresh hash hands out ids in insertion order, so id == coin index
+    SpatialHashInit(&session->coinHash, 64);
+    for (int i = 0; i < MAX_COINS; i++)
+    {
+        SpatialHashInsert(&session->coinHash, COIN_POSITIONS[i].x, COIN_POSITIONS[i].y, COIN_SIZE, COIN_SIZE);
+    }
+
+    session->rollbacks = 0;
+    session->resimulatedFrames = 0;
+    session->stalls = 0;
+    session->deepestRollback = 0;
+}
+
+void RollbackReceive(RollbackSession *session, const NetPacket &packet)
+{
+    const int remote = 1 - session->localPlayer;
+    session->remoteAck = std::max(session->remoteAck, packet.ackFrame);
+
+    for (int k = 0; k < packet.count; k++)
+    {
+        int frame = packet.firstFrame + k;
+        if (frame <= session->remoteFrame) continue;
+        // Gap from a lost or late packet: a later packet resends from our ack
+        if (frame != session->remoteFrame + 1) break;
+
+        uint8_t &used = session->inputs[frame % ROLLBACK_INPUT_RING][remote];
+        if (frame < session->state.frame && used != packet.buttons[k])
+        {
+            if (session->rollbackFrame < 0 || frame < session->rollbackFrame) session->rollbackFrame = frame;
+        }
+
+        used = packet.buttons[k];
+        session->remoteFrame = frame;
+    }
+}
+
+bool RollbackAdvance(RollbackSession *session, uint8_t localButtons)
+{
+    // Re-simulate from the first mispredicted frame up to the present
+    if (session->rollbackFrame >= 0)
+    {
+        int from = session->rollbackFrame;
+        int to = session->state.frame;
+        session->rollbackFrame = -1;
+
+        session->state = session->snapshots[from % ROLLBACK_RING];
+        while (session->state.frame < to) SimulateFrame(session);
+
+        session->rollbacks++;
+        session->resimulatedFrames += to - from;
+        session->deepestRollback = std::max(session->deepestRollback, to - from);
+    }
+
+    // Never predict further than a rollback can repair, nor outrun the input ring
+    // with input the remote has not acknowledged
+    int frame = session->state.frame;
+    if (frame - session->remoteFrame > ROLLBACK_MAX_FRAMES || frame - session->remoteAck >= ROLLBACK_INPUT_RING)
+    {
+        session->stalls++;
+        return false;
+    }
+
+    session->inputs[frame % ROLLBACK_INPUT_RING][session->localPlayer] = localButtons;
+    SimulateFrame(session);
+    return true;
+}
+
+void RollbackMakePacket(const RollbackSession *session, NetPacket *packet)
+{
+    packet->firstFrame = session->remoteAck + 1;
+    packet->count = std::min(session->state.frame - packet->firstFrame, NET_PACKET_INPUTS);
+    for (int k = 0; k < packet->count; k++)
+    {
+        packet->buttons[k] = session->inputs[(packet->firstFrame + k) % ROLLBACK_INPUT_RING][session->localPlayer];
+    }
+    packet->ackFrame = session->remoteFrame;
+}
+
+int RollbackConfirmedFrame(const RollbackSession *session)
+{
+    int confirmed = std::min(session->remoteFrame, session->state.frame - 1);
+
+    // States after a pending misprediction are still wrong
+    if (session->rollbackFrame >= 0) confirmed = std::min(confirmed, session->rollbackFrame - 1);
+    return confirmed;
+}
+
+const NetGameState *RollbackStateAt(const RollbackSession *session, int frame)
+{
+    if (frame == session->state.frame) return &session->state;
+    return &session->snapshots[frame % ROLLBACK_RING];
+}
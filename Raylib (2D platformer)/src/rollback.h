@@ -0,0 +1,86 @@
+// rollback.h
+#pragma once
+#include "physics.h"
+#include "spatial_hash.h"
+#include "loopback.h"
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int NET_PLAYERS = 2;
+
+// Frames the simulation may run ahead of the remote input it has, which is also the
+// deepest rollback. A peer further ahead stalls until input arrives.
+constexpr int ROLLBACK_MAX_FRAMES = 8;
+
+// Snapshot and input rings, frame f lives at f % size (powers of two, larger than
+// ROLLBACK_MAX_FRAMES plus the inputs a peer can receive ahead of its own frame)
+constexpr int ROLLBACK_RING = 16;
+constexpr int ROLLBACK_INPUT_RING = 64;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Everything one simulated frame changes. Plain data, so a snapshot is one copy.
+struct NetGameState {
+    int frame = 0;
+    Entity players[NET_PLAYERS];
+    // Same role as the game's inputInstance: physics clears jump on landing
+    Input controls[NET_PLAYERS];
+    // Buttons of the previous frame, jump presses latch on the press only
+    uint8_t heldButtons[NET_PLAYERS] = {};
+    uint32_t coinsVisible = 0;         // Bit i for COIN_POSITIONS[i]
+    int score[NET_PLAYERS] = {};
+};
+
+// One peer of a two-player session. Buttons use the replay bit layout (InputPack).
+struct RollbackSession {
+    int localPlayer = 0;
+    NetGameState state;
+
+    // State at the start of each recent frame
+    NetGameState snapshots[ROLLBACK_RING];
+    // Buttons each frame was (or will be) simulated with, predicted for the remote
+    // player past remoteFrame
+    uint8_t inputs[ROLLBACK_INPUT_RING][NET_PLAYERS] = {};
+
+    int remoteFrame = -1;              // Remote input known up to this frame
+    int remoteAck = -1;                // Local input the remote has up to this frame
+    int rollbackFrame = -1;            // Earliest mispredicted frame, -1 when none
+
+    // Coins never move, the hash is built once and only queried
+    SpatialHash coinHash;
+    std::vector<int> coinCandidates;
+
+    // Stats
+    long rollbacks = 0;
+    long resimulatedFrames = 0;
+    long stalls = 0;
+    int deepestRollback = 0;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Both players and all coins of the default level (MapInit must have run)
+void NetGameStateInit(NetGameState *state);
+// One fixed step with the given buttons for every player
+void NetGameStateStep(NetGameState *state, const uint8_t buttons[NET_PLAYERS], SpatialHash *coinHash,
+                      std::vector<int> *coinCandidates);
+uint64_t NetGameStateHash(const NetGameState *state);
+
+void RollbackInit(RollbackSession *session, int localPlayer);
+
+// Takes in remote input and acknowledgements, marks a rollback on misprediction
+void RollbackReceive(RollbackSession *session, const NetPacket &packet);
+// Rolls back if needed, then simulates the next frame with the local buttons.
+// Returns false (nothing simulated) when too far ahead of the remote input.
+bool RollbackAdvance(RollbackSession *session, uint8_t localButtons);
+// Local input the remote has not acknowledged yet
+void RollbackMakePacket(const RollbackSession *session, NetPacket *packet);
+
+// Last frame both players' inputs are known for; its result never changes again
+int RollbackConfirmedFrame(const RollbackSession *session);
+// State at the start of 'frame', for the last ROLLBACK_RING frames and the current one
+const NetGameState *RollbackStateAt(const RollbackSession *session, int frame);
@@ -0,0 +1,184 @@
+// spatial_hash.cpp
+#include "spatial_hash.h"
+#include "physics.h"
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static int CellCoord(float v)
+{
+    return (int)std::floor(v / TILE_SIZE);
+}
+
+static int BucketIndex(const SpatialHash *hash, int cx, int cy)
+{
+    uint32_t h = (uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u;
+    return (int)(h & (uint32_t)hash->bucketMask);
+}
+
+static void BucketsAdd(SpatialHash *hash, int id)
+{
+    const SpatialItem &item = hash->items[id];
+    for (int cy = item.cellMinY; cy <= item.cellMaxY; cy++)
+    {
+        for (int cx = item.cellMinX; cx <= item.cellMaxX; cx++)
+        {
+            hash->buckets[BucketIndex(hash, cx, cy)].push_back(id);
+        }
+    }
+}
+
+static void BucketsRemove(SpatialHash *hash, int id)
+{
+    const SpatialItem &item = hash->items[id];
+    for (int cy = item.cellMinY; cy <= item.cellMaxY; cy++)
+    {
+        for (int cx = item.cellMinX; cx <= item.cellMaxX; cx++)
+        {
+            // Swap-remove one entry; order inside a bucket does not matter
+            std::vector<int> &bucket = hash->buckets[BucketIndex(hash, cx, cy)];
+            for (size_t i = 0; i < bucket.size(); i++)
+            {
+                if (bucket[i] == id)
+                {
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void SetBounds(SpatialItem *item, float x, float y, float width, float height)
+{
+    item->x = x;
+    item->y = y;
+    item->width = width;
+    item->height = height;
+    item->cellMinX = CellCoord(x);
+    item->cellMinY = CellCoord(y);
+    item->cellMaxX = CellCoord(x + width);
+    item->cellMaxY = CellCoord(y + height);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void SpatialHashInit(SpatialHash *hash, int bucketCount)
+{
+    int size = 1;
+    while (size < bucketCount) size <<= 1;
+
+    hash->bucketMask = size - 1;
+    hash->buckets.assign(size, std::vector<int>());
+    hash->items.clear();
+    hash->freeItems.clear();
+    hash->itemStamp.clear();
+    hash->queryStamp = 0;
+}
+
+void SpatialHashClear(SpatialHash *hash)
+{
+    // Keep bucket capacity so refilling a level does not allocate again
+    for (std::vector<int> &bucket : hash->buckets) bucket.clear();
+    hash->items.clear();
+    hash->freeItems.clear();
+    hash->itemStamp.clear();
+    hash->queryStamp = 0;
+}
+
+int SpatialHashInsert(SpatialHash *hash, float x, float y, float width, float height)
+{
+    int id;
+    if (!hash->freeItems.empty())
+    {
+        id = hash->freeItems.back();
+        hash->freeItems.pop_back();
+    }
+    else
+    {
+        id = (int)hash->items.size();
+        hash->items.emplace_back();
+        hash->itemStamp.push_back(0);
+    }
+
+    SpatialItem &item = hash->items[id];
+    SetBounds(&item, x, y, width, height);
+    item.active = true;
+    BucketsAdd(hash, id);
+
+    return id;
+}
+
+void SpatialHashRemove(SpatialHash *hash, int id)
+{
+    SpatialItem &item = hash->items[id];
+    if (!item.active) return;
+
+    BucketsRemove(hash, id);
+    item.active = false;
+    hash->freeItems.push_back(id);
+}
+
+void SpatialHashMove(SpatialHash *hash, int id, float x, float y)
+{
+    SpatialItem &item = hash->items[id];
+    if (!item.active) return;
+
+    int minX = CellCoord(x);
+    int minY = CellCoord(y);
+    int maxX = CellCoord(x + item.width);
+    int maxY = CellCoord(y + item.height);
+
+    if (minX == item.cellMinX && minY == item.cellMinY && maxX == item.cellMaxX && maxY == item.cellMaxY)
+    {
+        // Still in the same cells, nothing to rebucket
+        item.x = x;
+        item.y = y;
+        return;
+    }
+
+    BucketsRemove(hash, id);
+    SetBounds(&item, x, y, item.width, item.height);
+    BucketsAdd(hash, id);
+}
+
+int SpatialHashQuery(SpatialHash *hash, float x, float y, float width, float height, std::vector<int> *results)
+{
+    int minX = CellCoord(x);
+    int minY = CellCoord(y);
+    int maxX = CellCoord(x + width);
+    int maxY = CellCoord(y + height);
+
+    // Stamp wrap-around: reset so stale stamps cannot match
+    if (++hash->queryStamp == 0)
+    {
+        std::fill(hash->itemStamp.begin(), hash->itemStamp.end(), 0);
+        hash->queryStamp = 1;
+    }
+
+    int added = 0;
+    for (int cy = minY; cy <= maxY; cy++)
+    {
+        for (int cx = minX; cx <= maxX; cx++)
+        {
+            for (int id : hash->buckets[BucketIndex(hash, cx, cy)])
+            {
+                if (hash->itemStamp[id] == hash->queryStamp) continue;
+
+                // Skip objects that only share the bucket through a hash collision
+                const SpatialItem &item = hash->items[id];
+                if (item.cellMaxX < minX || item.cellMinX > maxX || item.cellMaxY < minY || item.cellMinY > maxY) continue;
+
+                hash->itemStamp[id] = hash->queryStamp;
+                results->push_back(id);
+                added++;
+            }
+        }
+    }
+
+    return added;
+}
@@ -0,0 +1,53 @@
+// spatial_hash.h
+#pragma once
+#include <vector>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Uniform grid broadphase with TILE_SIZE cells, hashed into a fixed bucket table so
+// the level size does not matter. Used for pickups, triggers and entity overlaps:
+// queries return only the objects registered in the cells around the query box,
+// the caller still runs the exact test (CheckCollisionRecs) on those candidates.
+//----------------------------------------------------------------------------------
+struct SpatialItem {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+
+    // Covered cell range, inclusive
+    int cellMinX = 0;
+    int cellMinY = 0;
+    int cellMaxX = -1;
+    int cellMaxY = -1;
+
+    bool active = false;
+};
+
+struct SpatialHash {
+    int bucketMask = 0;
+    std::vector<std::vector<int>> buckets;
+    std::vector<SpatialItem> items;
+    std::vector<int> freeItems;
+
+    // Query stamps so an object spanning several cells is returned once
+    std::vector<uint32_t> itemStamp;
+    uint32_t queryStamp = 0;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// bucketCount is rounded up to a power of two
+void SpatialHashInit(SpatialHash *hash, int bucketCount);
+void SpatialHashClear(SpatialHash *hash);
+
+// Returns the id used by the other calls. After Init or Clear ids are handed out in
+// insertion order as long as nothing was removed; removed ids are reused, the last first.
+int SpatialHashInsert(SpatialHash *hash, float x, float y, float width, float height);
+void SpatialHashRemove(SpatialHash *hash, int id);
+// Incremental: buckets are only touched when the object crosses a cell boundary
+void SpatialHashMove(SpatialHash *hash, int id, float x, float y);
+
+// Appends candidate ids near the box to results and returns how many were added
+int SpatialHashQuery(SpatialHash *hash, float x, float y, float width, float height, std::vector<int> *results);
@@ -0,0 +1,157 @@
+// replay_cli.cpp
+// Replays recorded platformer input through the headless fixed-step physics.
+// Build from the project folder:
+//   g++ -O2 -std=c++14 -Isrc tools/replay_cli.cpp src/physics.cpp src/replay.cpp -o platformer_replay
+//
+// Usage:
+//   platformer_replay <file.replay> [--repeat N] [--hashes out.txt] [--expect hashes.txt]
+//   platformer_replay --generate <out.replay> <steps> <seed>
+#include "physics.h"
+#include "replay.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static int Usage(void)
+{
+    fprintf(stderr, "usage: platformer_replay <file.replay> [--repeat N] [--hashes out.txt] [--expect hashes.txt]\n");
+    fprintf(stderr, "       platformer_replay --generate <out.replay> <steps> <seed>\n");
+    return EXIT_FAILURE;
+}
+
+// Random but human-like input: hold each combination for a while
+static int Generate(const char *fileName, int steps, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> hold(5, 40);
+    std::uniform_int_distribution<int> bits(0, 31);
+
+    Replay replay;
+    while ((int)replay.frames.size() < steps)
+    {
+        Input input = InputUnpack((uint8_t)bits(rng));
+        for (int i = hold(rng); i > 0 && (int)replay.frames.size() < steps; i--) replay.frames.push_back(input);
+    }
+
+    if (!ReplaySave(fileName, &replay))
+    {
+        fprintf(stderr, "cannot write %s\n", fileName);
+        return EXIT_FAILURE;
+    }
+    printf("wrote %d steps to %s\n", steps, fileName);
+    return EXIT_SUCCESS;
+}
+
+static bool LoadHashes(const char *fileName, std::vector<uint64_t> *hashes)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == nullptr) return false;
+
+    uint64_t hash;
+    while (fscanf(file, "%" SCNx64, &hash) == 1) hashes->push_back(hash);
+
+    fclose(file);
+    return true;
+}
+
+static bool SaveHashes(const char *fileName, const std::vector<uint64_t> &hashes)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == nullptr) return false;
+
+    for (uint64_t hash : hashes) fprintf(file, "%016" PRIx64 "\n", hash);
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) return Usage();
+
+    if (strcmp(argv[1], "--generate") == 0)
+    {
+        if (argc != 5) return Usage();
+        return Generate(argv[2], atoi(argv[3]), (unsigned int)strtoul(argv[4], nullptr, 10));
+    }
+
+    const char *replayFile = argv[1];
+    const char *hashesOut = nullptr;
+    const char *hashesExpected = nullptr;
+    int repeat = 1;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hashes") == 0 && i + 1 < argc) hashesOut = argv[++i];
+        else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) hashesExpected = argv[++i];
+        else return Usage();
+    }
+    if (repeat < 1) repeat = 1;
+
+    Replay replay;
+    if (!ReplayLoad(replayFile, &replay))
+    {
+        fprintf(stderr, "cannot read %s\n", replayFile);
+        return EXIT_FAILURE;
+    }
+
+    // Hashes come from the first run, extra runs are only for timing
+    std::vector<uint64_t> hashes;
+    hashes.reserve(replay.frames.size());
+
+    auto start = std::chrono::steady_clock::now();
+    ReplayResult result = ReplayRun(&replay, &hashes);
+    for (int i = 1; i < repeat; i++)
+    {
+        ReplayResult again = ReplayRun(&replay, nullptr);
+        if (again.finalHash != result.finalHash)
+        {
+            fprintf(stderr, "non-deterministic: run %d ended with %016" PRIx64 "\n", i, again.finalHash);
+            return EXIT_FAILURE;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double totalSteps = (double)result.steps * repeat;
+    double simulated = totalSteps * PHYSICS_DT;
+    printf("steps: %d x %d\n", result.steps, repeat);
+    printf("final hash: %016" PRIx64 "\n", result.finalHash);
+    printf("final position: %.1f %.1f\n", result.finalState.position.x, result.finalState.position.y);
+    printf("%.1f ns/step, %.0fx real time\n", seconds * 1e9 / totalSteps, (seconds > 0.0) ? simulated / seconds : 0.0);
+
+    if (hashesOut != nullptr && !SaveHashes(hashesOut, hashes))
+    {
+        fprintf(stderr, "cannot write %s\n", hashesOut);
+        return EXIT_FAILURE;
+    }
+
+    if (hashesExpected != nullptr)
+    {
+        std::vector<uint64_t> expected;
+        if (!LoadHashes(hashesExpected, &expected))
+        {
+            fprintf(stderr, "cannot read %s\n", hashesExpected);
+            return EXIT_FAILURE;
+        }
+        if (expected.size() != hashes.size())
+        {
+            printf("FAIL: %zu expected steps, replay has %zu\n", expected.size(), hashes.size());
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            if (hashes[i] != expected[i])
+            {
+                printf("FAIL: diverged at step %zu (%016" PRIx64 " != %016" PRIx64 ")\n", i, hashes[i], expected[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        printf("OK: all %zu step hashes match\n", hashes.size());
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,339 @@
+// board_evaluator_bench.cpp
+// BoardEvaluator against a cell by cell reference over Grid, on random boards with
+// holes, overhangs, full rows and empty columns, in batches that do not fill the last
+// block: every kernel must give the reference's features exactly, and the scalar
+// kernel's weighted scores to the bit. PlacementFinder::PlacedRows must leave the
+// boards Place leaves. Then boards per second with each kernel and the reference, and
+// one search step (every placement of a piece, scored) both ways.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -ffp-contract=off -Isrc -I../common -I../bench bench/board_evaluator_bench.cpp ../bench/bench_suite.cpp src/board_evaluator.cpp src/placement_finder.cpp src/game.cpp src/grid.cpp src/block.cpp src/colors.cpp src/postion.cpp ../common/sprite_batch.cpp ../common/profiler.cpp ../common/audio_mixer.cpp -pthread -o board_evaluator_bench
+#include "board_evaluator.h"
+#include "placement_finder.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240617;
+constexpr int CHECK_BOARDS = 1000 + 7;          // Not a multiple of the block
+constexpr int TIMING_BOARDS = 4096;
+constexpr int TIMING_PASSES = 200;
+constexpr int SEARCH_BOARDS = 64;
+const char *KERNEL_NAMES[] = { "scalar", "SSE", "AVX2" };
+const char *FEATURE_NAMES[] = { "aggregate height", "max height", "holes", "bumpiness", "row transitions", "column transitions", "complete lines" };
+
+// Dellacherie and El-Tetris style: penalize height, holes and ragged surfaces
+const float WEIGHTS[NUM_BOARD_FEATURES] = { -0.510066f, -0.1f, -0.35663f, -0.184483f, -0.32f, -0.93f, 0.760666f };
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static Block MakeBlock(int id)
+{
+    switch (id)
+    {
+        case 1: return LBlock();
+        case 2: return JBlock();
+        case 3: return IBlock();
+        case 4: return OBlock();
+        case 5: return SBlock();
+        case 6: return TBlock();
+        default: return ZBlock();
+    }
+}
+
+// Columns of random height with holes, floating cells, and now and then a full row
+// or an empty column
+static void RandomBoard(Grid *grid, std::mt19937 *rng)
+{
+    grid->Initialize();
+    int emptyCol = ((*rng)() % 3 == 0) ? (int)((*rng)() % 10) : -1;
+    for (int col = 0; col < 10; col++)
+    {
+        if (col == emptyCol) continue;
+        int height = (int)((*rng)() % 21);
+        for (int row = 19; row > 19 - height; row--)
+        {
+            if ((*rng)() % 5 != 0) grid->grid[row][col] = 1 + (int)((*rng)() % 7);
+        }
+    }
+    for (int i = 0; i < 3; i++) grid->grid[(*rng)() % 20][(*rng)() % 10] = 1;
+    if ((*rng)() % 4 == 0)
+    {
+        int row = 10 + (int)((*rng)() % 10);
+        for (int col = 0; col < 10; col++) grid->grid[row][col] = 2;
+    }
+}
+
+// The features the slow way: read off the cells, one column and one row at a time
+static void ReferenceFeatures(const Grid &grid, int feature[NUM_BOARD_FEATURES])
+{
+    for (int f = 0; f < NUM_BOARD_FEATURES; f++) feature[f] = 0;
+    int heights[10];
+    for (int col = 0; col < 10; col++)
+    {
+        int top = 20;
+        for (int row = 19; row >= 0; row--) if (grid.grid[row][col] != 0) top = row;
+        heights[col] = 20 - top;
+        for (int row = top; row < 20; row++) if (grid.grid[row][col] == 0) feature[FEATURE_HOLES]++;
+
+        bool above = false;                     // Air over the board
+        for (int row = 0; row < 20; row++)
+        {
+            bool filled = grid.grid[row][col] != 0;
+            if (filled != above) feature[FEATURE_COLUMN_TRANSITIONS]++;
+            above = filled;
+        }
+        if (!above) feature[FEATURE_COLUMN_TRANSITIONS]++;     // The floor
+    }
+    for (int col = 0; col < 10; col++)
+    {
+        feature[FEATURE_AGGREGATE_HEIGHT] += heights[col];
+        feature[FEATURE_MAX_HEIGHT] = std::max(feature[FEATURE_MAX_HEIGHT], heights[col]);
+        if (col > 0) feature[FEATURE_BUMPINESS] += std::abs(heights[col] - heights[col - 1]);
+    }
+    for (int row = 0; row < 20; row++)
+    {
+        bool left = true;                       // The wall
+        int filledCells = 0;
+        for (int col = 0; col < 10; col++)
+        {
+            bool filled = grid.grid[row][col] != 0;
+            if (filled != left) feature[FEATURE_ROW_TRANSITIONS]++;
+            left = filled;
+            filledCells += filled;
+        }
+        if (!left) feature[FEATURE_ROW_TRANSITIONS]++;
+        if (filledCells == 10) feature[FEATURE_COMPLETE_LINES]++;
+    }
+}
+
+static double ReferenceScore(const int feature[NUM_BOARD_FEATURES])
+{
+    double score = 0;
+    for (int f = 0; f < NUM_BOARD_FEATURES; f++) score += (double)WEIGHTS[f]*feature[f];
+    return score;
+}
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckKernels(int best)
+{
+    std::mt19937 rng(SEED);
+    std::vector<Grid> boards(CHECK_BOARDS);
+    for (int i = 1; i < CHECK_BOARDS; i++) RandomBoard(&boards[i], &rng);    // The first stays empty
+
+    BoardEvaluator scalar;
+    scalar.kernel = EVALUATOR_SCALAR;
+    for (const Grid &grid : boards) scalar.Add(grid);
+    scalar.Evaluate(WEIGHTS);
+
+    for (int kernel = EVALUATOR_SCALAR; kernel <= best; kernel++)
+    {
+        BoardEvaluator evaluator;
+        evaluator.kernel = kernel;
+        // A second round over a cleared batch, so stale lanes must not leak in
+        for (int round = 0; round < 2; round++)
+        {
+            evaluator.Clear();
+            for (int i = round; i < CHECK_BOARDS; i++) evaluator.Add(boards[i]);
+            evaluator.Evaluate(WEIGHTS);
+        }
+
+        bool sameFeatures = true, sameScores = true, closeScores = true;
+        int wrongFeature = -1;
+        for (int i = 1; i < CHECK_BOARDS; i++)
+        {
+            int feature[NUM_BOARD_FEATURES];
+            ReferenceFeatures(boards[i], feature);
+            for (int f = 0; f < NUM_BOARD_FEATURES; f++)
+            {
+                if (evaluator.Feature(i - 1, f) != feature[f])
+                {
+                    sameFeatures = false;
+                    wrongFeature = f;
+                }
+            }
+            sameScores = sameScores && (evaluator.Score(i - 1) == scalar.Score(i));
+            double expected = ReferenceScore(feature);
+            closeScores = closeScores && std::fabs(evaluator.Score(i - 1) - expected) <= 1e-4*std::max(1.0, std::fabs(expected));
+        }
+        char what[96];
+        snprintf(what, sizeof(what), "%s gives the reference features (wrong: %s)", KERNEL_NAMES[kernel],
+                 wrongFeature >= 0 ? FEATURE_NAMES[wrongFeature] : "none");
+        BenchCheck(sameFeatures, what);
+        snprintf(what, sizeof(what), "%s gives the scalar kernel's score bits", KERNEL_NAMES[kernel]);
+        BenchCheck(sameScores, what);
+        snprintf(what, sizeof(what), "%s scores match the weighted reference", KERNEL_NAMES[kernel]);
+        BenchCheck(closeScores, what);
+    }
+
+    int empty[NUM_BOARD_FEATURES];
+    ReferenceFeatures(boards[0], empty);
+    BenchCheck(scalar.Feature(0, FEATURE_ROW_TRANSITIONS) == 40 && scalar.Feature(0, FEATURE_COLUMN_TRANSITIONS) == 10 &&
+          scalar.Feature(0, FEATURE_AGGREGATE_HEIGHT) == 0 && empty[FEATURE_ROW_TRANSITIONS] == 40, "an empty board has only the wall and floor transitions");
+}
+
+static void CheckPlacedRows(void)
+{
+    std::mt19937 rng(SEED + 1);
+    PlacementFinder finder;
+    bool same = true, sameCleared = true;
+    int placed = 0;
+    for (int board = 0; board < 200; board++)
+    {
+        Grid grid;
+        RandomBoard(&grid, &rng);
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 10; col++) grid.grid[row][col] = 0;     // Room to spawn
+        }
+        Block block = MakeBlock(1 + board % 7);
+        finder.Find(grid, block);
+        for (const Placement &placement : finder.placements)
+        {
+            Grid expected = grid;
+            int cleared = finder.Place(expected, block, placement);
+            uint16_t rows[20];
+            sameCleared = sameCleared && (finder.PlacedRows(placement, rows) == cleared);
+            for (int row = 0; row < 20; row++)
+            {
+                for (int col = 0; col < 10; col++) same = same && (((rows[row] >> col) & 1) == (expected.grid[row][col] != 0));
+            }
+            placed++;
+        }
+    }
+    BenchCheck(same, "PlacedRows leaves the board Place leaves");
+    BenchCheck(sameCleared, "and clears as many rows");
+    printf("%d placements built as row masks\n", placed);
+}
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeKernels(int best)
+{
+    std::mt19937 rng(SEED + 2);
+    std::vector<Grid> boards(TIMING_BOARDS);
+    for (Grid &grid : boards) RandomBoard(&grid, &rng);
+
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (int pass = 0; pass < TIMING_PASSES/10; pass++)
+    {
+        for (const Grid &grid : boards)
+        {
+            int feature[NUM_BOARD_FEATURES];
+            ReferenceFeatures(grid, feature);
+            sum += ReferenceScore(feature);
+        }
+    }
+    double referenceNs = Milliseconds(start)*1e6/((double)(TIMING_PASSES/10)*TIMING_BOARDS);
+    printf("\n%10s %10s %14s\n", "kernel", "ns/board", "boards/s");
+    printf("%10s %10.2f %14.0f\n", "reference", referenceNs, 1e9/referenceNs);
+
+    for (int kernel = EVALUATOR_SCALAR; kernel <= best; kernel++)
+    {
+        BoardEvaluator evaluator;
+        evaluator.kernel = kernel;
+        for (const Grid &grid : boards) evaluator.Add(grid);
+        evaluator.Evaluate(WEIGHTS);
+        start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < TIMING_PASSES; pass++) evaluator.Evaluate(WEIGHTS);
+        double ns = Milliseconds(start)*1e6/((double)TIMING_PASSES*TIMING_BOARDS);
+        printf("%10s %10.2f %14.0f   (%.0fx the reference)\n", KERNEL_NAMES[kernel], ns, 1e9/ns, referenceNs/ns);
+        sum += evaluator.Score(evaluator.Best());
+    }
+    if (sum == 12345.0) printf(" ");
+}
+
+// Every placement of a piece, scored, the best one picked: the Grid way against row
+// masks into the evaluator
+static void TimeSearch(void)
+{
+    std::mt19937 rng(SEED + 3);
+    std::vector<Grid> boards(SEARCH_BOARDS);
+    for (Grid &grid : boards)
+    {
+        RandomBoard(&grid, &rng);
+        for (int row = 0; row < 6; row++)
+        {
+            for (int col = 0; col < 10; col++) grid.grid[row][col] = 0;
+        }
+    }
+    PlacementFinder finder;
+    BoardEvaluator evaluator;
+    long long placements = 0, gridSearches = 0, maskSearches = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 4; pass++)
+    {
+        for (int i = 0; i < SEARCH_BOARDS; i++)
+        {
+            Block block = MakeBlock(1 + i % 7);
+            finder.Find(boards[i], block);
+            double bestScore = -1e30;
+            for (const Placement &placement : finder.placements)
+            {
+                Grid child = boards[i];
+                finder.Place(child, block, placement);
+                int feature[NUM_BOARD_FEATURES];
+                ReferenceFeatures(child, feature);
+                bestScore = std::max(bestScore, ReferenceScore(feature));
+            }
+            placements += (long long)finder.placements.size();
+            gridSearches += (bestScore > -1e30);
+        }
+    }
+    double gridMs = Milliseconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 4; pass++)
+    {
+        for (int i = 0; i < SEARCH_BOARDS; i++)
+        {
+            Block block = MakeBlock(1 + i % 7);
+            finder.Find(boards[i], block);
+            evaluator.Clear();
+            for (const Placement &placement : finder.placements)
+            {
+                uint16_t rows[20];
+                finder.PlacedRows(placement, rows);
+                evaluator.Add(rows);
+            }
+            evaluator.Evaluate(WEIGHTS);
+            maskSearches += (evaluator.Best() >= 0);
+        }
+    }
+    double maskMs = Milliseconds(start);
+    BenchCheck(maskSearches == gridSearches, "both searches score every board");
+    printf("\nsearch step, %lld placements: %.2f us per piece with Grid copies, %.2f us with row masks (%.1fx)\n",
+           placements/4, gridMs*1000/(4*SEARCH_BOARDS), maskMs*1000/(4*SEARCH_BOARDS), gridMs/maskMs);
+}
+
+int main(void)
+{
+    int best = BoardEvaluator::BestKernel();
+    printf("best kernel on this CPU: %s\n", KERNEL_NAMES[best]);
+
+    CheckKernels(best);
+    CheckPlacedRows();
+    TimeKernels(best);
+    TimeSearch();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: every evaluator kernel gives the reference features\n");
+    return EXIT_SUCCESS;
+}
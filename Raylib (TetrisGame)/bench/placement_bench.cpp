@@ -0,0 +1,320 @@
+// placement_bench.cpp
+// PlacementFinder against a search through the Block and Grid API, on random boards
+// with holes and overhangs: the same placements with the same shortest input counts.
+// Every placement's inputs are replayed through Game::HandleAction and must lock the
+// block exactly there, and a board built for it must give a tuck. Then a perft-style
+// count: every sequence of placements for a fixed piece order, in placements per
+// second, with the Block API search for comparison.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -Isrc -I../common -I../bench bench/placement_bench.cpp ../bench/bench_suite.cpp src/placement_finder.cpp src/game.cpp src/grid.cpp src/block.cpp src/colors.cpp src/postion.cpp ../common/sprite_batch.cpp ../common/profiler.cpp ../common/audio_mixer.cpp -pthread -o placement_bench
+#include "placement_finder.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240615;
+constexpr int CHECK_BOARDS = 60;
+constexpr int REPLAY_GAMES = 40;
+constexpr int PERFT_DEPTH = 4;
+constexpr int REFERENCE_DEPTH = 2;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static Block MakeBlock(int id)
+{
+    switch (id)
+    {
+        case 1: return LBlock();
+        case 2: return JBlock();
+        case 3: return IBlock();
+        case 4: return OBlock();
+        case 5: return SBlock();
+        case 6: return TBlock();
+        default: return ZBlock();
+    }
+}
+
+// Columns of random height from the floor, with holes, and a few floating cells that
+// make overhangs; the top rows stay clear for the spawn
+static void RandomBoard(Grid *grid, std::mt19937 *rng)
+{
+    grid->Initialize();
+    for (int col = 0; col < 10; col++)
+    {
+        int height = (int)((*rng)() % 12);
+        for (int row = 19; row > 19 - height; row--)
+        {
+            if ((*rng)() % 6 != 0) grid->grid[row][col] = 1 + (int)((*rng)() % 7);
+        }
+    }
+    for (int i = 0; i < 4; i++) grid->grid[6 + (*rng)() % 10][(*rng)() % 10] = 1;
+}
+
+static uint32_t CellsKey(const BlockCells &cells)
+{
+    int index[4];
+    for (int i = 0; i < 4; i++) index[i] = cells[i].row*10 + cells[i].cols;
+    std::sort(index, index + 4);
+    return (uint32_t)index[0] | (uint32_t)index[1] << 8 | (uint32_t)index[2] << 16 | (uint32_t)index[3] << 24;
+}
+
+// The keystroke way: copies of the Block moved with its own API, checked cell by cell
+static bool BlockFitsOn(Grid &grid, Block &block)
+{
+    for (Position item : block.GetCellPosition())
+    {
+        if (grid.IsCellOutside(item.row, item.cols) || !grid.IsCellEmpty(item.row, item.cols)) return false;
+    }
+    return true;
+}
+
+static std::map<uint32_t, int> ReferencePlacements(Grid &grid, const Block &spawn)
+{
+    std::map<uint32_t, int> found;
+    std::set<std::tuple<int, int, int>> visited;
+    std::vector<std::pair<Block, int>> queue;
+    Block start = spawn;
+    if (!BlockFitsOn(grid, start)) return found;
+    queue.push_back({ start, 0 });
+    visited.insert(std::make_tuple(start.GetRotation(), start.GetRowOffset(), start.GetColOffset()));
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        Block block = queue[head].first;
+        int depth = queue[head].second;
+        for (int move = 0; move < 4; move++)
+        {
+            Block next = block;
+            if (move == 0) next.Move(0, -1);
+            else if (move == 1) next.Move(0, 1);
+            else if (move == 2) next.Rotate();
+            else next.Move(1, 0);
+
+            if (!BlockFitsOn(grid, next))
+            {
+                if (move == 3)
+                {
+                    uint32_t key = CellsKey(block.GetCellPosition());
+                    if (found.find(key) == found.end()) found[key] = depth + 1;
+                }
+                continue;
+            }
+            if (visited.insert(std::make_tuple(next.GetRotation(), next.GetRowOffset(), next.GetColOffset())).second)
+            {
+                queue.push_back({ next, depth + 1 });
+            }
+        }
+    }
+    return found;
+}
+
+static uint32_t PlacementKey(Block block, const Placement &placement)
+{
+    BlockCells cells = block.cells[placement.rotation];
+    for (Position &item : cells)
+    {
+        item.row += placement.row;
+        item.cols += placement.col;
+    }
+    return CellsKey(cells);
+}
+
+static bool SameGrid(const Grid &a, const Grid &b)
+{
+    for (int row = 0; row < 20; row++)
+    {
+        for (int col = 0; col < 10; col++) if (a.grid[row][col] != b.grid[row][col]) return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckAgainstReference(void)
+{
+    std::mt19937 rng(SEED);
+    PlacementFinder finder;
+    bool sameSets = true, sameDepths = true;
+    Grid grid;
+    for (int board = 0; board < CHECK_BOARDS; board++)
+    {
+        if (board > 0) RandomBoard(&grid, &rng);
+        for (int id = 1; id <= 7; id++)
+        {
+            Block block = MakeBlock(id);
+            std::map<uint32_t, int> reference = ReferencePlacements(grid, block);
+            finder.Find(grid, block);
+
+            sameSets = sameSets && (finder.placements.size() == reference.size());
+            for (const Placement &placement : finder.placements)
+            {
+                auto match = reference.find(PlacementKey(block, placement));
+                sameSets = sameSets && (match != reference.end());
+                sameDepths = sameDepths && (match != reference.end() && match->second == placement.inputCount);
+            }
+        }
+    }
+    BenchCheck(sameSets, "the finder reaches the same placements as the Block API search");
+    BenchCheck(sameDepths, "and with the same shortest input counts");
+
+    printf("placements on the empty board:");
+    const char *names = "LJIOSTZ";
+    for (int id = 1; id <= 7; id++)
+    {
+        Block block = MakeBlock(id);
+        printf(" %c %d", names[id - 1], finder.Find(Grid(), block));
+    }
+    printf("\n");
+}
+
+static void CheckReplay(void)
+{
+    PlacementFinder finder;
+    std::mt19937 rng(SEED + 1);
+    bool locksThere = true, notBefore = true;
+    int replayed = 0;
+    for (int g = 0; g < REPLAY_GAMES; g++)
+    {
+        srand(SEED + g);
+        Game game(nullptr);
+        RandomBoard(&game.grid, &rng);
+        Block block = game.GetCurrentBlock();
+        finder.Find(game.grid, block);
+
+        for (const Placement &placement : finder.placements)
+        {
+            std::vector<GameAction> inputs = finder.Inputs(placement);
+            Game copy = game;
+            for (size_t i = 0; i + 1 < inputs.size(); i++) copy.HandleAction(inputs[i]);
+            notBefore = notBefore && SameGrid(copy.grid, game.grid);
+            copy.HandleAction(inputs.back());
+
+            Grid expected = game.grid;
+            finder.Place(expected, block, placement);
+            locksThere = locksThere && SameGrid(copy.grid, expected);
+            replayed++;
+        }
+    }
+    BenchCheck(notBefore, "no input before the last one locks the block");
+    BenchCheck(locksThere, "the inputs lock the block at its placement through Game");
+    printf("replayed %d placements through Game::HandleAction\n", replayed);
+}
+
+static void CheckTuck(void)
+{
+    // Rows 18-19 of columns 0-3 are open, but columns 0-1 have a roof on row 17: an O
+    // only gets under it by dropping at columns 2-3 and sliding left
+    Grid grid;
+    for (int col = 4; col < 10; col++) grid.grid[18][col] = grid.grid[19][col] = 1;
+    grid.grid[17][0] = grid.grid[17][1] = 1;
+
+    PlacementFinder finder;
+    Block block = OBlock();
+    finder.Find(grid, block);
+    bool tucked = false;
+    for (const Placement &placement : finder.placements)
+    {
+        if (placement.row == 18 && placement.col == 0)
+        {
+            std::vector<GameAction> inputs = finder.Inputs(placement);
+            tucked = inputs.size() >= 3 && inputs[inputs.size() - 2] == ACTION_LEFT && inputs[inputs.size() - 3] == ACTION_LEFT;
+        }
+    }
+    BenchCheck(tucked, "an O tucks under an overhang");
+}
+
+//------------------------------------------------------------------------------------
+// Perft
+//------------------------------------------------------------------------------------
+static const int PIECE_ORDER[] = { 6, 3, 4, 1, 2, 5, 7 };
+
+static long long generated = 0;
+
+// One finder per level, each keeps its placements while the levels below run
+static long long Perft(std::vector<PlacementFinder> &finders, const Grid &grid, int depth, int pieceIndex)
+{
+    PlacementFinder &finder = finders[depth - 1];
+    Block block = MakeBlock(PIECE_ORDER[pieceIndex % 7]);
+    int count = finder.Find(grid, block);
+    generated += count;
+    if (depth == 1) return count;
+
+    long long leaves = 0;
+    for (int i = 0; i < count; i++)
+    {
+        Grid child = grid;
+        finder.Place(child, block, finder.placements[i]);
+        leaves += Perft(finders, child, depth - 1, pieceIndex + 1);
+    }
+    return leaves;
+}
+
+static long long ReferencePerft(const Grid &grid, int depth, int pieceIndex)
+{
+    Grid board = grid;
+    Block block = MakeBlock(PIECE_ORDER[pieceIndex % 7]);
+    std::map<uint32_t, int> found = ReferencePlacements(board, block);
+    if (depth == 1) return (long long)found.size();
+
+    long long leaves = 0;
+    for (const auto &entry : found)
+    {
+        Grid child = grid;
+        for (int i = 0; i < 4; i++)
+        {
+            int cell = (entry.first >> (8*i)) & 0xff;
+            child.grid[cell/10][cell%10] = block.id;
+        }
+        child.ClearFullRows();
+        leaves += ReferencePerft(child, depth - 1, pieceIndex + 1);
+    }
+    return leaves;
+}
+
+static void TimePerft(void)
+{
+    std::vector<PlacementFinder> finders(PERFT_DEPTH);
+    Grid empty;
+
+    printf("\n%6s %12s %14s %10s %16s\n", "depth", "leaves", "placements", "ms", "placements/s");
+    for (int depth = 1; depth <= PERFT_DEPTH; depth++)
+    {
+        generated = 0;
+        auto start = std::chrono::steady_clock::now();
+        long long leaves = Perft(finders, empty, depth, 0);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        printf("%6d %12lld %14lld %10.2f %16.0f\n", depth, leaves, generated, ms, generated/(ms/1000.0));
+
+        if (depth <= REFERENCE_DEPTH)
+        {
+            auto referenceStart = std::chrono::steady_clock::now();
+            long long referenceLeaves = ReferencePerft(empty, depth, 0);
+            double referenceMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - referenceStart).count();
+            BenchCheck(referenceLeaves == leaves, "perft matches the Block API search");
+            printf("%6s %12lld %14s %10.2f   (Block API search, %.0fx slower)\n", "", referenceLeaves, "", referenceMs, referenceMs/ms);
+        }
+    }
+}
+
+int main(void)
+{
+    CheckAgainstReference();
+    CheckReplay();
+    CheckTuck();
+    TimePerft();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: every reachable placement found, with inputs that reach it\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,289 @@
+// tetris_env_bench.cpp
+// The batched environment against Game: from the same board and blocks, an action's
+// key presses through Game::HandleAction and the environment's step must leave the
+// same board, the same points and the same game over. Stepping on several threads must
+// give the one-thread bytes, a step must not allocate, and a second process that maps
+// the shared segment by name must read the owner's buffers and hand it actions through
+// them. Then environment steps per second at B = 1, 64 and 4096.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -Isrc -I../common -I../bench bench/tetris_env_bench.cpp ../bench/bench_suite.cpp src/tetris_env.cpp src/game.cpp src/grid.cpp src/block.cpp src/colors.cpp src/postion.cpp ../common/sprite_batch.cpp ../common/profiler.cpp ../common/audio_mixer.cpp ../common/job_system.cpp ../common/alloc_tracker.cpp -pthread -lrt -o tetris_env_bench
+#include "tetris_env.h"
+#include "game.h"
+#include "alloc_tracker.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240616;
+constexpr int GAME_STEPS = 4000;
+constexpr int THREAD_BATCH = 1000;              // Not a multiple of the thread count
+constexpr int THREAD_STEPS = 300;
+constexpr int SHARED_BATCH = 256;
+constexpr int SHARED_STEPS = 50;
+constexpr int TIMING_BATCHES[] = { 1, 64, 4096 };
+constexpr long long TIMING_GAME_STEPS = 2000000;
+constexpr int ACTION_ROWS = 64;                 // Steps of random actions the timing cycles through
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static std::vector<int32_t> RandomActions(int count, std::mt19937 *rng)
+{
+    std::vector<int32_t> actions(count);
+    for (int32_t &action : actions) action = (int32_t)((*rng)() % TETRIS_ENV_NUM_ACTIONS);
+    return actions;
+}
+
+// FNV-1a over every buffer after the header
+static uint64_t HashBuffers(const TetrisEnvHeader *header)
+{
+    const uint8_t *bytes = (const uint8_t *)header;
+    uint64_t hash = 1469598103934665603ull;
+    for (uint64_t i = header->observationsOffset; i < header->totalBytes; i++) hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+// The presses the environment stands for: turns, then sideways to the column, then DOWN
+// until the grid changes, which is the lock
+static void PressAction(Game &game, int action)
+{
+    for (int turn = 0; turn < action / 10; turn++) game.HandleAction(ACTION_ROTATE);
+    int left = 10;
+    for (Position item : game.GetCurrentBlock().GetCellPosition()) left = std::min(left, item.cols);
+    int shift = action % 10 - left;
+    for (int k = 0; k < abs(shift); k++) game.HandleAction(shift > 0 ? ACTION_RIGHT : ACTION_LEFT);
+
+    Grid before = game.grid;
+    bool locked = false;
+    while (!locked)
+    {
+        game.HandleAction(ACTION_DOWN);
+        locked = memcmp(before.grid, game.grid.grid, sizeof(before.grid)) != 0;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckAgainstGame(void)
+{
+    srand(SEED);
+    std::mt19937 rng(SEED);
+    Game game(nullptr);
+    TetrisEnv *env = tetris_env_create(1, 1, SEED, nullptr);
+    const uint8_t *observation = tetris_env_observations(env);
+
+    bool validStates = true, sameBoards = true, samePoints = true, sameOver = true, sameBlocks = true;
+    int games = 1, linesSteps = 0;
+    for (int step = 0; step < GAME_STEPS; step++)
+    {
+        if (game.GameOver)
+        {
+            game.HandleAction(ACTION_OTHER);    // Restarts it
+            games++;
+        }
+        uint8_t board[200];
+        for (int row = 0; row < 20; row++)
+        {
+            for (int col = 0; col < 10; col++) board[row*10 + col] = (uint8_t)game.grid.grid[row][col];
+        }
+        int current = game.GetCurrentBlock().id;
+        int scoreBefore = game.score;
+
+        int action = (int)(rng() % TETRIS_ENV_NUM_ACTIONS);
+        PressAction(game, action);
+        int next = game.GetCurrentBlock().id;
+        int points = game.score - scoreBefore;
+        if (points > 100) linesSteps++;
+
+        validStates = validStates && tetris_env_set_state(env, 0, board, current, next) == 0;
+        int32_t envAction = action;
+        tetris_env_step(env, &envAction);
+
+        bool done = tetris_env_dones(env)[0] != 0;
+        sameOver = sameOver && (done == game.GameOver);
+        samePoints = samePoints && (tetris_env_rewards(env)[0] == (float)points);
+        if (done) continue;                     // Its observation is the next game's
+        sameBlocks = sameBlocks && (observation[200] == next);
+        for (int row = 0; row < 20; row++)
+        {
+            for (int col = 0; col < 10; col++) sameBoards = sameBoards && (observation[row*10 + col] == (game.grid.grid[row][col] != 0));
+        }
+    }
+    uint8_t board[200] = {};
+    uint8_t badCell[200] = {};
+    badCell[37] = 8;
+    bool rejected = tetris_env_set_state(env, 1, board, 1, 2) == -1 && tetris_env_set_state(env, -1, board, 1, 2) == -1 &&
+                    tetris_env_set_state(env, 0, board, 0, 2) == -1 && tetris_env_set_state(env, 0, board, 1, 8) == -1 &&
+                    tetris_env_set_state(env, 0, badCell, 1, 2) == -1 && tetris_env_set_state(env, 0, nullptr, 1, 2) == -1;
+    tetris_env_destroy(env);
+
+    BenchCheck(validStates, "set_state takes Game's states");
+    BenchCheck(rejected, "set_state rejects a bad index, board or block id");
+    BenchCheck(sameBoards, "the environment leaves Game's board");
+    BenchCheck(samePoints, "and scores Game's points");
+    BenchCheck(sameOver, "and ends the game when Game does");
+    BenchCheck(sameBlocks, "and moves on to the next block");
+    BenchCheck(linesSteps > 0 && games > 1, "the checked games clear rows and end");
+    printf("%d steps over %d games through Game::HandleAction, %d clearing rows\n", GAME_STEPS, games, linesSteps);
+}
+
+static void CheckThreads(void)
+{
+    unsigned cores = std::max(2u, std::thread::hardware_concurrency());
+    TetrisEnv *serial = tetris_env_create(THREAD_BATCH, 1, SEED, nullptr);
+    TetrisEnv *parallel = tetris_env_create(THREAD_BATCH, (int)cores + 2, SEED, nullptr);
+    std::mt19937 rng(SEED + 1);
+
+    bool same = true;
+    long long dones = 0;
+    for (int step = 0; step < THREAD_STEPS; step++)
+    {
+        std::vector<int32_t> actions = RandomActions(THREAD_BATCH, &rng);
+        tetris_env_step(serial, actions.data());
+        tetris_env_step(parallel, actions.data());
+        same = same && HashBuffers(tetris_env_header(serial)) == HashBuffers(tetris_env_header(parallel));
+        for (int i = 0; i < THREAD_BATCH; i++) dones += tetris_env_dones(serial)[i];
+    }
+    BenchCheck(tetris_env_threads(parallel) > 1, "a big batch steps on several threads");
+    BenchCheck(same, "several threads give the one-thread buffers");
+    BenchCheck(dones > 0, "games end and restart in the batch");
+    printf("%d games on %d threads match one thread over %d steps, %lld games ended\n",
+           THREAD_BATCH, tetris_env_threads(parallel), THREAD_STEPS, dones);
+    tetris_env_destroy(serial);
+    tetris_env_destroy(parallel);
+}
+
+static void CheckNoAllocation(void)
+{
+    TetrisEnv *env = tetris_env_create(TIMING_BATCHES[2], 0, SEED, nullptr);
+    std::mt19937 rng(SEED + 2);
+    std::vector<int32_t> actions = RandomActions(TIMING_BATCHES[2], &rng);
+    tetris_env_step(env, actions.data());
+    AllocStats start = AllocTrackerTotals();
+    for (int step = 0; step < 100; step++) tetris_env_step(env, actions.data());
+    tetris_env_step(env, nullptr);
+    BenchCheck(AllocTrackerSince(&start).allocations == 0, "stepping allocates nothing");
+    tetris_env_destroy(env);
+}
+
+#ifndef _WIN32
+// A child process maps the segment by name, reports the hash of what it reads there
+// and leaves actions in it for the owner's next step
+static void CheckShared(void)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/tetris_env_bench_%d", (int)getpid());
+    TetrisEnv *env = tetris_env_create(SHARED_BATCH, 1, SEED, name);
+    TetrisEnv *twin = tetris_env_create(SHARED_BATCH, 1, SEED, nullptr);
+    BenchCheck(env != nullptr, "the shared segment is made");
+    if (env == nullptr) return;
+    TetrisEnv *clash = tetris_env_create(SHARED_BATCH, 1, SEED, name);
+    BenchCheck(clash == nullptr, "a second owner of the same name is refused");
+    if (clash != nullptr) tetris_env_destroy(clash);
+    std::mt19937 rng(SEED + 3);
+    for (int step = 0; step < SHARED_STEPS; step++)
+    {
+        std::vector<int32_t> actions = RandomActions(SHARED_BATCH, &rng);
+        tetris_env_step(env, actions.data());
+        tetris_env_step(twin, actions.data());
+    }
+
+    uint64_t ownerHash = HashBuffers(tetris_env_header(env));
+    int channel[2];
+    BenchCheck(pipe(channel) == 0, "a pipe to the reader");
+    pid_t child = fork();
+    if (child == 0)
+    {
+        uint64_t report[2] = { 0, 0 };
+        TetrisEnvHeader *header = tetris_env_map(name);
+        if (header != nullptr)
+        {
+            report[0] = __atomic_load_n(&header->steps, __ATOMIC_ACQUIRE);
+            report[1] = HashBuffers(header);
+            int32_t *actions = (int32_t *)((uint8_t *)header + header->actionsOffset);
+            for (uint32_t i = 0; i < header->batch; i++) actions[i] = (int32_t)((i*7 + 3) % TETRIS_ENV_NUM_ACTIONS);
+            tetris_env_unmap(header);
+        }
+        ssize_t written = write(channel[1], report, sizeof(report));
+        _exit(written == (ssize_t)sizeof(report) ? 0 : 1);
+    }
+    uint64_t report[2] = { 0, 0 };
+    ssize_t got = read(channel[0], report, sizeof(report));
+    int status = 0;
+    waitpid(child, &status, 0);
+    close(channel[0]);
+    close(channel[1]);
+
+    BenchCheck(got == (ssize_t)sizeof(report) && WIFEXITED(status) && WEXITSTATUS(status) == 0, "the reader process ran");
+    BenchCheck(report[0] == SHARED_STEPS && report[1] == ownerHash, "the reader sees the owner's buffers");
+
+    std::vector<int32_t> actions(SHARED_BATCH);
+    for (int i = 0; i < SHARED_BATCH; i++) actions[i] = (i*7 + 3) % TETRIS_ENV_NUM_ACTIONS;
+    tetris_env_step(env, nullptr);
+    tetris_env_step(twin, actions.data());
+    BenchCheck(memcmp(tetris_env_observations(env), tetris_env_observations(twin), (size_t)SHARED_BATCH*TETRIS_ENV_OBSERVATION_BYTES) == 0,
+          "the owner steps with the reader's actions");
+
+    tetris_env_destroy(env);
+    tetris_env_destroy(twin);
+    BenchCheck(tetris_env_map(name) == nullptr, "destroy removes the segment");
+    printf("a second process read %d games' buffers from %s and sent their actions\n", SHARED_BATCH, name);
+}
+#endif
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeSteps(void)
+{
+    std::vector<int> threadCounts = { 1 };
+    if (std::thread::hardware_concurrency() > 1) threadCounts.push_back((int)std::thread::hardware_concurrency());
+
+    printf("\n%6s %8s %10s %14s %16s\n", "batch", "threads", "steps", "us/step", "env steps/s");
+    for (int batch : TIMING_BATCHES)
+    {
+        for (int threads : threadCounts)
+        {
+            TetrisEnv *env = tetris_env_create(batch, threads, SEED, nullptr);
+            std::mt19937 rng(SEED + 4);
+            std::vector<int32_t> actions = RandomActions(batch*ACTION_ROWS, &rng);
+            for (int step = 0; step < ACTION_ROWS; step++) tetris_env_step(env, actions.data() + (size_t)step*batch);
+
+            int steps = (int)std::max(200LL, TIMING_GAME_STEPS/batch);
+            auto start = std::chrono::steady_clock::now();
+            for (int step = 0; step < steps; step++) tetris_env_step(env, actions.data() + (size_t)(step % ACTION_ROWS)*batch);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printf("%6d %8d %10d %14.2f %16.0f\n", batch, tetris_env_threads(env), steps, seconds*1e6/steps, (double)steps*batch/seconds);
+            tetris_env_destroy(env);
+        }
+    }
+}
+
+int main(void)
+{
+    CheckAgainstGame();
+    CheckThreads();
+    CheckNoAllocation();
+#ifndef _WIN32
+    CheckShared();
+#endif
+    TimeSteps();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: the batched environment plays by Game's rules\n");
+    return EXIT_SUCCESS;
+}
@@ -7,16 +7,18 @@ Block::Block()
 {
     cellSize = 30;
     rotationState = 0;
-    colors = GetCellColors();
     rowOffset = 0;
     colsOffset = 0;
 }
 
-void Block::draw(int offsetX, int offsetY)
+void Block::draw(SpriteBatch &batch, int offsetX, int offsetY)
 {
-    vector<Position> tiles = GetCellPosition();
+    // Made once, not per block: blocks are copied every time one is drawn from the bag
+    static const vector<Color> colors = GetCellColors();
+    BlockCells tiles = GetCellPosition();
     for(Position item : tiles){
-        DrawRectangle(item.cols * cellSize + offsetX, item.row * cellSize + offsetY, cellSize - 1, cellSize - 1, colors[id]);
+        // Layer 1 keeps blocks above the grid cells
+        SpriteBatchRect(&batch, item.cols * cellSize + offsetX, item.row * cellSize + offsetY, cellSize - 1, cellSize - 1, colors[id], 1);
     }
 }
 
@@ -26,15 +28,14 @@ void Block::Move(int rows, int cols)
     colsOffset += cols;
 }
 
-vector<Position> Block::GetCellPosition()
+BlockCells Block::GetCellPosition()
 {
-    vector<Position> tiles = cells[rotationState];
-    vector<Position> movedTiles;
+    BlockCells movedTiles = cells[rotationState];
 
-    for(Position item : tiles)
+    for(Position& item : movedTiles)
     {
-        Position newPos = Position(item.row + rowOffset, item.cols + colsOffset);
-        movedTiles.push_back(newPos);
+        item.row += rowOffset;
+        item.cols += colsOffset;
     }
     return movedTiles;
 }
@@ -54,3 +55,18 @@ void Block::UndoRotation()
         rotationState = cells.size() - 1;
     }
 }
+
+int Block::GetRotation()
+{
+    return rotationState;
+}
+
+int Block::GetRowOffset()
+{
+    return rowOffset;
+}
+
+int Block::GetColOffset()
+{
+    return colsOffset;
+}
@@ -1,28 +1,70 @@
 #pragma once
-#include <vector>
-#include <map>
+#include <initializer_list>
 #include "position.h"
 #include "colors.h"
+#include "sprite_batch.h"
 
 using namespace std;
 
+// The four cells of a block in one rotation. Held in place, so copying a Block or
+// moving its cells allocates nothing.
+struct BlockCells
+{
+    Position items[4];
+    int count = 0;
+
+    BlockCells() {}
+    BlockCells(initializer_list<Position> list)
+    {
+        for(Position item : list){
+            items[count++] = item;
+        }
+    }
+    Position* begin() { return items; }
+    Position* end() { return items + count; }
+    const Position* begin() const { return items; }
+    const Position* end() const { return items + count; }
+    int size() const { return count; }
+    Position& operator[](int index) { return items[index]; }
+    const Position& operator[](int index) const { return items[index]; }
+};
+
+// Cells per rotation. Setting cells[k] counts rotations up to k, like the map it replaced.
+struct BlockShapes
+{
+    BlockCells rotations[4];
+    int count = 0;
+
+    BlockCells& operator[](int rotation)
+    {
+        if(rotation >= count){
+            count = rotation + 1;
+        }
+        return rotations[rotation];
+    }
+    const BlockCells& operator[](int rotation) const { return rotations[rotation]; }
+    int size() const { return count; }
+};
+
 class Block
 {
 public:
     Block();
-    void draw(int offsetX, int offsetY);
+    void draw(SpriteBatch &batch, int offsetX, int offsetY);
     void Move(int rows, int cols);
-    vector<Position> GetCellPosition();
+    BlockCells GetCellPosition();
     void Rotate();
     void UndoRotation();
+    int GetRotation();
+    int GetRowOffset();
+    int GetColOffset();
     int id;
 
-    map<int, vector<Position>> cells;
+    BlockShapes cells;
 
 private:
     int cellSize;
     int rotationState;
-    vector<Color> colors;
     int rowOffset;
     int colsOffset;
 };
\ No newline at end of file
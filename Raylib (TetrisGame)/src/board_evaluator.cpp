@@ -0,0 +1,263 @@
+#include "board_evaluator.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BOARD_EVALUATOR_X86 1
+#endif
+
+using namespace std;
+
+static const int BOARD_ROWS = 20;
+static const uint16_t FULL_ROW = 0x3ff;
+static const int BLOCK_ROWS = BOARD_ROWS * BoardEvaluator::LANES;
+static const int BLOCK_FEATURES = NUM_BOARD_FEATURES * BoardEvaluator::LANES;
+
+BoardEvaluator::BoardEvaluator()
+{
+    count = 0;
+    kernel = BestKernel();
+}
+
+void BoardEvaluator::Clear()
+{
+    count = 0;
+}
+
+int BoardEvaluator::Add(const Grid &grid)
+{
+    uint16_t boardRows[BOARD_ROWS];
+    for(int r = 0; r < BOARD_ROWS; r++){
+        uint16_t mask = 0;
+        for(int c = 0; c < 10; c++){
+            if(grid.grid[r][c] != 0){
+                mask |= (uint16_t)(1 << c);
+            }
+        }
+        boardRows[r] = mask;
+    }
+    return Add(boardRows);
+}
+
+int BoardEvaluator::Add(const uint16_t boardRows[20])
+{
+    int block = count / LANES, lane = count % LANES;
+    if(lane == 0 && (size_t)(block + 1) * BLOCK_ROWS > rows.size()){
+        rows.resize((size_t)(block + 1) * BLOCK_ROWS, 0);
+        features.resize((size_t)(block + 1) * BLOCK_FEATURES, 0);
+        scores.resize((size_t)(block + 1) * LANES, 0.0f);
+    }
+    uint16_t* out = &rows[(size_t)block * BLOCK_ROWS + lane];
+    for(int r = 0; r < BOARD_ROWS; r++){
+        out[r * LANES] = boardRows[r] & FULL_ROW;
+    }
+    return count++;
+}
+
+int BoardEvaluator::Feature(int board, int feature) const
+{
+    return features[(size_t)(board / LANES) * BLOCK_FEATURES + feature * LANES + board % LANES];
+}
+
+float BoardEvaluator::Score(int board) const
+{
+    return scores[board];
+}
+
+int BoardEvaluator::Best() const
+{
+    int best = -1;
+    for(int board = 0; board < count; board++){
+        if(best < 0 || scores[board] > scores[best]){
+            best = board;
+        }
+    }
+    return best;
+}
+
+//------------------------------------------------------------------------------------
+// Kernels, one block of LANES boards each. The scores add the weighted features in
+// feature order from zero in every kernel, and the file builds without FMA
+// contraction, so they all give the same bits.
+//------------------------------------------------------------------------------------
+static void EvaluateBlockScalar(const uint16_t* block, int16_t* out, float* scores, const float* weights)
+{
+    const int LANES = BoardEvaluator::LANES;
+    for(int lane = 0; lane < LANES; lane++){
+        // Column masks with the top row in bit 19, so a height is 32 minus the leading zeros
+        uint32_t columns[10] = { 0 };
+        int feature[NUM_BOARD_FEATURES] = { 0 };
+        for(int r = 0; r < BOARD_ROWS; r++){
+            uint16_t row = block[r * LANES + lane];
+            for(int c = 0; c < 10; c++){
+                columns[c] |= (uint32_t)((row >> c) & 1) << (BOARD_ROWS - 1 - r);
+            }
+            uint32_t walled = (uint32_t)(row << 1) | 0x801;
+            feature[FEATURE_ROW_TRANSITIONS] += __builtin_popcount((walled ^ (walled >> 1)) & 0x7ff);
+            feature[FEATURE_COMPLETE_LINES] += (row == FULL_ROW);
+        }
+        int previous = 0;
+        for(int c = 0; c < 10; c++){
+            int height = (columns[c] != 0) ? 32 - __builtin_clz(columns[c]) : 0;
+            feature[FEATURE_AGGREGATE_HEIGHT] += height;
+            feature[FEATURE_MAX_HEIGHT] = (height > feature[FEATURE_MAX_HEIGHT]) ? height : feature[FEATURE_MAX_HEIGHT];
+            feature[FEATURE_HOLES] += height - __builtin_popcount(columns[c]);
+            if(c > 0){
+                feature[FEATURE_BUMPINESS] += (height > previous) ? height - previous : previous - height;
+            }
+            previous = height;
+            // The floor below in bit 0, empty air above the top
+            uint32_t floored = (columns[c] << 1) | 1;
+            feature[FEATURE_COLUMN_TRANSITIONS] += __builtin_popcount((floored ^ (floored >> 1)) & 0x1fffff);
+        }
+
+        float score = 0.0f;
+        for(int f = 0; f < NUM_BOARD_FEATURES; f++){
+            out[f * LANES + lane] = (int16_t)feature[f];
+            score = score + weights[f] * (float)feature[f];
+        }
+        scores[lane] = score;
+    }
+}
+
+#ifdef BOARD_EVALUATOR_X86
+// Bit counts of 16-bit lanes by halving sums, SSE2 has no byte shuffle
+__attribute__((target("sse2")))
+static inline __m128i Popcount16Sse(__m128i x)
+{
+    x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1), _mm_set1_epi16(0x5555)));
+    x = _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)), _mm_and_si128(_mm_srli_epi16(x, 2), _mm_set1_epi16(0x3333)));
+    x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)), _mm_set1_epi16(0x0f0f));
+    return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), _mm_set1_epi16(0x1f));
+}
+
+// Eight lanes of a block, starting at lane
+__attribute__((target("sse2")))
+static void EvaluateHalfSse(const uint16_t* block, int16_t* out, float* scores, const float* weights, int lane)
+{
+    const int LANES = BoardEvaluator::LANES;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i full = _mm_set1_epi16(FULL_ROW);
+    const __m128i walls = _mm_set1_epi16(0x801);
+    __m128i seen = zero, above = zero;
+    __m128i feature[NUM_BOARD_FEATURES];
+    for(int f = 0; f < NUM_BOARD_FEATURES; f++) feature[f] = zero;
+
+    for(int r = 0; r < BOARD_ROWS; r++){
+        __m128i row = _mm_loadu_si128((const __m128i*)(block + r * LANES + lane));
+        seen = _mm_or_si128(seen, row);
+        feature[FEATURE_AGGREGATE_HEIGHT] = _mm_add_epi16(feature[FEATURE_AGGREGATE_HEIGHT], Popcount16Sse(seen));
+        feature[FEATURE_MAX_HEIGHT] = _mm_add_epi16(feature[FEATURE_MAX_HEIGHT], _mm_andnot_si128(_mm_cmpeq_epi16(seen, zero), one));
+        feature[FEATURE_HOLES] = _mm_add_epi16(feature[FEATURE_HOLES], Popcount16Sse(_mm_andnot_si128(row, seen)));
+        __m128i steps = _mm_and_si128(_mm_xor_si128(seen, _mm_srli_epi16(seen, 1)), _mm_set1_epi16(0x1ff));
+        feature[FEATURE_BUMPINESS] = _mm_add_epi16(feature[FEATURE_BUMPINESS], Popcount16Sse(steps));
+        __m128i walled = _mm_or_si128(_mm_slli_epi16(row, 1), walls);
+        __m128i across = _mm_and_si128(_mm_xor_si128(walled, _mm_srli_epi16(walled, 1)), _mm_set1_epi16(0x7ff));
+        feature[FEATURE_ROW_TRANSITIONS] = _mm_add_epi16(feature[FEATURE_ROW_TRANSITIONS], Popcount16Sse(across));
+        feature[FEATURE_COLUMN_TRANSITIONS] = _mm_add_epi16(feature[FEATURE_COLUMN_TRANSITIONS], Popcount16Sse(_mm_xor_si128(row, above)));
+        feature[FEATURE_COMPLETE_LINES] = _mm_sub_epi16(feature[FEATURE_COMPLETE_LINES], _mm_cmpeq_epi16(row, full));
+        above = row;
+    }
+    feature[FEATURE_COLUMN_TRANSITIONS] = _mm_add_epi16(feature[FEATURE_COLUMN_TRANSITIONS], Popcount16Sse(_mm_xor_si128(above, full)));
+
+    __m128 low = _mm_setzero_ps(), high = _mm_setzero_ps();
+    for(int f = 0; f < NUM_BOARD_FEATURES; f++){
+        _mm_storeu_si128((__m128i*)(out + f * LANES + lane), feature[f]);
+        __m128 weight = _mm_set1_ps(weights[f]);
+        __m128 lowFeature = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(feature[f], feature[f]), 16));
+        __m128 highFeature = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(feature[f], feature[f]), 16));
+        low = _mm_add_ps(low, _mm_mul_ps(weight, lowFeature));
+        high = _mm_add_ps(high, _mm_mul_ps(weight, highFeature));
+    }
+    _mm_storeu_ps(scores + lane, low);
+    _mm_storeu_ps(scores + lane + 4, high);
+}
+
+// Bit counts of 16-bit lanes from a nibble table, two shuffles per vector
+__attribute__((target("avx2")))
+static inline __m256i Popcount16Avx2(__m256i x)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbles = _mm256_set1_epi8(0x0f);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, nibbles)),
+                                    _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibbles)));
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xff)), _mm256_srli_epi16(bytes, 8));
+}
+
+__attribute__((target("avx2")))
+static void EvaluateBlockAvx2(const uint16_t* block, int16_t* out, float* scores, const float* weights)
+{
+    const int LANES = BoardEvaluator::LANES;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i full = _mm256_set1_epi16(FULL_ROW);
+    const __m256i walls = _mm256_set1_epi16(0x801);
+    __m256i seen = zero, above = zero;
+    __m256i feature[NUM_BOARD_FEATURES];
+    for(int f = 0; f < NUM_BOARD_FEATURES; f++) feature[f] = zero;
+
+    for(int r = 0; r < BOARD_ROWS; r++){
+        __m256i row = _mm256_loadu_si256((const __m256i*)(block + r * LANES));
+        seen = _mm256_or_si256(seen, row);
+        feature[FEATURE_AGGREGATE_HEIGHT] = _mm256_add_epi16(feature[FEATURE_AGGREGATE_HEIGHT], Popcount16Avx2(seen));
+        feature[FEATURE_MAX_HEIGHT] = _mm256_add_epi16(feature[FEATURE_MAX_HEIGHT], _mm256_andnot_si256(_mm256_cmpeq_epi16(seen, zero), one));
+        feature[FEATURE_HOLES] = _mm256_add_epi16(feature[FEATURE_HOLES], Popcount16Avx2(_mm256_andnot_si256(row, seen)));
+        __m256i steps = _mm256_and_si256(_mm256_xor_si256(seen, _mm256_srli_epi16(seen, 1)), _mm256_set1_epi16(0x1ff));
+        feature[FEATURE_BUMPINESS] = _mm256_add_epi16(feature[FEATURE_BUMPINESS], Popcount16Avx2(steps));
+        __m256i walled = _mm256_or_si256(_mm256_slli_epi16(row, 1), walls);
+        __m256i across = _mm256_and_si256(_mm256_xor_si256(walled, _mm256_srli_epi16(walled, 1)), _mm256_set1_epi16(0x7ff));
+        feature[FEATURE_ROW_TRANSITIONS] = _mm256_add_epi16(feature[FEATURE_ROW_TRANSITIONS], Popcount16Avx2(across));
+        feature[FEATURE_COLUMN_TRANSITIONS] = _mm256_add_epi16(feature[FEATURE_COLUMN_TRANSITIONS], Popcount16Avx2(_mm256_xor_si256(row, above)));
+        feature[FEATURE_COMPLETE_LINES] = _mm256_sub_epi16(feature[FEATURE_COMPLETE_LINES], _mm256_cmpeq_epi16(row, full));
+        above = row;
+    }
+    feature[FEATURE_COLUMN_TRANSITIONS] = _mm256_add_epi16(feature[FEATURE_COLUMN_TRANSITIONS], Popcount16Avx2(_mm256_xor_si256(above, full)));
+
+    __m256 low = _mm256_setzero_ps(), high = _mm256_setzero_ps();
+    for(int f = 0; f < NUM_BOARD_FEATURES; f++){
+        _mm256_storeu_si256((__m256i*)(out + f * LANES), feature[f]);
+        __m256 weight = _mm256_set1_ps(weights[f]);
+        __m256 lowFeature = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(feature[f])));
+        __m256 highFeature = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(feature[f], 1)));
+        low = _mm256_add_ps(low, _mm256_mul_ps(weight, lowFeature));
+        high = _mm256_add_ps(high, _mm256_mul_ps(weight, highFeature));
+    }
+    _mm256_storeu_ps(scores, low);
+    _mm256_storeu_ps(scores + 8, high);
+}
+#endif
+
+void BoardEvaluator::Evaluate(const float weights[NUM_BOARD_FEATURES])
+{
+    int blocks = (count + LANES - 1) / LANES;
+    for(int b = 0; b < blocks; b++){
+        const uint16_t* block = &rows[(size_t)b * BLOCK_ROWS];
+        int16_t* out = &features[(size_t)b * BLOCK_FEATURES];
+        float* blockScores = &scores[(size_t)b * LANES];
+#ifdef BOARD_EVALUATOR_X86
+        if(kernel == EVALUATOR_AVX2){
+            EvaluateBlockAvx2(block, out, blockScores, weights);
+        }
+        else if(kernel == EVALUATOR_SSE){
+            EvaluateHalfSse(block, out, blockScores, weights, 0);
+            EvaluateHalfSse(block, out, blockScores, weights, 8);
+        }
+        else{
+            EvaluateBlockScalar(block, out, blockScores, weights);
+        }
+#else
+        EvaluateBlockScalar(block, out, blockScores, weights);
+#endif
+    }
+}
+
+int BoardEvaluator::BestKernel()
+{
+#ifdef BOARD_EVALUATOR_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return EVALUATOR_AVX2;
+    if(__builtin_cpu_supports("sse2")) return EVALUATOR_SSE;
+#endif
+    return EVALUATOR_SCALAR;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "grid.h"
+
+using namespace std;
+
+// Heuristic features of a board, in the order Evaluate takes their weights
+enum BoardFeature
+{
+    FEATURE_AGGREGATE_HEIGHT,   // Sum of the column heights
+    FEATURE_MAX_HEIGHT,
+    FEATURE_HOLES,              // Empty cells under the top of their column
+    FEATURE_BUMPINESS,          // Sum of the height steps between neighbouring columns
+    FEATURE_ROW_TRANSITIONS,    // Filled/empty changes along each row, the walls filled
+    FEATURE_COLUMN_TRANSITIONS, // The same down each column, the floor filled
+    FEATURE_COMPLETE_LINES,
+    NUM_BOARD_FEATURES
+};
+
+enum EvaluatorKernel
+{
+    EVALUATOR_SCALAR,
+    EVALUATOR_SSE,
+    EVALUATOR_AVX2
+};
+
+// Features and weighted scores of a batch of candidate boards. Boards are 20 row masks
+// of 16 bits, column c in bit c, kept LANES boards to a block with each row's masks
+// side by side, so a vector register holds one row of 8 or 16 boards. Every feature is
+// a sum of popcounts over the rows, including the column ones: a row counts toward a
+// column's height once anything above it in that column is filled, so the heights
+// never need to be found. The scalar kernel instead turns each board into column masks
+// and reads the heights with a leading zero count.
+class BoardEvaluator
+{
+public:
+    static const int LANES = 16;
+
+    BoardEvaluator();
+    // Forgets the boards, keeping the memory
+    void Clear();
+    // Adds a board, returns its index
+    int Add(const Grid &grid);
+    int Add(const uint16_t boardRows[20]);
+    // Every board's features, and their sum weighted by weights, in one pass
+    void Evaluate(const float weights[NUM_BOARD_FEATURES]);
+    int Feature(int board, int feature) const;
+    float Score(int board) const;
+    // The board with the highest score, the first of equals; -1 when there are none
+    int Best() const;
+    int count;
+    int kernel;                 // An EvaluatorKernel, BestKernel() to start with
+
+    static int BestKernel();
+
+private:
+    vector<uint16_t> rows;      // [block][row][lane]
+    vector<int16_t> features;   // [block][feature][lane]
+    vector<float> scores;
+};
@@ -1,5 +1,6 @@
 #pragma once
-#include <raylib.h>
+// Color from raylib.h when it is included first, from sprite_batch.h otherwise
+#include "sprite_batch.h"
 #include <vector>
 
 using namespace std;
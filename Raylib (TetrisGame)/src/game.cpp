@@ -1,23 +1,27 @@
 #include "game.h"
+#include "profiler.h"
 #include <random>
 
 using namespace std;
 
-Game::Game()
+Game::Game(SpriteSubmitFunc submit)
 {
     grid = Grid();
-    blocks = GetAllBlocks();
+    RefillBlocks();
     CurrentBlock = GetRandomBlock();
     nextBlock = GetRandomBlock();
     GameOver = false;
     score = 0;
-
+    SpriteBatchInit(&spriteBatch, 256, submit);
+    audio = nullptr;
+    rotateSound = -1;
+    clearSound = -1;
 }
 
 Block Game::GetRandomBlock()
 {
     if(blocks.empty()){
-        blocks = GetAllBlocks();
+        RefillBlocks();
     }
     int RandIdx = rand() % blocks.size();
     Block block = blocks[RandIdx];
@@ -26,54 +30,59 @@ Block Game::GetRandomBlock()
     return block;
 }
 
-vector<Block> Game::GetAllBlocks()
+// Into the bag's own storage: after the first fill, drawing blocks allocates nothing
+void Game::RefillBlocks()
 {
-    return {IBlock(), JBlock(), LBlock(), OBlock(), SBlock(), TBlock(), ZBlock()};
+    blocks.assign({IBlock(), JBlock(), LBlock(), OBlock(), SBlock(), TBlock(), ZBlock()});
 }
 
 void Game::draw()
 {
-    grid.draw();
-    CurrentBlock.draw(11, 11);
+    SpriteBatchBegin(&spriteBatch);
+    grid.draw(spriteBatch);
+    CurrentBlock.draw(spriteBatch, 11, 11);
     switch(nextBlock.id){
         case 3:
-            nextBlock.draw(255,290);
+            nextBlock.draw(spriteBatch, 255,290);
             break;
         case 4:
-            nextBlock.draw(255,280);
+            nextBlock.draw(spriteBatch, 255,280);
             break;
         default:
-            nextBlock.draw(270,270);
+            nextBlock.draw(spriteBatch, 270,270);
             break;
     }
+    SpriteBatchFlush(&spriteBatch);
 }
 
-void Game::HandleInput()
+void Game::HandleAction(GameAction action)
 {
-    int keyPressed = GetKeyPressed();
-    if(GameOver && keyPressed != 0){
+    if(GameOver){
         GameOver = false;
         Reset();
     }
 
-    switch(keyPressed)
+    switch(action)
     {
-        case KEY_LEFT:
+        case ACTION_LEFT:
             MoveBlockLeft();
             break;
 
-        case KEY_RIGHT:
+        case ACTION_RIGHT:
             MoveBlockRight();
             break;
 
-        case KEY_DOWN:
+        case ACTION_DOWN:
             MoveBlockDown();
             UpdateScore(0, 1);
             break;
         
-        case KEY_UP:
+        case ACTION_ROTATE:
             RotateBlock();
             break;
+
+        default:
+            break;
     }
 }
 
@@ -100,6 +109,7 @@ void Game::MoveBlockRight()
 
 void Game::MoveBlockDown()
 {   
+    PROFILE_ZONE("MoveBlockDown");
     if(!GameOver){
         CurrentBlock.Move(1, 0);
         if(IsBlockOutside() || BlockFits() == false){
@@ -112,7 +122,7 @@ void Game::MoveBlockDown()
 
 bool Game::IsBlockOutside()
 {
-    vector<Position> tiles = CurrentBlock.GetCellPosition();
+    BlockCells tiles = CurrentBlock.GetCellPosition();
     for(Position item: tiles){
         if(grid.IsCellOutside(item.row, item.cols)){
             return true;
@@ -128,13 +138,17 @@ void Game::RotateBlock()
         if(IsBlockOutside() || BlockFits() == false){
             CurrentBlock.UndoRotation();
         }
+        else{
+            QueueSound(rotateSound);
+        }
     }
     
 }
 
 void Game::LockBlock()
 {
-    vector<Position> tiles = CurrentBlock.GetCellPosition();
+    PROFILE_ZONE("LockBlock");
+    BlockCells tiles = CurrentBlock.GetCellPosition();
     for(Position item: tiles)
     {
         grid.grid[item.row][item.cols] = CurrentBlock.id;
@@ -146,12 +160,15 @@ void Game::LockBlock()
     }
     nextBlock = GetRandomBlock();
     int rowsCleared = grid.ClearFullRows();
+    if(rowsCleared > 0){
+        QueueSound(clearSound);
+    }
     UpdateScore(rowsCleared, 0);
 }
 
 bool Game::BlockFits()
 {
-    vector<Position> tiles = CurrentBlock.GetCellPosition();
+    BlockCells tiles = CurrentBlock.GetCellPosition();
     for(Position item : tiles)
     {
         if(grid.IsCellEmpty(item.row, item.cols) == false){
@@ -161,31 +178,45 @@ bool Game::BlockFits()
     return true;
 }
 
+Block Game::GetCurrentBlock()
+{
+    return CurrentBlock;
+}
+
 void Game::Reset()
 {
     grid.Initialize();
-    blocks = GetAllBlocks();
+    RefillBlocks();
     CurrentBlock = GetRandomBlock();
     nextBlock = GetRandomBlock();
     score = 0;
 }
 
-void Game::UpdateScore(int LinesCleared, int moveDownPoints)
+// Only a push onto the mixer's queue, decoding and mixing happen on its thread
+void Game::QueueSound(int sound)
+{
+    if(audio != nullptr){
+        AudioMixerPlay(audio, sound, 1.0f);
+    }
+}
+
+int Game::LinePoints(int linesCleared)
 {
-    switch (LinesCleared)
+    switch (linesCleared)
     {
     case 1:
-        score += 100;
-        break;
+        return 100;
     case 2:
-        score += 300;
-        break;
+        return 300;
     case 3:
-        score += 500;
-        break;
+        return 500;
     default:
-        break;
+        return 0;
     }
+}
 
+void Game::UpdateScore(int LinesCleared, int moveDownPoints)
+{
+    score += LinePoints(LinesCleared);
     score += moveDownPoints;
 }
@@ -1,31 +1,56 @@
 #pragma once
 #include "grid.h"
 #include "blocks.cpp"
+#include "audio_mixer.h"
 
 using namespace std;
 
+// What a key press does, HandleInput maps the arrow keys to these
+enum GameAction
+{
+    ACTION_OTHER,       // Any other key, only restarts a finished game
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_DOWN,
+    ACTION_ROTATE
+};
+
 class Game
 {
 public:
-    Game();
+    // Built quads go to submit, nullptr when nothing is drawn
+    Game(SpriteSubmitFunc submit);
     Block GetRandomBlock();
-    vector<Block> GetAllBlocks();
     void draw();
+    // Reads the keyboard, defined with raylib in game_input.cpp
     void HandleInput();
+    void HandleAction(GameAction action);
     void MoveBlockLeft();
     void MoveBlockRight();
     void MoveBlockDown();
+    bool BlockFits();
+    // The falling block, where it is now
+    Block GetCurrentBlock();
+    // Points for clearing this many rows at once
+    static int LinePoints(int linesCleared);
     Grid grid;
     bool GameOver;
     int score;
+    // Cells of the grid and blocks, quad and draw call counters per frame
+    SpriteBatch spriteBatch;
+    // Sound events are queued to audio when it is set; clip ids from AudioMixerAddClip
+    AudioMixer *audio;
+    int rotateSound;
+    int clearSound;
 
 private:
     bool IsBlockOutside();
     void RotateBlock();
     void LockBlock();
-    bool BlockFits();
     void Reset();
+    void RefillBlocks();
     void UpdateScore(int LinesCleared, int moveDownPoints);
+    void QueueSound(int sound);
     vector<Block> blocks;
     Block CurrentBlock;
     Block nextBlock;
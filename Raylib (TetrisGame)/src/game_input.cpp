@@ -0,0 +1,37 @@
+#include <raylib.h>
+#include "game.h"
+#include "profiler.h"
+
+using namespace std;
+
+void Game::HandleInput()
+{
+    PROFILE_ZONE("HandleInput");
+    int keyPressed = GetKeyPressed();
+
+    switch(keyPressed)
+    {
+        case 0:
+            break;
+
+        case KEY_LEFT:
+            HandleAction(ACTION_LEFT);
+            break;
+
+        case KEY_RIGHT:
+            HandleAction(ACTION_RIGHT);
+            break;
+
+        case KEY_DOWN:
+            HandleAction(ACTION_DOWN);
+            break;
+
+        case KEY_UP:
+            HandleAction(ACTION_ROTATE);
+            break;
+
+        default:
+            HandleAction(ACTION_OTHER);
+            break;
+    }
+}
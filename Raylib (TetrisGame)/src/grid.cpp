@@ -1,6 +1,7 @@
 #include <iostream>
 #include "grid.h"
 #include "colors.h"
+#include "profiler.h"
 
 using namespace std;
 
@@ -35,12 +36,13 @@ void Grid::print()
 }
 
 
-void Grid::draw()
+void Grid::draw(SpriteBatch &batch)
 {
+    PROFILE_ZONE("Grid::draw");
     for(int rows = 0; rows < numRows; rows++){
         for(int cols = 0; cols < numCols; cols++){
             int cellValue = grid[rows][cols];
-            DrawRectangle(cols * cellSize + 11, rows * cellSize + 11, cellSize - 1, cellSize - 1, colors[cellValue]);
+            SpriteBatchRect(&batch, cols * cellSize + 11, rows * cellSize + 11, cellSize - 1, cellSize - 1, colors[cellValue], 0);
         }
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
-#include <raylib.h>
+#include "colors.h"
+#include "sprite_batch.h"
 
 using namespace std;
 
@@ -10,7 +11,7 @@ class Grid{
         Grid();
         void Initialize();
         void print();
-        void draw();
+        void draw(SpriteBatch &batch);
         bool IsCellOutside(int row, int cols);
         bool IsCellEmpty(int row, int cols);
         int ClearFullRows();
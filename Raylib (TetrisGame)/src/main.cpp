@@ -1,11 +1,21 @@
 #include <raylib.h>
 #include "game.h"
 #include "colors.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include "asset_pack_raylib.h"
+#include "audio_mixer_raylib.h"
+#include "hud_text_raylib.h"
+#include <cstring>
 #include <iostream>
+#include <string>
 
 using namespace std;
 
 double lastUpdateTime = 0;
+AssetPack assets;
+AudioMixer mixer;
+AudioMusicSource music;
 
 bool EventTriggered(double interval)
 {
@@ -17,47 +27,130 @@ bool EventTriggered(double interval)
   return false;
 }
 
+// A clip from tetris.pak when it has one, from the loose file otherwise
+int LoadClip(const char *name, const char *path)
+{
+  if(AssetPackFind(&assets, name) >= 0){
+    // Points into the pack, nothing to unload
+    Wave wave = AssetLoadWave(&assets, name);
+    if(wave.frameCount > 0){
+      return AudioMixerAddWave(&mixer, wave);
+    }
+  }
+  Wave wave = LoadWave(path);
+  int clip = AudioMixerAddWave(&mixer, wave);
+  UnloadWave(wave);
+  return clip;
+}
+
+// Music is decoded here, while loading, so the mixer thread only copies it out
+void LoadMusic(const char *name, const char *path)
+{
+  int index = AssetPackFind(&assets, name);
+  const AssetBlob *blob = (index >= 0) ? AssetPackWait(&assets, index) : nullptr;
+  if(blob != nullptr && blob->size > sizeof(AssetStreamHeader)){
+    AssetStreamHeader header;
+    memcpy(&header, blob->data, sizeof(header));
+    header.fileType[sizeof(header.fileType) - 1] = '\0';
+    AudioMusicSourceInit(&music, header.fileType, blob->data + sizeof(header), (int)(blob->size - sizeof(header)));
+  }
+  else{
+    int size = 0;
+    unsigned char *musicFile = LoadFileData(path, &size);
+    AudioMusicSourceInit(&music, GetFileExtension(path), musicFile, size);
+    UnloadFileData(musicFile);
+  }
+  AudioMixerSetMusic(&mixer, AudioMusicSourceRead, &music);
+}
+
 int main() 
 {   
     
     InitWindow(500,620,"The Game");
     SetTargetFPS(60);
+    // The overlay counts what each frame allocates, steady play should show none
+    ProfilerSetAllocCounter(AllocTrackerCount);
 
-    Font font = LoadFontEx("Font/monogram.ttf", 64, 0, 0);
+    // tetris.pak next to the executable holds the font already baked, the loose
+    // .ttf is the fallback when the archive was not built
+    double loadStart = GetTime();
+    string appDir = GetApplicationDirectory();
+    Font font = {};
+    if(AssetPackOpen(&assets, (appDir + "tetris.pak").c_str())){
+      font = AssetLoadFont(&assets, "font/monogram");
+    }
+    bool fromPack = (font.texture.id != 0);
+    if(!fromPack){
+      font = LoadFontEx("Font/monogram.ttf", 64, 0, 0);
+    }
+    TraceLog(LOG_INFO, "STARTUP: Font ready in %.2f ms from %s", (GetTime() - loadStart)*1000.0, fromPack ? "tetris.pak" : "Font/monogram.ttf");
+
+    // HUD text keeps its glyph quads between frames, only a new score is laid out again
+    HudFont hudFont;
+    HudFontFromRaylib(&hudFont, font);
+    SpriteBatch hud;
+    SpriteBatchInit(&hud, 64, SpriteBatchSubmitRlgl);
+    HudText scoreLabel, nextLabel, gameOverLabel, scoreText;
+    HudTextSet(&scoreLabel, &hudFont, "Score", 38, 2);
+    HudTextSet(&nextLabel, &hudFont, "Next", 38, 2);
+    HudTextSet(&gameOverLabel, &hudFont, "Game Over", 38, 2);
     
-    Game game = Game();
+    // Sounds are mixed on their own thread, the game only queues events to it
+    InitAudioDevice();
+    AudioMixerInit(&mixer);
+    int rotateSound = LoadClip("sound/rotate", "Sounds/rotate.mp3");
+    int clearSound = LoadClip("sound/clear", "Sounds/clear.mp3");
+    LoadMusic("music/main", "Sounds/music.mp3");
+    AudioMixerStart(&mixer);
+    AudioDeviceStart(&mixer);
+    AudioMixerPush(&mixer, {AUDIO_CMD_MUSIC_PLAY, 0, 0.0f});
+
+    Game game = Game(SpriteBatchSubmitRlgl);
+    game.audio = &mixer;
+    game.rotateSound = rotateSound;
+    game.clearSound = clearSound;
 
     while (WindowShouldClose() == false)
     {   
       game.HandleInput();
+      ProfilerUpdateKeys("tetris_trace.json");
       if(EventTriggered(0.5)){
         game.MoveBlockDown();
       }
       BeginDrawing();
       ClearBackground(darkBlue);
 
-      DrawTextEx(font, "Score", {365,15}, 38 ,2 ,WHITE);
-      DrawTextEx(font, "Next", {370,175}, 38 ,2 ,WHITE);
-
-      if(game.GameOver)
-      {
-        DrawTextEx(font, "Game Over", {320,450}, 38 ,2 ,WHITE);
-      }
-      
       DrawRectangleRounded({320,55,170,60}, 0.3, 6, lightBlue);
-
-      char scoreText[10];
-      sprintf(scoreText,"%d", game.score);
-      Vector2 textSize = MeasureTextEx(font ,scoreText, 38, 2);
-
-      DrawTextEx(font, scoreText, {320 + (170 - textSize.x) / 2, 65}, 38 ,2 ,WHITE);
-      
       DrawRectangleRounded({320,215,170,180}, 0.3, 6, lightBlue);
 
       game.draw();
 
+      // All the text in one batch, over the panels
+      {
+        PROFILE_ZONE("Hud");
+        HudTextSetInt(&scoreText, &hudFont, "%d", game.score, 38, 2);
+        SpriteBatchBegin(&hud);
+        HudTextDraw(&hud, &scoreLabel, 365, 15, WHITE, 0);
+        HudTextDraw(&hud, &nextLabel, 370, 175, WHITE, 0);
+        if(game.GameOver)
+        {
+          HudTextDraw(&hud, &gameOverLabel, 320, 450, WHITE, 0);
+        }
+        HudTextDraw(&hud, &scoreText, 320 + (170 - scoreText.width) / 2, 65, WHITE, 0);
+        SpriteBatchFlush(&hud);
+      }
+
+      ProfilerDrawOverlay(10, 10);
       EndDrawing();
+      ProfilerFrameMark();
     }
     
+    AudioDeviceStop();
+    AudioMixerStop(&mixer);
+    AudioMusicSourceUnload(&music);
+    CloseAudioDevice();
+
+    UnloadFont(font);
     CloseWindow();
+    AssetPackClose(&assets);
 }
\ No newline at end of file
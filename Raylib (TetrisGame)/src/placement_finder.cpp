@@ -0,0 +1,173 @@
+#include "placement_finder.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+PlacementFinder::PlacementFinder()
+{
+    rotations = 0;
+}
+
+bool PlacementFinder::Fits(int rotation, int row, int col)
+{
+    if(row + minRow[rotation] < 0 || row + maxRow[rotation] >= 20){
+        return false;
+    }
+    if(col + minCol[rotation] < 0 || col + maxCol[rotation] >= 10){
+        return false;
+    }
+    for(int r = minRow[rotation]; r <= maxRow[rotation]; r++){
+        uint16_t shape = (col >= 0) ? (uint16_t)(shapes[rotation][r] << col) : (uint16_t)(shapes[rotation][r] >> -col);
+        if(rows[row + r] & shape){
+            return false;
+        }
+    }
+    return true;
+}
+
+int PlacementFinder::Find(const Grid &grid, Block &block)
+{
+    placements.clear();
+    covered.clear();
+
+    for(int r = 0; r < 20; r++){
+        uint16_t mask = 0;
+        for(int c = 0; c < 10; c++){
+            if(grid.grid[r][c] != 0){
+                mask |= (uint16_t)(1 << c);
+            }
+        }
+        rows[r] = mask;
+    }
+
+    rotations = (int)block.cells.size();
+    for(int rotation = 0; rotation < rotations; rotation++){
+        memset(shapes[rotation], 0, sizeof(shapes[rotation]));
+        minRow[rotation] = minCol[rotation] = 4;
+        maxRow[rotation] = maxCol[rotation] = -1;
+        for(Position item : block.cells[rotation]){
+            shapes[rotation][item.row] |= (uint16_t)(1 << item.cols);
+            minRow[rotation] = min(minRow[rotation], item.row);
+            maxRow[rotation] = max(maxRow[rotation], item.row);
+            minCol[rotation] = min(minCol[rotation], item.cols);
+            maxCol[rotation] = max(maxCol[rotation], item.cols);
+        }
+    }
+
+    int startRotation = block.GetRotation();
+    int startRow = block.GetRowOffset();
+    int startCol = block.GetColOffset();
+    if(!Fits(startRotation, startRow, startCol)){
+        return 0;
+    }
+
+    memset(visited, 0, sizeof(visited));
+    auto index = [](int rotation, int row, int col){
+        return (rotation * STATE_ROWS + row + ROW_BIAS) * STATE_COLS + col + COL_BIAS;
+    };
+    int start = index(startRotation, startRow, startCol);
+    visited[start >> 6] |= 1ull << (start & 63);
+    parent[start] = -1;
+    depth[start] = 0;
+    int head = 0, tail = 0;
+    queue[tail++] = (int16_t)start;
+
+    while(head < tail){
+        int state = queue[head++];
+        int col = state % STATE_COLS - COL_BIAS;
+        int row = (state / STATE_COLS) % STATE_ROWS - ROW_BIAS;
+        int rotation = state / (STATE_COLS * STATE_ROWS);
+
+        // Same order as a player would try them; the first path found is a shortest one
+        const int moves[3][4] = {
+            { ACTION_LEFT, rotation, row, col - 1 },
+            { ACTION_RIGHT, rotation, row, col + 1 },
+            { ACTION_ROTATE, (rotation + 1) % rotations, row, col },
+        };
+        for(const int *move : moves){
+            if(!Fits(move[1], move[2], move[3])){
+                continue;
+            }
+            int next = index(move[1], move[2], move[3]);
+            if(visited[next >> 6] & (1ull << (next & 63))){
+                continue;
+            }
+            visited[next >> 6] |= 1ull << (next & 63);
+            parent[next] = (int16_t)state;
+            action[next] = (uint8_t)move[0];
+            depth[next] = depth[state] + 1;
+            queue[tail++] = (int16_t)next;
+        }
+
+        if(Fits(rotation, row + 1, col)){
+            int next = index(rotation, row + 1, col);
+            if(!(visited[next >> 6] & (1ull << (next & 63)))){
+                visited[next >> 6] |= 1ull << (next & 63);
+                parent[next] = (int16_t)state;
+                action[next] = ACTION_DOWN;
+                depth[next] = depth[state] + 1;
+                queue[tail++] = (int16_t)next;
+            }
+            continue;
+        }
+
+        // DOWN from here locks the block. States dequeue by depth, so the first state
+        // that covers these cells has the shortest inputs.
+        int cells[4], count = 0;
+        for(Position item : block.cells[rotation]){
+            cells[count++] = (item.row + row) * 10 + item.cols + col;
+        }
+        sort(cells, cells + 4);
+        uint32_t key = (uint32_t)cells[0] | (uint32_t)cells[1] << 8 | (uint32_t)cells[2] << 16 | (uint32_t)cells[3] << 24;
+        if(find(covered.begin(), covered.end(), key) != covered.end()){
+            continue;
+        }
+        covered.push_back(key);
+        placements.push_back({ row, col, rotation, depth[state] + 1, state });
+    }
+    return (int)placements.size();
+}
+
+vector<GameAction> PlacementFinder::Inputs(const Placement &placement)
+{
+    vector<GameAction> inputs(placement.inputCount);
+    inputs[placement.inputCount - 1] = ACTION_DOWN;
+    int k = placement.inputCount - 2;
+    for(int state = placement.state; parent[state] >= 0; state = parent[state]){
+        inputs[k--] = (GameAction)action[state];
+    }
+    return inputs;
+}
+
+int PlacementFinder::Place(Grid &grid, Block &block, const Placement &placement)
+{
+    for(Position item : block.cells[placement.rotation]){
+        grid.grid[item.row + placement.row][item.cols + placement.col] = block.id;
+    }
+    return grid.ClearFullRows();
+}
+
+int PlacementFinder::PlacedRows(const Placement &placement, uint16_t out[20])
+{
+    uint16_t placed[20];
+    memcpy(placed, rows, sizeof(rows));
+    int col = placement.col;
+    for(int r = minRow[placement.rotation]; r <= maxRow[placement.rotation]; r++){
+        uint16_t shape = shapes[placement.rotation][r];
+        placed[placement.row + r] |= (col >= 0) ? (uint16_t)(shape << col) : (uint16_t)(shape >> -col);
+    }
+
+    int write = 19, cleared = 0;
+    for(int r = 19; r >= 0; r--){
+        if(placed[r] == 0x3ff){
+            cleared++;
+            continue;
+        }
+        out[write--] = placed[r];
+    }
+    while(write >= 0){
+        out[write--] = 0;
+    }
+    return cleared;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "grid.h"
+#include "block.h"
+#include "game.h"
+
+using namespace std;
+
+// Where a block can lock: its offsets and rotation state at that point, as Block keeps
+// them, and how many key presses reach it from the spawn (the last one is the DOWN
+// that locks it)
+struct Placement
+{
+    int row;
+    int col;
+    int rotation;
+    int inputCount;
+    int state;          // BFS state index, for Inputs
+};
+
+// Every placement a block can reach with LEFT, RIGHT, DOWN and ROTATE from where it is,
+// tucks and spins included. A breadth-first search over (row, col, rotation) with
+// the board as 16-bit row masks and the visited states as a bitset. Placements that
+// cover the same cells are one placement, with the shortest inputs.
+class PlacementFinder
+{
+public:
+    PlacementFinder();
+    int Find(const Grid &grid, Block &block);
+    // The key presses, in order, that lock the block at placement
+    vector<GameAction> Inputs(const Placement &placement);
+    // Locks a block at placement on grid and clears the full rows, like Game does
+    int Place(Grid &grid, Block &block, const Placement &placement);
+    // The board from the last Find as row masks after locking at placement and clearing
+    // the full rows, without a Grid; returns the rows cleared
+    int PlacedRows(const Placement &placement, uint16_t out[20]);
+    vector<Placement> placements;
+
+    // States are rotation x row x column, with the offsets biased to stay positive
+    static const int ROW_BIAS = 4;
+    static const int COL_BIAS = 4;
+    static const int STATE_ROWS = 24;
+    static const int STATE_COLS = 16;
+    static const int NUM_STATES = 4 * STATE_ROWS * STATE_COLS;
+
+private:
+    bool Fits(int rotation, int row, int col);
+    uint16_t rows[20];
+    int rotations;
+    uint16_t shapes[4][4];          // Row masks per rotation, columns from bit 0
+    int minRow[4], maxRow[4], minCol[4], maxCol[4];
+    uint64_t visited[NUM_STATES / 64];
+    int16_t parent[NUM_STATES];
+    uint8_t action[NUM_STATES];
+    int16_t depth[NUM_STATES];
+    int16_t queue[NUM_STATES];
+    vector<uint32_t> covered;       // Cells of each placement, for merging duplicates
+};
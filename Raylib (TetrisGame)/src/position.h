@@ -3,6 +3,7 @@
 class Position
 {
 public:
+    Position();
     Position(int row,int cols);
     int row;
     int cols;
@@ -1,5 +1,11 @@
 #include "position.h"
 
+Position::Position()
+{
+    row = 0;
+    cols = 0;
+}
+
 Position::Position(int row,int cols)
 {
     this -> row = row;
@@ -0,0 +1,495 @@
+#include "tetris_env.h"
+#include "game.h"
+#include "job_system.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TETRIS_ENV_SHARED 1
+#endif
+
+using namespace std;
+
+// Games per job: fewer would spend the step scheduling, and no more workers are made
+// than there are such shares
+static const int GAMES_PER_JOB = 64;
+static const size_t BUFFER_ALIGN = 64;
+
+// The blocks from blocks.cpp as row masks, made once. Ids run 1-7.
+struct EnvPiece
+{
+    int rotations;
+    int spawnRow;
+    int spawnCol;
+    uint16_t shapes[4][4];      // Row masks per rotation, columns from bit 0
+    int minRow[4], maxRow[4], minCol[4], maxCol[4];
+};
+
+static const EnvPiece* Pieces()
+{
+    static const vector<EnvPiece> pieces = []{
+        vector<EnvPiece> made(8);
+        vector<Block> blocks = {IBlock(), JBlock(), LBlock(), OBlock(), SBlock(), TBlock(), ZBlock()};
+        for(Block block : blocks){
+            EnvPiece& piece = made[block.id];
+            memset(&piece, 0, sizeof(piece));
+            piece.rotations = (int)block.cells.size();
+            piece.spawnRow = block.GetRowOffset();
+            piece.spawnCol = block.GetColOffset();
+            for(int rotation = 0; rotation < piece.rotations; rotation++){
+                piece.minRow[rotation] = piece.minCol[rotation] = 4;
+                piece.maxRow[rotation] = piece.maxCol[rotation] = -1;
+                for(Position item : block.cells[rotation]){
+                    piece.shapes[rotation][item.row] |= (uint16_t)(1 << item.cols);
+                    piece.minRow[rotation] = min(piece.minRow[rotation], item.row);
+                    piece.maxRow[rotation] = max(piece.maxRow[rotation], item.row);
+                    piece.minCol[rotation] = min(piece.minCol[rotation], item.cols);
+                    piece.maxCol[rotation] = max(piece.maxCol[rotation], item.cols);
+                }
+            }
+        }
+        return made;
+    }();
+    return pieces.data();
+}
+
+// Game::RefillBlocks order, the bag draws from what is left of it like GetRandomBlock
+static const int BAG_ORDER[7] = { 3, 2, 1, 4, 5, 6, 7 };
+
+struct EnvGame
+{
+    Grid grid;
+    uint16_t rows[20];          // grid as masks, for the fit tests
+    int current;
+    int next;
+    uint8_t bag;                // Bit k set while BAG_ORDER[k] is still in the bag
+    uint32_t random;
+    int score;
+};
+
+struct TetrisEnv
+{
+    int batch;
+    vector<EnvGame> games;
+    uint8_t* block;
+    size_t blockBytes;
+    TetrisEnvHeader* header;
+    uint8_t* observations;
+    int32_t* actions;
+    float* rewards;
+    uint8_t* dones;
+    int32_t* scores;
+    bool shared;
+    char name[256];
+
+    // A step is a parallel for over the games; the stepping thread is worker 0
+    JobSystem jobs;
+    const int32_t* stepActions;
+};
+
+//------------------------------------------------------------------------------------
+// One game
+//------------------------------------------------------------------------------------
+static uint32_t NextRandom(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static int DrawBlock(EnvGame& game)
+{
+    if(game.bag == 0){
+        game.bag = 0x7f;
+    }
+    int left = __builtin_popcount(game.bag);
+    int pick = (int)(NextRandom(game.random) % (uint32_t)left);
+    for(int k = 0; k < 7; k++){
+        if((game.bag & (1 << k)) && pick-- == 0){
+            game.bag &= (uint8_t)~(1 << k);
+            return BAG_ORDER[k];
+        }
+    }
+    return BAG_ORDER[0];
+}
+
+static bool Fits(const EnvGame& game, const EnvPiece& piece, int rotation, int row, int col)
+{
+    if(row + piece.minRow[rotation] < 0 || row + piece.maxRow[rotation] >= 20){
+        return false;
+    }
+    if(col + piece.minCol[rotation] < 0 || col + piece.maxCol[rotation] >= 10){
+        return false;
+    }
+    for(int r = piece.minRow[rotation]; r <= piece.maxRow[rotation]; r++){
+        uint16_t shape = (col >= 0) ? (uint16_t)(piece.shapes[rotation][r] << col) : (uint16_t)(piece.shapes[rotation][r] >> -col);
+        if(game.rows[row + r] & shape){
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RebuildRows(EnvGame& game)
+{
+    for(int r = 0; r < 20; r++){
+        uint16_t mask = 0;
+        for(int c = 0; c < 10; c++){
+            if(game.grid.grid[r][c] != 0){
+                mask |= (uint16_t)(1 << c);
+            }
+        }
+        game.rows[r] = mask;
+    }
+}
+
+static void ResetGame(EnvGame& game)
+{
+    game.grid.Initialize();
+    memset(game.rows, 0, sizeof(game.rows));
+    game.bag = 0x7f;
+    game.current = DrawBlock(game);
+    game.next = DrawBlock(game);
+    game.score = 0;
+}
+
+static void WriteObservation(const EnvGame& game, uint8_t* observation)
+{
+    for(int r = 0; r < 20; r++){
+        for(int c = 0; c < 10; c++){
+            observation[r * 10 + c] = (uint8_t)(game.grid.grid[r][c] != 0);
+        }
+    }
+    observation[200] = (uint8_t)game.current;
+    observation[201] = (uint8_t)game.next;
+}
+
+// The key presses Game would get for this action: ROTATE a / 10 times, LEFT or RIGHT
+// toward the column, then DOWN until the block locks. Blocked presses do nothing, as
+// in Game. Returns the points scored; done is set when the next block does not fit.
+static int StepGame(EnvGame& game, int action, bool& done)
+{
+    const EnvPiece* pieces = Pieces();
+    const EnvPiece& piece = pieces[game.current];
+    int rotation = 0, row = piece.spawnRow, col = piece.spawnCol;
+
+    for(int turn = 0; turn < action / 10; turn++){
+        int turned = (rotation + 1) % piece.rotations;
+        if(Fits(game, piece, turned, row, col)){
+            rotation = turned;
+        }
+    }
+    int shift = action % 10 - (col + piece.minCol[rotation]);
+    int direction = (shift > 0) ? 1 : -1;
+    for(int k = 0; k < abs(shift) && Fits(game, piece, rotation, row, col + direction); k++){
+        col += direction;
+    }
+    int points = 1;
+    while(Fits(game, piece, rotation, row + 1, col)){
+        row++;
+        points++;
+    }
+
+    // Game::LockBlock: the next block is tested before the full rows clear
+    for(int r = piece.minRow[rotation]; r <= piece.maxRow[rotation]; r++){
+        uint16_t shape = (col >= 0) ? (uint16_t)(piece.shapes[rotation][r] << col) : (uint16_t)(piece.shapes[rotation][r] >> -col);
+        game.rows[row + r] |= shape;
+        for(int c = 0; c < 10; c++){
+            if(shape & (1 << c)){
+                game.grid.grid[row + r][c] = game.current;
+            }
+        }
+    }
+    game.current = game.next;
+    const EnvPiece& next = pieces[game.current];
+    done = !Fits(game, next, 0, next.spawnRow, next.spawnCol);
+    game.next = DrawBlock(game);
+    int rowsCleared = game.grid.ClearFullRows();
+    if(rowsCleared > 0){
+        RebuildRows(game);
+    }
+    points += Game::LinePoints(rowsCleared);
+    game.score += points;
+    return points;
+}
+
+static void StepRange(TetrisEnv* env, const int32_t* actions, int first, int end)
+{
+    for(int i = first; i < end; i++){
+        EnvGame& game = env->games[i];
+        int action = actions[i] % TETRIS_ENV_NUM_ACTIONS;
+        if(action < 0){
+            action += TETRIS_ENV_NUM_ACTIONS;
+        }
+        bool done = false;
+        env->rewards[i] = (float)StepGame(game, action, done);
+        env->dones[i] = (uint8_t)done;
+        env->scores[i] = game.score;
+        if(done){
+            ResetGame(game);
+        }
+        WriteObservation(game, env->observations + (size_t)i * TETRIS_ENV_OBSERVATION_BYTES);
+    }
+}
+
+// Games [begin, end) of a JobParallelFor
+static void StepJob(void* user, int begin, int end)
+{
+    TetrisEnv* env = (TetrisEnv*)user;
+    StepRange(env, env->stepActions, begin, end);
+}
+
+//------------------------------------------------------------------------------------
+// Memory block
+//------------------------------------------------------------------------------------
+static size_t AlignUp(size_t bytes)
+{
+    return (bytes + BUFFER_ALIGN - 1) / BUFFER_ALIGN * BUFFER_ALIGN;
+}
+
+static bool MapBlock(TetrisEnv* env, size_t bytes, const char* sharedName)
+{
+    env->blockBytes = bytes;
+    env->shared = false;
+    env->name[0] = '\0';
+    if(sharedName == nullptr){
+        env->block = (uint8_t*)calloc(1, bytes);
+        return env->block != nullptr;
+    }
+#ifdef TETRIS_ENV_SHARED
+    if(strlen(sharedName) >= sizeof(env->name)){
+        return false;
+    }
+    // Never adopt a segment someone else made: its size and contents are unknown
+    int fd = shm_open(sharedName, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0){
+        return false;
+    }
+    void* mapped = MAP_FAILED;
+    if(ftruncate(fd, (off_t)bytes) == 0){
+        mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(mapped == MAP_FAILED){
+        shm_unlink(sharedName);
+        return false;
+    }
+    env->block = (uint8_t*)mapped;
+    memset(env->block, 0, bytes);
+    env->shared = true;
+    strcpy(env->name, sharedName);
+    return true;
+#else
+    return false;
+#endif
+}
+
+static void UnmapBlock(TetrisEnv* env)
+{
+#ifdef TETRIS_ENV_SHARED
+    if(env->shared){
+        munmap(env->block, env->blockBytes);
+        shm_unlink(env->name);
+        return;
+    }
+#endif
+    free(env->block);
+}
+
+//------------------------------------------------------------------------------------
+// C API
+//------------------------------------------------------------------------------------
+TetrisEnv* tetris_env_create(int batch, int threads, uint64_t seed, const char* sharedName)
+{
+    if(batch <= 0){
+        return nullptr;
+    }
+    size_t observationsOffset = AlignUp(sizeof(TetrisEnvHeader));
+    size_t actionsOffset = observationsOffset + AlignUp((size_t)batch * TETRIS_ENV_OBSERVATION_BYTES);
+    size_t rewardsOffset = actionsOffset + AlignUp((size_t)batch * sizeof(int32_t));
+    size_t donesOffset = rewardsOffset + AlignUp((size_t)batch * sizeof(float));
+    size_t scoresOffset = donesOffset + AlignUp((size_t)batch);
+    size_t totalBytes = scoresOffset + AlignUp((size_t)batch * sizeof(int32_t));
+
+    TetrisEnv* env = new TetrisEnv();
+    if(!MapBlock(env, totalBytes, sharedName)){
+        delete env;
+        return nullptr;
+    }
+    TetrisEnvHeader* header = (TetrisEnvHeader*)env->block;
+    header->magic = TETRIS_ENV_MAGIC;
+    header->version = TETRIS_ENV_VERSION;
+    header->batch = (uint32_t)batch;
+    header->rows = TETRIS_ENV_ROWS;
+    header->cols = TETRIS_ENV_COLS;
+    header->numActions = TETRIS_ENV_NUM_ACTIONS;
+    header->observationBytes = TETRIS_ENV_OBSERVATION_BYTES;
+    header->observationsOffset = observationsOffset;
+    header->actionsOffset = actionsOffset;
+    header->rewardsOffset = rewardsOffset;
+    header->donesOffset = donesOffset;
+    header->scoresOffset = scoresOffset;
+    header->totalBytes = totalBytes;
+    header->steps = 0;
+
+    env->batch = batch;
+    env->header = header;
+    env->observations = env->block + observationsOffset;
+    env->actions = (int32_t*)(env->block + actionsOffset);
+    env->rewards = (float*)(env->block + rewardsOffset);
+    env->dones = env->block + donesOffset;
+    env->scores = (int32_t*)(env->block + scoresOffset);
+
+    // One xorshift stream per game, spread by a splitmix step so neighbouring games
+    // and seeds do not start alike
+    env->games.resize(batch);
+    for(int i = 0; i < batch; i++){
+        uint64_t z = seed + 0x9e3779b97f4a7c15ull * (uint64_t)(i + 1);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        z ^= z >> 31;
+        env->games[i].random = (uint32_t)z | 1u;
+    }
+    tetris_env_reset(env);
+
+    if(threads <= 0){
+        threads = (int)max(1u, thread::hardware_concurrency());
+    }
+    threads = max(1, min(threads, (batch + GAMES_PER_JOB - 1) / GAMES_PER_JOB));
+    env->stepActions = env->actions;
+    JobSystemInit(&env->jobs, threads);
+    return env;
+}
+
+void tetris_env_destroy(TetrisEnv* env)
+{
+    if(env == nullptr){
+        return;
+    }
+    JobSystemShutdown(&env->jobs);
+    UnmapBlock(env);
+    delete env;
+}
+
+void tetris_env_reset(TetrisEnv* env)
+{
+    for(int i = 0; i < env->batch; i++){
+        ResetGame(env->games[i]);
+        WriteObservation(env->games[i], env->observations + (size_t)i * TETRIS_ENV_OBSERVATION_BYTES);
+        env->rewards[i] = 0.0f;
+        env->dones[i] = 0;
+        env->scores[i] = 0;
+    }
+}
+
+void tetris_env_step(TetrisEnv* env, const int32_t* actions)
+{
+    env->stepActions = (actions != nullptr) ? actions : env->actions;
+    JobParallelFor(&env->jobs, env->batch, GAMES_PER_JOB, StepJob, env);
+    __atomic_store_n(&env->header->steps, env->header->steps + 1, __ATOMIC_RELEASE);
+}
+
+int tetris_env_set_state(TetrisEnv* env, int index, const uint8_t* board, int current, int next)
+{
+    if(index < 0 || index >= env->batch || board == nullptr || current < 1 || current > 7 || next < 1 || next > 7){
+        return -1;
+    }
+    for(int i = 0; i < TETRIS_ENV_ROWS * TETRIS_ENV_COLS; i++){
+        if(board[i] > 7){
+            return -1;
+        }
+    }
+    EnvGame& game = env->games[index];
+    for(int r = 0; r < 20; r++){
+        for(int c = 0; c < 10; c++){
+            game.grid.grid[r][c] = board[r * 10 + c];
+        }
+    }
+    RebuildRows(game);
+    game.current = current;
+    game.next = next;
+    WriteObservation(game, env->observations + (size_t)index * TETRIS_ENV_OBSERVATION_BYTES);
+    return 0;
+}
+
+TetrisEnvHeader* tetris_env_header(TetrisEnv* env)
+{
+    return env->header;
+}
+
+uint8_t* tetris_env_observations(TetrisEnv* env)
+{
+    return env->observations;
+}
+
+int32_t* tetris_env_actions(TetrisEnv* env)
+{
+    return env->actions;
+}
+
+float* tetris_env_rewards(TetrisEnv* env)
+{
+    return env->rewards;
+}
+
+uint8_t* tetris_env_dones(TetrisEnv* env)
+{
+    return env->dones;
+}
+
+int32_t* tetris_env_scores(TetrisEnv* env)
+{
+    return env->scores;
+}
+
+int tetris_env_threads(TetrisEnv* env)
+{
+    return env->jobs.workerCount;
+}
+
+TetrisEnvHeader* tetris_env_map(const char* name)
+{
+#ifdef TETRIS_ENV_SHARED
+    int fd = shm_open(name, O_RDWR, 0);
+    if(fd < 0){
+        return nullptr;
+    }
+    struct stat info;
+    void* mapped = MAP_FAILED;
+    if(fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(TetrisEnvHeader)){
+        mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(mapped == MAP_FAILED){
+        return nullptr;
+    }
+    TetrisEnvHeader* header = (TetrisEnvHeader*)mapped;
+    if(header->magic != TETRIS_ENV_MAGIC || header->version != TETRIS_ENV_VERSION || header->totalBytes != (uint64_t)info.st_size){
+        munmap(mapped, (size_t)info.st_size);
+        return nullptr;
+    }
+    return header;
+#else
+    (void)name;
+    return nullptr;
+#endif
+}
+
+void tetris_env_unmap(TetrisEnvHeader* header)
+{
+#ifdef TETRIS_ENV_SHARED
+    if(header != nullptr){
+        munmap(header, (size_t)header->totalBytes);
+    }
+#else
+    (void)header;
+#endif
+}
@@ -0,0 +1,101 @@
+#pragma once
+// Batched Tetris for training placement policies, as a C library (libtetris_env).
+// B games step in lockstep: one action per game picks a rotation and a column, the
+// block drops and locks there under the Game and Grid rules, and the observations,
+// rewards, done flags and scores of all B games land in one block of memory. Stepping
+// allocates nothing, and the block can be a POSIX shared memory segment that a
+// trainer in another process maps by name and reads in place.
+//
+// Layout of the block, every offset from its start and 64-byte aligned:
+//   header        TetrisEnvHeader
+//   observations  B x observationBytes: the 20x10 board row by row, 1 where a cell is
+//                 filled, then the falling block's id and the next block's id (1-7)
+//   actions       B x int32, read by tetris_env_step when it is given no actions
+//   rewards       B x float, points the step scored: one per row the block dropped
+//                 plus its lock, and 100/300/500 for 1/2/3 rows cleared
+//   dones         B x uint8, 1 when the step ended the game; that game restarts, so its
+//                 observation is already the new game's first
+//   scores        B x int32, points of the game so far, of the finished game on a done
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define TETRIS_ENV_API
+#else
+#define TETRIS_ENV_API __attribute__((visibility("default")))
+#endif
+
+#define TETRIS_ENV_MAGIC 0x56454e54u        /* "TENV" */
+#define TETRIS_ENV_VERSION 1u
+#define TETRIS_ENV_ROWS 20
+#define TETRIS_ENV_COLS 10
+#define TETRIS_ENV_OBSERVATION_BYTES (TETRIS_ENV_ROWS * TETRIS_ENV_COLS + 2)
+// Action a turns the block a / 10 times, then moves its leftmost cell to column a % 10
+#define TETRIS_ENV_NUM_ACTIONS 40
+
+typedef struct TetrisEnvHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t batch;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t numActions;
+    uint32_t observationBytes;
+    uint32_t reserved;
+    uint64_t observationsOffset;
+    uint64_t actionsOffset;
+    uint64_t rewardsOffset;
+    uint64_t donesOffset;
+    uint64_t scoresOffset;
+    uint64_t totalBytes;
+    // Batches stepped, stored with release order after a step's buffers are written:
+    // a reader that loads it with acquire order and sees a new count sees that step
+    uint64_t steps;
+} TetrisEnvHeader;
+
+typedef struct TetrisEnv TetrisEnv;
+
+// batch games on threads workers (0 for one per core, never more than one per 64
+// games), seeded from seed. sharedName, like "/tetris_env", puts the buffers in a
+// shared memory segment of that name, removed again by tetris_env_destroy; NULL keeps
+// them in private memory. Returns NULL when batch is not positive or the segment
+// cannot be made, which includes a segment of that name already existing: a stale one
+// left by a crashed owner has to be removed (shm_unlink) by the caller.
+TETRIS_ENV_API TetrisEnv *tetris_env_create(int batch, int threads, uint64_t seed, const char *sharedName);
+TETRIS_ENV_API void tetris_env_destroy(TetrisEnv *env);
+
+// Restarts every game and writes the first observations
+TETRIS_ENV_API void tetris_env_reset(TetrisEnv *env);
+
+// One action per game, NULL to use the actions buffer. Actions out of range are
+// taken modulo TETRIS_ENV_NUM_ACTIONS.
+TETRIS_ENV_API void tetris_env_step(TetrisEnv *env, const int32_t *actions);
+
+// Puts game index in a given state: board holds 200 cells row by row, 0 for empty and
+// a block id otherwise; current and next are block ids. Its observation is rewritten.
+// Returns 0, or -1 and changes nothing when index is not in [0, batch), board is NULL
+// or a cell, current or next is not a block id.
+TETRIS_ENV_API int tetris_env_set_state(TetrisEnv *env, int index, const uint8_t *board, int current, int next);
+
+TETRIS_ENV_API TetrisEnvHeader *tetris_env_header(TetrisEnv *env);
+TETRIS_ENV_API uint8_t *tetris_env_observations(TetrisEnv *env);
+TETRIS_ENV_API int32_t *tetris_env_actions(TetrisEnv *env);
+TETRIS_ENV_API float *tetris_env_rewards(TetrisEnv *env);
+TETRIS_ENV_API uint8_t *tetris_env_dones(TetrisEnv *env);
+TETRIS_ENV_API int32_t *tetris_env_scores(TetrisEnv *env);
+TETRIS_ENV_API int tetris_env_threads(TetrisEnv *env);
+
+// For the reading side: maps the segment a tetris_env_create made under name, NULL
+// when there is none or it is not a tetris_env block. The buffers are at the header's
+// offsets from the returned pointer.
+TETRIS_ENV_API TetrisEnvHeader *tetris_env_map(const char *name);
+TETRIS_ENV_API void tetris_env_unmap(TetrisEnvHeader *header);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,167 @@
+// margolus_bench.cpp
+// The Margolus block rule against the column scan (SandStep). Checks that the table
+// keeps every grain, that the stepping kernel follows the table, that a world keeps
+// its grain count over thousands of steps whatever the job system, and reports how
+// many grains the column scan loses on the same start. Then times both rules.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -pthread -Isrc -I../common -I../bench bench/margolus_bench.cpp ../bench/bench_suite.cpp src/sand.cpp ../common/job_system.cpp -o margolus_bench
+#include "sand.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240611;
+constexpr int MASS_SIZE = 256;
+constexpr int MASS_STEPS = 2000;
+constexpr int THREAD_STEPS = 300;
+constexpr int TIMING_SIZES[] = { 39, 512, 1024 };
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// The upper half at 50% density, like game_bench
+static void Fill(SandWorld &world, int size)
+{
+    SandInit(world, size, size, SEED);
+    std::mt19937 rng(SEED);
+    for (int col = 0; col < size; col++)
+    {
+        for (int row = 0; row < size/2; row++) world.grid[col][row] = (int)(rng() & 1);
+    }
+    SandRebuildStats(world);
+}
+
+static int Bits(int block)
+{
+    return (block & 1) + ((block >> 1) & 1) + ((block >> 2) & 1) + ((block >> 3) & 1);
+}
+
+template <typename Step>
+static double TimeSteps(SandWorld &world, int steps, Step step)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++) step(world);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()/steps;
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckTable(void)
+{
+    bool conserved = true, followed = true;
+    for (int block = 0; block < 16; block++)
+    {
+        int next = SandMargolusRule(block);
+        conserved = conserved && (Bits(next) == Bits(block));
+
+        // One block alone, stepped by the kernel
+        SandWorld world;
+        SandInit(world, 2, 2, SEED);
+        world.grid[0][0] = (block & SAND_BLOCK_TL) ? 1 : 0;
+        world.grid[1][0] = (block & SAND_BLOCK_TR) ? 1 : 0;
+        world.grid[0][1] = (block & SAND_BLOCK_BL) ? 1 : 0;
+        world.grid[1][1] = (block & SAND_BLOCK_BR) ? 1 : 0;
+        SandRebuildStats(world);
+        SandStepMargolus(world);
+        int stepped = world.grid[0][0]*SAND_BLOCK_TL + world.grid[1][0]*SAND_BLOCK_TR +
+                      world.grid[0][1]*SAND_BLOCK_BL + world.grid[1][1]*SAND_BLOCK_BR;
+        followed = followed && (stepped == next);
+    }
+    BenchCheck(conserved, "every table entry keeps its grains");
+    BenchCheck(followed, "the kernel follows the table");
+    BenchCheck(SandMargolusRule(SAND_BLOCK_TL) == SAND_BLOCK_BL, "a lone grain falls");
+    BenchCheck(SandMargolusRule(SAND_BLOCK_TL | SAND_BLOCK_BL) == (SAND_BLOCK_BL | SAND_BLOCK_BR), "a full column topples");
+}
+
+static void CheckMass(void)
+{
+    SandWorld margolus, scan;
+    Fill(margolus, MASS_SIZE);
+    Fill(scan, MASS_SIZE);
+    int start = SandCount(margolus);
+
+    bool kept = true;
+    for (int step = 0; step < MASS_STEPS; step++)
+    {
+        SandStepMargolus(margolus);
+        SandStep(scan);
+        kept = kept && (SandCount(margolus) == start);
+    }
+    BenchCheck(kept, "Margolus keeps every grain on every step");
+
+    // Settled: the bottom row is full under a pile this tall
+    bool bottomFull = true;
+    for (int col = 0; col < MASS_SIZE; col++) bottomFull = bottomFull && (margolus.grid[col][MASS_SIZE - 1] == 1);
+    BenchCheck(bottomFull, "Margolus pile reaches the floor everywhere");
+
+    int lost = start - SandCount(scan);
+    printf("mass over %d steps on %dx%d: %d grains; Margolus keeps %d, column scan keeps %d (%d lost, %.2f%%)\n",
+           MASS_STEPS, MASS_SIZE, MASS_SIZE, start, SandCount(margolus), SandCount(scan), lost, 100.0*lost/start);
+}
+
+static void CheckThreads(void)
+{
+    // Worker counts the steps take turns on, none for the plain loop
+    const int workerCounts[] = { 0, 1, 2, 3, 4, 7 };
+    const int systemCount = (int)(sizeof(workerCounts)/sizeof(workerCounts[0]));
+    JobSystem systems[systemCount];
+    for (int i = 1; i < systemCount; i++) JobSystemInit(&systems[i], workerCounts[i]);
+
+    SandWorld serial, split;
+    Fill(serial, MASS_SIZE*2 + 3);           // Odd size: both offsets cut a block at the border
+    Fill(split, MASS_SIZE*2 + 3);
+    for (int step = 0; step < THREAD_STEPS; step++)
+    {
+        int system = step % systemCount;
+        SandStepMargolus(serial);
+        SandStepMargolus(split, (system == 0) ? nullptr : &systems[system]);
+    }
+    BenchCheck(serial.grid == split.grid, "the job system does not change the grid");
+    for (int i = 1; i < systemCount; i++) JobSystemShutdown(&systems[i]);
+}
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeRules(void)
+{
+    JobSystem jobs;
+    JobSystemInit(&jobs, 0);
+    int threads = jobs.workerCount;
+
+    printf("\n%8s %14s %14s %18s\n", "grid", "scan ms/step", "margolus", "margolus on jobs");
+    for (int size : TIMING_SIZES)
+    {
+        int steps = (size < 100) ? 5000 : (size < 600) ? 100 : 30;
+        SandWorld world;
+
+        Fill(world, size);
+        double scanMs = TimeSteps(world, steps, [](SandWorld &w) { SandStep(w); });
+        Fill(world, size);
+        double margolusMs = TimeSteps(world, steps, [](SandWorld &w) { SandStepMargolus(w); });
+        Fill(world, size);
+        double threadedMs = TimeSteps(world, steps, [&jobs](SandWorld &w) { SandStepMargolus(w, &jobs); });
+
+        printf("%4dx%-4d %14.4f %8.4f (%.1fx) %10.4f (%d, %.1fx)\n", size, size, scanMs, margolusMs, scanMs/margolusMs,
+               threadedMs, threads, scanMs/threadedMs);
+    }
+    JobSystemShutdown(&jobs);
+}
+
+int main(void)
+{
+    CheckTable();
+    CheckMass();
+    CheckThreads();
+    TimeRules();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: Margolus rule conserves mass and is independent of the job system\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,263 @@
+// sand_heat_bench.cpp
+// The heat field over the sand grid. Checks that the SSE and AVX2 stencils give the
+// scalar kernel's bits on grids that do not fill whole vectors, that an ambient field
+// stays put and heat leaks out at the border, that sand melts and sets at its
+// thresholds with the load above it, and that the field updating as a job while the
+// sand steps on the same job system gives the serial result. Then times the field update per cell with
+// each kernel, and the sand step with and without the field beside it.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -pthread -ffp-contract=off -Isrc -I../common -I../bench bench/sand_heat_bench.cpp ../bench/bench_suite.cpp src/sand.cpp src/sand_heat.cpp
+//       ../common/job_system.cpp -o sand_heat_bench
+#include "sand.h"
+#include "sand_heat.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240614;
+constexpr int CHECK_COLS = 77;
+constexpr int CHECK_ROWS = 203;                 // Not a multiple of 4 or 8
+constexpr int CHECK_ITERATIONS = 300;
+constexpr int TIMING_SIZES[] = { 256, 1024, 2048 };
+constexpr int PARALLEL_SIZE = 1024;
+constexpr int PARALLEL_STEPS = 40;
+const char *KERNEL_NAMES[] = { "scalar", "SSE", "AVX2" };
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Lower half at 50% density, hot spots scattered over the field
+static void Setup(SandWorld &world, SandHeat &heat, int numCols, int numRows)
+{
+    SandInit(world, numCols, numRows, SEED);
+    std::mt19937 rng(SEED);
+    for (int col = 0; col < numCols; col++)
+    {
+        for (int row = numRows/2; row < numRows; row++) world.grid[col][row] = (int)(rng() & 1);
+    }
+    SandRebuildStats(world);
+
+    SandHeatInit(heat, numCols, numRows);
+    for (int spot = 0; spot < 12; spot++)
+    {
+        SandHeatAdd(heat, (int)(rng() % numCols), (int)(rng() % numRows), 1 + (int)(rng() % 6), 500.0f + (float)(rng() % 2500));
+    }
+    SandHeatSync(heat, world);
+}
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The game's heat job: one field update
+static void HeatJob(void *user, int, int)
+{
+    SandHeatStep(*(SandHeat *)user, 1);
+}
+
+// Queues the field update, steps the sand on the same workers and waits for both
+static void StepBeside(JobSystem *jobs, SandWorld &world, SandHeat &heat)
+{
+    JobTask task;
+    JobCounter done;
+    SandHeatSync(heat, world);
+    JobTaskInit(&task, HeatJob, &heat, 0, 1, 1);
+    JobSystemRun(jobs, &task, 1, &done);
+    SandStepMargolus(world, jobs);
+    JobSystemWait(jobs, &done);
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckKernels(int best)
+{
+    SandWorld world;
+    SandHeat reference;
+    Setup(world, reference, CHECK_COLS, CHECK_ROWS);
+    SandHeat start = reference;
+    reference.kernel = SAND_HEAT_SCALAR;
+    SandHeatStep(reference, CHECK_ITERATIONS);
+
+    for (int kernel = SAND_HEAT_SSE; kernel <= best; kernel++)
+    {
+        SandHeat heat = start;
+        heat.kernel = kernel;
+        SandHeatStep(heat, CHECK_ITERATIONS);
+        char what[64];
+        snprintf(what, sizeof(what), "%s gives the scalar kernel's bits", KERNEL_NAMES[kernel]);
+        BenchCheck(heat.temperature == reference.temperature && heat.molten == reference.molten, what);
+    }
+}
+
+static void CheckField(void)
+{
+    SandWorld world;
+    SandInit(world, CHECK_COLS, CHECK_ROWS, SEED);
+    SandHeat heat;
+    SandHeatInit(heat, CHECK_COLS, CHECK_ROWS);
+    SandHeatSync(heat, world);
+    SandHeatStep(heat, 50);
+    bool ambient = true;
+    for (float t : heat.temperature) ambient = ambient && (t == SAND_AMBIENT_TEMPERATURE);
+    BenchCheck(ambient, "an ambient field stays ambient");
+
+    // A hot spot spreads evenly, then leaks out at the border
+    SandHeatAdd(heat, CHECK_COLS/2, CHECK_ROWS/2, 0, 10000.0f);
+    SandHeatStep(heat, 20);
+    float left = SandHeatAt(heat, CHECK_COLS/2 - 3, CHECK_ROWS/2), right = SandHeatAt(heat, CHECK_COLS/2 + 3, CHECK_ROWS/2);
+    float up = SandHeatAt(heat, CHECK_COLS/2, CHECK_ROWS/2 - 3), down = SandHeatAt(heat, CHECK_COLS/2, CHECK_ROWS/2 + 3);
+    BenchCheck(left == right && up == down && left == up && left > SAND_AMBIENT_TEMPERATURE, "heat spreads evenly in air");
+    double before = 0, after = 0;
+    for (float t : heat.temperature) before += t - SAND_AMBIENT_TEMPERATURE;
+    SandHeatStep(heat, 20000);
+    for (float t : heat.temperature) after += t - SAND_AMBIENT_TEMPERATURE;
+    BenchCheck(after < 0.5*before, "heat leaks out at the border");
+}
+
+static void CheckPhases(void)
+{
+    // A column of sand, full from row 20 down
+    SandWorld world;
+    SandInit(world, 9, 60, SEED);
+    for (int col = 0; col < 9; col++)
+    {
+        for (int row = 20; row < 60; row++) world.grid[col][row] = 1;
+    }
+    SandRebuildStats(world);
+    SandHeat heat;
+    SandHeatInit(heat, 9, 60);
+    SandHeatSync(heat, world);
+
+    // Hot enough at the surface, not under 30 grains
+    for (float &t : heat.temperature) t = SAND_MELT_TEMPERATURE + 10.0f;
+    SandHeatStep(heat, 1);
+    BenchCheck(SandHeatMolten(heat, 4, 20), "sand at the surface melts");
+    BenchCheck(!SandHeatMolten(heat, 4, 50), "the load above keeps deep sand solid");
+    BenchCheck(!SandHeatMolten(heat, 4, 5), "air does not melt");
+
+    // Between the thresholds nothing changes, below them it sets
+    for (float &t : heat.temperature) t = SAND_SOLIDIFY_TEMPERATURE + 10.0f;
+    SandHeatStep(heat, 1);
+    BenchCheck(SandHeatMolten(heat, 4, 20), "molten sand stays molten above the setting point");
+    for (float &t : heat.temperature) t = SAND_SOLIDIFY_TEMPERATURE - 10.0f;
+    SandHeatStep(heat, 1);
+    BenchCheck(!SandHeatMolten(heat, 4, 20), "molten sand sets below it");
+}
+
+static void CheckParallel(void)
+{
+    SandWorld serialWorld, parallelWorld;
+    SandHeat serialHeat, parallelHeat;
+    Setup(serialWorld, serialHeat, 301, 299);
+    Setup(parallelWorld, parallelHeat, 301, 299);
+    JobSystem jobs;
+    JobSystemInit(&jobs, 3);
+
+    for (int step = 0; step < 60; step++)
+    {
+        if (step % 4 == 0)
+        {
+            SandHeatSync(serialHeat, serialWorld);
+            SandHeatStep(serialHeat, 1);
+        }
+        SandStepMargolus(serialWorld);
+
+        if (step % 4 == 0) StepBeside(&jobs, parallelWorld, parallelHeat);
+        else SandStepMargolus(parallelWorld, &jobs);
+    }
+    JobSystemShutdown(&jobs);
+    BenchCheck(serialWorld.grid == parallelWorld.grid && serialHeat.temperature == parallelHeat.temperature &&
+          serialHeat.molten == parallelHeat.molten, "the field as a job beside the step gives the serial result");
+}
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeKernels(int best)
+{
+    printf("\n%10s", "ns/cell");
+    for (int kernel = SAND_HEAT_SCALAR; kernel <= best; kernel++) printf(" %10s", KERNEL_NAMES[kernel]);
+    printf("\n");
+    for (int size : TIMING_SIZES)
+    {
+        SandWorld world;
+        SandHeat start;
+        Setup(world, start, size, size);
+        int iterations = (int)(200LL*1024*1024/((long long)size*size)) + 1;
+
+        printf("%4dx%-5d", size, size);
+        double scalarNs = 0;
+        for (int kernel = SAND_HEAT_SCALAR; kernel <= best; kernel++)
+        {
+            SandHeat heat = start;
+            heat.kernel = kernel;
+            SandHeatStep(heat, 1);                  // Warm the caches
+            auto begin = std::chrono::steady_clock::now();
+            SandHeatStep(heat, iterations);
+            double ns = Milliseconds(begin)*1e6/((double)iterations*size*size);
+            if (kernel == SAND_HEAT_SCALAR) scalarNs = ns;
+            printf(" %10.3f", ns);
+            if (kernel != SAND_HEAT_SCALAR) printf(" (%.1fx)", scalarNs/ns);
+        }
+        printf("\n");
+    }
+}
+
+static void TimeParallel(void)
+{
+    SandWorld world;
+    SandHeat heat;
+    Setup(world, heat, PARALLEL_SIZE, PARALLEL_SIZE);
+    SandWorld start = world;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int step = 0; step < PARALLEL_STEPS; step++) SandStepMargolus(world);
+    double aloneMs = Milliseconds(begin)/PARALLEL_STEPS;
+
+    world = start;
+    begin = std::chrono::steady_clock::now();
+    for (int step = 0; step < PARALLEL_STEPS; step++)
+    {
+        SandHeatSync(heat, world);
+        SandHeatStep(heat, 1);
+        SandStepMargolus(world);
+    }
+    double serialMs = Milliseconds(begin)/PARALLEL_STEPS;
+
+    JobSystem jobs;
+    JobSystemInit(&jobs, 0);
+    world = start;
+    begin = std::chrono::steady_clock::now();
+    for (int step = 0; step < PARALLEL_STEPS; step++) StepBeside(&jobs, world, heat);
+    double parallelMs = Milliseconds(begin)/PARALLEL_STEPS;
+    int workers = jobs.workerCount;
+    JobSystemShutdown(&jobs);
+
+    printf("\nMargolus step on %dx%d: %.3f ms alone, %.3f ms with the field after it, %.3f ms with both on %d workers\n",
+           PARALLEL_SIZE, PARALLEL_SIZE, aloneMs, serialMs, parallelMs, workers);
+    printf("whole field update with sync and phase changes: %.3f ns/cell\n", (serialMs - aloneMs)*1e6/(PARALLEL_SIZE*PARALLEL_SIZE));
+}
+
+int main(void)
+{
+    int best = SandHeatBestKernel();
+    printf("best kernel on this CPU: %s\n", KERNEL_NAMES[best]);
+
+    CheckKernels(best);
+    CheckField();
+    CheckPhases();
+    CheckParallel();
+    TimeKernels(best);
+    TimeParallel();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: every stencil kernel gives the same field\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,235 @@
+// sand_history_bench.cpp
+// The sand history: keyframes every K ticks and XOR/RLE deltas between them in a ring
+// with a byte budget. Checks that every stored tick restores to the grid that was
+// recorded, in any order, that a restored world steps on exactly as before, that
+// recording after a restore branches, and that the ring stays within its budget.
+// Then reports memory per tick and scrub latency on a 1024x1024 pile, to size the
+// budget with.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -pthread -Isrc -I../common -I../bench bench/sand_history_bench.cpp ../bench/bench_suite.cpp src/sand.cpp src/sand_history.cpp
+//       ../common/frame_arena.cpp ../common/job_system.cpp -o sand_history_bench
+#include "sand.h"
+#include "sand_history.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240613;
+constexpr int CHECK_SIZE = 157;                 // Columns do not end on a byte
+constexpr int CHECK_TICKS = 300;
+constexpr int CHECK_INTERVAL = 16;
+constexpr int TIMING_SIZE = 1024;
+constexpr int TIMING_TICKS = 256;
+constexpr int SETTLE_STEPS = 1500;
+constexpr int TIMING_INTERVALS[] = { 8, 32, 128 };
+constexpr int SCRUBS = 200;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Upper part at 50% density
+static void Fill(SandWorld &world, int size, int rows)
+{
+    SandInit(world, size, size, SEED);
+    std::mt19937 rng(SEED);
+    for (int col = 0; col < size; col++)
+    {
+        for (int row = 0; row < rows; row++) world.grid[col][row] = (int)(rng() & 1);
+    }
+    SandRebuildStats(world);
+}
+
+// One tick of the game: a stream poured at the top, then either rule
+static void Tick(SandWorld &world, int tick)
+{
+    int col = world.numCols/2 + (tick % 7) - 3;
+    SandSet(world, col, 0, 1);
+    if ((tick / 40) % 2 == 0) SandStepMargolus(world);
+    else SandStep(world);
+}
+
+static bool SameWorld(const SandWorld &a, const SandWorld &b)
+{
+    return a.grid == b.grid && a.random == b.random && a.margolusPhase == b.margolusPhase && a.top == b.top;
+}
+
+static double Percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    return values[(size_t)(p*(values.size() - 1))];
+}
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckRestore(void)
+{
+    SandWorld world, restored;
+    Fill(world, CHECK_SIZE, CHECK_SIZE/2);
+    SandHistory history;
+    SandHistoryInit(history, CHECK_SIZE, CHECK_SIZE, CHECK_INTERVAL, (size_t)1 << 30);
+
+    std::vector<SandWorld> recorded;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick > 0) Tick(world, tick);
+        BenchCheck(SandHistoryRecord(history, world) == tick, "ticks are numbered from 0");
+        recorded.push_back(world);
+    }
+
+    // Random jumps, then a full sweep back and forward one tick at a time
+    std::mt19937 rng(SEED);
+    bool matches = true;
+    for (int jump = 0; jump < 500; jump++)
+    {
+        int tick = (int)(rng() % CHECK_TICKS);
+        matches = matches && SandHistoryRestore(history, tick, restored) && SameWorld(restored, recorded[tick]);
+    }
+    for (int tick = CHECK_TICKS - 1; tick >= 0; tick--) matches = matches && SandHistoryRestore(history, tick, restored) && SameWorld(restored, recorded[tick]);
+    for (int tick = 0; tick < CHECK_TICKS; tick++) matches = matches && SandHistoryRestore(history, tick, restored) && SameWorld(restored, recorded[tick]);
+    BenchCheck(matches, "every tick restores to the recorded world");
+    BenchCheck(!SandHistoryRestore(history, CHECK_TICKS, restored) && !SandHistoryRestore(history, -1, restored), "ticks outside the history do not restore");
+
+    // A restored world steps on as it did, and recording from it branches
+    int from = CHECK_TICKS/2 + 3;
+    SandHistoryRestore(history, from, restored);
+    bool replays = true;
+    for (int tick = from + 1; tick < from + 60; tick++)
+    {
+        Tick(restored, tick);
+        replays = replays && SameWorld(restored, recorded[tick]);
+    }
+    BenchCheck(replays, "a restored world steps on exactly as recorded");
+
+    SandHistoryRestore(history, from, restored);
+    SandSet(restored, 3, 3, 1);
+    BenchCheck(SandHistoryRecord(history, restored) == from + 1, "recording after a restore continues from it");
+    BenchCheck(SandHistoryNewest(history) == from + 1, "the ticks after the restore are dropped");
+    SandWorld branch;
+    BenchCheck(SandHistoryRestore(history, from + 1, branch) && SameWorld(branch, restored), "the branch restores");
+    BenchCheck(SandHistoryRestore(history, from - 5, branch) && SameWorld(branch, recorded[from - 5]), "ticks before the branch still restore");
+}
+
+static void CheckBudget(void)
+{
+    SandWorld world;
+    Fill(world, CHECK_SIZE, CHECK_SIZE/2);
+    SandHistory history;
+    const size_t budget = 64*1024;
+    SandHistoryInit(history, CHECK_SIZE, CHECK_SIZE, CHECK_INTERVAL, budget);
+
+    std::vector<SandWorld> recorded;
+    bool within = true, keyed = true;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick > 0) Tick(world, tick);
+        SandHistoryRecord(history, world);
+        recorded.push_back(world);
+        within = within && (history.bytes <= budget);
+        keyed = keyed && SandHistoryFrameAt(history, 0).keyframe;
+    }
+    BenchCheck(within, "the ring stays within its byte budget");
+    BenchCheck(keyed, "the oldest stored tick is always a keyframe");
+    BenchCheck(SandHistoryOldest(history) > 0 && SandHistoryNewest(history) == CHECK_TICKS - 1, "old ticks are dropped, new ones kept");
+
+    // The kept ticks' bytes have wrapped around the store many times by now
+    SandWorld restored;
+    bool matches = true;
+    for (int tick = SandHistoryOldest(history); tick <= SandHistoryNewest(history); tick++)
+    {
+        matches = matches && SandHistoryRestore(history, tick, restored) && SameWorld(restored, recorded[tick]);
+    }
+    BenchCheck(matches, "every kept tick restores after the ring wrapped");
+}
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeHistory(const char *name, const SandWorld &initial, int interval)
+{
+    SandWorld world = initial, restored;
+    SandHistory history;
+    SandHistoryInit(history, TIMING_SIZE, TIMING_SIZE, interval, (size_t)1 << 32);
+
+    double recordMs = 0;
+    for (int tick = 0; tick < TIMING_TICKS; tick++)
+    {
+        if (tick > 0) Tick(world, tick);
+        auto start = std::chrono::steady_clock::now();
+        SandHistoryRecord(history, world);
+        recordMs += Milliseconds(start);
+    }
+
+    size_t keyBytes = 0, deltaBytes = 0;
+    int keyframes = 0;
+    for (int i = 0; i < SandHistoryFrames(history); i++)
+    {
+        const SandHistoryFrame &frame = SandHistoryFrameAt(history, i);
+        if (frame.keyframe) { keyBytes += frame.size; keyframes++; }
+        else deltaBytes += frame.size;
+    }
+    int deltas = TIMING_TICKS - keyframes;
+
+    // Scrubbing: one tick back, one tick forward, and jumps anywhere
+    std::mt19937 rng(SEED);
+    std::vector<double> back, forward, jump;
+    int tick = TIMING_TICKS - 1;
+    SandHistoryRestore(history, tick, restored);
+    for (int i = 0; i < SCRUBS; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SandHistoryRestore(history, --tick, restored);
+        back.push_back(Milliseconds(start));
+    }
+    for (int i = 0; i < SCRUBS; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SandHistoryRestore(history, ++tick, restored);
+        forward.push_back(Milliseconds(start));
+    }
+    for (int i = 0; i < SCRUBS/4; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SandHistoryRestore(history, (int)(rng() % TIMING_TICKS), restored);
+        jump.push_back(Milliseconds(start));
+    }
+
+    printf("%-10s %8d %10.1f %10.1f %12.1f %10.3f %11.2f/%-6.2f %11.2f/%-6.2f %9.2f/%-6.2f\n", name, interval,
+           keyBytes/1024.0/keyframes, deltas ? deltaBytes/1024.0/deltas : 0.0, history.bytes/1024.0/TIMING_TICKS, recordMs/TIMING_TICKS,
+           Percentile(back, 0.5), Percentile(back, 0.99), Percentile(forward, 0.5), Percentile(forward, 0.99),
+           Percentile(jump, 0.5), Percentile(jump, 0.99));
+}
+
+int main(void)
+{
+    CheckRestore();
+    CheckBudget();
+
+    printf("\n%dx%d, %d ticks; raw grid %.1f KB, packed %.1f KB\n", TIMING_SIZE, TIMING_SIZE, TIMING_TICKS,
+           TIMING_SIZE*TIMING_SIZE*sizeof(int)/1024.0, TIMING_SIZE*TIMING_SIZE/8/1024.0);
+    printf("%-10s %8s %10s %10s %12s %10s %18s %18s %16s\n", "world", "interval", "key KB", "delta KB", "KB per tick", "record ms",
+           "back ms p50/p99", "fwd ms p50/p99", "jump p50/p99");
+    // A half-full grid collapsing, where every tick moves most grains, and a settled
+    // bed under a poured stream, where a tick moves a few
+    SandWorld collapsing, settled;
+    Fill(collapsing, TIMING_SIZE, TIMING_SIZE/2);
+    Fill(settled, TIMING_SIZE, TIMING_SIZE/4);
+    for (int step = 0; step < SETTLE_STEPS; step++) SandStepMargolus(settled);
+    for (int interval : TIMING_INTERVALS) TimeHistory("collapsing", collapsing, interval);
+    for (int interval : TIMING_INTERVALS) TimeHistory("settled", settled, interval);
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: every stored tick restores exactly and the ring keeps its budget\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+// sand_stats_bench.cpp
+// The per-column tops, chunk counts and summed-area table that SandWorld keeps next to
+// its grid. Checks that the steps which skip the air above the tops give the same grid
+// as a full scan, that the statistics match a recount after steps and mouse edits, and
+// that region queries match a brute-force count. Then times the step on sparse and
+// dense worlds against the full scan, and region queries against scanning the cells.
+// Build from the project folder:
+//   g++ -O3 -std=c++14 -pthread -Isrc -I../common -I../bench bench/sand_stats_bench.cpp ../bench/bench_suite.cpp src/sand.cpp ../common/job_system.cpp -o sand_stats_bench
+#include "sand.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t SEED = 20240612;
+constexpr int CHECK_SIZE = 203;             // Not a multiple of SAND_CHUNK
+constexpr int CHECK_STEPS = 400;
+constexpr int EDITS_PER_STEP = 40;
+constexpr int QUERIES = 2000;
+constexpr int TIMING_SIZE = 1024;
+constexpr int TIMING_STEPS = 30;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// SandStep before the statistics: every cell of every column, the same RNG order
+static void ReferenceStep(SandWorld &world)
+{
+    const int numCols = world.numCols, numRows = world.numRows;
+    std::vector<std::vector<int>> next(numCols, std::vector<int>(numRows, 0));
+    for (int i = 0; i < numCols; i++)
+    {
+        for (int j = numRows - 1; j >= 0; j--)
+        {
+            if (world.grid[i][j] != 1) continue;
+            if (j + 1 >= numRows) { next[i][j] = 1; continue; }
+
+            int below = world.grid[i][j + 1];
+            int belowA = (i - 1 >= 0) ? world.grid[i - 1][j + 1] : 1;
+            int belowB = (i + 1 < numCols) ? world.grid[i + 1][j + 1] : 1;
+            if (below == 0) next[i][j + 1] = 1;
+            else if (belowA == 0 && belowB == 0)
+            {
+                uint32_t &state = world.random;
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                int rand = (int)(state >> 31);
+                if (rand == 0 && i - 1 >= 0) next[i - 1][j + 1] = 1;
+                else if (i + 1 < numCols) next[i + 1][j + 1] = 1;
+                else next[i][j] = 1;
+            }
+            else if (belowA == 0 && i - 1 >= 0) next[i - 1][j + 1] = 1;
+            else if (belowB == 0 && i + 1 < numCols) next[i + 1][j + 1] = 1;
+            else next[i][j] = 1;
+        }
+    }
+    world.grid.swap(next);
+}
+
+// Random grains in a rectangle of the grid
+static void Scatter(SandWorld &world, int col, int row, int width, int height, std::mt19937 &rng)
+{
+    for (int i = col; i < col + width; i++)
+    {
+        for (int j = row; j < row + height; j++) world.grid[i][j] = (int)(rng() & 1);
+    }
+    SandRebuildStats(world);
+}
+
+static int BruteCount(const SandWorld &world, int col, int row, int width, int height)
+{
+    int count = 0;
+    for (int i = std::max(col, 0); i < std::min(col + width, world.numCols); i++)
+    {
+        for (int j = std::max(row, 0); j < std::min(row + height, world.numRows); j++) count += world.grid[i][j];
+    }
+    return count;
+}
+
+// The statistics recounted from the grid alone
+static bool StatsMatch(const SandWorld &world)
+{
+    SandWorld fresh;
+    fresh.numCols = world.numCols;
+    fresh.numRows = world.numRows;
+    fresh.grid = world.grid;
+    fresh.nextGrid = world.grid;
+    SandRebuildStats(fresh);
+    return fresh.top == world.top && fresh.chunkCounts == world.chunkCounts;
+}
+
+template <typename Step>
+static double TimeSteps(SandWorld &world, int steps, Step step)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++) step(world);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()/steps;
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static void CheckStepMatchesReference(void)
+{
+    SandWorld world, reference;
+    std::mt19937 rng(SEED);
+    SandInit(world, CHECK_SIZE, CHECK_SIZE, SEED);
+    Scatter(world, 0, 0, CHECK_SIZE, CHECK_SIZE/2, rng);
+    reference = world;
+
+    bool same = true;
+    for (int step = 0; step < CHECK_STEPS && same; step++)
+    {
+        SandStep(world);
+        ReferenceStep(reference);
+        same = (world.grid == reference.grid) && (world.random == reference.random);
+    }
+    BenchCheck(same, "SandStep gives the full scan's grid on every step");
+}
+
+static void CheckStatsStayInSync(void)
+{
+    SandWorld world;
+    std::mt19937 rng(SEED + 1);
+    SandInit(world, CHECK_SIZE, CHECK_SIZE, SEED);
+    JobSystem systems[3];
+    for (int i = 0; i < 3; i++) JobSystemInit(&systems[i], 1 + i);
+    Scatter(world, 40, 10, 60, 30, rng);
+
+    bool synced = true, counted = true, pileMatches = true;
+    for (int step = 0; step < CHECK_STEPS; step++)
+    {
+        // Mouse-style edits: mostly drawing, some erasing
+        for (int edit = 0; edit < EDITS_PER_STEP; edit++)
+        {
+            int col = (int)(rng() % CHECK_SIZE), row = (int)(rng() % CHECK_SIZE);
+            SandSet(world, col, row, (rng() % 4 != 0) ? 1 : 0);
+        }
+        if (step % 2 == 0) SandStep(world);
+        else SandStepMargolus(world, &systems[step % 3]);
+
+        synced = synced && StatsMatch(world);
+        int chunkTotal = 0;
+        for (int count : world.chunkCounts) chunkTotal += count;
+        counted = counted && (chunkTotal == SandCount(world));
+
+        int tallest = 0;
+        for (int col = 0; col < CHECK_SIZE; col++)
+        {
+            int height = 0;
+            for (int row = 0; row < CHECK_SIZE; row++) if (world.grid[col][row] == 1) { height = CHECK_SIZE - row; break; }
+            tallest = std::max(tallest, height);
+            pileMatches = pileMatches && (SandColumnHeight(world, col) == height);
+        }
+        pileMatches = pileMatches && (SandPileHeight(world) == tallest);
+    }
+    BenchCheck(synced, "tops and chunk counts match a recount after steps and edits");
+    BenchCheck(counted, "chunk counts add up to the grain count");
+    BenchCheck(pileMatches, "column and pile heights match the grid");
+    for (JobSystem &system : systems) JobSystemShutdown(&system);
+}
+
+static void CheckRegions(void)
+{
+    SandWorld world;
+    std::mt19937 rng(SEED + 2);
+    SandInit(world, CHECK_SIZE, CHECK_SIZE, SEED);
+    Scatter(world, 0, CHECK_SIZE/3, CHECK_SIZE, CHECK_SIZE - CHECK_SIZE/3, rng);
+
+    bool matches = true;
+    for (int query = 0; query < QUERIES; query++)
+    {
+        // Some rectangles hang over the border
+        int col = (int)(rng() % (CHECK_SIZE + 20)) - 10, row = (int)(rng() % (CHECK_SIZE + 20)) - 10;
+        int width = (int)(rng() % 80), height = (int)(rng() % 80);
+        matches = matches && (SandRegionCount(world, col, row, width, height) == BruteCount(world, col, row, width, height));
+
+        // The table rebuilds after a change
+        if (query % 50 == 0)
+        {
+            SandSet(world, (int)(rng() % CHECK_SIZE), (int)(rng() % CHECK_SIZE), (int)(rng() & 1));
+            SandStep(world);
+        }
+    }
+    BenchCheck(matches, "region counts match a brute-force count");
+    BenchCheck(SandRegionCount(world, 0, 0, CHECK_SIZE, CHECK_SIZE) == SandCount(world), "the whole grid counts every grain");
+    BenchCheck(SandChunkCount(world, -1, 0) == 0 && SandChunkCount(world, 0, world.chunkRows) == 0, "chunks outside the grid are empty");
+}
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeWorld(const char *name, int clumpSize)
+{
+    SandWorld start;
+    std::mt19937 rng(SEED + 3);
+    SandInit(start, TIMING_SIZE, TIMING_SIZE, SEED);
+    Scatter(start, (TIMING_SIZE - clumpSize)/2, 0, clumpSize, clumpSize, rng);
+
+    SandWorld world = start;
+    double fullMs = TimeSteps(world, TIMING_STEPS, ReferenceStep);
+    world = start;
+    double skipMs = TimeSteps(world, TIMING_STEPS, [](SandWorld &w) { SandStep(w); });
+    printf("%-24s %12.3f %12.3f %8.1fx\n", name, fullMs, skipMs, fullMs/skipMs);
+}
+
+static void TimeQueries(void)
+{
+    SandWorld world;
+    std::mt19937 rng(SEED + 4);
+    SandInit(world, TIMING_SIZE, TIMING_SIZE, SEED);
+    Scatter(world, 0, TIMING_SIZE/2, TIMING_SIZE, TIMING_SIZE/2, rng);
+
+    std::vector<int> rects(4*QUERIES);
+    for (int &value : rects) value = (int)(rng() % (TIMING_SIZE/2));
+
+    auto start = std::chrono::steady_clock::now();
+    long long scanned = 0;
+    for (int q = 0; q < QUERIES; q++) scanned += BruteCount(world, rects[4*q], rects[4*q + 1], rects[4*q + 2], rects[4*q + 3]);
+    double scanUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()/QUERIES;
+
+    start = std::chrono::steady_clock::now();
+    SandRegionCount(world, 0, 0, 1, 1);             // Builds the table
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    long long summed = 0;
+    for (int q = 0; q < QUERIES; q++) summed += SandRegionCount(world, rects[4*q], rects[4*q + 1], rects[4*q + 2], rects[4*q + 3]);
+    double tableUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()/QUERIES;
+
+    BenchCheck(scanned == summed, "timed region counts agree");
+    printf("\nregion query on %dx%d: scan %.2f us, table %.4f us (table build %.2f ms)\n",
+           TIMING_SIZE, TIMING_SIZE, scanUs, tableUs, buildMs);
+}
+
+int main(void)
+{
+    CheckStepMatchesReference();
+    CheckStatsStayInSync();
+    CheckRegions();
+
+    printf("\n%-24s %12s %12s %9s\n", "SandStep ms/step", "full scan", "skip air", "speedup");
+    TimeWorld("sparse (64x64 clump)", 64);
+    TimeWorld("512x512 clump", TIMING_SIZE/2);
+    TimeWorld("full grid", TIMING_SIZE);
+    TimeQueries();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("\nOK: sand statistics stay in sync with the grid\n");
+    return EXIT_SUCCESS;
+}
@@ -1,106 +1,161 @@
 #include "raylib.h"
+#include "sprite_batch.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include "sand.h"
+#include "sand_history.h"
+#include "sand_heat.h"
 #include <vector>
 #include <cstring>
+#include <algorithm>
 
 using namespace std;
 
 const int numRows = 39;
 const int numCols = 39;
+const int heatTicks = 4;        // The heat field updates every this many ticks
 
 const Color sand = { 194, 178, 128, 255 };
 const Color darkGrey = {26, 31, 40, 255};
 const Color lightBlue = {59, 85, 162, 255};
+const Color glow = {255, 90, 20, 255};
+const Color molten = {255, 170, 60, 255};
+
+// A JobFunc running one heat field update
+static void HeatJob(void* user, int, int) {
+    SandHeatStep(*(SandHeat*)user, 1);
+}
 
 
-void HandleMouse(vector<vector<int>>& grid, int cellSize) {
+void HandleMouse(SandWorld& world, SandHeat& heat, int cellSize) {
+    Vector2 mousePos = GetMousePosition();
+    int col = (mousePos.x - 9) / cellSize;
+    int row = (mousePos.y - 9) / cellSize;
+    if (row < 0 || row >= numRows || col < 0 || col >= numCols) return;
     if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-        Vector2 mousePos = GetMousePosition();
-        int col = (mousePos.x - 9) / cellSize;
-        int row = (mousePos.y - 9) / cellSize;
-        if (row >= 0 && row < numRows && col >= 0 && col < numCols) {
-            grid[col][row] = 1;
-        }
+        SandSet(world, col, row, 1);
+    }
+    if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON)) {
+        SandHeatAdd(heat, col, row, 2, 200.0f);
     }
 }
 
+// Hot cells glow, molten sand glows brightest
+Color CellColor(const SandWorld& world, const SandHeat& heat, int col, int row) {
+    Color base = (world.grid[col][row] == 1) ? sand : lightBlue;
+    if (world.grid[col][row] == 1 && SandHeatMolten(heat, col, row)) return molten;
+    float amount = (SandHeatAt(heat, col, row) - 300.0f) / 1400.0f;
+    if (amount <= 0.0f) return base;
+    amount = min(amount, 1.0f);
+    return { (unsigned char)(base.r + (glow.r - base.r) * amount), (unsigned char)(base.g + (glow.g - base.g) * amount),
+             (unsigned char)(base.b + (glow.b - base.b) * amount), 255 };
+}
+
 int main(){
 
     int cellSize = 15;
 
-    vector<vector<int>> grid(numCols, vector<int>(numRows, 0));
-    
     InitWindow(600, 600, "Sand Simulation");
     SetTargetFPS(20);
+    ProfilerSetAllocCounter(AllocTrackerCount);      // Allocations per frame in the overlay
+
+    SandWorld world;
+    SandInit(world, numCols, numRows, (uint32_t)GetRandomValue(1, 0x7fffffff));
+
+    // One quad per cell, all in a single draw call
+    SpriteBatch batch;
+    SpriteBatchInit(&batch, numRows * numCols, SpriteBatchSubmitRlgl);
+
+    // M switches to the Margolus block rule, which never loses a grain
+    bool margolus = false;
+
+    // Every tick goes into the history. H pauses to scrub it with LEFT and RIGHT,
+    // H again carries on from the tick on screen.
+    SandHistory history;
+    SandHistoryInit(history, numCols, numRows, 32, 4 << 20);
+    SandHistoryRecord(history, world);
+    bool scrubbing = false;
+    int scrubTick = 0;
+
+    // The sand step and the heat field share one job system
+    JobSystem jobs;
+    JobSystemInit(&jobs, 0);
+
+    // Right mouse heats the grid. The field updates as a job while the sand steps,
+    // and is done before the next frame draws.
+    SandHeat heat;
+    SandHeatInit(heat, numCols, numRows);
+    JobTask heatTask;
+    JobCounter heatDone;
+    int tick = 0;
 
     while(WindowShouldClose() == false)
     {
+        JobSystemWait(&jobs, &heatDone);
+
         BeginDrawing();
         ClearBackground(darkGrey);
 
-        HandleMouse(grid, cellSize);
+        ProfilerUpdateKeys("sand_trace.json");
+        if(IsKeyPressed(KEY_M)) margolus = !margolus;
+        if(IsKeyPressed(KEY_H)){
+            scrubbing = !scrubbing;
+            scrubTick = SandHistoryNewest(history);
+        }
+        if(scrubbing){
+            int target = scrubTick;
+            if(IsKeyDown(KEY_LEFT)) target--;
+            if(IsKeyDown(KEY_RIGHT)) target++;
+            target = max(SandHistoryOldest(history), min(target, SandHistoryNewest(history)));
+            if(target != scrubTick){
+                PROFILE_ZONE("SandScrub");
+                SandHistoryRestore(history, target, world);
+                scrubTick = target;
+            }
+        }
+        else{
+            HandleMouse(world, heat, cellSize);
+        }
 
-        for(int i = 0; i < numCols; i++){
-            for(int j = 0; j < numRows; j++){
-                int x = i * cellSize;
-                int y = j * cellSize;
+        {
+            PROFILE_ZONE("SandDraw");
+            SpriteBatchBegin(&batch);
+            for(int i = 0; i < numCols; i++){
+                for(int j = 0; j < numRows; j++){
+                    int x = i * cellSize;
+                    int y = j * cellSize;
 
-                if(grid[i][j] == 1){
-                    DrawRectangle(x + 9, y + 9, cellSize - 1, cellSize - 1, sand);
+                    SpriteBatchRect(&batch, x + 9, y + 9, cellSize - 1, cellSize - 1, CellColor(world, heat, i, j), 0);
                 }
-                else{
-                    DrawRectangle(x + 9, y + 9, cellSize - 1, cellSize - 1, lightBlue);
-                }   
             }
+            SpriteBatchFlush(&batch);
         }
         
-        vector<vector<int>> nextGrid(numCols, vector<int>(numRows, 0));
-
-        for(int i = 0; i < numCols; i++){
-            for(int j = numRows - 1; j >= 0; j--){
-                int state = grid[i][j];
-                if(state == 1){
-                    // Check if we are not at the bottom row
-                    if(j + 1 < numRows){
-                        int below = grid[i][j + 1];
-
-                        int belowA = (i - 1 >= 0) ? grid[i - 1][j + 1] : 1;
-                        int belowB = (i + 1 < numCols) ? grid[i + 1][j + 1] : 1;
-
-                        if(below == 0){
-                            nextGrid[i][j + 1] = 1;
-                        }
-                        else if(belowA == 0 && belowB == 0){
-                            int rand = GetRandomValue(0, 1);
-                            if(rand == 0 && i - 1 >= 0){
-                                nextGrid[i - 1][j + 1] = 1;
-                            }
-                            else if(i + 1 < numCols){
-                                nextGrid[i + 1][j + 1] = 1;
-                            }
-                            else{
-                                nextGrid[i][j] = 1;
-                            }
-                        }
-                        else if(belowA == 0 && i - 1 >= 0){
-                            nextGrid[i - 1][j + 1] = 1;
-                        }
-                        else if(belowB == 0 && i + 1 < numCols){
-                            nextGrid[i + 1][j + 1] = 1;
-                        }
-                        else{
-                            nextGrid[i][j] = 1;
-                        }
-                    }
-                    else{
-                        nextGrid[i][j] = 1;
-                    }
-                }
+        if(scrubbing){
+            DrawText(TextFormat("tick %d of %d-%d", scrubTick, SandHistoryOldest(history), SandHistoryNewest(history)), 12, 12, 20, RAYWHITE);
+        }
+        else{
+            if(tick % heatTicks == 0){
+                SandHeatSync(heat, world);
+                JobTaskInit(&heatTask, HeatJob, &heat, 0, 1, 1);
+                JobSystemRun(&jobs, &heatTask, 1, &heatDone);
+            }
+            tick++;
+            {
+                PROFILE_ZONE("SandStep");
+                if(margolus) SandStepMargolus(world, &jobs);
+                else SandStep(world);
             }
+            PROFILE_ZONE("SandHistoryRecord");
+            SandHistoryRecord(history, world);
         }
-        grid = nextGrid;
 
+        ProfilerDrawOverlay(10, 10);
         EndDrawing();
+        ProfilerFrameMark();
     }
 
+    JobSystemWait(&jobs, &heatDone);
+    JobSystemShutdown(&jobs);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "sand.h"
+#include <algorithm>
+
+using namespace std;
+
+// Margolus blocks per job, 128 columns
+static const int MARGOLUS_GRAIN = 64;
+
+struct MargolusJob
+{
+    SandWorld* world;
+    int offset;
+};
+
+// xorshift32, the top bit is the coin flip
+static int RandomBit(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state >> 31;
+}
+
+void SandInit(SandWorld& world, int numCols, int numRows, uint32_t seed)
+{
+    world.numCols = numCols;
+    world.numRows = numRows;
+    world.grid.assign(numCols, vector<int>(numRows, 0));
+    world.nextGrid.assign(numCols, vector<int>(numRows, 0));
+    world.random = (seed != 0) ? seed : 1;
+    SandRebuildStats(world);
+}
+
+void SandStep(SandWorld& world)
+{
+    const int numCols = world.numCols;
+    const int numRows = world.numRows;
+    const vector<vector<int>>& grid = world.grid;
+    vector<vector<int>>& nextGrid = world.nextGrid;
+    const vector<int>& top = world.top;
+    vector<int>& nextTop = world.nextTop;
+    vector<int>& chunkCounts = world.chunkCounts;
+    const int chunkCols = world.chunkCols;
+
+    // nextGrid still holds the step before, with no grains above nextTop
+    for(int i = 0; i < numCols; i++){
+        fill(nextGrid[i].begin() + nextTop[i], nextGrid[i].end(), 0);
+        nextTop[i] = numRows;
+    }
+    fill(chunkCounts.begin(), chunkCounts.end(), 0);
+
+    auto place = [&](int col, int row){
+        int& cell = nextGrid[col][row];
+        if(cell == 1) return;
+        cell = 1;
+        if(row < nextTop[col]) nextTop[col] = row;
+        chunkCounts[(row / SAND_CHUNK) * chunkCols + col / SAND_CHUNK]++;
+    };
+
+    for(int i = 0; i < numCols; i++){
+        // Nothing to move in the air above the column's top
+        for(int j = numRows - 1; j >= top[i]; j--){
+            int state = grid[i][j];
+            if(state == 1){
+                // Check if we are not at the bottom row
+                if(j + 1 < numRows){
+                    int below = grid[i][j + 1];
+
+                    int belowA = (i - 1 >= 0) ? grid[i - 1][j + 1] : 1;
+                    int belowB = (i + 1 < numCols) ? grid[i + 1][j + 1] : 1;
+
+                    if(below == 0){
+                        place(i, j + 1);
+                    }
+                    else if(belowA == 0 && belowB == 0){
+                        int rand = RandomBit(world.random);
+                        if(rand == 0 && i - 1 >= 0){
+                            place(i - 1, j + 1);
+                        }
+                        else if(i + 1 < numCols){
+                            place(i + 1, j + 1);
+                        }
+                        else{
+                            place(i, j);
+                        }
+                    }
+                    else if(belowA == 0 && i - 1 >= 0){
+                        place(i - 1, j + 1);
+                    }
+                    else if(belowB == 0 && i + 1 < numCols){
+                        place(i + 1, j + 1);
+                    }
+                    else{
+                        place(i, j);
+                    }
+                }
+                else{
+                    place(i, j);
+                }
+            }
+        }
+    }
+    world.grid.swap(world.nextGrid);
+    world.top.swap(world.nextTop);
+    world.summedAreaDirty = true;
+}
+
+// Whole blocks with their left column in [firstCol, endCol), from the first block row
+// that holds a grain. The table's rule in bit operations, without branches or
+// lookups, so the row loop vectorizes: a grain falls into an empty cell below, then a
+// grain on a full column topples into the empty column beside it.
+static void MargolusColumns(SandWorld& world, int firstCol, int endCol, int offset)
+{
+    const int numRows = world.numRows;
+    for(int i = firstCol; i < endCol; i += 2){
+        int firstRow = min(world.top[i], world.top[i + 1]) - 1;
+        if(((firstRow - offset) & 1) != 0) firstRow++;
+        if(firstRow < offset) firstRow = offset;
+
+        int* left = world.grid[i].data();
+        int* right = world.grid[i + 1].data();
+        for(int j = firstRow; j < numRows - 1; j += 2){
+            int tl = left[j], tr = right[j], bl = left[j + 1], br = right[j + 1];
+            int tlFell = tl & bl, blFell = tl | bl;
+            int trFell = tr & br, brFell = tr | br;
+            int toppleLeft = tlFell & (brFell ^ 1);
+            int toppleRight = trFell & (blFell ^ 1);
+            left[j] = tlFell ^ toppleLeft;
+            right[j] = trFell ^ toppleRight;
+            left[j + 1] = blFell | toppleRight;
+            right[j + 1] = brFell | toppleLeft;
+        }
+    }
+}
+
+// Blocks [begin, end) of a JobParallelFor
+static void MargolusBlocks(void* user, int begin, int end)
+{
+    MargolusJob* job = (MargolusJob*)user;
+    MargolusColumns(*job->world, job->offset + begin * 2, job->offset + end * 2, job->offset);
+}
+
+// Grains only fall or topple one column over, so a column's new top is at or below
+// the old tops around it. Counts from there down, chunk segment by chunk segment.
+static void MargolusRecount(SandWorld& world)
+{
+    const int numCols = world.numCols;
+    const int numRows = world.numRows;
+    fill(world.chunkCounts.begin(), world.chunkCounts.end(), 0);
+
+    int leftTop = numRows;
+    for(int i = 0; i < numCols; i++){
+        int oldTop = world.top[i];
+        int rightTop = (i + 1 < numCols) ? world.top[i + 1] : numRows;
+        int bound = min(oldTop, min(leftTop, rightTop));
+        leftTop = oldTop;
+
+        const int* column = world.grid[i].data();
+        int newTop = (int)(find(column + bound, column + numRows, 1) - column);
+        world.top[i] = newTop;
+        for(int chunkRow = newTop / SAND_CHUNK; chunkRow < world.chunkRows; chunkRow++){
+            int first = max(newTop, chunkRow * SAND_CHUNK);
+            int end = min(numRows, (chunkRow + 1) * SAND_CHUNK);
+            int count = 0;
+            for(int j = first; j < end; j++) count += column[j];
+            world.chunkCounts[chunkRow * world.chunkCols + i / SAND_CHUNK] += count;
+        }
+    }
+}
+
+void SandStepMargolus(SandWorld& world, JobSystem* jobs)
+{
+    const int offset = world.margolusPhase;
+    world.margolusPhase ^= 1;
+
+    // Left columns of the whole blocks: offset, offset + 2, ... up to numCols - 2
+    int blockCount = (world.numCols - offset) / 2;
+    if(blockCount <= 0) return;
+    if(jobs == nullptr){
+        MargolusColumns(world, offset, offset + blockCount * 2, offset);
+    }
+    else{
+        MargolusJob job = { &world, offset };
+        JobParallelFor(jobs, blockCount, MARGOLUS_GRAIN, MargolusBlocks, &job);
+    }
+
+    MargolusRecount(world);
+    world.summedAreaDirty = true;
+}
+
+int SandMargolusRule(int block)
+{
+    bool tl = block & SAND_BLOCK_TL, tr = block & SAND_BLOCK_TR, bl = block & SAND_BLOCK_BL, br = block & SAND_BLOCK_BR;
+    if(tl && !bl){ tl = false; bl = true; }
+    if(tr && !br){ tr = false; br = true; }
+    if(tl && bl && !tr && !br){ tl = false; br = true; }
+    else if(tr && br && !tl && !bl){ tr = false; bl = true; }
+    return (tl ? SAND_BLOCK_TL : 0) | (tr ? SAND_BLOCK_TR : 0) | (bl ? SAND_BLOCK_BL : 0) | (br ? SAND_BLOCK_BR : 0);
+}
+
+int SandCount(const SandWorld& world)
+{
+    int count = 0;
+    for(const vector<int>& column : world.grid){
+        count += (int)std::count(column.begin(), column.end(), 1);
+    }
+    return count;
+}
+
+void SandSet(SandWorld& world, int col, int row, int value)
+{
+    if(col < 0 || col >= world.numCols || row < 0 || row >= world.numRows) return;
+    value = (value != 0) ? 1 : 0;
+    int& cell = world.grid[col][row];
+    if(cell == value) return;
+    cell = value;
+
+    world.chunkCounts[(row / SAND_CHUNK) * world.chunkCols + col / SAND_CHUNK] += value ? 1 : -1;
+    vector<int>& column = world.grid[col];
+    if(value == 1 && row < world.top[col]){
+        world.top[col] = row;
+    }
+    else if(value == 0 && row == world.top[col]){
+        world.top[col] = (int)(find(column.begin() + row, column.end(), 1) - column.begin());
+    }
+    world.summedAreaDirty = true;
+}
+
+void SandRebuildStats(SandWorld& world)
+{
+    const int numCols = world.numCols;
+    const int numRows = world.numRows;
+    world.chunkCols = (numCols + SAND_CHUNK - 1) / SAND_CHUNK;
+    world.chunkRows = (numRows + SAND_CHUNK - 1) / SAND_CHUNK;
+    world.chunkCounts.assign(world.chunkCols * world.chunkRows, 0);
+    world.top.assign(numCols, numRows);
+    world.nextTop.assign(numCols, numRows);
+
+    for(int i = 0; i < numCols; i++){
+        fill(world.nextGrid[i].begin(), world.nextGrid[i].end(), 0);
+        for(int j = numRows - 1; j >= 0; j--){
+            if(world.grid[i][j] == 1){
+                world.top[i] = j;
+                world.chunkCounts[(j / SAND_CHUNK) * world.chunkCols + i / SAND_CHUNK]++;
+            }
+        }
+    }
+    world.summedAreaDirty = true;
+}
+
+int SandColumnHeight(const SandWorld& world, int col)
+{
+    if(col < 0 || col >= world.numCols) return 0;
+    return world.numRows - world.top[col];
+}
+
+int SandPileHeight(const SandWorld& world)
+{
+    int highest = world.numRows;
+    for(int top : world.top) highest = min(highest, top);
+    return world.numRows - highest;
+}
+
+int SandChunkCount(const SandWorld& world, int chunkCol, int chunkRow)
+{
+    if(chunkCol < 0 || chunkCol >= world.chunkCols || chunkRow < 0 || chunkRow >= world.chunkRows) return 0;
+    return world.chunkCounts[chunkRow * world.chunkCols + chunkCol];
+}
+
+// summedArea[c * (numRows + 1) + r] holds the grains in columns [0, c) and rows [0, r)
+static void BuildSummedArea(SandWorld& world)
+{
+    const int numCols = world.numCols;
+    const int numRows = world.numRows;
+    const int stride = numRows + 1;
+    world.summedArea.assign((numCols + 1) * stride, 0);
+
+    for(int i = 0; i < numCols; i++){
+        const int* previous = &world.summedArea[i * stride];
+        int* current = &world.summedArea[(i + 1) * stride];
+        const vector<int>& column = world.grid[i];
+        int top = world.top[i];
+        // Air adds nothing above the top
+        for(int r = 0; r <= top; r++) current[r] = previous[r];
+        int columnSum = 0;
+        for(int r = top; r < numRows; r++){
+            columnSum += column[r];
+            current[r + 1] = previous[r + 1] + columnSum;
+        }
+    }
+    world.summedAreaDirty = false;
+}
+
+int SandRegionCount(SandWorld& world, int col, int row, int width, int height)
+{
+    int col0 = max(col, 0), row0 = max(row, 0);
+    int col1 = min(col + width, world.numCols), row1 = min(row + height, world.numRows);
+    if(col0 >= col1 || row0 >= row1) return 0;
+    if(world.summedAreaDirty) BuildSummedArea(world);
+
+    const int stride = world.numRows + 1;
+    const vector<int>& table = world.summedArea;
+    return table[col1 * stride + row1] - table[col0 * stride + row1] - table[col1 * stride + row0] + table[col0 * stride + row0];
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "job_system.h"
+
+using namespace std;
+
+// Cells of a Margolus block as bits of its index
+const int SAND_BLOCK_TL = 1;
+const int SAND_BLOCK_TR = 2;
+const int SAND_BLOCK_BL = 4;
+const int SAND_BLOCK_BR = 8;
+
+// Side of the square chunks that count their grains
+const int SAND_CHUNK = 16;
+
+// Falling sand on grid[col][row], 0 is air and 1 is sand
+struct SandWorld
+{
+    int numCols = 0;
+    int numRows = 0;
+    vector<vector<int>> grid;
+    vector<vector<int>> nextGrid;   // Written by SandStep, then swapped with grid
+    uint32_t random = 1;            // Picks a side when sand can slide both ways
+    int margolusPhase = 0;          // Block offset of the next SandStepMargolus, 0 or 1
+
+    // Kept in sync by the steps and SandSet; after writing grid directly, call
+    // SandRebuildStats. The steps skip the air above top.
+    vector<int> top;                // Row of the highest grain per column, numRows when empty
+    vector<int> nextTop;            // The same for nextGrid
+    int chunkCols = 0;
+    int chunkRows = 0;
+    vector<int> chunkCounts;        // Grains per chunk, [chunkRow * chunkCols + chunkCol]
+    vector<int> summedArea;         // (numCols + 1) x (numRows + 1), built by the first region query after a change
+    bool summedAreaDirty = true;
+};
+
+void SandInit(SandWorld& world, int numCols, int numRows, uint32_t seed);
+// Column scan into nextGrid: when two grains claim one cell, one of them is lost
+void SandStep(SandWorld& world);
+// Margolus rule: 2x2 blocks at an offset that alternates every step, each block
+// rewritten in place by SandMargolusRule. Blocks never overlap, so every grain is
+// kept and jobs split the columns without locks; with or without jobs, and on any
+// number of workers, the grid comes out the same. Cells of blocks cut by the border
+// wait for the other offset.
+void SandStepMargolus(SandWorld& world, JobSystem* jobs = nullptr);
+// The 16-entry table: next state of a block from its SAND_BLOCK_* bits
+int SandMargolusRule(int block);
+int SandCount(const SandWorld& world);
+
+// Edits that keep the statistics, and a full recount after direct grid writes
+void SandSet(SandWorld& world, int col, int row, int value);
+void SandRebuildStats(SandWorld& world);
+
+// Queries on the statistics
+int SandColumnHeight(const SandWorld& world, int col);
+int SandPileHeight(const SandWorld& world);
+int SandChunkCount(const SandWorld& world, int chunkCol, int chunkRow);
+// Grains in a rectangle of cells, O(1) once the summed-area table is current
+int SandRegionCount(SandWorld& world, int col, int row, int width, int height);
@@ -0,0 +1,216 @@
+#include "sand_heat.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SAND_HEAT_X86 1
+#endif
+
+using namespace std;
+
+// Share of the neighbours' difference a cell takes per iteration
+static const float AIR_DIFFUSIVITY = 0.05f;
+static const float SAND_DIFFUSIVITY = 0.12f;
+static const float MOLTEN_DIFFUSIVITY = 0.2f;
+
+// next = c + d * ((up + down) + (left + right) - 4c). Every kernel does these
+// operations in this order, and the file builds without FMA contraction, so they all
+// round alike.
+static inline float Diffuse(float c, float up, float down, float left, float right, float d)
+{
+    float laplacian = ((up + down) + (left + right)) - 4.0f * c;
+    return c + d * laplacian;
+}
+
+// Rows [1, numRows - 1) of one column. The reference is kept scalar so the timings
+// compare against one cell per instruction.
+#if defined(__clang__)
+static void StencilScalar(const float* t, const float* d, float* out, int numRows)
+{
+#pragma clang loop vectorize(disable)
+    for(int j = 1; j < numRows - 1; j++){
+        out[j] = Diffuse(t[j], t[j - 1], t[j + 1], t[j - numRows], t[j + numRows], d[j]);
+    }
+}
+#else
+__attribute__((optimize("no-tree-vectorize")))
+static void StencilScalar(const float* t, const float* d, float* out, int numRows)
+{
+    for(int j = 1; j < numRows - 1; j++){
+        out[j] = Diffuse(t[j], t[j - 1], t[j + 1], t[j - numRows], t[j + numRows], d[j]);
+    }
+}
+#endif
+
+#ifdef SAND_HEAT_X86
+__attribute__((target("sse2")))
+static void StencilSse(const float* t, const float* d, float* out, int numRows)
+{
+    const __m128 four = _mm_set1_ps(4.0f);
+    int j = 1;
+    for(; j + 4 <= numRows - 1; j += 4){
+        __m128 c = _mm_loadu_ps(t + j);
+        __m128 vertical = _mm_add_ps(_mm_loadu_ps(t + j - 1), _mm_loadu_ps(t + j + 1));
+        __m128 horizontal = _mm_add_ps(_mm_loadu_ps(t + j - numRows), _mm_loadu_ps(t + j + numRows));
+        __m128 laplacian = _mm_sub_ps(_mm_add_ps(vertical, horizontal), _mm_mul_ps(four, c));
+        _mm_storeu_ps(out + j, _mm_add_ps(c, _mm_mul_ps(_mm_loadu_ps(d + j), laplacian)));
+    }
+    for(; j < numRows - 1; j++){
+        out[j] = Diffuse(t[j], t[j - 1], t[j + 1], t[j - numRows], t[j + numRows], d[j]);
+    }
+}
+
+__attribute__((target("avx2")))
+static void StencilAvx2(const float* t, const float* d, float* out, int numRows)
+{
+    const __m256 four = _mm256_set1_ps(4.0f);
+    int j = 1;
+    for(; j + 8 <= numRows - 1; j += 8){
+        __m256 c = _mm256_loadu_ps(t + j);
+        __m256 vertical = _mm256_add_ps(_mm256_loadu_ps(t + j - 1), _mm256_loadu_ps(t + j + 1));
+        __m256 horizontal = _mm256_add_ps(_mm256_loadu_ps(t + j - numRows), _mm256_loadu_ps(t + j + numRows));
+        __m256 laplacian = _mm256_sub_ps(_mm256_add_ps(vertical, horizontal), _mm256_mul_ps(four, c));
+        _mm256_storeu_ps(out + j, _mm256_add_ps(c, _mm256_mul_ps(_mm256_loadu_ps(d + j), laplacian)));
+    }
+    for(; j < numRows - 1; j++){
+        out[j] = Diffuse(t[j], t[j - 1], t[j + 1], t[j - numRows], t[j + numRows], d[j]);
+    }
+}
+#endif
+
+// A cell on the border: outside the grid is ambient air
+static float DiffuseBorder(const SandHeat& heat, int col, int row)
+{
+    const int numRows = heat.numRows;
+    const float* t = heat.temperature.data();
+    int k = col * numRows + row;
+    float up = (row > 0) ? t[k - 1] : SAND_AMBIENT_TEMPERATURE;
+    float down = (row + 1 < numRows) ? t[k + 1] : SAND_AMBIENT_TEMPERATURE;
+    float left = (col > 0) ? t[k - numRows] : SAND_AMBIENT_TEMPERATURE;
+    float right = (col + 1 < heat.numCols) ? t[k + numRows] : SAND_AMBIENT_TEMPERATURE;
+    return Diffuse(t[k], up, down, left, right, heat.diffusivity[k]);
+}
+
+// Arithmetic rather than a lookup, so the loops around it vectorize
+static inline float Diffusivity(uint8_t sand, uint8_t molten)
+{
+    return AIR_DIFFUSIVITY + (float)sand * (SAND_DIFFUSIVITY - AIR_DIFFUSIVITY) + (float)molten * (MOLTEN_DIFFUSIVITY - SAND_DIFFUSIVITY);
+}
+
+void SandHeatInit(SandHeat& heat, int numCols, int numRows)
+{
+    size_t cells = (size_t)numCols * numRows;
+    heat.numCols = numCols;
+    heat.numRows = numRows;
+    heat.kernel = SandHeatBestKernel();
+    heat.temperature.assign(cells, SAND_AMBIENT_TEMPERATURE);
+    heat.nextTemperature.assign(cells, SAND_AMBIENT_TEMPERATURE);
+    heat.pressure.assign(cells, 0.0f);
+    heat.diffusivity.assign(cells, AIR_DIFFUSIVITY);
+    heat.material.assign(cells, 0);
+    heat.molten.assign(cells, 0);
+}
+
+// These passes only stream memory, so each plane is touched once per update: the sync
+// and the phase pass both leave the diffusivity current. Byte stores may alias
+// anything, so the planes are reached through local pointers.
+void SandHeatSync(SandHeat& heat, const SandWorld& world)
+{
+    const int numRows = heat.numRows;
+    for(int i = 0; i < heat.numCols; i++){
+        const int* column = world.grid[i].data();
+        uint8_t* material = &heat.material[(size_t)i * numRows];
+        const uint8_t* molten = &heat.molten[(size_t)i * numRows];
+        float* pressure = &heat.pressure[(size_t)i * numRows];
+        float* diffusivity = &heat.diffusivity[(size_t)i * numRows];
+        int above = 0;
+        for(int j = 0; j < numRows; j++){
+            uint8_t sand = (uint8_t)column[j];
+            material[j] = sand;
+            above += sand;
+            pressure[j] = (float)above;
+            diffusivity[j] = Diffusivity(sand, sand & molten[j]);
+        }
+    }
+}
+
+void SandHeatStep(SandHeat& heat, int iterations)
+{
+    const int numCols = heat.numCols;
+    const int numRows = heat.numRows;
+    const size_t cells = heat.temperature.size();
+
+    for(int iteration = 0; iteration < iterations; iteration++){
+        float* out = heat.nextTemperature.data();
+        for(int i = 0; i < numCols; i++){
+            int k = i * numRows;
+            if(i == 0 || i == numCols - 1 || numRows < 3){
+                for(int j = 0; j < numRows; j++) out[k + j] = DiffuseBorder(heat, i, j);
+                continue;
+            }
+            out[k] = DiffuseBorder(heat, i, 0);
+            out[k + numRows - 1] = DiffuseBorder(heat, i, numRows - 1);
+
+            const float* t = heat.temperature.data() + k;
+            const float* d = heat.diffusivity.data() + k;
+#ifdef SAND_HEAT_X86
+            if(heat.kernel == SAND_HEAT_AVX2) StencilAvx2(t, d, out + k, numRows);
+            else if(heat.kernel == SAND_HEAT_SSE) StencilSse(t, d, out + k, numRows);
+            else StencilScalar(t, d, out + k, numRows);
+#else
+            StencilScalar(t, d, out + k, numRows);
+#endif
+        }
+        heat.temperature.swap(heat.nextTemperature);
+    }
+
+    // Phase changes, with a gap between melting and setting so a grain at the
+    // threshold does not flicker. Branch free, material and phase are random across a pile.
+    const float* temperature = heat.temperature.data();
+    const float* pressure = heat.pressure.data();
+    const uint8_t* material = heat.material.data();
+    uint8_t* molten = heat.molten.data();
+    float* diffusivity = heat.diffusivity.data();
+    for(size_t k = 0; k < cells; k++){
+        float load = SAND_MELT_PER_GRAIN * (pressure[k] - 1.0f);
+        uint8_t melts = temperature[k] >= SAND_MELT_TEMPERATURE + load;
+        uint8_t staysMolten = temperature[k] >= SAND_SOLIDIFY_TEMPERATURE + load;
+        // Melting needs more heat than staying molten, so melts implies staysMolten
+        uint8_t phase = material[k] & (melts | (molten[k] & staysMolten));
+        molten[k] = phase;
+        diffusivity[k] = Diffusivity(material[k], phase);
+    }
+}
+
+void SandHeatAdd(SandHeat& heat, int col, int row, int radius, float amount)
+{
+    for(int i = max(col - radius, 0); i <= min(col + radius, heat.numCols - 1); i++){
+        for(int j = max(row - radius, 0); j <= min(row + radius, heat.numRows - 1); j++){
+            if((i - col) * (i - col) + (j - row) * (j - row) <= radius * radius){
+                heat.temperature[(size_t)i * heat.numRows + j] += amount;
+            }
+        }
+    }
+}
+
+float SandHeatAt(const SandHeat& heat, int col, int row)
+{
+    if(col < 0 || col >= heat.numCols || row < 0 || row >= heat.numRows) return SAND_AMBIENT_TEMPERATURE;
+    return heat.temperature[(size_t)col * heat.numRows + row];
+}
+
+bool SandHeatMolten(const SandHeat& heat, int col, int row)
+{
+    if(col < 0 || col >= heat.numCols || row < 0 || row >= heat.numRows) return false;
+    return heat.molten[(size_t)col * heat.numRows + row] != 0;
+}
+
+int SandHeatBestKernel(void)
+{
+#ifdef SAND_HEAT_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return SAND_HEAT_AVX2;
+    if(__builtin_cpu_supports("sse2")) return SAND_HEAT_SSE;
+#endif
+    return SAND_HEAT_SCALAR;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "sand.h"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Stencil kernels, all give the same bits
+const int SAND_HEAT_SCALAR = 0;
+const int SAND_HEAT_SSE = 1;            // 4 cells per instruction
+const int SAND_HEAT_AVX2 = 2;           // 8 cells per instruction
+
+const float SAND_AMBIENT_TEMPERATURE = 20.0f;     // Outside the grid, and the start
+const float SAND_MELT_TEMPERATURE = 1700.0f;      // A grain with nothing above melts here,
+const float SAND_SOLIDIFY_TEMPERATURE = 1500.0f;  // and sets again here
+const float SAND_MELT_PER_GRAIN = 0.5f;           // Both rise with every grain above
+
+// Temperature and pressure over the sand grid, as float planes laid out like the
+// grid: [col * numRows + row]. The field stays where it is when grains move.
+struct SandHeat
+{
+    int numCols = 0;
+    int numRows = 0;
+    int kernel = SAND_HEAT_SCALAR;  // The best this CPU runs, after SandHeatInit
+
+    vector<float> temperature;
+    vector<float> nextTemperature;
+    vector<float> pressure;         // Grains at and above the cell in its column
+    vector<float> diffusivity;      // Per cell from its material, at most 0.25 to stay stable
+    vector<uint8_t> material;       // The grid when SandHeatSync ran
+    vector<uint8_t> molten;         // Phase of the sand in each cell
+};
+
+void SandHeatInit(SandHeat& heat, int numCols, int numRows);
+// Takes the grid the next update works on. After this, SandHeatStep reads nothing of
+// the world, so it can run on another thread while the world steps.
+void SandHeatSync(SandHeat& heat, const SandWorld& world);
+// Diffuses the temperature with a 5-point stencil, then melts and sets the sand that
+// crossed its threshold. Call it every few ticks of the world, or every tick.
+void SandHeatStep(SandHeat& heat, int iterations = 1);
+// Adds heat (or takes it away) in a disc
+void SandHeatAdd(SandHeat& heat, int col, int row, int radius, float amount);
+float SandHeatAt(const SandHeat& heat, int col, int row);
+bool SandHeatMolten(const SandHeat& heat, int col, int row);
+// SAND_HEAT_AVX2 or SAND_HEAT_SSE when the CPU has them
+int SandHeatBestKernel(void);
@@ -0,0 +1,294 @@
+#include "sand_history.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+static void PutCount(uint8_t*& out, size_t value)
+{
+    while(value >= 0x80){
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+}
+
+static size_t GetCount(const uint8_t*& in)
+{
+    size_t value = 0;
+    int shift = 0;
+    while(*in & 0x80){
+        value |= (size_t)(*in++ & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= (size_t)(*in++) << shift;
+    return value;
+}
+
+static void Pack(SandHistory& history, const SandWorld& world, vector<uint8_t>& bits)
+{
+    const int numRows = history.numRows;
+    bits.assign((size_t)history.numCols * history.columnBytes, 0);
+    for(int i = 0; i < history.numCols; i++){
+        const int* column = world.grid[i].data();
+        uint8_t* out = &bits[(size_t)i * history.columnBytes];
+        // Air above the top packs to zero bytes already
+        for(int j = world.top[i] & ~7; j < numRows; j++){
+            out[j >> 3] |= (uint8_t)(column[j] << (j & 7));
+        }
+    }
+}
+
+static void Unpack(const SandHistory& history, const vector<uint8_t>& bits, SandWorld& world)
+{
+    for(int i = 0; i < history.numCols; i++){
+        int* column = world.grid[i].data();
+        const uint8_t* in = &bits[(size_t)i * history.columnBytes];
+        for(int j = 0; j < history.numRows; j++){
+            column[j] = (in[j >> 3] >> (j & 7)) & 1;
+        }
+    }
+}
+
+// Most bytes Encode writes for size bytes. Every run but the last takes a literal and
+// the two zeros after it, each run writes two counts of at most size.
+static size_t MaxCodedBytes(size_t size)
+{
+    size_t countBytes = 1;
+    for(size_t value = size; value >= 0x80; value >>= 7) countBytes++;
+    return size + (size / 3 + 2) * 2 * countBytes;
+}
+
+// Runs of (zero bytes, literal bytes) over bits XOR base, or the bits alone when base
+// is null. A literal ends at two zero bytes in a row. Returns the bytes written to out,
+// which has room for MaxCodedBytes.
+static size_t Encode(const uint8_t* bits, const uint8_t* base, size_t size, uint8_t* out)
+{
+    uint8_t* begin = out;
+    auto at = [&](size_t i){ return (uint8_t)(base ? bits[i] ^ base[i] : bits[i]); };
+    size_t i = 0;
+    while(i < size){
+        size_t zeroStart = i;
+        // Whole words first, most of a delta is unchanged
+        while(i + 8 <= size){
+            uint64_t a, b = 0;
+            memcpy(&a, bits + i, 8);
+            if(base) memcpy(&b, base + i, 8);
+            if(a != b) break;
+            i += 8;
+        }
+        while(i < size && at(i) == 0) i++;
+        size_t literalStart = i;
+        while(i < size && !(at(i) == 0 && (i + 1 == size || at(i + 1) == 0))) i++;
+
+        PutCount(out, literalStart - zeroStart);
+        PutCount(out, i - literalStart);
+        for(size_t k = literalStart; k < i; k++) *out++ = at(k);
+    }
+    return (size_t)(out - begin);
+}
+
+// XORs a coded frame into the bits: a delta steps them one tick either way, a
+// keyframe writes its grid over zeroed bits
+static void Apply(const SandHistory& history, const SandHistoryFrame& frame, uint8_t* bits)
+{
+    const uint8_t* in = SandHistoryFrameData(history, frame);
+    const uint8_t* end = in + frame.size;
+    size_t position = 0;
+    while(in < end){
+        position += GetCount(in);
+        size_t literals = GetCount(in);
+        for(size_t k = 0; k < literals; k++) bits[position + k] ^= in[k];
+        in += literals;
+        position += literals;
+    }
+}
+
+static SandHistoryFrame& FrameAt(SandHistory& history, int index)
+{
+    return history.frames[(history.frameFirst + index) % history.frames.size()];
+}
+
+static void CountBytes(SandHistory& history)
+{
+    history.bytes = 0;
+    if(history.frameCount > 0){
+        history.bytes = (size_t)(history.storeHead - FrameAt(history, 0).start) + history.frameCount * sizeof(SandHistoryFrame);
+    }
+}
+
+// Copies the stored frames to new rings of these sizes, oldest first
+static void Regrow(SandHistory& history, size_t frameSlots, size_t storeSize)
+{
+    vector<SandHistoryFrame> frames(frameSlots);
+    vector<uint8_t> store(storeSize);
+    uint64_t head = 0;
+    for(int k = 0; k < history.frameCount; k++){
+        SandHistoryFrame frame = FrameAt(history, k);
+        if(frame.size > 0) memcpy(&store[head], SandHistoryFrameData(history, frame), frame.size);
+        frame.start = head;
+        head += frame.size;
+        frames[k] = frame;
+    }
+    history.frames.swap(frames);
+    history.store.swap(store);
+    history.frameFirst = 0;
+    history.storeHead = head;
+    CountBytes(history);
+}
+
+static void DropOldest(SandHistory& history)
+{
+    history.frameFirst = (history.frameFirst + 1) % (int)history.frames.size();
+    history.frameCount--;
+}
+
+void SandHistoryInit(SandHistory& history, int numCols, int numRows, int keyframeInterval, size_t byteBudget)
+{
+    history.numCols = numCols;
+    history.numRows = numRows;
+    history.columnBytes = (numRows + 7) / 8;
+    history.keyframeInterval = max(keyframeInterval, 1);
+    history.byteBudget = byteBudget;
+    history.frames.assign(64, SandHistoryFrame());
+    history.frameFirst = 0;
+    history.frameCount = 0;
+    history.store.clear();
+    history.storeHead = 0;
+    history.bytes = 0;
+    history.nextTick = 0;
+    history.lastKeyframe = -1;
+    history.current.assign((size_t)numCols * history.columnBytes, 0);
+    history.currentTick = -1;
+    FrameArenaInit(&history.scratch, MaxCodedBytes(history.current.size()));
+}
+
+int SandHistoryRecord(SandHistory& history, const SandWorld& world)
+{
+    // Recording after a restore branches: the ticks after it are gone
+    if(history.frameCount > 0 && history.currentTick != SandHistoryNewest(history)){
+        while(history.frameCount > 0 && FrameAt(history, history.frameCount - 1).tick > history.currentTick){
+            history.frameCount--;
+        }
+        history.storeHead = FrameAt(history, history.frameCount - 1).start + FrameAt(history, history.frameCount - 1).size;
+        history.nextTick = history.currentTick + 1;
+        history.lastKeyframe = -1;
+        for(int k = history.frameCount - 1; k >= 0; k--){
+            if(FrameAt(history, k).keyframe){
+                history.lastKeyframe = FrameAt(history, k).tick;
+                break;
+            }
+        }
+    }
+
+    SandHistoryFrame frame;
+    frame.tick = history.nextTick++;
+    frame.keyframe = history.frameCount == 0 || frame.tick - history.lastKeyframe >= history.keyframeInterval;
+    frame.random = world.random;
+    frame.margolusPhase = world.margolusPhase;
+
+    Pack(history, world, history.packed);
+    FrameArenaReset(&history.scratch);
+    uint8_t* coded = FrameArenaArray<uint8_t>(&history.scratch, MaxCodedBytes(history.packed.size()));
+    frame.size = Encode(history.packed.data(), frame.keyframe ? nullptr : history.current.data(), history.packed.size(), coded);
+    history.current.swap(history.packed);
+    history.currentTick = frame.tick;
+    if(frame.keyframe) history.lastKeyframe = frame.tick;
+
+    // The bytes go after the newest frame's, or to the start of the store when they
+    // would wrap. The store doubles up to the budget plus the room one frame can need,
+    // or beyond while one keyframe group does not fit, and the frame ring doubles as
+    // the frames get small: neither grows once the budget is reached.
+    while(true){
+        size_t storeSize = history.store.size();
+        uint64_t start = history.storeHead;
+        if(storeSize > 0 && start % storeSize + frame.size > storeSize) start += storeSize - start % storeSize;
+        uint64_t oldest = (history.frameCount > 0) ? FrameAt(history, 0).start : start;
+        bool fits = start + frame.size - oldest <= storeSize;
+        if(fits && history.frameCount < (int)history.frames.size()){
+            frame.start = start;
+            break;
+        }
+        size_t limit = history.byteBudget + 2 * MaxCodedBytes(history.current.size());
+        size_t needed = (size_t)(start + frame.size - oldest);
+        size_t grown = fits ? storeSize : max(needed, min(max(storeSize * 2, (size_t)4096), limit));
+        size_t slots = history.frames.size() * (history.frameCount < (int)history.frames.size() ? 1 : 2);
+        Regrow(history, slots, grown);
+    }
+    if(frame.size > 0) memcpy(&history.store[frame.start % history.store.size()], coded, frame.size);
+    history.storeHead = frame.start + frame.size;
+    FrameAt(history, history.frameCount++) = frame;
+    CountBytes(history);
+
+    // Drop whole keyframe groups from the front, always keeping the newest one
+    while(history.bytes > history.byteBudget){
+        int next = 1;
+        while(next < history.frameCount && !FrameAt(history, next).keyframe) next++;
+        if(next == history.frameCount) break;
+        for(int k = 0; k < next; k++) DropOldest(history);
+        CountBytes(history);
+    }
+    return history.currentTick;
+}
+
+bool SandHistoryRestore(SandHistory& history, int tick, SandWorld& world)
+{
+    if(history.frameCount == 0 || tick < SandHistoryOldest(history) || tick > SandHistoryNewest(history)) return false;
+
+    const int first = SandHistoryOldest(history);
+    int index = tick - first;
+    int keyIndex = index;
+    while(!FrameAt(history, keyIndex).keyframe) keyIndex--;
+    int currentIndex = history.currentTick - first;
+    int nextKeyIndex = index + 1;
+    while(nextKeyIndex < history.frameCount && !FrameAt(history, nextKeyIndex).keyframe) nextKeyIndex++;
+
+    uint8_t* bits = history.current.data();
+    if(currentIndex >= keyIndex && currentIndex <= index){
+        // Forward within the group
+        for(int k = currentIndex + 1; k <= index; k++) Apply(history, FrameAt(history, k), bits);
+    }
+    else if(currentIndex > index && currentIndex < nextKeyIndex && currentIndex - index <= index - keyIndex){
+        // Backward within the group: a delta undoes itself
+        for(int k = currentIndex; k > index; k--) Apply(history, FrameAt(history, k), bits);
+    }
+    else{
+        fill(history.current.begin(), history.current.end(), 0);
+        for(int k = keyIndex; k <= index; k++) Apply(history, FrameAt(history, k), bits);
+    }
+    history.currentTick = tick;
+
+    if(world.numCols != history.numCols || world.numRows != history.numRows){
+        SandInit(world, history.numCols, history.numRows, 1);
+    }
+    Unpack(history, history.current, world);
+    world.random = FrameAt(history, index).random;
+    world.margolusPhase = FrameAt(history, index).margolusPhase;
+    SandRebuildStats(world);
+    return true;
+}
+
+int SandHistoryOldest(const SandHistory& history)
+{
+    return (history.frameCount == 0) ? -1 : SandHistoryFrameAt(history, 0).tick;
+}
+
+int SandHistoryNewest(const SandHistory& history)
+{
+    return (history.frameCount == 0) ? -1 : SandHistoryFrameAt(history, history.frameCount - 1).tick;
+}
+
+int SandHistoryFrames(const SandHistory& history)
+{
+    return history.frameCount;
+}
+
+const SandHistoryFrame& SandHistoryFrameAt(const SandHistory& history, int index)
+{
+    return history.frames[(history.frameFirst + index) % history.frames.size()];
+}
+
+const uint8_t* SandHistoryFrameData(const SandHistory& history, const SandHistoryFrame& frame)
+{
+    return history.store.data() + (history.store.empty() ? 0 : frame.start % history.store.size());
+}
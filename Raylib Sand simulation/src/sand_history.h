@@ -0,0 +1,62 @@
+#pragma once
+#include "sand.h"
+#include "frame_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// One recorded tick. Grids are packed to a bit per cell, then run-length coded:
+// a keyframe codes the bits themselves, a delta codes them XOR the tick before.
+struct SandHistoryFrame
+{
+    int tick = 0;
+    bool keyframe = false;
+    uint32_t random = 1;            // The world's RNG and Margolus offset, so a restored
+    int margolusPhase = 0;          // world steps on exactly as it did
+    uint64_t start = 0;             // Coded bytes in the store, from where the first
+    size_t size = 0;                // tick's went: the store's offset is start % its size
+};
+
+// Ring of recorded ticks within a byte budget. When it is over budget the oldest
+// keyframe goes, with the deltas that depend on it. Frames and their coded bytes sit
+// in two rings that only grow until the budget is reached, after which recording
+// allocates nothing.
+struct SandHistory
+{
+    int numCols = 0;
+    int numRows = 0;
+    int columnBytes = 0;            // Packed bytes per column, each column starts on a byte
+    int keyframeInterval = 32;
+    size_t byteBudget = 0;
+
+    vector<SandHistoryFrame> frames; // Ring of frameCount consecutive ticks from frameFirst,
+    int frameFirst = 0;              // the oldest a keyframe
+    int frameCount = 0;
+    vector<uint8_t> store;          // Coded bytes; a frame that would wrap starts over at 0
+    uint64_t storeHead = 0;         // Where the next frame's bytes go
+    size_t bytes = 0;               // Frames with their coded bytes, gaps at the wrap included
+    int nextTick = 0;
+    int lastKeyframe = -1;          // Tick of the newest keyframe
+
+    vector<uint8_t> current;        // Packed grid of currentTick, where scrubbing starts
+    int currentTick = -1;
+    vector<uint8_t> packed;         // Scratch for recording
+    FrameArena scratch;             // The coded tick, reset by every record
+};
+
+void SandHistoryInit(SandHistory& history, int numCols, int numRows, int keyframeInterval, size_t byteBudget);
+// Stores the world as the next tick and returns it. After a restore to an older tick,
+// the ticks after it are dropped first, so recording branches from there.
+int SandHistoryRecord(SandHistory& history, const SandWorld& world);
+// Puts the world back to a stored tick. Neighbouring ticks are reached by XOR-ing the
+// deltas in between into the current grid, further ones from their keyframe.
+bool SandHistoryRestore(SandHistory& history, int tick, SandWorld& world);
+
+int SandHistoryOldest(const SandHistory& history);  // -1 when empty
+int SandHistoryNewest(const SandHistory& history);
+// Stored frame index, 0 the oldest, and where its coded bytes are
+int SandHistoryFrames(const SandHistory& history);
+const SandHistoryFrame& SandHistoryFrameAt(const SandHistory& history, int index);
+const uint8_t* SandHistoryFrameData(const SandHistory& history, const SandHistoryFrame& frame);
@@ -0,0 +1,344 @@
+// bench_suite.cpp
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int BENCH_WARMUP_SAMPLES = 2;
+
+static const char *METRIC_NAMES[] = { "mean", "p50", "p99" };
+
+//------------------------------------------------------------------------------------
+// Global Variables Definition
+//------------------------------------------------------------------------------------
+static bool checkFailed = false;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Value at fraction of the sorted samples, nearest rank
+static double Percentile(const std::vector<double> &sorted, double fraction)
+{
+    int rank = (int)std::ceil(fraction*(double)sorted.size()) - 1;
+    if (rank < 0) rank = 0;
+    return sorted[rank];
+}
+
+static double MetricValue(const BenchResult &result, BenchMetric metric)
+{
+    if (metric == BENCH_METRIC_MEAN) return result.mean;
+    if (metric == BENCH_METRIC_P99) return result.p99;
+    return result.p50;
+}
+
+static void WriteJsonString(FILE *file, const std::string &text)
+{
+    fputc('"', file);
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\') fputc('\\', file);
+        fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+// Position just past "key": inside [begin, end), or npos
+static size_t FindKey(const std::string &text, const char *key, size_t begin, size_t end)
+{
+    std::string quoted = std::string("\"") + key + "\"";
+    size_t at = text.find(quoted, begin);
+    if (at == std::string::npos || at >= end) return std::string::npos;
+
+    at += quoted.size();
+    while (at < end && (text[at] == ' ' || text[at] == '\t' || text[at] == '\n' || text[at] == '\r' || text[at] == ':')) at++;
+    return at;
+}
+
+static bool ReadString(const std::string &text, size_t at, std::string *value)
+{
+    if (at >= text.size() || text[at] != '"') return false;
+    value->clear();
+    for (at++; at < text.size() && text[at] != '"'; at++)
+    {
+        if (text[at] == '\\' && at + 1 < text.size()) at++;
+        value->push_back(text[at]);
+    }
+    return at < text.size();
+}
+
+static bool ReadNumber(const std::string &text, const char *key, size_t begin, size_t end, double *value)
+{
+    size_t at = FindKey(text, key, begin, end);
+    if (at == std::string::npos) return false;
+    char *parsed = nullptr;
+    *value = strtod(text.c_str() + at, &parsed);
+    return parsed != text.c_str() + at;
+}
+
+static void PrintUsage(const char *program)
+{
+    printf("usage: %s [--samples N] [--filter text] [--out results.json]\n"
+           "          [--baseline baseline.json] [--threshold percent] [--metric mean|p50|p99]\n"
+           "       %s --compare baseline.json current.json [--threshold percent] [--metric mean|p50|p99]\n"
+           "       %s --list\n", program, program, program);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void BenchRun(const std::vector<BenchCase> &cases, int samples, const std::string &filter, std::vector<BenchResult> *results)
+{
+    printf("%-40s %10s %10s %10s  %s\n", "case", "mean", "p50", "p99", "ns per");
+
+    std::vector<double> times;
+    for (const BenchCase &benchCase : cases)
+    {
+        if (!filter.empty() && benchCase.name.find(filter) == std::string::npos) continue;
+
+        if (benchCase.setup != nullptr) benchCase.setup(benchCase.param);
+
+        times.clear();
+        for (int s = -BENCH_WARMUP_SAMPLES; s < samples; s++)
+        {
+            if (benchCase.prepare != nullptr) benchCase.prepare(benchCase.param);
+
+            auto start = std::chrono::steady_clock::now();
+            int operations = benchCase.run(benchCase.param);
+            auto end = std::chrono::steady_clock::now();
+
+            if (s < 0) continue;
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            times.push_back(ns/(double)std::max(operations, 1));
+        }
+
+        BenchResult result;
+        result.name = benchCase.name;
+        result.unit = benchCase.unit;
+        result.samples = (int)times.size();
+        if (!times.empty())
+        {
+            double sum = 0.0;
+            for (double t : times) sum += t;
+            result.mean = sum/(double)times.size();
+            std::sort(times.begin(), times.end());
+            result.p50 = Percentile(times, 0.50);
+            result.p99 = Percentile(times, 0.99);
+        }
+        results->push_back(result);
+
+        printf("%-40s %10.1f %10.1f %10.1f  %s\n", result.name.c_str(), result.mean, result.p50, result.p99, result.unit.c_str());
+        fflush(stdout);
+    }
+}
+
+bool BenchWriteJson(const char *path, const char *suite, const std::vector<BenchResult> &results)
+{
+    FILE *file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "BENCH: Failed to write %s\n", path);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"suite\": \"%s\",\n  \"unit\": \"ns per operation\",\n  \"results\": [\n", suite);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult &result = results[i];
+        fprintf(file, "    {\"name\": ");
+        WriteJsonString(file, result.name);
+        fprintf(file, ", \"unit\": ");
+        WriteJsonString(file, result.unit);
+        fprintf(file, ", \"samples\": %d, \"mean\": %.3f, \"p50\": %.3f, \"p99\": %.3f}%s\n",
+                result.samples, result.mean, result.p50, result.p99, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+bool BenchReadJson(const char *path, std::vector<BenchResult> *results)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "BENCH: Failed to open %s\n", path);
+        return false;
+    }
+
+    std::string text;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, read);
+    fclose(file);
+
+    // Every object with a "name" inside "results" is one case
+    size_t at = FindKey(text, "results", 0, text.size());
+    if (at == std::string::npos)
+    {
+        fprintf(stderr, "BENCH: %s has no results\n", path);
+        return false;
+    }
+
+    results->clear();
+    for (;;)
+    {
+        size_t begin = text.find('{', at);
+        if (begin == std::string::npos) break;
+        size_t end = text.find('}', begin);
+        if (end == std::string::npos) break;
+
+        BenchResult result;
+        double samples = 0.0;
+        size_t name = FindKey(text, "name", begin, end);
+        size_t unit = FindKey(text, "unit", begin, end);
+        if (name == std::string::npos || !ReadString(text, name, &result.name) ||
+            !ReadNumber(text, "mean", begin, end, &result.mean) ||
+            !ReadNumber(text, "p50", begin, end, &result.p50) ||
+            !ReadNumber(text, "p99", begin, end, &result.p99))
+        {
+            fprintf(stderr, "BENCH: Malformed result in %s at offset %d\n", path, (int)begin);
+            return false;
+        }
+        if (unit != std::string::npos) ReadString(text, unit, &result.unit);
+        if (ReadNumber(text, "samples", begin, end, &samples)) result.samples = (int)samples;
+
+        results->push_back(result);
+        at = end + 1;
+    }
+    return true;
+}
+
+int BenchCompare(const std::vector<BenchResult> &baseline, const std::vector<BenchResult> &current, double threshold, BenchMetric metric)
+{
+    printf("%-40s %12s %12s %9s  (%s, fail above +%.1f%%)\n", "case", "baseline", "current", "change", METRIC_NAMES[metric], threshold);
+
+    int regressions = 0;
+    for (const BenchResult &now : current)
+    {
+        const BenchResult *before = nullptr;
+        for (const BenchResult &candidate : baseline)
+        {
+            if (candidate.name == now.name) before = &candidate;
+        }
+        if (before == nullptr)
+        {
+            printf("%-40s %12s %12.1f %9s\n", now.name.c_str(), "-", MetricValue(now, metric), "new");
+            continue;
+        }
+
+        double oldValue = MetricValue(*before, metric);
+        double newValue = MetricValue(now, metric);
+        double change = (oldValue > 0.0) ? (newValue - oldValue)/oldValue*100.0 : 0.0;
+        bool regressed = change > threshold;
+        if (regressed) regressions++;
+
+        printf("%-40s %12.1f %12.1f %+8.1f%%%s\n", now.name.c_str(), oldValue, newValue, change, regressed ? "  REGRESSION" : "");
+    }
+
+    for (const BenchResult &before : baseline)
+    {
+        bool found = false;
+        for (const BenchResult &now : current) found = found || (now.name == before.name);
+        if (!found) printf("%-40s %12.1f %12s %9s\n", before.name.c_str(), MetricValue(before, metric), "-", "missing");
+    }
+
+    return regressions;
+}
+
+bool BenchParseMetric(const char *text, BenchMetric *metric)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (strcmp(text, METRIC_NAMES[i]) == 0)
+        {
+            *metric = (BenchMetric)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void BenchCheck(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        checkFailed = true;
+    }
+}
+
+bool BenchFailed(void)
+{
+    return checkFailed;
+}
+
+int BenchMain(int argc, char **argv, const char *suite, const std::vector<BenchCase> &cases)
+{
+    int samples = BENCH_DEFAULT_SAMPLES;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    BenchMetric metric = BENCH_METRIC_P50;
+    std::string filter;
+    const char *outPath = nullptr;
+    const char *baselinePath = nullptr;
+    const char *comparePaths[2] = { nullptr, nullptr };
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "--samples") == 0 && hasValue) samples = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && hasValue) filter = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && hasValue) outPath = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && hasValue) baselinePath = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && hasValue) threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--metric") == 0 && hasValue && BenchParseMetric(argv[i + 1], &metric)) i++;
+        else if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc)
+        {
+            comparePaths[0] = argv[++i];
+            comparePaths[1] = argv[++i];
+        }
+        else if (strcmp(argv[i], "--list") == 0)
+        {
+            for (const BenchCase &benchCase : cases) printf("%s\n", benchCase.name.c_str());
+            return EXIT_SUCCESS;
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (samples < 1) samples = 1;
+
+    std::vector<BenchResult> baseline;
+    std::vector<BenchResult> current;
+
+    if (comparePaths[0] != nullptr)
+    {
+        if (!BenchReadJson(comparePaths[0], &baseline) || !BenchReadJson(comparePaths[1], &current)) return EXIT_FAILURE;
+    }
+    else
+    {
+        // Read the baseline first, a bad path should not cost a whole run
+        if (baselinePath != nullptr && !BenchReadJson(baselinePath, &baseline)) return EXIT_FAILURE;
+
+        BenchRun(cases, samples, filter, &current);
+        if (outPath != nullptr && !BenchWriteJson(outPath, suite, current)) return EXIT_FAILURE;
+        if (baselinePath == nullptr) return EXIT_SUCCESS;
+        printf("\n");
+    }
+
+    int regressions = BenchCompare(baseline, current, threshold, metric);
+    if (regressions > 0)
+    {
+        printf("FAIL: %d case(s) regressed by more than %.1f%%\n", regressions, threshold);
+        return EXIT_FAILURE;
+    }
+    printf("OK: no regression above %.1f%%\n", threshold);
+    return EXIT_SUCCESS;
+}
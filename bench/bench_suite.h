@@ -0,0 +1,65 @@
+// bench_suite.h
+#pragma once
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int BENCH_DEFAULT_SAMPLES = 100;
+constexpr double BENCH_DEFAULT_THRESHOLD = 10.0;   // Percent slower before a compare fails
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// One measured workload. setup runs once, prepare before every sample (both
+// untimed, either may be nullptr), run is one timed sample and returns how many
+// operations it did; results are nanoseconds per operation.
+struct BenchCase {
+    std::string name;                  // "game/workload/size", matched by --filter
+    const char *unit;                  // What one operation is
+    int param;
+    void (*setup)(int param);
+    void (*prepare)(int param);
+    int (*run)(int param);
+};
+
+struct BenchResult {
+    std::string name;
+    std::string unit;
+    int samples = 0;
+    double mean = 0.0;                 // ns per operation
+    double p50 = 0.0;
+    double p99 = 0.0;
+};
+
+enum BenchMetric {
+    BENCH_METRIC_MEAN = 0,
+    BENCH_METRIC_P50,
+    BENCH_METRIC_P99
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Runs every case whose name contains filter (all for an empty filter)
+void BenchRun(const std::vector<BenchCase> &cases, int samples, const std::string &filter, std::vector<BenchResult> *results);
+
+bool BenchWriteJson(const char *path, const char *suite, const std::vector<BenchResult> &results);
+// Reads files written by BenchWriteJson
+bool BenchReadJson(const char *path, std::vector<BenchResult> *results);
+
+// Prints both sides and returns how many metrics got slower than threshold percent.
+// Cases missing from either side are listed but do not fail.
+int BenchCompare(const std::vector<BenchResult> &baseline, const std::vector<BenchResult> &current, double threshold, BenchMetric metric);
+bool BenchParseMetric(const char *text, BenchMetric *metric);
+
+// Correctness checks of the benches: prints "FAIL: what" when condition is false, and
+// BenchFailed then tells main to return EXIT_FAILURE
+void BenchCheck(bool condition, const char *what);
+bool BenchFailed(void);
+
+// Shared command line: [--samples N] [--filter text] [--out file.json]
+// [--baseline file.json] [--threshold percent] [--metric mean|p50|p99]
+// or --compare baseline.json current.json. Returns the process exit code.
+int BenchMain(int argc, char **argv, const char *suite, const std::vector<BenchCase> &cases);
@@ -0,0 +1,269 @@
+// frame_alloc_bench.cpp
+// Heap allocations per frame in all three games, counted by the allocation tracker.
+// Each game runs the work of its main loop headless from a fixed seed: Tetris plays a
+// scripted action stream and draws into a batch with nothing to submit to, the sand
+// world steps (Margolus on the job system, the heat field as a job) and records every
+// tick into a small history, and the platformer moves the player and picks up coins
+// through the spatial hash. All of them lay out their HUD score. After a warm-up, in
+// which buffers, rings and arenas reach their working size, a frame that allocates
+// at all is a failure. With the profiler built in, its per-frame count (the overlay's
+// allocation line) is checked against the tracker too.
+// Build from the repository folder:
+//   g++ -O3 -std=c++14 -pthread -Icommon "-IRaylib Sand simulation/src" "-IRaylib (TetrisGame)/src" "-IRaylib (2D platformer)/src" -Ibench bench/frame_alloc_bench.cpp bench/bench_suite.cpp <the three cores> common/hud_text.cpp common/alloc_tracker.cpp -o frame_alloc_bench
+#include "alloc_tracker.h"
+#include "profiler.h"
+#include "hud_text.h"
+#include "job_system.h"
+#include "sand.h"
+#include "sand_heat.h"
+#include "sand_history.h"
+#include "game.h"
+#include "physics.h"
+#include "spatial_hash.h"
+#include "replay.h"
+#include "bench_suite.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t BENCH_SEED = 12345;
+constexpr int WARMUP_FRAMES = 3000;
+constexpr int STEADY_FRAMES = 2000;
+
+constexpr int SAND_SIZE = 128;
+constexpr size_t SAND_HISTORY_BUDGET = 64 << 10;
+constexpr int SAND_HEAT_TICKS = 4;             // The field steps as a job every few ticks
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static volatile int sink = 0;
+static HudFont hudFont = {};                   // No glyphs: the layout work without a font file
+
+//------------------------------------------------------------------------------------
+// Tetris: an action every frame, gravity every fourth, a finished game restarts
+//------------------------------------------------------------------------------------
+struct TetrisFrames {
+    Game *game;
+    std::vector<GameAction> actions;
+    HudText score;
+};
+
+static void TetrisSetup(TetrisFrames *tetris)
+{
+    srand(BENCH_SEED);
+    tetris->game = new Game(nullptr);
+    std::mt19937 rng(BENCH_SEED);
+    const GameAction choices[] = { ACTION_LEFT, ACTION_RIGHT, ACTION_ROTATE, ACTION_DOWN, ACTION_DOWN };
+    tetris->actions.resize(4096);
+    for (GameAction &action : tetris->actions) action = choices[rng() % 5];
+}
+
+static void TetrisFrame(TetrisFrames *tetris, int frame)
+{
+    Game &game = *tetris->game;
+    game.HandleAction(tetris->actions[frame & 4095]);
+    if ((frame & 3) == 3) game.MoveBlockDown();
+    game.draw();
+    HudTextSetInt(&tetris->score, &hudFont, "%d", game.score, 38, 2);
+    sink = game.score;
+}
+
+//------------------------------------------------------------------------------------
+// Sand: grains poured in at the top, so the world never settles
+//------------------------------------------------------------------------------------
+struct SandFrames {
+    SandWorld world;
+    SandHeat heat;
+    SandHistory history;
+    JobSystem jobs;
+    JobTask heatTask;
+    JobCounter heatDone;
+    HudText tick;
+};
+
+static void HeatJob(void *user, int, int)
+{
+    SandHeatStep(*(SandHeat *)user, 1);
+}
+
+static void SandSetup(SandFrames *sand)
+{
+    SandInit(sand->world, SAND_SIZE, SAND_SIZE, BENCH_SEED);
+    SandHeatInit(sand->heat, SAND_SIZE, SAND_SIZE);
+    SandHistoryInit(sand->history, SAND_SIZE, SAND_SIZE, 32, SAND_HISTORY_BUDGET);
+    JobSystemInit(&sand->jobs, 2);
+}
+
+static void SandFrame(SandFrames *sand, int frame)
+{
+    JobSystemWait(&sand->jobs, &sand->heatDone);
+
+    // A pile that slides both ways; once the grid is full it is emptied and refilled
+    int col = SAND_SIZE/2 + (frame % 9) - 4;
+    if (sand->world.grid[col][0] == 0) SandSet(sand->world, col, 0, 1);
+    if (frame % 1500 == 1499)
+    {
+        for (int c = 0; c < SAND_SIZE; c++)
+        {
+            for (int r = 0; r < SAND_SIZE; r++) sand->world.grid[c][r] = 0;
+        }
+        SandRebuildStats(sand->world);
+    }
+    if (frame % 50 == 0) SandHeatAdd(sand->heat, col, SAND_SIZE - 4, 2, 200.0f);
+
+    if (frame % SAND_HEAT_TICKS == 0)
+    {
+        SandHeatSync(sand->heat, sand->world);
+        JobTaskInit(&sand->heatTask, HeatJob, &sand->heat, 0, 1, 1);
+        JobSystemRun(&sand->jobs, &sand->heatTask, 1, &sand->heatDone);
+    }
+    SandStepMargolus(sand->world, &sand->jobs);
+    SandHistoryRecord(sand->history, sand->world);
+    HudTextSetInt(&sand->tick, &hudFont, "tick %d", SandHistoryNewest(sand->history), 20, 2);
+}
+
+//------------------------------------------------------------------------------------
+// Platformer: the player on the default level, coins picked up like CoinUpdate does
+//------------------------------------------------------------------------------------
+struct PlatformerFrames {
+    Entity player;
+    Input input;
+    std::vector<uint8_t> script;
+    SpatialHash coins;
+    std::vector<int> candidates;
+    bool taken[MAX_COINS];
+    int score;
+    HudText scoreText;
+};
+
+static void PlatformerReset(PlatformerFrames *platformer)
+{
+    MapInit();
+    PlayerInit(&platformer->player, &platformer->input);
+    SpatialHashClear(&platformer->coins);
+    for (int i = 0; i < MAX_COINS; i++)
+    {
+        SpatialHashInsert(&platformer->coins, COIN_POSITIONS[i].x, COIN_POSITIONS[i].y, COIN_SIZE, COIN_SIZE);
+        platformer->taken[i] = false;
+    }
+    platformer->score = 0;
+}
+
+static void PlatformerSetup(PlatformerFrames *platformer)
+{
+    deltaTimeFrame = PHYSICS_DT;
+    platformer->input = Input{};
+    SpatialHashInit(&platformer->coins, 256);
+    std::mt19937 rng(BENCH_SEED);
+    platformer->script.resize(4096);
+    for (int i = 0; i < 4096; i += 16)
+    {
+        uint8_t bits = (uint8_t)(rng() & 0x1f);
+        for (int j = i; j < i + 16; j++) platformer->script[j] = bits;
+    }
+    PlatformerReset(platformer);
+}
+
+static void PlatformerFrame(PlatformerFrames *platformer, int frame)
+{
+    Entity &player = platformer->player;
+    platformer->input = InputUnpack(platformer->script[frame & 4095]);
+    EntityMoveUpdate(&player);
+
+    float x = player.position.x - player.width*0.5f;
+    float y = player.position.y - player.height + 1;
+    platformer->candidates.clear();
+    SpatialHashQuery(&platformer->coins, x, y, (float)player.width, (float)player.height, &platformer->candidates);
+    for (int i : platformer->candidates)
+    {
+        if (platformer->taken[i]) continue;
+        const Vector2 &coin = COIN_POSITIONS[i];
+        if (x < coin.x + COIN_SIZE && coin.x < x + player.width && y < coin.y + COIN_SIZE && coin.y < y + player.height)
+        {
+            platformer->taken[i] = true;
+            SpatialHashRemove(&platformer->coins, i);
+            platformer->score++;
+        }
+    }
+    // Restarts the level now and then, as winning or falling off would
+    if (frame % 1024 == 1023) PlatformerReset(platformer);
+    HudTextSetInt(&platformer->scoreText, &hudFont, "SCORE: %i", platformer->score, 40, 4);
+}
+
+//----------------------------------------------------------------------------------
+// Checks
+//----------------------------------------------------------------------------------
+typedef void (*FrameFunc)(void *state, int frame);
+
+// Warms up, then counts every steady frame's allocations; the worst frame and the
+// last warm-up frame that allocated are printed
+static void CheckSteadyFrames(const char *name, FrameFunc run, void *state)
+{
+    int lastWarmup = -1;
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++)
+    {
+        AllocStats start = AllocTrackerTotals();
+        run(state, frame);
+        ProfilerFrameMark();
+        if (AllocTrackerSince(&start).allocations > 0) lastWarmup = frame;
+    }
+
+    uint64_t allocations = 0, bytes = 0, worst = 0;
+    int allocatingFrames = 0;
+    bool profilerAgrees = true;
+    for (int frame = WARMUP_FRAMES; frame < WARMUP_FRAMES + STEADY_FRAMES; frame++)
+    {
+        AllocStats start = AllocTrackerTotals();
+        run(state, frame);
+        AllocStats used = AllocTrackerSince(&start);
+        ProfilerFrameMark();
+
+        uint64_t profiled = 0, profiledBytes = 0;
+        if (ProfilerFrameAllocs(&profiled, &profiledBytes)) profilerAgrees = profilerAgrees && profiled == used.allocations;
+        allocations += used.allocations;
+        bytes += used.bytes;
+        if (used.allocations > worst) worst = used.allocations;
+        if (used.allocations > 0) allocatingFrames++;
+    }
+
+    printf("%-12s %8d %14.2f %14.1f %12llu %10d\n", name, lastWarmup, (double)allocations/STEADY_FRAMES,
+           (double)bytes/STEADY_FRAMES, (unsigned long long)worst, allocatingFrames);
+
+    char what[128];
+    snprintf(what, sizeof(what), "%s: steady frames allocate nothing", name);
+    BenchCheck(allocations == 0, what);
+    snprintf(what, sizeof(what), "%s: the profiler counts the same allocations", name);
+    BenchCheck(profilerAgrees, what);
+}
+
+int main(void)
+{
+    ProfilerSetAllocCounter(AllocTrackerCount);
+
+    TetrisFrames tetris;
+    SandFrames sand;
+    PlatformerFrames platformer;
+    TetrisSetup(&tetris);
+    SandSetup(&sand);
+    PlatformerSetup(&platformer);
+
+    printf("%d warm-up frames, then %d steady ones\n", WARMUP_FRAMES, STEADY_FRAMES);
+    printf("%-12s %8s %14s %14s %12s %10s\n", "game", "warm-up", "allocs/frame", "bytes/frame", "worst frame", "frames");
+    CheckSteadyFrames("tetris", [](void *state, int frame) { TetrisFrame((TetrisFrames *)state, frame); }, &tetris);
+    CheckSteadyFrames("sand", [](void *state, int frame) { SandFrame((SandFrames *)state, frame); }, &sand);
+    CheckSteadyFrames("platformer", [](void *state, int frame) { PlatformerFrame((PlatformerFrames *)state, frame); }, &platformer);
+
+    JobSystemWait(&sand.jobs, &sand.heatDone);
+    JobSystemShutdown(&sand.jobs);
+    delete tetris.game;
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: no game allocates in a steady frame\n");
+    return EXIT_SUCCESS;
+}
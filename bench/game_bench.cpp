@@ -0,0 +1,373 @@
+// game_bench.cpp
+// Benchmark suite over the headless cores of all three games: the sand step (column
+// scan and Margolus, and a sparse world) at several grid sizes, Tetris BlockFits /
+// placement search / board evaluation / ClearFullRows / whole-game throughput (also
+// with sound events queued to the mixer) and platformer EntityMoveUpdate against tile
+// collision. Every workload is built from a fixed seed; results are ns per operation
+// (mean, p50, p99 over the samples).
+//
+//   game_bench --out results.json
+//   game_bench --baseline baseline.json --threshold 10    (exit code 1 on regression)
+//   game_bench --compare baseline.json results.json
+#include "bench_suite.h"
+#include "sand.h"
+#include "game.h"
+#include "placement_finder.h"
+#include "board_evaluator.h"
+#include "physics.h"
+#include "level_gen.h"
+#include "replay.h"
+#include "audio_mixer.h"
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t BENCH_SEED = 12345;
+
+constexpr int SAND_STEPS_PER_SAMPLE = 4;
+constexpr int TETRIS_FITS_PER_SAMPLE = 4096;
+constexpr int TETRIS_CLEAR_GRIDS = 64;           // ClearFullRows calls per sample
+constexpr int TETRIS_ACTIONS_PER_SAMPLE = 4096;
+constexpr int TETRIS_FINDS_PER_SAMPLE = 64;
+constexpr int TETRIS_EVALUATIONS_PER_SAMPLE = 64;
+constexpr int TETRIS_AUDIO_ACTIONS_PER_SAMPLE = 512;    // Keeps a sample's sounds inside the queue
+constexpr int ENTITY_STEPS_PER_SAMPLE = 2048;
+
+constexpr int LEVEL_WIDTH = 2048;
+constexpr int LEVEL_HEIGHT = 64;
+constexpr int LEVEL_ENTITIES = 256;
+constexpr int LEVEL_FRAMES_PER_SAMPLE = 16;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static volatile int sink = 0;
+
+//------------------------------------------------------------------------------------
+// Sand: SandStep on a square grid, the upper half seeded at 50% density. Every sample
+// restarts from the same grid, so each one times the same falls and slides.
+//------------------------------------------------------------------------------------
+static SandWorld sandWorld;
+static std::vector<std::vector<int>> sandStart;
+
+static void SandSetup(int size)
+{
+    SandInit(sandWorld, size, size, BENCH_SEED);
+    std::mt19937 rng(BENCH_SEED);
+    for (int col = 0; col < size; col++)
+    {
+        for (int row = 0; row < size/2; row++) sandWorld.grid[col][row] = (int)(rng() & 1);
+    }
+    sandStart = sandWorld.grid;
+}
+
+// Mostly air: one falling clump, 64 cells square, over the middle of the grid
+static void SandSparseSetup(int size)
+{
+    SandInit(sandWorld, size, size, BENCH_SEED);
+    std::mt19937 rng(BENCH_SEED);
+    for (int col = size/2 - 32; col < size/2 + 32; col++)
+    {
+        for (int row = 0; row < 64; row++) sandWorld.grid[col][row] = (int)(rng() & 1);
+    }
+    sandStart = sandWorld.grid;
+}
+
+static void SandPrepare(int)
+{
+    sandWorld.grid = sandStart;
+    sandWorld.margolusPhase = 0;
+    SandRebuildStats(sandWorld);
+}
+
+static int SandRun(int)
+{
+    for (int i = 0; i < SAND_STEPS_PER_SAMPLE; i++) SandStep(sandWorld);
+    return SAND_STEPS_PER_SAMPLE;
+}
+
+// The Margolus rule on one thread, the same start as the column scan
+static int SandMargolusRun(int)
+{
+    for (int i = 0; i < SAND_STEPS_PER_SAMPLE; i++) SandStepMargolus(sandWorld);
+    return SAND_STEPS_PER_SAMPLE;
+}
+
+//------------------------------------------------------------------------------------
+// Tetris
+//------------------------------------------------------------------------------------
+static std::unique_ptr<Game> tetrisGame;
+static Grid tetrisClearStart;
+static std::vector<Grid> tetrisClearGrids;
+static std::vector<GameAction> tetrisActions;
+
+// Rows above 'full' rows get one hole each, so only the bottom rows clear
+static void FillGrid(Grid *grid, int filledRows, int fullRows, std::mt19937 *rng)
+{
+    grid->Initialize();
+    for (int r = 0; r < filledRows; r++)
+    {
+        int row = 19 - r;
+        int hole = (r < fullRows) ? -1 : (int)((*rng)() % 10);
+        for (int col = 0; col < 10; col++) grid->grid[row][col] = (col == hole) ? 0 : 1 + (int)((*rng)() % 7);
+    }
+}
+
+// BlockFits of the spawned piece over a half-filled board
+static void TetrisFitsSetup(int)
+{
+    srand(BENCH_SEED);
+    tetrisGame.reset(new Game(nullptr));
+    std::mt19937 rng(BENCH_SEED);
+    FillGrid(&tetrisGame->grid, 10, 0, &rng);
+}
+
+static int TetrisFitsRun(int)
+{
+    int fits = 0;
+    for (int i = 0; i < TETRIS_FITS_PER_SAMPLE; i++) fits += tetrisGame->BlockFits();
+    sink = fits;
+    return TETRIS_FITS_PER_SAMPLE;
+}
+
+// PlacementFinder::Find of the spawned piece over the same half-filled board
+static PlacementFinder tetrisFinder;
+static Block tetrisBlock;
+
+static void TetrisPlacementsSetup(int)
+{
+    TetrisFitsSetup(0);
+    tetrisBlock = tetrisGame->GetCurrentBlock();
+}
+
+static int TetrisPlacementsRun(int)
+{
+    int found = 0;
+    for (int i = 0; i < TETRIS_FINDS_PER_SAMPLE; i++) found += tetrisFinder.Find(tetrisGame->grid, tetrisBlock);
+    sink = found;
+    return TETRIS_FINDS_PER_SAMPLE;
+}
+
+// BoardEvaluator::Evaluate over the boards those placements leave
+static BoardEvaluator tetrisEvaluator;
+static const float TETRIS_WEIGHTS[NUM_BOARD_FEATURES] = { -0.51f, -0.1f, -0.36f, -0.18f, -0.32f, -0.93f, 0.76f };
+
+static void TetrisEvaluateSetup(int)
+{
+    TetrisPlacementsSetup(0);
+    tetrisFinder.Find(tetrisGame->grid, tetrisBlock);
+    tetrisEvaluator.Clear();
+    for (const Placement &placement : tetrisFinder.placements)
+    {
+        uint16_t rows[20];
+        tetrisFinder.PlacedRows(placement, rows);
+        tetrisEvaluator.Add(rows);
+    }
+}
+
+static int TetrisEvaluateRun(int)
+{
+    int best = 0;
+    for (int i = 0; i < TETRIS_EVALUATIONS_PER_SAMPLE; i++)
+    {
+        tetrisEvaluator.Evaluate(TETRIS_WEIGHTS);
+        best += tetrisEvaluator.Best();
+    }
+    sink = best;
+    return TETRIS_EVALUATIONS_PER_SAMPLE;
+}
+
+// ClearFullRows with 'fullRows' complete rows under a stack of 12
+static void TetrisClearSetup(int fullRows)
+{
+    std::mt19937 rng(BENCH_SEED);
+    FillGrid(&tetrisClearStart, 12, fullRows, &rng);
+    tetrisClearGrids.assign(TETRIS_CLEAR_GRIDS, tetrisClearStart);
+}
+
+static void TetrisClearPrepare(int)
+{
+    for (Grid &grid : tetrisClearGrids) grid = tetrisClearStart;
+}
+
+static int TetrisClearRun(int)
+{
+    int cleared = 0;
+    for (Grid &grid : tetrisClearGrids) cleared += grid.ClearFullRows();
+    sink = cleared;
+    return TETRIS_CLEAR_GRIDS;
+}
+
+// Whole game from a seeded action stream, gravity every fourth action; a finished
+// game restarts on the next action like it does for a key press
+static void TetrisGameSetup(int)
+{
+    srand(BENCH_SEED);
+    tetrisGame.reset(new Game(nullptr));
+
+    std::mt19937 rng(BENCH_SEED);
+    const GameAction choices[] = { ACTION_LEFT, ACTION_RIGHT, ACTION_ROTATE, ACTION_DOWN, ACTION_DOWN };
+    tetrisActions.resize(TETRIS_ACTIONS_PER_SAMPLE);
+    for (GameAction &action : tetrisActions) action = choices[rng() % 5];
+}
+
+static int PlayActions(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        tetrisGame->HandleAction(tetrisActions[i]);
+        if ((i & 3) == 3) tetrisGame->MoveBlockDown();
+    }
+    sink = tetrisGame->score;
+    return count;
+}
+
+static int TetrisGameRun(int)
+{
+    return PlayActions(TETRIS_ACTIONS_PER_SAMPLE);
+}
+
+// The same game queueing rotate and clear sounds to a mixer. Prepare does the work of
+// the mixer thread and the device, so samples time only what the game thread pays.
+static AudioMixer tetrisMixer;
+static std::vector<int16_t> tetrisAudioOut(AUDIO_OUTPUT_FRAMES*AUDIO_CHANNELS);
+
+static void TetrisAudioSetup(int)
+{
+    TetrisGameSetup(0);
+    AudioMixerInit(&tetrisMixer);
+    std::vector<int16_t> click(2400*AUDIO_CHANNELS, 1000);
+    tetrisGame->audio = &tetrisMixer;
+    tetrisGame->rotateSound = AudioMixerAddClip(&tetrisMixer, click.data(), 2400);
+    tetrisGame->clearSound = AudioMixerAddClip(&tetrisMixer, click.data(), 2400);
+}
+
+static void TetrisAudioPrepare(int)
+{
+    AudioMixerUpdate(&tetrisMixer);
+    AudioMixerRead(&tetrisMixer, tetrisAudioOut.data(), AUDIO_OUTPUT_FRAMES);
+}
+
+static int TetrisAudioRun(int)
+{
+    return PlayActions(TETRIS_AUDIO_ACTIONS_PER_SAMPLE);
+}
+
+//------------------------------------------------------------------------------------
+// Platformer: EntityMoveUpdate with tile collision, driven by seeded input held for
+// 16 steps at a time
+//------------------------------------------------------------------------------------
+static std::vector<Entity> entities;
+static std::vector<Input> entityInputs;
+static std::vector<uint8_t> inputScript;
+static int entityFrame = 0;
+
+static void MakeInputScript(int length)
+{
+    std::mt19937 rng(BENCH_SEED);
+    inputScript.resize(length);
+    for (int i = 0; i < length; i += 16)
+    {
+        uint8_t bits = (uint8_t)(rng() & 0x1f);
+        for (int j = i; j < i + 16 && j < length; j++) inputScript[j] = bits;
+    }
+}
+
+// The player alone on the default 20x12 level
+static void PlayerSetup(int)
+{
+    deltaTimeFrame = PHYSICS_DT;
+    MapInit();
+    entityInputs.assign(1, Input{});
+    entities.assign(1, Entity{});
+    PlayerInit(&entities[0], &entityInputs[0]);
+    MakeInputScript(4096);
+    entityFrame = 0;
+}
+
+static int PlayerRun(int)
+{
+    Entity &player = entities[0];
+    for (int i = 0; i < ENTITY_STEPS_PER_SAMPLE; i++)
+    {
+        entityInputs[0] = InputUnpack(inputScript[entityFrame++ & 4095]);
+        EntityMoveUpdate(&player);
+    }
+    return ENTITY_STEPS_PER_SAMPLE;
+}
+
+// LEVEL_ENTITIES movers spread over a generated level, each on its own input phase
+static void CrowdSetup(int)
+{
+    deltaTimeFrame = PHYSICS_DT;
+    Entity mover;
+    PlayerInit(&mover, nullptr);
+
+    LevelGenParams params;
+    params.width = LEVEL_WIDTH;
+    params.height = LEVEL_HEIGHT;
+    params.seed = BENCH_SEED;
+    params.threads = 1;
+    LevelGenResult level;
+    LevelGenerate(params, &mover, &level);
+
+    entityInputs.assign(LEVEL_ENTITIES, Input{});
+    entities.assign(LEVEL_ENTITIES, Entity{});
+    for (int i = 0; i < LEVEL_ENTITIES; i++)
+    {
+        PlayerInit(&entities[i], &entityInputs[i]);
+        // Feet at the bottom of a coin, which always floats over standable ground
+        const Vector2 &coin = level.coins[(size_t)i*level.coins.size()/LEVEL_ENTITIES];
+        entities[i].position.x = coin.x + COIN_SIZE*0.5f;
+        entities[i].position.y = coin.y + COIN_SIZE - 1.0f;
+    }
+    MakeInputScript(4096);
+    entityFrame = 0;
+}
+
+static int CrowdRun(int)
+{
+    for (int frame = 0; frame < LEVEL_FRAMES_PER_SAMPLE; frame++, entityFrame++)
+    {
+        for (int i = 0; i < LEVEL_ENTITIES; i++)
+        {
+            entityInputs[i] = InputUnpack(inputScript[(entityFrame + i*37) & 4095]);
+            EntityMoveUpdate(&entities[i]);
+        }
+    }
+    return LEVEL_FRAMES_PER_SAMPLE*LEVEL_ENTITIES;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    std::vector<BenchCase> cases = {
+        { "sand/step/39", "step", 39, SandSetup, SandPrepare, SandRun },
+        { "sand/step/128", "step", 128, SandSetup, SandPrepare, SandRun },
+        { "sand/step/512", "step", 512, SandSetup, SandPrepare, SandRun },
+        { "sand/step/1024", "step", 1024, SandSetup, SandPrepare, SandRun },
+        { "sand/margolus/512", "step", 512, SandSetup, SandPrepare, SandMargolusRun },
+        { "sand/margolus/1024", "step", 1024, SandSetup, SandPrepare, SandMargolusRun },
+        { "sand/sparse/1024", "step", 1024, SandSparseSetup, SandPrepare, SandRun },
+
+        { "tetris/block_fits", "call", 0, TetrisFitsSetup, nullptr, TetrisFitsRun },
+        { "tetris/placements", "call", 0, TetrisPlacementsSetup, nullptr, TetrisPlacementsRun },
+        { "tetris/evaluate", "call", 0, TetrisEvaluateSetup, nullptr, TetrisEvaluateRun },
+        { "tetris/clear_full_rows/0", "call", 0, TetrisClearSetup, TetrisClearPrepare, TetrisClearRun },
+        { "tetris/clear_full_rows/4", "call", 4, TetrisClearSetup, TetrisClearPrepare, TetrisClearRun },
+        { "tetris/game", "action", 0, TetrisGameSetup, nullptr, TetrisGameRun },
+        { "tetris/game_audio", "action", 0, TetrisAudioSetup, TetrisAudioPrepare, TetrisAudioRun },
+
+        { "platformer/entity_move/default_map", "step", 0, PlayerSetup, nullptr, PlayerRun },
+        { "platformer/entity_move/generated_level", "entity step", 0, CrowdSetup, nullptr, CrowdRun },
+    };
+
+    return BenchMain(argc, argv, "game_bench", cases);
+}
@@ -0,0 +1,63 @@
+// alloc_tracker.cpp
+#include "alloc_tracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+// Constant initialized, so allocations made before main are counted too
+static std::atomic<uint64_t> allocations(0);
+static std::atomic<uint64_t> bytes(0);
+static std::atomic<uint64_t> frees(0);
+
+//------------------------------------------------------------------------------------
+// Replaced global operators. The array and nothrow forms of the standard library call
+// these, so they need no replacing of their own.
+//------------------------------------------------------------------------------------
+// GCC takes the free below for a mismatch once it inlines operator new into callers
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    if (p == nullptr) return;
+    frees.fetch_add(1, std::memory_order_relaxed);
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+AllocStats AllocTrackerTotals(void)
+{
+    return { allocations.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed), frees.load(std::memory_order_relaxed) };
+}
+
+AllocStats AllocTrackerSince(const AllocStats *start)
+{
+    AllocStats now = AllocTrackerTotals();
+    return { now.allocations - start->allocations, now.bytes - start->bytes, now.frees - start->frees };
+}
+
+void AllocTrackerCount(uint64_t *allocationCount, uint64_t *byteCount)
+{
+    *allocationCount = allocations.load(std::memory_order_relaxed);
+    *byteCount = bytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,33 @@
+// alloc_tracker.h
+#pragma once
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Global allocation counter. Linking alloc_tracker.cpp replaces the global operator
+// new and delete with versions that count every allocation and its bytes, on every
+// thread, before handing the memory to malloc. Only executables link it: a game, to
+// show allocations per frame in the profiler overlay (ProfilerSetAllocCounter), and
+// the benches that fail when a steady-state frame or step allocates.
+//
+// Counting is one relaxed atomic add per call, and totals only ever grow: take two
+// snapshots and subtract them to get what a stretch of code allocated.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct AllocStats {
+    uint64_t allocations;
+    uint64_t bytes;                    // Requested, over all allocations
+    uint64_t frees;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+AllocStats AllocTrackerTotals(void);
+// What was allocated since the snapshot start
+AllocStats AllocTrackerSince(const AllocStats *start);
+
+// Matches ProfilerAllocFunc: ProfilerSetAllocCounter(AllocTrackerCount)
+void AllocTrackerCount(uint64_t *allocations, uint64_t *bytes);
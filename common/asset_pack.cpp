@@ -0,0 +1,433 @@
+// asset_pack.cpp
+#include "asset_pack.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int LZ_MIN_MATCH = 4;
+constexpr int LZ_MAX_OFFSET = 65535;
+constexpr int LZ_HASH_BITS = 16;
+
+// Compressed entries must save at least this share, or they are stored
+constexpr double ASSET_MIN_SAVING = 0.1;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static void WriteLength(std::vector<uint8_t> *out, size_t length)
+{
+    while (length >= 255)
+    {
+        out->push_back(255);
+        length -= 255;
+    }
+    out->push_back((uint8_t)length);
+}
+
+static bool ReadLength(const uint8_t **in, const uint8_t *end, size_t *length)
+{
+    for (;;)
+    {
+        if (*in >= end) return false;
+        uint8_t byte = *(*in)++;
+        *length += byte;
+        if (byte != 255) return true;
+    }
+}
+
+static uint32_t Read32(const uint8_t *p)
+{
+    uint32_t value;
+    memcpy(&value, p, 4);
+    return value;
+}
+
+// One token: literal count and match length - LZ_MIN_MATCH in the two nibbles, each
+// continued in extra bytes at 15, then the literals, then a 16-bit match offset. The
+// last token has literals only.
+static void WriteSequence(std::vector<uint8_t> *out, const uint8_t *literals, size_t literalCount, size_t offset, size_t matchLength)
+{
+    size_t matchCode = (matchLength > 0) ? matchLength - LZ_MIN_MATCH : 0;
+    uint8_t token = (uint8_t)(((literalCount < 15) ? literalCount : 15) << 4 | ((matchCode < 15) ? matchCode : 15));
+    out->push_back(token);
+    if (literalCount >= 15) WriteLength(out, literalCount - 15);
+    out->insert(out->end(), literals, literals + literalCount);
+    if (matchLength == 0) return;
+
+    out->push_back((uint8_t)(offset & 0xff));
+    out->push_back((uint8_t)(offset >> 8));
+    if (matchCode >= 15) WriteLength(out, matchCode - 15);
+}
+
+static void DecodeEntry(AssetPack *pack, int index)
+{
+    const AssetPackEntry &entry = pack->entries[index];
+    AssetSlot &slot = pack->slots[index];
+
+    slot.decoded.resize((size_t)entry.size);
+    bool ok = AssetDecompress(pack->data + entry.offset, (size_t)entry.packedSize, slot.decoded.data(), slot.decoded.size()) &&
+              AssetHash(slot.decoded.data(), slot.decoded.size()) == entry.hash;
+    if (ok) slot.blob = { slot.decoded.data(), slot.decoded.size() };
+    else
+    {
+        fprintf(stderr, "ASSETS: Entry %s is corrupt\n", entry.name);
+        std::vector<uint8_t>().swap(slot.decoded);
+    }
+
+    slot.state.store(ok ? ASSET_READY : ASSET_FAILED, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(pack->mutex);
+    pack->done.notify_all();
+}
+
+static void WorkerLoop(AssetPack *pack)
+{
+    for (;;)
+    {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(pack->mutex);
+            pack->wake.wait(lock, [pack] { return pack->closing || !pack->queue.empty(); });
+            if (pack->closing) return;
+            index = pack->queue.front();
+            pack->queue.pop_front();
+        }
+
+        // A waiting caller may have taken it already
+        int expected = ASSET_QUEUED;
+        if (pack->slots[index].state.compare_exchange_strong(expected, ASSET_DECODING)) DecodeEntry(pack, index);
+    }
+}
+
+static bool MapFile(AssetPack *pack, const char *path)
+{
+#if !defined(_WIN32)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    pack->data = (const uint8_t *)mapping;
+    pack->size = (size_t)info.st_size;
+    pack->mapped = true;
+    return true;
+#else
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0)
+    {
+        pack->fileCopy.resize((size_t)size);
+        if (fread(pack->fileCopy.data(), 1, (size_t)size, file) != (size_t)size) pack->fileCopy.clear();
+    }
+    fclose(file);
+    if (pack->fileCopy.empty()) return false;
+
+    pack->data = pack->fileCopy.data();
+    pack->size = pack->fileCopy.size();
+    pack->mapped = false;
+    return true;
+#endif
+}
+
+static void UnmapFile(AssetPack *pack)
+{
+#if !defined(_WIN32)
+    if (pack->mapped) munmap((void *)pack->data, pack->size);
+#endif
+    std::vector<uint8_t>().swap(pack->fileCopy);
+    pack->data = nullptr;
+    pack->size = 0;
+    pack->mapped = false;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+uint32_t AssetHash(const uint8_t *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Greedy LZ77 with one candidate per 4-byte hash
+std::vector<uint8_t> AssetCompress(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> out;
+    out.reserve(size/2 + 16);
+    std::vector<int64_t> table((size_t)1 << LZ_HASH_BITS, -1);
+
+    size_t literalStart = 0;
+    size_t pos = 0;
+    while (pos + LZ_MIN_MATCH <= size)
+    {
+        uint32_t key = (Read32(data + pos)*2654435761u) >> (32 - LZ_HASH_BITS);
+        int64_t candidate = table[key];
+        table[key] = (int64_t)pos;
+
+        if (candidate < 0 || pos - (size_t)candidate > LZ_MAX_OFFSET || Read32(data + candidate) != Read32(data + pos))
+        {
+            pos++;
+            continue;
+        }
+
+        size_t length = LZ_MIN_MATCH;
+        while (pos + length < size && data[candidate + length] == data[pos + length]) length++;
+
+        WriteSequence(&out, data + literalStart, pos - literalStart, pos - (size_t)candidate, length);
+        pos += length;
+        literalStart = pos;
+    }
+
+    WriteSequence(&out, data + literalStart, size - literalStart, 0, 0);
+    return out;
+}
+
+bool AssetDecompress(const uint8_t *packed, size_t packedSize, uint8_t *out, size_t size)
+{
+    const uint8_t *in = packed;
+    const uint8_t *inEnd = packed + packedSize;
+    size_t written = 0;
+
+    while (in < inEnd)
+    {
+        uint8_t token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !ReadLength(&in, inEnd, &literals)) return false;
+        if (literals > (size_t)(inEnd - in) || literals > size - written) return false;
+        if (literals > 0) memcpy(out + written, in, literals);
+        in += literals;
+        written += literals;
+
+        if (in == inEnd) break;
+
+        if (inEnd - in < 2) return false;
+        size_t offset = (size_t)in[0] | (size_t)in[1] << 8;
+        in += 2;
+        size_t length = (token & 15);
+        if (length == 15 && !ReadLength(&in, inEnd, &length)) return false;
+        length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > written || length > size - written) return false;
+
+        // Overlapping matches repeat the bytes just written
+        uint8_t *dst = out + written;
+        const uint8_t *src = dst - offset;
+        if (offset >= length) memcpy(dst, src, length);
+        else for (size_t i = 0; i < length; i++) dst[i] = src[i];
+        written += length;
+    }
+    return written == size;
+}
+
+bool AssetPackWrite(const char *path, const std::vector<AssetPackInput> &inputs)
+{
+    std::vector<AssetPackEntry> entries(inputs.size());
+    std::vector<std::vector<uint8_t>> payloads(inputs.size());
+
+    uint64_t offset = sizeof(AssetPackHeader) + sizeof(AssetPackEntry)*inputs.size();
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        const AssetPackInput &input = inputs[i];
+        AssetPackEntry &entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+
+        if (input.name.empty() || input.name.size() >= (size_t)ASSET_NAME_LENGTH)
+        {
+            fprintf(stderr, "ASSETS: Entry name '%s' must be 1 to %d characters\n", input.name.c_str(), ASSET_NAME_LENGTH - 1);
+            return false;
+        }
+        memcpy(entry.name, input.name.c_str(), input.name.size());
+        entry.type = input.type;
+        entry.size = input.bytes.size();
+        entry.hash = AssetHash(input.bytes.data(), input.bytes.size());
+
+        std::vector<uint8_t> packed;
+        if (input.compress && !input.bytes.empty()) packed = AssetCompress(input.bytes.data(), input.bytes.size());
+        if (!packed.empty() && (double)packed.size() <= (double)input.bytes.size()*(1.0 - ASSET_MIN_SAVING))
+        {
+            entry.codec = ASSET_CODEC_LZ;
+            payloads[i].swap(packed);
+        }
+        else
+        {
+            entry.codec = ASSET_CODEC_NONE;
+            payloads[i] = input.bytes;
+        }
+
+        offset = (offset + ASSET_PACK_ALIGN - 1) & ~(uint64_t)(ASSET_PACK_ALIGN - 1);
+        entry.offset = offset;
+        entry.packedSize = payloads[i].size();
+        offset += entry.packedSize;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "ASSETS: Failed to write %s\n", path);
+        return false;
+    }
+
+    AssetPackHeader header = { ASSET_PACK_MAGIC, ASSET_PACK_VERSION, (uint32_t)entries.size(), 0 };
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (!entries.empty()) ok = ok && fwrite(entries.data(), sizeof(AssetPackEntry), entries.size(), file) == entries.size();
+
+    uint64_t position = sizeof(AssetPackHeader) + sizeof(AssetPackEntry)*entries.size();
+    static const uint8_t zeros[ASSET_PACK_ALIGN] = {};
+    for (size_t i = 0; i < entries.size() && ok; i++)
+    {
+        ok = fwrite(zeros, 1, (size_t)(entries[i].offset - position), file) == entries[i].offset - position;
+        if (!payloads[i].empty()) ok = ok && fwrite(payloads[i].data(), 1, payloads[i].size(), file) == payloads[i].size();
+        position = entries[i].offset + entries[i].packedSize;
+    }
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) fprintf(stderr, "ASSETS: Failed to write %s\n", path);
+    return ok;
+}
+
+bool AssetPackOpen(AssetPack *pack, const char *path)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (!MapFile(pack, path)) return false;
+
+    AssetPackHeader header;
+    bool ok = pack->size >= sizeof(header);
+    if (ok)
+    {
+        memcpy(&header, pack->data, sizeof(header));
+        ok = header.magic == ASSET_PACK_MAGIC && header.version == ASSET_PACK_VERSION &&
+             (uint64_t)header.entryCount*sizeof(AssetPackEntry) <= pack->size - sizeof(header);
+    }
+
+    // Entries are read in place, so every one is checked once here
+    const AssetPackEntry *entries = (const AssetPackEntry *)(pack->data + sizeof(header));
+    for (uint32_t i = 0; ok && i < header.entryCount; i++)
+    {
+        const AssetPackEntry &entry = entries[i];
+        ok = memchr(entry.name, 0, ASSET_NAME_LENGTH) != nullptr &&
+             entry.offset <= pack->size && entry.packedSize <= pack->size - entry.offset &&
+             (entry.codec == ASSET_CODEC_LZ || (entry.codec == ASSET_CODEC_NONE && entry.size == entry.packedSize));
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "ASSETS: %s is not a valid archive\n", path);
+        UnmapFile(pack);
+        return false;
+    }
+
+    pack->entries = entries;
+    pack->entryCount = (int)header.entryCount;
+    pack->slots.reset(new AssetSlot[header.entryCount > 0 ? header.entryCount : 1]);
+    for (int i = 0; i < pack->entryCount; i++)
+    {
+        if (entries[i].codec == ASSET_CODEC_NONE) pack->slots[i].blob = { pack->data + entries[i].offset, (size_t)entries[i].size };
+    }
+    pack->closing = false;
+    pack->queue.clear();
+
+    pack->openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void AssetPackClose(AssetPack *pack)
+{
+    if (pack->worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(pack->mutex);
+            pack->closing = true;
+        }
+        pack->wake.notify_all();
+        pack->worker.join();
+    }
+
+    pack->queue.clear();
+    pack->slots.reset();
+    pack->entries = nullptr;
+    pack->entryCount = 0;
+    UnmapFile(pack);
+}
+
+int AssetPackFind(const AssetPack *pack, const char *name)
+{
+    for (int i = 0; i < pack->entryCount; i++)
+    {
+        if (strcmp(pack->entries[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+void AssetPackRequest(AssetPack *pack, int index)
+{
+    if (index < 0 || index >= pack->entryCount) return;
+
+    AssetSlot &slot = pack->slots[index];
+    const AssetPackEntry &entry = pack->entries[index];
+    int expected = ASSET_IDLE;
+
+    // Stored entries are used straight from the mapping, their blob is set at open
+    if (entry.codec == ASSET_CODEC_NONE)
+    {
+        slot.state.compare_exchange_strong(expected, ASSET_READY, std::memory_order_acq_rel);
+        return;
+    }
+
+    if (!slot.state.compare_exchange_strong(expected, ASSET_QUEUED, std::memory_order_acq_rel)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(pack->mutex);
+        pack->queue.push_back(index);
+        if (!pack->worker.joinable()) pack->worker = std::thread(WorkerLoop, pack);
+    }
+    pack->wake.notify_one();
+}
+
+const AssetBlob *AssetPackGet(AssetPack *pack, int index)
+{
+    if (index < 0 || index >= pack->entryCount) return nullptr;
+    if (pack->slots[index].state.load(std::memory_order_acquire) != ASSET_READY) return nullptr;
+    return &pack->slots[index].blob;
+}
+
+const AssetBlob *AssetPackWait(AssetPack *pack, int index)
+{
+    if (index < 0 || index >= pack->entryCount) return nullptr;
+
+    AssetSlot &slot = pack->slots[index];
+    AssetPackRequest(pack, index);
+
+    // Still waiting in the queue: decode here instead of behind the other entries
+    int expected = ASSET_QUEUED;
+    if (slot.state.compare_exchange_strong(expected, ASSET_DECODING, std::memory_order_acq_rel)) DecodeEntry(pack, index);
+
+    std::unique_lock<std::mutex> lock(pack->mutex);
+    pack->done.wait(lock, [&slot] { return slot.state.load(std::memory_order_acquire) >= ASSET_READY; });
+    return (slot.state.load(std::memory_order_acquire) == ASSET_READY) ? &slot.blob : nullptr;
+}
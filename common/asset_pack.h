@@ -0,0 +1,165 @@
+// asset_pack.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Packed resource archive. An offline packer (tools/asset_packer.cpp) bakes fonts into
+// glyph atlases, short sounds into PCM and keeps music in its streamable file format,
+// all in one indexed file. At runtime the file is memory mapped; an entry is only
+// decoded when requested, on a worker thread, and stored entries are used in place.
+// This part needs no raylib, asset_pack_raylib.cpp turns entries into Font, Sound and
+// Music.
+//
+// File layout, little endian: AssetPackHeader, entryCount AssetPackEntry records, then
+// the entry payloads, each starting on an ASSET_PACK_ALIGN boundary.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t ASSET_PACK_MAGIC = 0x4b415041;   // "APAK"
+constexpr uint32_t ASSET_PACK_VERSION = 1;
+constexpr int ASSET_NAME_LENGTH = 48;               // Including the terminator
+constexpr int ASSET_PACK_ALIGN = 16;
+
+// Entry types, each with its own payload layout
+constexpr uint32_t ASSET_RAW = 0;                   // Bytes as given
+constexpr uint32_t ASSET_FONT = 1;                  // AssetFontHeader, glyphs, atlas pixels
+constexpr uint32_t ASSET_WAVE = 2;                  // AssetWaveHeader, samples
+constexpr uint32_t ASSET_STREAM = 3;                // AssetStreamHeader, the original file
+
+// Payload codecs
+constexpr uint32_t ASSET_CODEC_NONE = 0;
+constexpr uint32_t ASSET_CODEC_LZ = 1;
+
+// Decode state of an entry
+constexpr int ASSET_IDLE = 0;
+constexpr int ASSET_QUEUED = 1;
+constexpr int ASSET_DECODING = 2;
+constexpr int ASSET_READY = 3;
+constexpr int ASSET_FAILED = 4;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct AssetPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct AssetPackEntry {
+    char name[ASSET_NAME_LENGTH];
+    uint32_t type;
+    uint32_t codec;
+    uint64_t offset;                   // From the start of the file
+    uint64_t packedSize;               // Bytes in the file
+    uint64_t size;                     // Bytes once decoded
+    uint32_t hash;                     // FNV-1a of the decoded bytes
+    uint32_t reserved;
+};
+
+struct AssetFontHeader {
+    int32_t baseSize;
+    int32_t glyphCount;
+    int32_t glyphPadding;
+    int32_t atlasWidth;
+    int32_t atlasHeight;
+    int32_t atlasFormat;               // raylib PixelFormat of the atlas pixels
+};
+
+// Followed by the atlas pixels
+struct AssetGlyph {
+    int32_t value;
+    int32_t offsetX;
+    int32_t offsetY;
+    int32_t advanceX;
+    float x, y, width, height;         // Rectangle in the atlas
+};
+
+struct AssetWaveHeader {
+    uint32_t frameCount;
+    uint32_t sampleRate;
+    uint32_t sampleSize;               // Bits
+    uint32_t channels;
+};
+
+struct AssetStreamHeader {
+    char fileType[8];                  // Extension raylib picks the decoder by, ".mp3"
+};
+
+// One entry for AssetPackWrite
+struct AssetPackInput {
+    std::string name;
+    uint32_t type = ASSET_RAW;
+    std::vector<uint8_t> bytes;        // Decoded payload
+    bool compress = true;              // Kept stored when compression saves little
+};
+
+// Decoded bytes of an entry, valid until AssetPackClose
+struct AssetBlob {
+    const uint8_t *data;
+    size_t size;
+};
+
+struct AssetSlot {
+    std::atomic<int> state{ASSET_IDLE};
+    std::vector<uint8_t> decoded;      // Owned bytes of compressed entries
+    AssetBlob blob{nullptr, 0};
+};
+
+struct AssetPack {
+    const uint8_t *data = nullptr;     // Whole file, mapped or read
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<uint8_t> fileCopy;     // Where mapping is not available
+
+    const AssetPackEntry *entries = nullptr;
+    int entryCount = 0;
+    std::unique_ptr<AssetSlot[]> slots;
+
+    // Decode worker, started by the first request that needs it
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;      // Work queued or closing
+    std::condition_variable done;      // An entry finished
+    std::deque<int> queue;
+    bool closing = false;
+
+    // Startup cost of AssetPackOpen
+    double openMs = 0.0;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Compresses entries as they ask and writes the archive. Returns false on I/O errors
+// or names that do not fit.
+bool AssetPackWrite(const char *path, const std::vector<AssetPackInput> &inputs);
+
+bool AssetPackOpen(AssetPack *pack, const char *path);
+void AssetPackClose(AssetPack *pack);
+int AssetPackFind(const AssetPack *pack, const char *name);     // -1 when missing
+
+// Queues the entry for decoding; stored entries are ready at once. Cheap to repeat.
+void AssetPackRequest(AssetPack *pack, int index);
+// nullptr until the entry is ready
+const AssetBlob *AssetPackGet(AssetPack *pack, int index);
+// Blocks until ready, decoding on the calling thread when the worker has not started
+// on it yet. nullptr when the entry is corrupt.
+const AssetBlob *AssetPackWait(AssetPack *pack, int index);
+
+// LZ77 block codec of the archive
+std::vector<uint8_t> AssetCompress(const uint8_t *data, size_t size);
+bool AssetDecompress(const uint8_t *packed, size_t packedSize, uint8_t *out, size_t size);
+uint32_t AssetHash(const uint8_t *data, size_t size);
@@ -0,0 +1,106 @@
+// asset_pack_raylib.cpp
+// Font, Wave, Sound and Music from archive entries, the only part of the asset pack
+// that needs raylib
+#include "asset_pack_raylib.h"
+#include <cstring>
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static const AssetBlob *WaitTyped(AssetPack *pack, const char *name, uint32_t type, size_t headerSize)
+{
+    int index = AssetPackFind(pack, name);
+    if (index < 0 || pack->entries[index].type != type)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: No entry %s of type %u", name, type);
+        return nullptr;
+    }
+
+    const AssetBlob *blob = AssetPackWait(pack, index);
+    if (blob == nullptr || blob->size < headerSize) return nullptr;
+    return blob;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+Font AssetLoadFont(AssetPack *pack, const char *name)
+{
+    Font font = {};
+    const AssetBlob *blob = WaitTyped(pack, name, ASSET_FONT, sizeof(AssetFontHeader));
+    if (blob == nullptr) return font;
+
+    AssetFontHeader header;
+    memcpy(&header, blob->data, sizeof(header));
+    size_t glyphBytes = (size_t)header.glyphCount*sizeof(AssetGlyph);
+    size_t bytesPerPixel = (header.atlasFormat == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) ? 2 : 4;
+    size_t pixelBytes = (size_t)header.atlasWidth*header.atlasHeight*bytesPerPixel;
+    if (header.glyphCount <= 0 || blob->size != sizeof(header) + glyphBytes + pixelBytes)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: Font %s has an unexpected size", name);
+        return font;
+    }
+
+    const uint8_t *glyphData = blob->data + sizeof(header);
+    Image atlas = { (void *)(glyphData + glyphBytes), header.atlasWidth, header.atlasHeight, 1, header.atlasFormat };
+    font.texture = LoadTextureFromImage(atlas);
+    font.baseSize = header.baseSize;
+    font.glyphCount = header.glyphCount;
+    font.glyphPadding = header.glyphPadding;
+
+    // Allocated the way raylib does, so UnloadFont frees them; glyph images stay empty
+    // as DrawTextEx only reads the atlas
+    font.recs = (Rectangle *)RL_MALLOC(header.glyphCount*sizeof(Rectangle));
+    font.glyphs = (GlyphInfo *)RL_CALLOC(header.glyphCount, sizeof(GlyphInfo));
+    for (int i = 0; i < header.glyphCount; i++)
+    {
+        AssetGlyph glyph;
+        memcpy(&glyph, glyphData + i*sizeof(AssetGlyph), sizeof(glyph));
+        font.glyphs[i].value = glyph.value;
+        font.glyphs[i].offsetX = glyph.offsetX;
+        font.glyphs[i].offsetY = glyph.offsetY;
+        font.glyphs[i].advanceX = glyph.advanceX;
+        font.recs[i] = { glyph.x, glyph.y, glyph.width, glyph.height };
+    }
+    return font;
+}
+
+Wave AssetLoadWave(AssetPack *pack, const char *name)
+{
+    Wave wave = {};
+    const AssetBlob *blob = WaitTyped(pack, name, ASSET_WAVE, sizeof(AssetWaveHeader));
+    if (blob == nullptr) return wave;
+
+    AssetWaveHeader header;
+    memcpy(&header, blob->data, sizeof(header));
+    if (blob->size != sizeof(header) + (size_t)header.frameCount*header.channels*(header.sampleSize/8))
+    {
+        TraceLog(LOG_WARNING, "ASSETS: Wave %s has an unexpected size", name);
+        return wave;
+    }
+
+    wave.frameCount = header.frameCount;
+    wave.sampleRate = header.sampleRate;
+    wave.sampleSize = header.sampleSize;
+    wave.channels = header.channels;
+    wave.data = (void *)(blob->data + sizeof(header));
+    return wave;
+}
+
+Sound AssetLoadSound(AssetPack *pack, const char *name)
+{
+    Wave wave = AssetLoadWave(pack, name);
+    if (wave.frameCount == 0) return Sound{};
+    return LoadSoundFromWave(wave);
+}
+
+Music AssetLoadMusic(AssetPack *pack, const char *name)
+{
+    const AssetBlob *blob = WaitTyped(pack, name, ASSET_STREAM, sizeof(AssetStreamHeader));
+    if (blob == nullptr) return Music{};
+
+    AssetStreamHeader header;
+    memcpy(&header, blob->data, sizeof(header));
+    header.fileType[sizeof(header.fileType) - 1] = '\0';
+    return LoadMusicStreamFromMemory(header.fileType, blob->data + sizeof(header), (int)(blob->size - sizeof(header)));
+}
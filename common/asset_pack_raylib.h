@@ -0,0 +1,20 @@
+// asset_pack_raylib.h
+// raylib objects from AssetPack entries
+#pragma once
+#include "raylib.h"
+#include "asset_pack.h"
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Each waits for its entry (see AssetPackWait) and fails with an empty object (zero
+// texture id or frame count) when the entry is missing, corrupt or of another type.
+
+// Atlas, glyph metrics and rectangles as LoadFontEx makes them; release with UnloadFont
+Font AssetLoadFont(AssetPack *pack, const char *name);
+// Samples point into the pack: do not UnloadWave, it stays valid until AssetPackClose
+Wave AssetLoadWave(AssetPack *pack, const char *name);
+// Copies the samples into a sound buffer; release with UnloadSound
+Sound AssetLoadSound(AssetPack *pack, const char *name);
+// Streams from the pack's memory, which must stay open while it plays
+Music AssetLoadMusic(AssetPack *pack, const char *name);
@@ -0,0 +1,272 @@
+// audio_mixer.cpp
+#include "audio_mixer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr uint32_t QUEUE_MASK = AUDIO_QUEUE_SIZE - 1;
+constexpr uint32_t OUTPUT_MASK = AUDIO_OUTPUT_FRAMES - 1;
+constexpr uint32_t MUSIC_MASK = AUDIO_MUSIC_FRAMES - 1;
+constexpr int32_t UNITY_GAIN = 256;
+constexpr int32_t MAX_GAIN = 4*UNITY_GAIN;
+
+// Half a pass, so the output ring never runs lower than one pass ahead of the device
+constexpr auto MIXER_SLEEP = std::chrono::microseconds(1000000LL*AUDIO_MIX_FRAMES/AUDIO_SAMPLE_RATE/2);
+constexpr auto PULL_PERIOD = std::chrono::microseconds(1000000LL*AUDIO_MIX_FRAMES/AUDIO_SAMPLE_RATE);
+
+static_assert((AUDIO_QUEUE_SIZE & QUEUE_MASK) == 0, "AUDIO_QUEUE_SIZE must be a power of two");
+static_assert((AUDIO_OUTPUT_FRAMES & OUTPUT_MASK) == 0, "AUDIO_OUTPUT_FRAMES must be a power of two");
+static_assert((AUDIO_MUSIC_FRAMES & MUSIC_MASK) == 0, "AUDIO_MUSIC_FRAMES must be a power of two");
+static_assert(AUDIO_OUTPUT_FRAMES % AUDIO_MIX_FRAMES == 0, "A pass must not wrap the output ring");
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static int32_t GainFromVolume(float volume)
+{
+    return std::min(std::max((int32_t)(volume*UNITY_GAIN + 0.5f), 0), MAX_GAIN);
+}
+
+static void StartVoice(AudioMixer *mixer, int clip, int32_t gain)
+{
+    int slot = mixer->voiceCount;
+    if (slot == AUDIO_MAX_VOICES)
+    {
+        // Steal the voice furthest into its clip
+        slot = 0;
+        for (int i = 1; i < AUDIO_MAX_VOICES; i++)
+        {
+            if (mixer->voices[i].position > mixer->voices[slot].position) slot = i;
+        }
+    }
+    else mixer->voiceCount++;
+
+    mixer->voices[slot] = { clip, 0, gain };
+}
+
+static void ApplyCommands(AudioMixer *mixer)
+{
+    uint32_t tail = mixer->commandTail.load(std::memory_order_relaxed);
+    uint32_t head = mixer->commandHead.load(std::memory_order_acquire);
+    if (tail == head) return;
+
+    for (uint32_t i = tail; i != head; i++)
+    {
+        const AudioCommand &command = mixer->commands[i & QUEUE_MASK];
+        switch (command.type)
+        {
+            case AUDIO_CMD_PLAY: StartVoice(mixer, command.clip, GainFromVolume(command.volume)); break;
+            case AUDIO_CMD_STOP_CLIPS: mixer->voiceCount = 0; break;
+            case AUDIO_CMD_MUSIC_PLAY: mixer->musicPlaying = (mixer->musicRead != nullptr); break;
+            case AUDIO_CMD_MUSIC_STOP: mixer->musicPlaying = false; break;
+            case AUDIO_CMD_MUSIC_VOLUME: mixer->musicGain = GainFromVolume(command.volume); break;
+        }
+    }
+
+    mixer->commandTail.store(head, std::memory_order_release);
+    mixer->commandsApplied.store(mixer->commandsApplied.load(std::memory_order_relaxed) + (head - tail), std::memory_order_relaxed);
+}
+
+// Decodes ahead in large reads while the ring has room for one
+static void FillMusic(AudioMixer *mixer)
+{
+    while (AUDIO_MUSIC_FRAMES - (mixer->musicWrite - mixer->musicReadPos) >= (uint32_t)AUDIO_MUSIC_READ_FRAMES)
+    {
+        uint32_t at = mixer->musicWrite & MUSIC_MASK;
+        int contiguous = std::min(AUDIO_MUSIC_READ_FRAMES, (int)(AUDIO_MUSIC_FRAMES - at));
+        int frames = mixer->musicRead(mixer->musicUser, &mixer->music[at*AUDIO_CHANNELS], contiguous);
+        if (frames <= 0) break;
+        mixer->musicWrite += (uint32_t)std::min(frames, contiguous);
+    }
+}
+
+static void MixPass(AudioMixer *mixer)
+{
+    int32_t *mix = mixer->mixBuffer.data();
+    memset(mix, 0, sizeof(int32_t)*AUDIO_MIX_FRAMES*AUDIO_CHANNELS);
+
+    // Music, stopping for good once a finite source has run dry
+    if (mixer->musicPlaying)
+    {
+        int frames = (int)std::min(mixer->musicWrite - mixer->musicReadPos, (uint32_t)AUDIO_MIX_FRAMES);
+        if (frames == 0) mixer->musicPlaying = false;
+        for (int i = 0; i < frames; i++)
+        {
+            const int16_t *frame = &mixer->music[((mixer->musicReadPos + i) & MUSIC_MASK)*AUDIO_CHANNELS];
+            mix[i*2] += frame[0]*mixer->musicGain;
+            mix[i*2 + 1] += frame[1]*mixer->musicGain;
+        }
+        mixer->musicReadPos += (uint32_t)frames;
+    }
+
+    for (int v = 0; v < mixer->voiceCount; )
+    {
+        AudioVoice &voice = mixer->voices[v];
+        const AudioClip &clip = mixer->clips[voice.clip];
+        int frames = std::min(clip.frameCount - voice.position, AUDIO_MIX_FRAMES);
+        const int16_t *samples = &clip.samples[(size_t)voice.position*AUDIO_CHANNELS];
+        for (int i = 0; i < frames*AUDIO_CHANNELS; i++) mix[i] += samples[i]*voice.gain;
+
+        voice.position += frames;
+        if (voice.position >= clip.frameCount) voice = mixer->voices[--mixer->voiceCount];
+        else v++;
+    }
+
+    uint32_t write = mixer->outputWrite.load(std::memory_order_relaxed);
+    int16_t *out = &mixer->output[(write & OUTPUT_MASK)*AUDIO_CHANNELS];
+    for (int i = 0; i < AUDIO_MIX_FRAMES*AUDIO_CHANNELS; i++)
+    {
+        out[i] = (int16_t)std::min(std::max(mix[i]/UNITY_GAIN, -32768), 32767);
+    }
+    mixer->outputWrite.store(write + AUDIO_MIX_FRAMES, std::memory_order_release);
+    mixer->framesMixed.store(mixer->framesMixed.load(std::memory_order_relaxed) + AUDIO_MIX_FRAMES, std::memory_order_relaxed);
+}
+
+static void MixerLoop(AudioMixer *mixer)
+{
+    while (mixer->running.load(std::memory_order_acquire))
+    {
+        AudioMixerUpdate(mixer);
+        std::this_thread::sleep_for(MIXER_SLEEP);
+    }
+}
+
+static void NullBackendLoop(AudioNullBackend *backend)
+{
+    std::vector<int16_t> frames(AUDIO_MIX_FRAMES*AUDIO_CHANNELS);
+    auto next = std::chrono::steady_clock::now();
+
+    while (backend->running.load(std::memory_order_acquire))
+    {
+        int got = AudioMixerRead(backend->mixer, frames.data(), AUDIO_MIX_FRAMES);
+        int32_t peak = backend->peak.load(std::memory_order_relaxed);
+        for (int16_t sample : frames) peak = std::max(peak, (int32_t)std::abs((int32_t)sample));
+        backend->peak.store(peak, std::memory_order_relaxed);
+        backend->framesPulled.store(backend->framesPulled.load(std::memory_order_relaxed) + (uint64_t)got, std::memory_order_relaxed);
+
+        next += PULL_PERIOD;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void AudioMixerInit(AudioMixer *mixer)
+{
+    mixer->clipCount = 0;
+    mixer->voiceCount = 0;
+    mixer->musicPlaying = false;
+    mixer->musicGain = UNITY_GAIN;
+    mixer->music.assign((size_t)AUDIO_MUSIC_FRAMES*AUDIO_CHANNELS, 0);
+    mixer->musicWrite = mixer->musicReadPos = 0;
+    mixer->mixBuffer.assign((size_t)AUDIO_MIX_FRAMES*AUDIO_CHANNELS, 0);
+    mixer->output.assign((size_t)AUDIO_OUTPUT_FRAMES*AUDIO_CHANNELS, 0);
+}
+
+int AudioMixerAddClip(AudioMixer *mixer, const int16_t *frames, int frameCount)
+{
+    if (mixer->clipCount == AUDIO_MAX_CLIPS || frameCount <= 0) return -1;
+
+    AudioClip &clip = mixer->clips[mixer->clipCount];
+    clip.samples.assign(frames, frames + (size_t)frameCount*AUDIO_CHANNELS);
+    clip.frameCount = frameCount;
+    return mixer->clipCount++;
+}
+
+void AudioMixerSetMusic(AudioMixer *mixer, AudioStreamReadFunc read, void *user)
+{
+    mixer->musicRead = read;
+    mixer->musicUser = user;
+}
+
+void AudioMixerStart(AudioMixer *mixer)
+{
+    if (mixer->running.load()) return;
+    mixer->running.store(true, std::memory_order_release);
+    mixer->thread = std::thread(MixerLoop, mixer);
+}
+
+void AudioMixerStop(AudioMixer *mixer)
+{
+    if (!mixer->running.load()) return;
+    mixer->running.store(false, std::memory_order_release);
+    mixer->thread.join();
+}
+
+bool AudioMixerPush(AudioMixer *mixer, AudioCommand command)
+{
+    uint32_t head = mixer->commandHead.load(std::memory_order_relaxed);
+    if (head - mixer->commandTail.load(std::memory_order_acquire) >= (uint32_t)AUDIO_QUEUE_SIZE)
+    {
+        mixer->droppedCommands.store(mixer->droppedCommands.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    mixer->commands[head & QUEUE_MASK] = command;
+    mixer->commandHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioMixerPlay(AudioMixer *mixer, int clip, float volume)
+{
+    if (clip < 0 || clip >= mixer->clipCount) return false;
+    return AudioMixerPush(mixer, { AUDIO_CMD_PLAY, clip, volume });
+}
+
+int AudioMixerUpdate(AudioMixer *mixer)
+{
+    ApplyCommands(mixer);
+    if (mixer->musicPlaying) FillMusic(mixer);
+
+    int mixed = 0;
+    while (AUDIO_OUTPUT_FRAMES - (mixer->outputWrite.load(std::memory_order_relaxed) -
+                                  mixer->outputRead.load(std::memory_order_acquire)) >= (uint32_t)AUDIO_MIX_FRAMES)
+    {
+        MixPass(mixer);
+        mixed += AUDIO_MIX_FRAMES;
+    }
+    return mixed;
+}
+
+int AudioMixerRead(AudioMixer *mixer, int16_t *frames, int frameCount)
+{
+    uint32_t read = mixer->outputRead.load(std::memory_order_relaxed);
+    uint32_t available = mixer->outputWrite.load(std::memory_order_acquire) - read;
+    int count = (int)std::min(available, (uint32_t)frameCount);
+
+    // At most two pieces around the end of the ring
+    uint32_t at = read & OUTPUT_MASK;
+    int first = std::min(count, (int)(AUDIO_OUTPUT_FRAMES - at));
+    memcpy(frames, &mixer->output[at*AUDIO_CHANNELS], sizeof(int16_t)*first*AUDIO_CHANNELS);
+    memcpy(frames + first*AUDIO_CHANNELS, mixer->output.data(), sizeof(int16_t)*(count - first)*AUDIO_CHANNELS);
+    mixer->outputRead.store(read + (uint32_t)count, std::memory_order_release);
+
+    if (count < frameCount)
+    {
+        memset(frames + count*AUDIO_CHANNELS, 0, sizeof(int16_t)*(frameCount - count)*AUDIO_CHANNELS);
+        mixer->underruns.store(mixer->underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void AudioNullBackendStart(AudioNullBackend *backend, AudioMixer *mixer)
+{
+    if (backend->running.load()) return;
+    backend->mixer = mixer;
+    backend->framesPulled.store(0);
+    backend->peak.store(0);
+    backend->running.store(true, std::memory_order_release);
+    backend->thread = std::thread(NullBackendLoop, backend);
+}
+
+void AudioNullBackendStop(AudioNullBackend *backend)
+{
+    if (!backend->running.load()) return;
+    backend->running.store(false, std::memory_order_release);
+    backend->thread.join();
+}
@@ -0,0 +1,139 @@
+// audio_mixer.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Software mixer on its own thread. The game thread only pushes small commands into a
+// lock-free queue (AudioMixerPlay costs a few stores); the mixer thread applies them,
+// keeps a music ring filled ahead from a stream source, mixes the playing clips over
+// the music and leaves the result in an output ring. The audio device drains that ring
+// from its callback, or the null backend does when there is no device.
+//
+// Clips are decoded up front to AUDIO_SAMPLE_RATE 16-bit stereo. No raylib here,
+// audio_mixer_raylib.cpp has the device and the decoders.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int AUDIO_SAMPLE_RATE = 48000;
+constexpr int AUDIO_CHANNELS = 2;
+constexpr int AUDIO_MAX_CLIPS = 32;
+constexpr int AUDIO_MAX_VOICES = 16;           // Clips playing at once, the oldest makes room
+constexpr int AUDIO_QUEUE_SIZE = 256;          // Commands, a power of two
+constexpr int AUDIO_MIX_FRAMES = 256;          // Frames mixed per pass, about 5 ms
+constexpr int AUDIO_OUTPUT_FRAMES = 2048;      // Output ring, a power of two, about 43 ms
+constexpr int AUDIO_MUSIC_FRAMES = 16384;      // Music ring, a power of two
+constexpr int AUDIO_MUSIC_READ_FRAMES = 4096;  // Frames asked from the stream source at once
+
+enum AudioCommandType : uint32_t {
+    AUDIO_CMD_PLAY,                    // clip at volume
+    AUDIO_CMD_STOP_CLIPS,
+    AUDIO_CMD_MUSIC_PLAY,              // From where it stopped
+    AUDIO_CMD_MUSIC_STOP,
+    AUDIO_CMD_MUSIC_VOLUME             // volume
+};
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct AudioCommand {
+    AudioCommandType type;
+    int32_t clip;
+    float volume;
+};
+
+// Music source: writes up to frameCount interleaved stereo frames and returns how many,
+// 0 when it has nothing more (a looping source never does). Called on the mixer thread,
+// so it must not block: a read that stalls lets the output ring run dry. The raylib
+// source (AudioMusicSource) is predecoded while loading and only copies here.
+typedef int (*AudioStreamReadFunc)(void *user, int16_t *frames, int frameCount);
+
+struct AudioClip {
+    std::vector<int16_t> samples;      // Interleaved stereo
+    int frameCount = 0;
+};
+
+struct AudioVoice {
+    int clip;
+    int position;                      // Next frame
+    int32_t gain;                      // Volume in 1/256
+};
+
+struct AudioMixer {
+    // Game thread -> mixer thread, single producer, single consumer
+    alignas(64) std::atomic<uint32_t> commandHead{0};  // Next write, owned by the producer
+    alignas(64) std::atomic<uint32_t> commandTail{0};  // Next read, owned by the mixer
+    std::atomic<uint32_t> droppedCommands{0};          // Queue was full, written by the producer
+    AudioCommand commands[AUDIO_QUEUE_SIZE];
+
+    // Set up before AudioMixerStart, read only afterwards
+    AudioClip clips[AUDIO_MAX_CLIPS];
+    int clipCount = 0;
+    AudioStreamReadFunc musicRead = nullptr;
+    void *musicUser = nullptr;
+
+    // Mixer thread only
+    AudioVoice voices[AUDIO_MAX_VOICES];
+    int voiceCount = 0;
+    bool musicPlaying = false;
+    int32_t musicGain = 256;
+    std::vector<int16_t> music;        // Ring of AUDIO_MUSIC_FRAMES decoded ahead
+    uint32_t musicWrite = 0;
+    uint32_t musicReadPos = 0;
+    std::vector<int32_t> mixBuffer;
+
+    // Mixer thread -> device, single producer, single consumer
+    std::vector<int16_t> output;       // Ring of AUDIO_OUTPUT_FRAMES
+    alignas(64) std::atomic<uint32_t> outputWrite{0};  // Frames, owned by the mixer
+    alignas(64) std::atomic<uint32_t> outputRead{0};   // Frames, owned by the device
+    std::atomic<uint32_t> underruns{0};                // Device reads that found too little, written by the device
+
+    // Statistics, written by the mixer thread
+    std::atomic<uint32_t> commandsApplied{0};
+    std::atomic<uint64_t> framesMixed{0};
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+};
+
+// Drains the mixer in real time and throws the frames away, for runs without a device
+struct AudioNullBackend {
+    AudioMixer *mixer = nullptr;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> framesPulled{0};
+    std::atomic<int32_t> peak{0};      // Largest absolute sample seen
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+void AudioMixerInit(AudioMixer *mixer);
+// Copies AUDIO_SAMPLE_RATE stereo frames, returns the clip id or -1 (full or empty)
+int AudioMixerAddClip(AudioMixer *mixer, const int16_t *frames, int frameCount);
+void AudioMixerSetMusic(AudioMixer *mixer, AudioStreamReadFunc read, void *user);
+
+// The mixer thread, which calls AudioMixerUpdate every few milliseconds
+void AudioMixerStart(AudioMixer *mixer);
+void AudioMixerStop(AudioMixer *mixer);
+
+// Game thread. Lock-free and allocation-free; false when the queue is full (the
+// command is dropped and counted) or the clip does not exist.
+bool AudioMixerPush(AudioMixer *mixer, AudioCommand command);
+bool AudioMixerPlay(AudioMixer *mixer, int clip, float volume);
+
+// One mixer pass: applies queued commands, tops up the music ring and mixes until the
+// output ring is full. Returns the frames mixed. Only ever from one thread at a time,
+// the mixer thread once it is started.
+int AudioMixerUpdate(AudioMixer *mixer);
+
+// Device side: copies frameCount stereo frames out of the output ring, silence for
+// whatever is missing. Returns the frames that were really mixed.
+int AudioMixerRead(AudioMixer *mixer, int16_t *frames, int frameCount);
+
+void AudioNullBackendStart(AudioNullBackend *backend, AudioMixer *mixer);
+void AudioNullBackendStop(AudioNullBackend *backend);
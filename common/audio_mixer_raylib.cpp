@@ -0,0 +1,92 @@
+// audio_mixer_raylib.cpp
+// The raylib side of the mixer: the device callback that drains the output ring, and
+// wave conversion and music predecoding into the mixer format
+#include "audio_mixer_raylib.h"
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Frames the device asks for per callback, half the output ring
+constexpr int DEVICE_BUFFER_FRAMES = AUDIO_OUTPUT_FRAMES/2;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+// raylib's stream callback carries no user pointer
+static AudioMixer *deviceMixer = nullptr;
+static AudioStream deviceStream = {};
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Runs on the audio device thread
+static void DeviceCallback(void *buffer, unsigned int frames)
+{
+    AudioMixerRead(deviceMixer, (int16_t *)buffer, (int)frames);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+int AudioMixerAddWave(AudioMixer *mixer, Wave wave)
+{
+    if (wave.data == nullptr || wave.frameCount == 0) return -1;
+
+    Wave converted = WaveCopy(wave);
+    WaveFormat(&converted, AUDIO_SAMPLE_RATE, 16, AUDIO_CHANNELS);
+    int clip = AudioMixerAddClip(mixer, (const int16_t *)converted.data, (int)converted.frameCount);
+    UnloadWave(converted);
+    return clip;
+}
+
+void AudioMusicSourceInit(AudioMusicSource *source, const char *fileType, const unsigned char *data, int size)
+{
+    memset(source, 0, sizeof(*source));
+    source->wave = LoadWaveFromMemory(fileType, data, size);
+    if (source->wave.data != nullptr) WaveFormat(&source->wave, AUDIO_SAMPLE_RATE, 16, AUDIO_CHANNELS);
+}
+
+int AudioMusicSourceRead(void *user, int16_t *frames, int frameCount)
+{
+    AudioMusicSource *source = (AudioMusicSource *)user;
+    if (source->wave.data == nullptr || source->wave.frameCount == 0) return 0;
+
+    // Up to the end of the track, the next read starts over
+    unsigned int count = source->wave.frameCount - source->position;
+    if (count > (unsigned int)frameCount) count = (unsigned int)frameCount;
+    memcpy(frames, (const int16_t *)source->wave.data + (size_t)source->position*AUDIO_CHANNELS, sizeof(int16_t)*count*AUDIO_CHANNELS);
+    source->position += count;
+    if (source->position == source->wave.frameCount) source->position = 0;
+    return (int)count;
+}
+
+void AudioMusicSourceUnload(AudioMusicSource *source)
+{
+    if (source->wave.data != nullptr) UnloadWave(source->wave);
+    source->wave = Wave{};
+    source->position = 0;
+}
+
+bool AudioDeviceStart(AudioMixer *mixer)
+{
+    if (!IsAudioDeviceReady() || deviceMixer != nullptr) return false;
+
+    deviceMixer = mixer;
+    SetAudioStreamBufferSizeDefault(DEVICE_BUFFER_FRAMES);
+    deviceStream = LoadAudioStream(AUDIO_SAMPLE_RATE, 16, AUDIO_CHANNELS);
+    SetAudioStreamBufferSizeDefault(0);
+
+    SetAudioStreamCallback(deviceStream, DeviceCallback);
+    PlayAudioStream(deviceStream);
+    return true;
+}
+
+void AudioDeviceStop(void)
+{
+    if (deviceMixer == nullptr) return;
+    StopAudioStream(deviceStream);
+    UnloadAudioStream(deviceStream);
+    deviceStream = {};
+    deviceMixer = nullptr;
+}
@@ -0,0 +1,35 @@
+// audio_mixer_raylib.h
+// raylib device output and decoders for the AudioMixer
+#pragma once
+#include "raylib.h"
+#include "audio_mixer.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Looping music from an encoded file in memory (.mp3, .ogg, ...). raylib has no
+// incremental decoder in its API, so this is a predecode, not a streaming decoder:
+// AudioMusicSourceInit decodes the whole file on the loading thread and keeps the PCM
+// (about 10 MB a minute). Reads on the mixer thread are copies out of it, so music
+// starting never stalls the mixer; the mixer then streams it through its ring.
+struct AudioMusicSource {
+    Wave wave;                         // Decoded to the mixer format
+    unsigned int position;             // Next frame
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Adds a converted copy of wave (any rate, sample size or channels) as a clip; wave
+// itself is left alone. Returns the clip id or -1.
+int AudioMixerAddWave(AudioMixer *mixer, Wave wave);
+
+// Decodes the whole file, before AudioMixerStart or on a loader thread; data can be
+// freed once it returns
+void AudioMusicSourceInit(AudioMusicSource *source, const char *fileType, const unsigned char *data, int size);
+int AudioMusicSourceRead(void *user, int16_t *frames, int frameCount);     // AudioStreamReadFunc
+void AudioMusicSourceUnload(AudioMusicSource *source);                     // After AudioMixerStop
+
+// Plays one mixer through the raylib audio device, after InitAudioDevice
+bool AudioDeviceStart(AudioMixer *mixer);
+void AudioDeviceStop(void);
@@ -0,0 +1,303 @@
+// asset_pack_bench.cpp
+// Checks the archive codec and reader (round trips, damaged input, in-place stored
+// entries, corrupt entries) and times what startup pays for assets: opening the
+// archive, the first entry the game waits for and the rest decoding behind it, next
+// to reading the same payloads as loose files.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -pthread -I. -I../bench bench/asset_pack_bench.cpp ../bench/bench_suite.cpp asset_pack.cpp -o asset_pack_bench
+#include "asset_pack.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char *PACK_FILE = "asset_pack_bench.pak";
+static const char *LOOSE_PREFIX = "asset_pack_bench_loose_";
+constexpr int BENCH_RUNS = 20;
+
+static double MsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------
+// Payloads shaped like the Tetris assets
+//------------------------------------------------------------------------------------
+// Gray-alpha glyph atlas: mostly empty with solid pixel-font blocks
+static std::vector<uint8_t> MakeAtlas(int width, int height, std::mt19937 *rng)
+{
+    std::vector<uint8_t> pixels((size_t)width*height*2, 0);
+    int cellWidth = width/12, cellHeight = height/8;
+    for (int glyph = 0; glyph < 95; glyph++)
+    {
+        int gx = (glyph % 12)*cellWidth + 4;
+        int gy = (glyph/12)*cellHeight + 4;
+        for (int y = 0; y < cellHeight - 8; y++)
+        {
+            for (int x = 0; x < cellWidth*3/4; x++)
+            {
+                bool on = (((*rng)() & 3) != 0) && ((x/4 + y/4) & 1);
+                size_t at = ((size_t)(gy + y)*width + gx + x)*2;
+                pixels[at] = 255;
+                pixels[at + 1] = on ? 255 : 0;
+            }
+        }
+    }
+    return pixels;
+}
+
+// 16-bit stereo tone with a decay and a little noise, like a short effect
+static std::vector<uint8_t> MakeWave(int frames, std::mt19937 *rng)
+{
+    std::vector<uint8_t> bytes(sizeof(AssetWaveHeader) + (size_t)frames*4);
+    AssetWaveHeader header = { (uint32_t)frames, 48000, 16, 2 };
+    memcpy(bytes.data(), &header, sizeof(header));
+
+    int16_t *samples = (int16_t *)(bytes.data() + sizeof(header));
+    for (int i = 0; i < frames; i++)
+    {
+        float envelope = expf(-(float)i/(float)frames*4.0f);
+        float value = sinf((float)i*0.06f)*envelope*20000.0f + (float)((*rng)() % 64) - 32.0f;
+        samples[i*2] = samples[i*2 + 1] = (int16_t)value;
+    }
+    return bytes;
+}
+
+static std::vector<uint8_t> MakeRandom(size_t size, std::mt19937 *rng)
+{
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t &b : bytes) b = (uint8_t)(*rng)();
+    return bytes;
+}
+
+//------------------------------------------------------------------------------------
+// Checks
+//------------------------------------------------------------------------------------
+static bool RoundTrip(const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> packed = AssetCompress(data.data(), data.size());
+    std::vector<uint8_t> out(data.size());
+    return AssetDecompress(packed.data(), packed.size(), out.data(), out.size()) && out == data;
+}
+
+static void CheckCodec(void)
+{
+    std::mt19937 rng(7);
+
+    BenchCheck(RoundTrip({}), "codec: empty");
+    for (size_t size = 1; size < 300; size += 7)
+    {
+        BenchCheck(RoundTrip(MakeRandom(size, &rng)), "codec: small random");
+        BenchCheck(RoundTrip(std::vector<uint8_t>(size, 0xab)), "codec: small run");
+    }
+    BenchCheck(RoundTrip(std::vector<uint8_t>(1 << 20, 0)), "codec: long zero run");
+    BenchCheck(RoundTrip(MakeRandom(1 << 18, &rng)), "codec: incompressible");
+    BenchCheck(RoundTrip(MakeAtlas(512, 256, &rng)), "codec: atlas");
+    BenchCheck(RoundTrip(MakeWave(48000, &rng)), "codec: wave");
+
+    // Repeats further back than a match can reach, and overlapping short periods
+    std::vector<uint8_t> far = MakeRandom(70000, &rng);
+    far.insert(far.end(), far.begin(), far.begin() + 1000);
+    BenchCheck(RoundTrip(far), "codec: repeat beyond the window");
+    std::vector<uint8_t> periods;
+    for (int i = 0; i < 5000; i++) periods.push_back((uint8_t)(i % 3));
+    BenchCheck(RoundTrip(periods), "codec: overlapping matches");
+
+    // Damaged streams must fail or decode to something, never write out of bounds
+    std::vector<uint8_t> source = MakeAtlas(256, 128, &rng);
+    std::vector<uint8_t> packed = AssetCompress(source.data(), source.size());
+    std::vector<uint8_t> out(source.size());
+    BenchCheck(!AssetDecompress(packed.data(), packed.size()/2, out.data(), out.size()), "codec: truncated input rejected");
+    BenchCheck(!AssetDecompress(packed.data(), packed.size(), out.data(), out.size() - 1), "codec: short output rejected");
+    for (int trial = 0; trial < 2000; trial++)
+    {
+        std::vector<uint8_t> damaged = packed;
+        for (int flips = 0; flips < 4; flips++) damaged[rng() % damaged.size()] ^= (uint8_t)(1 << (rng() % 8));
+        AssetDecompress(damaged.data(), damaged.size(), out.data(), out.size());
+    }
+}
+
+// Entries of the bench archive, in the order the game would want them
+static std::vector<AssetPackInput> MakeInputs(void)
+{
+    std::mt19937 rng(11);
+    std::vector<AssetPackInput> inputs(5);
+
+    inputs[0].name = "font/monogram";
+    inputs[0].type = ASSET_FONT;
+    inputs[0].bytes = MakeAtlas(1024, 512, &rng);
+    inputs[1].name = "sound/rotate";
+    inputs[1].type = ASSET_WAVE;
+    inputs[1].bytes = MakeWave(24000, &rng);
+    inputs[2].name = "sound/clear";
+    inputs[2].type = ASSET_WAVE;
+    inputs[2].bytes = MakeWave(48000, &rng);
+    inputs[3].name = "music/main";
+    inputs[3].type = ASSET_STREAM;
+    inputs[3].bytes = MakeRandom(1355520, &rng);
+    inputs[3].compress = false;
+    inputs[4].name = "empty";
+    return inputs;
+}
+
+static void CheckArchive(const std::vector<AssetPackInput> &inputs)
+{
+    BenchCheck(AssetPackWrite(PACK_FILE, inputs), "archive: written");
+
+    AssetPack pack;
+    BenchCheck(AssetPackOpen(&pack, PACK_FILE), "archive: opened");
+    if (pack.entryCount != (int)inputs.size())
+    {
+        BenchCheck(false, "archive: entry count");
+        AssetPackClose(&pack);
+        return;
+    }
+
+    BenchCheck(AssetPackFind(&pack, "missing") == -1, "archive: missing name");
+    int atlas = AssetPackFind(&pack, "font/monogram");
+    int music = AssetPackFind(&pack, "music/main");
+    BenchCheck(pack.entries[atlas].codec == ASSET_CODEC_LZ, "archive: atlas compressed");
+    BenchCheck(pack.entries[music].codec == ASSET_CODEC_NONE, "archive: stream stored");
+    BenchCheck(AssetPackGet(&pack, atlas) == nullptr, "archive: nothing decoded before a request");
+
+    for (int i = 0; i < pack.entryCount; i++) AssetPackRequest(&pack, i);
+    for (int i = pack.entryCount - 1; i >= 0; i--)
+    {
+        const AssetBlob *blob = AssetPackWait(&pack, i);
+        BenchCheck(blob != nullptr && blob->size == inputs[i].bytes.size() &&
+              (blob->size == 0 || memcmp(blob->data, inputs[i].bytes.data(), blob->size) == 0), "archive: entry round trip");
+        BenchCheck(AssetPackGet(&pack, i) == blob, "archive: ready after wait");
+    }
+
+    const AssetBlob *stored = AssetPackGet(&pack, music);
+    BenchCheck(stored != nullptr && stored->data >= pack.data && stored->data + stored->size <= pack.data + pack.size, "archive: stored entry used in place");
+    BenchCheck(((uintptr_t)stored->data % ASSET_PACK_ALIGN) == 0, "archive: payload aligned");
+    AssetPackClose(&pack);
+
+    // A flipped bit in a compressed payload fails the entry, not the process
+    std::vector<AssetPackInput> one(inputs.begin(), inputs.begin() + 1);
+    AssetPackWrite(PACK_FILE, one);
+    FILE *file = fopen(PACK_FILE, "r+b");
+    if (file != nullptr)
+    {
+        long at = (long)(sizeof(AssetPackHeader) + sizeof(AssetPackEntry) + 64);
+        at = (at + ASSET_PACK_ALIGN - 1) & ~(long)(ASSET_PACK_ALIGN - 1);
+        fseek(file, at, SEEK_SET);
+        int byte = fgetc(file);
+        fseek(file, at, SEEK_SET);
+        fputc(byte ^ 0x10, file);
+        fclose(file);
+    }
+    BenchCheck(AssetPackOpen(&pack, PACK_FILE), "corrupt: header still valid");
+    if (pack.entryCount == 1) BenchCheck(AssetPackWait(&pack, 0) == nullptr, "corrupt: entry rejected");
+    AssetPackClose(&pack);
+
+    const char garbage[] = "not an archive at all";
+    file = fopen(PACK_FILE, "wb");
+    if (file != nullptr)
+    {
+        fwrite(garbage, 1, sizeof(garbage), file);
+        fclose(file);
+    }
+    BenchCheck(!AssetPackOpen(&pack, PACK_FILE), "corrupt: bad header rejected");
+}
+
+//------------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------------
+static void TimeStartup(const std::vector<AssetPackInput> &inputs)
+{
+    AssetPackWrite(PACK_FILE, inputs);
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        std::string path = LOOSE_PREFIX + std::to_string(i);
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr) continue;
+        if (!inputs[i].bytes.empty()) fwrite(inputs[i].bytes.data(), 1, inputs[i].bytes.size(), file);
+        fclose(file);
+    }
+
+    double openMs = 0.0, firstMs = 0.0, allMs = 0.0, looseMs = 0.0;
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        // Archive: open, wait for the font the first frame draws, let the rest finish
+        auto start = std::chrono::steady_clock::now();
+        AssetPack pack;
+        AssetPackOpen(&pack, PACK_FILE);
+        for (int i = 1; i < pack.entryCount; i++) AssetPackRequest(&pack, i);
+        const AssetBlob *font = AssetPackWait(&pack, 0);
+        firstMs += MsSince(start);
+        openMs += pack.openMs;
+
+        // Touch every byte like an upload would, stored entries fault in from the map
+        uint32_t sum = 0;
+        for (int i = 0; i < pack.entryCount; i++)
+        {
+            const AssetBlob *blob = AssetPackWait(&pack, i);
+            for (size_t b = 0; blob != nullptr && b < blob->size; b += 64) sum += blob->data[b];
+        }
+        allMs += MsSince(start);
+        if (font == nullptr || sum == 1) printf("unexpected\n");
+        AssetPackClose(&pack);
+
+        // Loose files holding the same decoded bytes, read one after another
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            std::string path = LOOSE_PREFIX + std::to_string(i);
+            FILE *file = fopen(path.c_str(), "rb");
+            if (file == nullptr) continue;
+            std::vector<uint8_t> bytes(inputs[i].bytes.size());
+            if (!bytes.empty() && fread(bytes.data(), 1, bytes.size(), file) != bytes.size()) printf("short read\n");
+            fclose(file);
+        }
+        looseMs += MsSince(start);
+    }
+
+    size_t packedBytes = 0, totalBytes = 0;
+    AssetPack pack;
+    if (AssetPackOpen(&pack, PACK_FILE))
+    {
+        packedBytes = pack.size;
+        for (int i = 0; i < pack.entryCount; i++) totalBytes += (size_t)pack.entries[i].size;
+        AssetPackClose(&pack);
+    }
+
+    printf("archive %.2f MB for %.2f MB of payloads\n", packedBytes/1e6, totalBytes/1e6);
+    printf("open (map + index check)     %8.3f ms\n", openMs/BENCH_RUNS);
+    printf("first entry ready (font)     %8.3f ms\n", firstMs/BENCH_RUNS);
+    printf("every entry ready            %8.3f ms\n", allMs/BENCH_RUNS);
+    printf("loose files, read one by one %8.3f ms (decoded already, warm cache)\n", looseMs/BENCH_RUNS);
+
+    // Codec speed on the atlas
+    const std::vector<uint8_t> &atlas = inputs[0].bytes;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> packed = AssetCompress(atlas.data(), atlas.size());
+    double compressMs = MsSince(start);
+    std::vector<uint8_t> out(atlas.size());
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < BENCH_RUNS; run++) AssetDecompress(packed.data(), packed.size(), out.data(), out.size());
+    double decompressMs = MsSince(start)/BENCH_RUNS;
+    printf("atlas lz: %.2f MB -> %.3f MB, compress %.0f MB/s, decompress %.0f MB/s\n", atlas.size()/1e6, packed.size()/1e6,
+           atlas.size()/1e3/compressMs, atlas.size()/1e3/decompressMs);
+
+    for (size_t i = 0; i < inputs.size(); i++) remove((LOOSE_PREFIX + std::to_string(i)).c_str());
+}
+
+int main(void)
+{
+    CheckCodec();
+    std::vector<AssetPackInput> inputs = MakeInputs();
+    CheckArchive(inputs);
+    TimeStartup(inputs);
+    remove(PACK_FILE);
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: archive round trips match\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+// audio_mixer_bench.cpp
+// Checks the mixer without a device: clip and music output against expected samples,
+// clamping, voice stealing, a full command queue and underruns. Then runs the mixer
+// thread against the null backend and measures what a sound event costs the game
+// thread (one AudioMixerPlay), and what a mixing pass costs the mixer thread.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -pthread -I. -I../bench bench/audio_mixer_bench.cpp ../bench/bench_suite.cpp audio_mixer.cpp -o audio_mixer_bench
+#include "audio_mixer.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int MUSIC_LENGTH = 40000;            // Frames of the finite test source
+constexpr int EVENT_BATCHES = 500;
+constexpr int EVENTS_PER_BATCH = 64;           // Well inside the queue
+constexpr int MIX_PASSES = 2000;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Frame i of the test music is i on both channels, finite or looping
+struct CounterSource {
+    int position;
+    int length;                        // 0 loops forever
+};
+
+static int CounterRead(void *user, int16_t *frames, int frameCount)
+{
+    CounterSource *source = (CounterSource *)user;
+    int count = frameCount;
+    if (source->length > 0) count = std::min(count, source->length - source->position);
+    for (int i = 0; i < count; i++)
+    {
+        frames[i*2] = frames[i*2 + 1] = (int16_t)((source->position + i) & 0x7fff);
+    }
+    source->position += count;
+    return count;
+}
+
+static std::vector<int16_t> Ramp(int frames, int scale)
+{
+    std::vector<int16_t> samples((size_t)frames*AUDIO_CHANNELS);
+    for (int i = 0; i < frames; i++)
+    {
+        samples[i*2] = (int16_t)((i*scale) % 30000);
+        samples[i*2 + 1] = (int16_t)(-(i*scale) % 30000);
+    }
+    return samples;
+}
+
+//------------------------------------------------------------------------------------
+// Checks on one thread
+//------------------------------------------------------------------------------------
+static void CheckMixing(void)
+{
+    static AudioMixer mixer;
+    AudioMixerInit(&mixer);
+
+    std::vector<int16_t> ramp = Ramp(1000, 37);
+    int clip = AudioMixerAddClip(&mixer, ramp.data(), 1000);
+    std::vector<int16_t> loud(2*300, 30000);
+    int loudClip = AudioMixerAddClip(&mixer, loud.data(), 300);
+    BenchCheck(clip == 0 && loudClip == 1, "clip ids");
+    BenchCheck(AudioMixerAddClip(&mixer, ramp.data(), 0) == -1, "empty clip refused");
+    BenchCheck(!AudioMixerPlay(&mixer, 7, 1.0f), "unknown clip refused");
+
+    // Half volume is an exact halving in 1/256 steps
+    std::vector<int16_t> out(1024*AUDIO_CHANNELS);
+    AudioMixerPlay(&mixer, clip, 0.5f);
+    AudioMixerUpdate(&mixer);
+    AudioMixerRead(&mixer, out.data(), 1024);
+    bool match = true;
+    for (int i = 0; i < 1000*AUDIO_CHANNELS; i++) match = match && (out[i] == (int16_t)(ramp[i]*128/256));
+    for (int i = 1000*AUDIO_CHANNELS; i < 1024*AUDIO_CHANNELS; i++) match = match && (out[i] == 0);
+    BenchCheck(match, "clip at half volume");
+
+    // Two loud clips clamp instead of wrapping
+    AudioMixerPlay(&mixer, loudClip, 1.0f);
+    AudioMixerPlay(&mixer, loudClip, 1.0f);
+    AudioMixerUpdate(&mixer);
+    AudioMixerRead(&mixer, out.data(), 1024);       // Drain what was mixed before the plays
+    AudioMixerRead(&mixer, out.data(), 1024);
+    bool clamped = false;
+    for (int16_t sample : out) clamped = clamped || (sample == 32767);
+    BenchCheck(clamped, "sum clamps to 32767");
+
+    // More plays than voices steal the oldest, with a clip that outlasts the pass
+    std::vector<int16_t> longRamp = Ramp(AUDIO_SAMPLE_RATE, 5);
+    int longClip = AudioMixerAddClip(&mixer, longRamp.data(), AUDIO_SAMPLE_RATE);
+    for (int i = 0; i < AUDIO_MAX_VOICES + 4; i++) AudioMixerPlay(&mixer, longClip, 0.1f);
+    AudioMixerUpdate(&mixer);
+    BenchCheck(mixer.voiceCount == AUDIO_MAX_VOICES, "voices capped");
+    AudioMixerPush(&mixer, { AUDIO_CMD_STOP_CLIPS, 0, 0.0f });
+    AudioMixerUpdate(&mixer);
+    BenchCheck(mixer.voiceCount == 0, "clips stopped");
+
+    // A full queue drops and counts, never blocks
+    uint32_t dropped = mixer.droppedCommands.load();
+    int accepted = 0;
+    for (int i = 0; i < AUDIO_QUEUE_SIZE + 44; i++) accepted += AudioMixerPlay(&mixer, clip, 0.0f);
+    BenchCheck(accepted == AUDIO_QUEUE_SIZE && mixer.droppedCommands.load() - dropped == 44, "full queue drops");
+    AudioMixerPush(&mixer, { AUDIO_CMD_STOP_CLIPS, 0, 0.0f });
+    AudioMixerUpdate(&mixer);
+    BenchCheck(AudioMixerPush(&mixer, { AUDIO_CMD_STOP_CLIPS, 0, 0.0f }), "queue drained");
+    AudioMixerUpdate(&mixer);
+
+    // Reading more than was mixed pads with silence and counts an underrun
+    uint32_t underruns = mixer.underruns.load();
+    while (AudioMixerRead(&mixer, out.data(), 1024) == 1024) {}
+    BenchCheck(mixer.underruns.load() == underruns + 1, "underrun counted");
+}
+
+static void CheckMusic(void)
+{
+    static AudioMixer mixer;
+    AudioMixerInit(&mixer);
+    CounterSource source = { 0, MUSIC_LENGTH };
+    AudioMixerSetMusic(&mixer, CounterRead, &source);
+    AudioMixerPush(&mixer, { AUDIO_CMD_MUSIC_PLAY, 0, 0.0f });
+
+    // Through the music ring and the output ring, wrapping both several times
+    std::vector<int16_t> out(300*AUDIO_CHANNELS);
+    bool match = true;
+    int frame = 0;
+    while (frame < MUSIC_LENGTH + 5000)
+    {
+        AudioMixerUpdate(&mixer);
+        int got = AudioMixerRead(&mixer, out.data(), 300);
+        for (int i = 0; i < got; i++, frame++)
+        {
+            int16_t expected = (frame < MUSIC_LENGTH) ? (int16_t)(frame & 0x7fff) : 0;
+            match = match && (out[i*2] == expected) && (out[i*2 + 1] == expected);
+        }
+    }
+    BenchCheck(match, "music streams in order, silence after the end");
+    BenchCheck(!mixer.musicPlaying, "finite music stops");
+}
+
+//------------------------------------------------------------------------------------
+// Threads and timing
+//------------------------------------------------------------------------------------
+static void TimeEvents(void)
+{
+    static AudioMixer mixer;
+    AudioMixerInit(&mixer);
+    std::vector<int16_t> ramp = Ramp(4800, 91);
+    int clip = AudioMixerAddClip(&mixer, ramp.data(), 4800);
+    CounterSource source = { 0, 0 };
+    AudioMixerSetMusic(&mixer, CounterRead, &source);
+
+    AudioNullBackend backend;
+    AudioMixerStart(&mixer);
+    AudioNullBackendStart(&backend, &mixer);
+    AudioMixerPush(&mixer, { AUDIO_CMD_MUSIC_PLAY, 0, 0.0f });
+    AudioMixerPush(&mixer, { AUDIO_CMD_MUSIC_VOLUME, 0, 0.25f });
+
+    // Bursts like a game frame would send, then let the mixer catch up
+    double pushNs = 0.0;
+    int pushed = 2;
+    for (int batch = 0; batch < EVENT_BATCHES; batch++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < EVENTS_PER_BATCH; i++) pushed += AudioMixerPlay(&mixer, clip, 0.05f);
+        pushNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        while (mixer.commandsApplied.load() != (uint32_t)pushed) std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    AudioNullBackendStop(&backend);
+    AudioMixerStop(&mixer);
+
+    BenchCheck(pushed == 2 + EVENT_BATCHES*EVENTS_PER_BATCH, "no event dropped while the mixer keeps up");
+    BenchCheck(mixer.commandsApplied.load() == (uint32_t)pushed, "every event applied");
+    BenchCheck(backend.framesPulled.load() > 0 && backend.peak.load() > 0, "null backend pulled sound");
+    printf("game thread: %.1f ns per sound event (%d events)\n", pushNs/(EVENT_BATCHES*EVENTS_PER_BATCH), EVENT_BATCHES*EVENTS_PER_BATCH);
+    printf("mixer thread: %llu frames mixed, %u device underruns\n", (unsigned long long)mixer.framesMixed.load(), mixer.underruns.load());
+
+    // One pass with every voice busy and music on, what the mixer spends per 5 ms
+    static AudioMixer passMixer;
+    AudioMixerInit(&passMixer);
+    clip = AudioMixerAddClip(&passMixer, ramp.data(), 4800);
+    AudioMixerSetMusic(&passMixer, CounterRead, &source);
+    AudioMixerPush(&passMixer, { AUDIO_CMD_MUSIC_PLAY, 0, 0.0f });
+    std::vector<int16_t> sink(AUDIO_MIX_FRAMES*AUDIO_CHANNELS);
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < MIX_PASSES; pass++)
+    {
+        for (int v = passMixer.voiceCount; v < AUDIO_MAX_VOICES; v++) AudioMixerPlay(&passMixer, clip, 0.05f);
+        AudioMixerUpdate(&passMixer);
+        AudioMixerRead(&passMixer, sink.data(), AUDIO_MIX_FRAMES);
+    }
+    double passUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()/MIX_PASSES;
+    printf("mix pass: %.2f us per %d frames with %d voices and music (%.1f ms of audio)\n", passUs, AUDIO_MIX_FRAMES,
+           AUDIO_MAX_VOICES, AUDIO_MIX_FRAMES*1000.0/AUDIO_SAMPLE_RATE);
+}
+
+int main(void)
+{
+    CheckMixing();
+    CheckMusic();
+    TimeEvents();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: mixer output matches\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+// frame_arena_bench.cpp
+// The frame arena and the allocation tracker. Checks that arena allocations are
+// aligned and do not overlap, that a reset hands out the same memory again, that a
+// frame larger than the block still gets its memory and the next reset grows the block
+// so the same frames then allocate nothing, and that the tracker counts allocations,
+// bytes and frees on every thread. Then times scratch allocations from the arena
+// against new and delete.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -pthread -I. -I../bench bench/frame_arena_bench.cpp ../bench/bench_suite.cpp frame_arena.cpp alloc_tracker.cpp -o frame_arena_bench
+#include "frame_arena.h"
+#include "alloc_tracker.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int CHECK_FRAMES = 200;
+constexpr int CHECK_ALLOCS = 64;               // Per frame, at most
+constexpr int TIMING_ALLOCS = 1000;            // Per frame
+constexpr int TIMING_FRAMES = 5000;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static volatile uint32_t sink = 0;
+static void *volatile kept = nullptr;          // Keeps the compiler from eliding a new/delete pair
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+struct Piece {
+    uint8_t *p;
+    size_t size;
+    uint8_t fill;
+};
+
+// One frame of random sizes and alignments, each filled with its own byte; false if
+// one is misaligned or another's bytes were overwritten
+static bool Frame(FrameArena *arena, std::mt19937 *rng, int count, size_t maxSize)
+{
+    Piece pieces[CHECK_ALLOCS];
+    bool ok = true;
+    for (int i = 0; i < count; i++)
+    {
+        size_t align = (size_t)1 << ((*rng)() % 7);
+        size_t size = (*rng)() % maxSize;
+        uint8_t *p = (uint8_t *)FrameArenaAlloc(arena, size, align);
+        ok = ok && p != nullptr && ((uintptr_t)p & (align - 1)) == 0;
+        pieces[i] = { p, size, (uint8_t)(i + 1) };
+        memset(p, pieces[i].fill, size);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        for (size_t k = 0; k < pieces[i].size; k++) ok = ok && pieces[i].p[k] == pieces[i].fill;
+    }
+    return ok;
+}
+
+//----------------------------------------------------------------------------------
+// Checks
+//----------------------------------------------------------------------------------
+static void CheckArena(void)
+{
+    std::mt19937 rng(7);
+    FrameArena arena;
+    FrameArenaInit(&arena, 4096);
+
+    // Fits the block
+    bool ok = true;
+    for (int frame = 0; frame < CHECK_FRAMES; frame++)
+    {
+        FrameArenaReset(&arena);
+        ok = ok && Frame(&arena, &rng, 16, 64);
+    }
+    BenchCheck(ok, "arena: aligned and apart");
+    BenchCheck(arena.overflows == 0, "arena: small frames stay in the block");
+
+    FrameArenaReset(&arena);
+    void *first = FrameArenaAlloc(&arena, 100);
+    FrameArenaReset(&arena);
+    BenchCheck(FrameArenaAlloc(&arena, 100) == first, "arena: a reset hands out the same memory");
+
+    // Bigger frames overflow once, then fit the grown block
+    FrameArenaReset(&arena);
+    ok = Frame(&arena, &rng, CHECK_ALLOCS, 2000);
+    BenchCheck(ok && arena.overflows > 0, "arena: an overflowing frame gets its memory");
+    int overflows = arena.overflows;
+    size_t peak = arena.peak;
+    FrameArenaReset(&arena);
+    BenchCheck(arena.capacity >= peak, "arena: the reset grows the block to the peak");
+
+    AllocStats start = AllocTrackerTotals();
+    for (int frame = 0; frame < CHECK_FRAMES; frame++)
+    {
+        std::mt19937 same(frame % 4);          // Frames no larger than the first
+        FrameArenaReset(&arena);
+        ok = ok && Frame(&arena, &same, CHECK_ALLOCS/2, 2000);
+    }
+    BenchCheck(ok, "arena: grown block aligned and apart");
+    BenchCheck(arena.overflows == overflows && AllocTrackerSince(&start).allocations == 0, "arena: steady frames allocate nothing");
+
+    FrameArenaFree(&arena);
+    FrameArenaReset(&arena);
+    BenchCheck(FrameArenaAlloc(&arena, 10) != nullptr, "arena: works without a block");
+}
+
+static void CheckTracker(void)
+{
+    AllocStats start = AllocTrackerTotals();
+    kept = new int(3);
+    AllocStats one = AllocTrackerSince(&start);
+    delete (int *)kept;
+    AllocStats freed = AllocTrackerSince(&start);
+    BenchCheck(one.allocations == 1 && one.bytes == sizeof(int) && one.frees == 0, "tracker: one new counted with its bytes");
+    BenchCheck(freed.frees == 1, "tracker: the delete counted");
+
+    start = AllocTrackerTotals();
+    std::vector<char> grown;
+    for (int i = 0; i < 1000; i++) grown.push_back((char)i);
+    AllocStats growth = AllocTrackerSince(&start);
+    BenchCheck(growth.allocations > 1 && growth.bytes >= 1000, "tracker: vector growth counted");
+
+    // Other threads count into the same totals
+    start = AllocTrackerTotals();
+    std::thread worker([] {
+        for (int i = 0; i < 1000; i++)
+        {
+            kept = new long long(i);
+            delete (long long *)kept;
+        }
+    });
+    worker.join();
+    BenchCheck(AllocTrackerSince(&start).allocations >= 1000, "tracker: allocations on other threads counted");
+
+    uint64_t allocations = 0, bytes = 0;
+    AllocTrackerCount(&allocations, &bytes);
+    AllocStats totals = AllocTrackerTotals();
+    BenchCheck(allocations <= totals.allocations && bytes <= totals.bytes && allocations > 0, "tracker: running totals");
+}
+
+//----------------------------------------------------------------------------------
+// Timing
+//----------------------------------------------------------------------------------
+// TIMING_ALLOCS scratch arrays of 8 to 256 bytes a frame, per allocation
+static double ArenaNanoseconds(const std::vector<size_t> &sizes)
+{
+    FrameArena arena;
+    FrameArenaInit(&arena, 1 << 20);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < TIMING_FRAMES; frame++)
+    {
+        FrameArenaReset(&arena);
+        for (size_t size : sizes)
+        {
+            uint8_t *p = FrameArenaArray<uint8_t>(&arena, size);
+            p[0] = (uint8_t)frame;
+            sink += p[0];
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()*1e9/((double)TIMING_FRAMES*sizes.size());
+}
+
+static double HeapNanoseconds(const std::vector<size_t> &sizes)
+{
+    std::vector<uint8_t *> live(sizes.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < TIMING_FRAMES; frame++)
+    {
+        for (size_t i = 0; i < sizes.size(); i++)
+        {
+            live[i] = new uint8_t[sizes[i]];
+            live[i][0] = (uint8_t)frame;
+            sink += live[i][0];
+        }
+        for (uint8_t *p : live) delete[] p;
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()*1e9/((double)TIMING_FRAMES*sizes.size());
+}
+
+int main(void)
+{
+    CheckArena();
+    CheckTracker();
+
+    std::mt19937 rng(11);
+    std::vector<size_t> sizes(TIMING_ALLOCS);
+    for (size_t &size : sizes) size = 8 + rng() % 249;
+    printf("%d scratch allocations a frame: arena %.2f ns, new/delete %.2f ns per allocation\n",
+           TIMING_ALLOCS, ArenaNanoseconds(sizes), HeapNanoseconds(sizes));
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: frame arena and allocation tracker checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+// hud_text_bench.cpp
+// The Tetris and platformer HUDs drawn the old way (formatting, MeasureText and
+// DrawText every frame) and through HudText caches, on the headless renderer. Checks
+// that both put the same pixels in the framebuffer, that the cached text is laid out
+// only when its value changes and that its width is MeasureTextEx's; then times the
+// HUD's CPU cost per frame both ways, drawn off screen so no pixels are filled.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -ffp-contract=off -I. -Iheadless -I../bench bench/hud_text_bench.cpp ../bench/bench_suite.cpp hud_text.cpp hud_text_raylib.cpp
+//       sprite_batch.cpp sprite_batch_rlgl.cpp headless/headless_*.cpp -o hud_text_bench
+#include "raylib.h"
+#include "headless.h"
+#include "hud_text_raylib.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int SCREEN_WIDTH = 500;              // The Tetris window
+constexpr int SCREEN_HEIGHT = 620;
+constexpr int BENCH_FRAMES = 20000;
+constexpr int SCORE_EVERY = 60;                // Frames between score changes, one a second
+constexpr float OFF_SCREEN = -4096.0f;         // Timing runs draw here, clipped whole
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct HudState {
+    int score;
+    bool gameOver;                             // Tetris
+    bool recording;                            // Platformer
+    bool win;
+};
+
+// What each game keeps for its HUD
+struct HudCache {
+    HudFont font;
+    SpriteBatch batch;
+    HudText scoreLabel, nextLabel, gameOverLabel, score;       // Tetris
+    HudText recLabel, winLabel, platformerScore;               // Platformer
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static Font font = {};                         // The Tetris font; the headless build has one font
+static HudCache cache;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// The text calls of Tetris' main loop before the cache, x shifted by ox
+static void TetrisHudOld(const HudState &state, float ox)
+{
+    DrawTextEx(font, "Score", { ox + 365, 15 }, 38, 2, WHITE);
+    DrawTextEx(font, "Next", { ox + 370, 175 }, 38, 2, WHITE);
+    if (state.gameOver) DrawTextEx(font, "Game Over", { ox + 320, 450 }, 38, 2, WHITE);
+
+    char scoreText[10];
+    sprintf(scoreText, "%d", state.score);
+    Vector2 textSize = MeasureTextEx(font, scoreText, 38, 2);
+    DrawTextEx(font, scoreText, { ox + 320 + (170 - textSize.x)/2, 65 }, 38, 2, WHITE);
+}
+
+static void TetrisHudCached(const HudState &state, float ox)
+{
+    SpriteBatchBegin(&cache.batch);
+    HudTextDraw(&cache.batch, &cache.scoreLabel, ox + 365, 15, WHITE, 0);
+    HudTextDraw(&cache.batch, &cache.nextLabel, ox + 370, 175, WHITE, 0);
+    if (state.gameOver) HudTextDraw(&cache.batch, &cache.gameOverLabel, ox + 320, 450, WHITE, 0);
+
+    HudTextSetInt(&cache.score, &cache.font, "%d", state.score, 38, 2);
+    HudTextDraw(&cache.batch, &cache.score, ox + 320 + (170 - cache.score.width)/2, 65, WHITE, 0);
+    SpriteBatchFlush(&cache.batch);
+}
+
+// The platformer's DrawGame text before the cache
+static void PlatformerHudOld(const HudState &state, int ox)
+{
+    DrawText(TextFormat("SCORE: %i", state.score), ox + GetScreenWidth()/2 - MeasureText(TextFormat("SCORE: %i", state.score), 40)/2, 50, 40, BLACK);
+    if (state.recording) DrawText("REC", ox + 10, 10, 20, RED);
+    if (state.win) DrawText("PRESS [ENTER] TO PLAY AGAIN", ox + GetScreenWidth()/2 - MeasureText("PRESS [ENTER] TO PLAY AGAIN", 20)/2, GetScreenHeight()/2 - 50, 20, GRAY);
+}
+
+static void PlatformerHudCached(const HudState &state, int ox)
+{
+    SpriteBatchBegin(&cache.batch);
+    HudTextSetInt(&cache.platformerScore, &cache.font, "SCORE: %i", state.score, HudDefaultSize(40), HudDefaultSpacing(40));
+    HudTextDraw(&cache.batch, &cache.platformerScore, (float)(ox + GetScreenWidth()/2 - (int)cache.platformerScore.width/2), 50, BLACK, 0);
+    if (state.recording) HudTextDraw(&cache.batch, &cache.recLabel, (float)(ox + 10), 10, RED, 0);
+    if (state.win) HudTextDraw(&cache.batch, &cache.winLabel, (float)(ox + GetScreenWidth()/2 - (int)cache.winLabel.width/2), (float)(GetScreenHeight()/2 - 50), GRAY, 0);
+    SpriteBatchFlush(&cache.batch);
+}
+
+static void InitCache(void)
+{
+    HudFontFromRaylib(&cache.font, font);
+    SpriteBatchInit(&cache.batch, 256, SpriteBatchSubmitRlgl);
+    HudTextSet(&cache.scoreLabel, &cache.font, "Score", 38, 2);
+    HudTextSet(&cache.nextLabel, &cache.font, "Next", 38, 2);
+    HudTextSet(&cache.gameOverLabel, &cache.font, "Game Over", 38, 2);
+    HudTextSet(&cache.recLabel, &cache.font, "REC", HudDefaultSize(20), HudDefaultSpacing(20));
+    HudTextSet(&cache.winLabel, &cache.font, "PRESS [ENTER] TO PLAY AGAIN", HudDefaultSize(20), HudDefaultSpacing(20));
+}
+
+static std::vector<Color> Frame(void)
+{
+    const Color *pixels = HeadlessFramebuffer();
+    return std::vector<Color>(pixels, pixels + SCREEN_WIDTH*SCREEN_HEIGHT);
+}
+
+static bool SameFrame(const std::vector<Color> &a, const std::vector<Color> &b)
+{
+    return memcmp(a.data(), b.data(), a.size()*sizeof(Color)) == 0;
+}
+
+//----------------------------------------------------------------------------------
+// Checks
+//----------------------------------------------------------------------------------
+static void CheckPixels(void)
+{
+    const HudState states[] = {
+        { 0, false, false, false }, { 7, true, true, false }, { 1230, false, true, true },
+        { 99999, true, false, true }, { -40, false, false, false }
+    };
+
+    int differing = 0;
+    for (const HudState &state : states)
+    {
+        ClearBackground(DARKBLUE);
+        TetrisHudOld(state, 0.0f);
+        std::vector<Color> old = Frame();
+        ClearBackground(DARKBLUE);
+        TetrisHudCached(state, 0.0f);
+        if (!SameFrame(old, Frame())) differing++;
+
+        ClearBackground(RAYWHITE);
+        PlatformerHudOld(state, 0);
+        old = Frame();
+        ClearBackground(RAYWHITE);
+        PlatformerHudCached(state, 0);
+        if (!SameFrame(old, Frame())) differing++;
+    }
+    BenchCheck(differing == 0, "pixels: cached HUD draws what the text calls drew");
+}
+
+static void CheckLayouts(void)
+{
+    HudText text;
+    int before = cache.score.layouts;
+    BenchCheck(HudTextSet(&text, &cache.font, "Score", 38, 2), "layouts: first set lays out");
+    BenchCheck(!HudTextSet(&text, &cache.font, "Score", 38, 2), "layouts: same text is kept");
+    BenchCheck(HudTextSet(&text, &cache.font, "Score", 40, 2), "layouts: new size lays out");
+    BenchCheck(text.layouts == 2, "layouts: counted");
+
+    Vector2 size = MeasureTextEx(font, "Score", 40, 2);
+    BenchCheck(text.width == size.x && text.height == size.y, "layouts: width and height are MeasureTextEx's");
+    BenchCheck(text.quadCount == 5, "layouts: a quad per glyph");
+    HudTextSet(&text, &cache.font, "a b\tc", 40, 2);
+    BenchCheck(text.quadCount == 3 && text.width == MeasureTextEx(font, "a b\tc", 40, 2).x, "layouts: blanks advance without quads");
+
+    char longText[HUD_TEXT_LENGTH*2];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    HudTextSet(&text, &cache.font, longText, 20, 2);
+    BenchCheck(strlen(text.text) == HUD_TEXT_LENGTH - 1 && text.quadCount == HUD_TEXT_LENGTH - 1, "layouts: long text is cut");
+
+    // A score changing once a second over a run lays out once per change
+    for (int frame = 0; frame < 600; frame++) TetrisHudCached({ frame/SCORE_EVERY, false, false, false }, OFF_SCREEN);
+    BenchCheck(cache.score.layouts - before == 600/SCORE_EVERY, "layouts: once per score change");
+}
+
+//----------------------------------------------------------------------------------
+// Timing
+//----------------------------------------------------------------------------------
+typedef void (*TetrisHudFunc)(const HudState &state, float ox);
+typedef void (*PlatformerHudFunc)(const HudState &state, int ox);
+
+static double FrameNanoseconds(TetrisHudFunc tetris, PlatformerHudFunc platformer, int scoreEvery)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++)
+    {
+        HudState state = { 100*(frame/scoreEvery), false, true, false };
+        if (tetris != nullptr) tetris(state, OFF_SCREEN);
+        if (platformer != nullptr) platformer(state, (int)OFF_SCREEN);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds*1e9/BENCH_FRAMES;
+}
+
+// Draw calls and API shapes of one frame of a HUD, counted by the headless renderer
+static HeadlessFrameStats FrameStats(TetrisHudFunc tetris, PlatformerHudFunc platformer)
+{
+    HudState state = { 12345, true, true, true };
+    BeginDrawing();
+    if (tetris != nullptr) tetris(state, 0.0f);
+    if (platformer != nullptr) platformer(state, 0);
+    EndDrawing();
+    return HeadlessFrames().back();
+}
+
+int main(void)
+{
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "hud_text_bench");
+    font = LoadFontEx("Font/monogram.ttf", 64, 0, 0);
+    InitCache();
+
+    CheckPixels();
+    CheckLayouts();
+
+    printf("%-12s %14s %14s %20s %12s\n", "HUD", "text calls", "cached", "cached, every frame", "API draws");
+    HeadlessFrameStats oldStats = FrameStats(TetrisHudOld, nullptr), cachedStats = FrameStats(TetrisHudCached, nullptr);
+    printf("%-12s %11.0f ns %11.0f ns %17.0f ns %6d -> %d\n", "tetris",
+           FrameNanoseconds(TetrisHudOld, nullptr, SCORE_EVERY), FrameNanoseconds(TetrisHudCached, nullptr, SCORE_EVERY),
+           FrameNanoseconds(TetrisHudCached, nullptr, 1), oldStats.shapes, cachedStats.shapes);
+    oldStats = FrameStats(nullptr, PlatformerHudOld);
+    cachedStats = FrameStats(nullptr, PlatformerHudCached);
+    printf("%-12s %11.0f ns %11.0f ns %17.0f ns %6d -> %d\n", "platformer",
+           FrameNanoseconds(nullptr, PlatformerHudOld, SCORE_EVERY), FrameNanoseconds(nullptr, PlatformerHudCached, SCORE_EVERY),
+           FrameNanoseconds(nullptr, PlatformerHudCached, 1), oldStats.shapes, cachedStats.shapes);
+
+    CloseWindow();
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: cached HUD matches the text calls\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,291 @@
+// job_system_bench.cpp
+// Stress checks of the job system on 1 to 8 workers: every parallel-for item runs
+// exactly once whatever the grain, random task graphs never start a task before its
+// predecessors finished, nested loops inside jobs complete, and a steady state
+// allocates nothing. Then the scheduling overhead: an empty task run and waited for,
+// and a parallel for over items that do almost nothing, by grain. Meant to be run
+// under -DRAYLIB_GAMES_SANITIZE=thread as well.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -pthread -I. -I../bench bench/job_system_bench.cpp ../bench/bench_suite.cpp job_system.cpp alloc_tracker.cpp -o job_system_bench
+#include "job_system.h"
+#include "alloc_tracker.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int STRESS_WORKERS[] = { 1, 2, 4, 8 };
+constexpr int STRESS_ROUNDS = 200;
+constexpr int GRAPH_TASKS = 48;
+constexpr int GRAPH_ITEMS = 32;              // Range of a graph task at most
+constexpr int TIMING_ITEMS = 1 << 16;
+constexpr int TIMING_GRAINS[] = { 1, 16, 256, 4096 };
+constexpr int EMPTY_RUNS = 20000;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Counts the visits of every item
+struct CoverData {
+    std::vector<std::atomic<int>> visits;
+    int grain;
+    std::atomic<int> oversized{0};             // Pieces longer than the grain
+};
+
+static void CoverFunc(void *user, int begin, int end)
+{
+    CoverData *data = (CoverData *)user;
+    if (end - begin > data->grain) data->oversized++;
+    for (int i = begin; i < end; i++) data->visits[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Every piece stamps when it starts and ends on one shared clock, so a task's first
+// start must come after its predecessors' last end. Items are also written plainly
+// and read by the successors, which TSan reports if the ordering does not hold.
+struct GraphData {
+    std::atomic<int> clock{0};
+    std::atomic<int> start[GRAPH_TASKS];       // Earliest piece start
+    std::atomic<int> finish[GRAPH_TASKS];      // Latest piece end
+    int items[GRAPH_TASKS][GRAPH_ITEMS];
+    std::vector<int> predecessors[GRAPH_TASKS];
+};
+
+struct GraphNode {
+    GraphData *graph;
+    int index;
+};
+
+static void GraphFunc(void *user, int begin, int end)
+{
+    GraphNode *node = (GraphNode *)user;
+    GraphData *graph = node->graph;
+
+    int stamp = graph->clock.fetch_add(1);
+    int earliest = graph->start[node->index].load();
+    while (stamp < earliest && !graph->start[node->index].compare_exchange_weak(earliest, stamp)) {}
+
+    for (int i = begin; i < end; i++)
+    {
+        int sum = 1;
+        for (int p : graph->predecessors[node->index]) sum += graph->items[p][i];
+        graph->items[node->index][i] = sum;
+    }
+
+    stamp = graph->clock.fetch_add(1);
+    int latest = graph->finish[node->index].load();
+    while (stamp > latest && !graph->finish[node->index].compare_exchange_weak(latest, stamp)) {}
+}
+
+static void NestedInner(void *user, int begin, int end)
+{
+    std::atomic<int> *count = (std::atomic<int> *)user;
+    count->fetch_add(end - begin, std::memory_order_relaxed);
+}
+
+struct NestedData {
+    JobSystem *system;
+    std::atomic<int> count{0};
+};
+
+static void NestedOuter(void *user, int begin, int end)
+{
+    NestedData *data = (NestedData *)user;
+    for (int i = begin; i < end; i++) JobParallelFor(data->system, 100, 7, NestedInner, &data->count);
+}
+
+static void EmptyFunc(void *, int, int)
+{
+}
+
+// Almost nothing per item, but nothing the compiler can skip
+static void CountFunc(void *user, int begin, int end)
+{
+    uint32_t *counts = (uint32_t *)user;
+    for (int i = begin; i < end; i++) counts[i]++;
+}
+
+//----------------------------------------------------------------------------------
+// Checks
+//----------------------------------------------------------------------------------
+static void CheckParallelFor(JobSystem *system, std::mt19937 *rng)
+{
+    // One worker runs the range in one call
+    bool once = true, bounded = true;
+    for (int round = 0; round < STRESS_ROUNDS; round++)
+    {
+        int count = (int)((*rng)() % 5000);
+        CoverData data;
+        data.visits = std::vector<std::atomic<int>>(count);
+        data.grain = 1 + (int)((*rng)() % 64);
+        JobParallelFor(system, count, data.grain, CoverFunc, &data);
+        for (const std::atomic<int> &visits : data.visits) once = once && visits.load() == 1;
+        bounded = bounded && (system->workerCount == 1 || data.oversized.load() == 0);
+    }
+    BenchCheck(once, "parallel for: every item runs once");
+    BenchCheck(bounded, "parallel for: no piece is longer than the grain");
+}
+
+static void CheckGraphs(JobSystem *system, std::mt19937 *rng)
+{
+    GraphData *graph = new GraphData();
+    GraphNode nodes[GRAPH_TASKS];
+    JobTask tasks[GRAPH_TASKS];
+    bool ordered = true, finished = true;
+
+    for (int round = 0; round < STRESS_ROUNDS; round++)
+    {
+        // Up to 3 predecessors among the earlier tasks, so the graph has no cycle
+        for (int t = 0; t < GRAPH_TASKS; t++)
+        {
+            nodes[t] = { graph, t };
+            int items = (int)((*rng)() % (GRAPH_ITEMS + 1));
+            JobTaskInit(&tasks[t], GraphFunc, &nodes[t], 0, items, 1 + (int)((*rng)() % 8));
+            graph->predecessors[t].clear();
+            graph->start[t] = 1 << 30;
+            graph->finish[t] = -1;
+            int wanted = (t == 0) ? 0 : (int)((*rng)() % 4);
+            for (int k = 0; k < wanted; k++)
+            {
+                int p = (int)((*rng)() % t);
+                if (std::find(graph->predecessors[t].begin(), graph->predecessors[t].end(), p) != graph->predecessors[t].end()) continue;
+                if (JobTaskDepends(&tasks[t], &tasks[p])) graph->predecessors[t].push_back(p);
+            }
+        }
+
+        JobCounter counter;
+        JobSystemRun(system, tasks, GRAPH_TASKS, &counter);
+        JobSystemWait(system, &counter);
+        finished = finished && JobCounterDone(&counter);
+
+        for (int t = 0; t < GRAPH_TASKS; t++)
+        {
+            if (tasks[t].end == 0) continue;
+            for (int p : graph->predecessors[t])
+            {
+                if (tasks[p].end > 0 && graph->finish[p].load() > graph->start[t].load()) ordered = false;
+            }
+        }
+    }
+    delete graph;
+    BenchCheck(finished, "graphs: the counter reaches zero");
+    BenchCheck(ordered, "graphs: no task starts before its predecessors end");
+}
+
+static void CheckNested(JobSystem *system)
+{
+    NestedData data;
+    data.system = system;
+    JobParallelFor(system, 64, 1, NestedOuter, &data);
+    BenchCheck(data.count.load() == 64*100, "nested: loops inside jobs complete");
+}
+
+static void CheckAllocations(JobSystem *system)
+{
+    std::vector<uint32_t> counts(TIMING_ITEMS);
+    JobParallelFor(system, TIMING_ITEMS, 16, CountFunc, counts.data());
+
+    AllocStats start = AllocTrackerTotals();
+    for (int round = 0; round < 100; round++) JobParallelFor(system, TIMING_ITEMS, 16, CountFunc, counts.data());
+    JobTask tasks[4];
+    for (int round = 0; round < 100; round++)
+    {
+        for (int i = 0; i < 4; i++) JobTaskInit(&tasks[i], CountFunc, counts.data() + i*1000, 0, 1000, 10);
+        JobTaskDepends(&tasks[3], &tasks[1]);
+        JobTaskDepends(&tasks[3], &tasks[2]);
+        JobTaskDepends(&tasks[1], &tasks[0]);
+        JobCounter counter;
+        JobSystemRun(system, tasks, 4, &counter);
+        JobSystemWait(system, &counter);
+    }
+    BenchCheck(AllocTrackerSince(&start).allocations == 0, "steady state allocates nothing");
+}
+
+//----------------------------------------------------------------------------------
+// Timing
+//----------------------------------------------------------------------------------
+// One task with one empty item, run and waited for
+static double EmptyTaskNanoseconds(JobSystem *system)
+{
+    JobTask task;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EMPTY_RUNS; i++)
+    {
+        JobTaskInit(&task, EmptyFunc, nullptr, 0, 1, 1);
+        JobCounter counter;
+        JobSystemRun(system, &task, 1, &counter);
+        JobSystemWait(system, &counter);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()*1e9/EMPTY_RUNS;
+}
+
+// A parallel for over TIMING_ITEMS increments, per item
+static double ParallelForNanoseconds(JobSystem *system, int grain)
+{
+    std::vector<uint32_t> counts(TIMING_ITEMS);
+    uint32_t rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    do
+    {
+        JobParallelFor(system, TIMING_ITEMS, grain, CountFunc, counts.data());
+        rounds++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < 0.05);
+    BenchCheck(std::count(counts.begin(), counts.end(), rounds) == TIMING_ITEMS, "timing: parallel for counts every item");
+    return seconds*1e9/((double)rounds*TIMING_ITEMS);
+}
+
+int main(void)
+{
+    std::mt19937 rng(11);
+    for (int workers : STRESS_WORKERS)
+    {
+        JobSystem system;
+        JobSystemInit(&system, workers);
+        CheckParallelFor(&system, &rng);
+        CheckGraphs(&system, &rng);
+        CheckNested(&system);
+        CheckAllocations(&system);
+        JobSystemShutdown(&system);
+    }
+
+    // Overhead next to a plain loop: grain 1 is the worst case, one job per item
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> workerCounts = { 1, 2 };
+    if (cores > 2) workerCounts.push_back(cores);
+
+    std::vector<uint32_t> counts(TIMING_ITEMS);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 2000; i++) CountFunc(counts.data(), 0, TIMING_ITEMS);
+    double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()*1e9/(2000.0*TIMING_ITEMS);
+    BenchCheck(counts[TIMING_ITEMS - 1] == 2000, "timing: plain loop counts every item");
+    printf("plain loop: %.2f ns/item\n", serial);
+
+    printf("%8s %14s", "workers", "empty task");
+    for (int grain : TIMING_GRAINS) printf("   grain %-5d", grain);
+    printf("\n");
+    for (int workers : workerCounts)
+    {
+        JobSystem system;
+        JobSystemInit(&system, workers);
+        printf("%8d %11.0f ns", workers, EmptyTaskNanoseconds(&system));
+        for (int grain : TIMING_GRAINS) printf(" %8.2f ns/i", ParallelForNanoseconds(&system, grain));
+        printf("\n");
+
+        uint64_t steals = 0;
+        for (int i = 0; i < system.workerCount; i++) steals += system.workers[i].steals.load();
+        JobSystemShutdown(&system);
+        if (workers > 1 && cores > 1) BenchCheck(steals > 0, "timing: idle workers steal");
+    }
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: job system stress checks passed\n");
+    return EXIT_SUCCESS;
+}
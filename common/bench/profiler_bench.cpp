@@ -0,0 +1,151 @@
+// profiler_bench.cpp
+// Checks that zones recorded on several threads all reach the statistics or are
+// counted as dropped, that a capture writes one trace event per zone and frame, and
+// measures the cost of a zone.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -pthread -DPROFILER_ENABLED -I. -I../bench bench/profiler_bench.cpp ../bench/bench_suite.cpp profiler.cpp -o profiler_bench
+#include "profiler.h"
+#include "bench_suite.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr int BENCH_THREADS = 4;
+constexpr int BENCH_ZONES_PER_THREAD = 200000;  // Outer zones; each has one inner zone
+constexpr int BENCH_TIMED_ZONES = 1 << 22;
+static const char *TRACE_FILE = "profiler_bench_trace.json";
+
+// Sums the calls of one zone over the frames marked so far
+struct ZoneTotals {
+    long long outer = 0;
+    long long inner = 0;
+    long long main = 0;
+};
+
+static void MarkAndCount(ZoneTotals *totals)
+{
+    ProfilerFrameMark();
+
+    const ProfileZoneStat *zones = nullptr;
+    int count = ProfilerZoneStats(&zones);
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(zones[i].name, "Outer") == 0) totals->outer += zones[i].calls;
+        else if (strcmp(zones[i].name, "Inner") == 0) totals->inner += zones[i].calls;
+        else if (strcmp(zones[i].name, "Main") == 0) totals->main += zones[i].calls;
+    }
+}
+
+static void Worker(void)
+{
+    volatile unsigned sink = 0;         // Wraps instead of overflowing
+    for (int i = 0; i < BENCH_ZONES_PER_THREAD; i++)
+    {
+        PROFILE_ZONE("Outer");
+        {
+            PROFILE_ZONE("Inner");
+            sink = sink + (unsigned)i;
+        }
+    }
+}
+
+static void CheckThreads(void)
+{
+    ZoneTotals totals;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < BENCH_THREADS; t++) workers.emplace_back(Worker);
+
+    // The main thread keeps draining while the workers record, like a game frame loop
+    int frames = 0;
+    for (;;)
+    {
+        {
+            PROFILE_ZONE("Main");
+        }
+        MarkAndCount(&totals);
+        frames++;
+        if (totals.outer + totals.inner + ProfilerDroppedEvents() >= 2LL*BENCH_THREADS*BENCH_ZONES_PER_THREAD) break;
+        std::this_thread::yield();
+    }
+    for (std::thread &worker : workers) worker.join();
+    MarkAndCount(&totals);
+
+    long long expected = 2LL*BENCH_THREADS*BENCH_ZONES_PER_THREAD;
+    long long dropped = ProfilerDroppedEvents();
+    printf("threads: %d x %d zones over %d frames, %lld dropped to full rings\n", BENCH_THREADS, 2*BENCH_ZONES_PER_THREAD, frames, dropped);
+    BenchCheck(totals.outer + totals.inner + dropped == expected, "threads: every zone drained or counted as dropped");
+    BenchCheck(totals.main == frames, "threads: one main zone per frame");
+}
+
+static int CountOccurrences(const std::string &text, const char *pattern)
+{
+    int count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) count++;
+    return count;
+}
+
+static void CheckCapture(void)
+{
+    constexpr int frames = 5;
+    constexpr int zonesPerFrame = 10;
+
+    ProfilerCaptureStart(frames, TRACE_FILE);
+    for (int f = 0; f < frames; f++)
+    {
+        for (int i = 0; i < zonesPerFrame; i++)
+        {
+            PROFILE_ZONE("Captured \"quoted\"");
+        }
+        ProfilerFrameMark();
+    }
+    BenchCheck(!ProfilerCapturing(), "capture: stops after its frames");
+
+    FILE *file = fopen(TRACE_FILE, "r");
+    BenchCheck(file != nullptr, "capture: trace written");
+    if (file == nullptr) return;
+
+    std::string text;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, read);
+    fclose(file);
+    remove(TRACE_FILE);
+
+    BenchCheck(CountOccurrences(text, "\"ph\":\"X\"") == frames*(zonesPerFrame + 1), "capture: one event per zone and frame");
+    BenchCheck(CountOccurrences(text, "\"name\":\"Frame\"") == frames, "capture: frame events");
+    BenchCheck(CountOccurrences(text, "\"name\":\"Captured \\\"quoted\\\"\"") == frames*zonesPerFrame, "capture: names escaped");
+    BenchCheck(text.compare(text.size() - 3, 3, "]}\n") == 0, "capture: closed array");
+}
+
+static double ZoneNanoseconds(void)
+{
+    volatile unsigned sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_TIMED_ZONES; i++)
+    {
+        PROFILE_ZONE("Timed");
+        sink = sink + (unsigned)i;
+        // Drain before the ring fills so every zone takes the recording path
+        if ((i & (PROFILER_RING_EVENTS/2 - 1)) == 0) ProfilerFrameMark();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count()/BENCH_TIMED_ZONES;
+}
+
+int main(void)
+{
+    CheckThreads();
+    CheckCapture();
+
+    uint32_t droppedBefore = ProfilerDroppedEvents();
+    printf("zone cost: %.1f ns (begin and end timestamps plus the ring write)\n", ZoneNanoseconds());
+    BenchCheck(ProfilerDroppedEvents() == droppedBefore, "timing: no zone dropped");
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: every zone accounted for\n");
+    return EXIT_SUCCESS;
+}
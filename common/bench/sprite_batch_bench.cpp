@@ -0,0 +1,175 @@
+// sprite_batch_bench.cpp
+// Headless checks of the SpriteBatch vertex stream (ordering, corners, draw calls,
+// early flushes) and the build cost per quad for in-order and shuffled submissions.
+// Build from the common folder:
+//   g++ -O3 -std=c++14 -I. -I../bench bench/sprite_batch_bench.cpp ../bench/bench_suite.cpp sprite_batch.cpp -o sprite_batch_bench
+#include "sprite_batch.h"
+#include "bench_suite.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Quads per frame: a sand grid, a large tile map, and past what fits in cache
+constexpr int BENCH_SIZES[] = { 1 << 12, 1 << 16, 1 << 20 };
+constexpr int BENCH_TOTAL_QUADS = 1 << 24;
+
+// Everything the headless submit function received, flush by flush
+static std::vector<std::vector<SpriteVertex>> submittedVertices;
+static std::vector<std::vector<SpriteDrawCall>> submittedCalls;
+
+static void CaptureSubmit(const SpriteBatch *batch)
+{
+    submittedVertices.emplace_back(batch->vertices.begin(), batch->vertices.begin() + batch->vertexCount);
+    submittedCalls.push_back(batch->calls);
+}
+
+// Tag quads through the red channel so the stream order can be read back
+static Color Tag(int id)
+{
+    return { (unsigned char)id, 0, 0, 255 };
+}
+
+static void CheckOrdering(void)
+{
+    SpriteBatch batch;
+    SpriteBatchInit(&batch, 64, CaptureSubmit);
+    submittedVertices.clear();
+    submittedCalls.clear();
+
+    // id: layer, texture
+    SpriteBatchRect(&batch, 0, 0, 1, 1, Tag(0), 2);                          // 0: 2, none
+    SpriteBatchTexture(&batch, 7, 0, 0, 1, 1, 0, 0, 1, 1, Tag(1), 0);       // 1: 0, 7
+    SpriteBatchRect(&batch, 0, 0, 1, 1, Tag(2), 0);                          // 2: 0, none
+    SpriteBatchTexture(&batch, 7, 0, 0, 1, 1, 0, 0, 1, 1, Tag(3), 0);       // 3: 0, 7
+    SpriteBatchRect(&batch, 0, 0, 1, 1, Tag(4), -1);                         // 4: -1, none
+    SpriteBatchRect(&batch, 0, 0, 1, 1, Tag(5), 2);                          // 5: 2, none
+    SpriteBatchTexture(&batch, 3, 0, 0, 1, 1, 0, 0, 1, 1, Tag(6), 1);       // 6: 1, 3
+    SpriteBatchFlush(&batch);
+
+    // Layer, then texture, then submission. Runs 4,2 share the untextured texture
+    // across layers -1 and 0, so they are one call.
+    const int expected[] = { 4, 2, 1, 3, 6, 0, 5 };
+    const unsigned int expectedTextures[] = { SPRITE_NO_TEXTURE, 7, 3, SPRITE_NO_TEXTURE };
+    const int expectedCounts[] = { 2, 2, 1, 2 };
+
+    BenchCheck(submittedVertices.size() == 1, "ordering: one flush");
+    if (submittedVertices.size() != 1) return;
+
+    const std::vector<SpriteVertex> &stream = submittedVertices[0];
+    const std::vector<SpriteDrawCall> &calls = submittedCalls[0];
+    BenchCheck(stream.size() == 7 * 4, "ordering: 4 vertices per quad");
+    for (int i = 0; i < 7 && (size_t)i * 4 < stream.size(); i++)
+    {
+        for (int k = 0; k < 4; k++) BenchCheck(stream[i * 4 + k].color.r == expected[i], "ordering: quad order");
+    }
+
+    BenchCheck(calls.size() == 4, "ordering: draw calls per texture run");
+    int vertex = 0;
+    for (size_t i = 0; i < calls.size() && i < 4; i++)
+    {
+        BenchCheck(calls[i].texture == expectedTextures[i], "ordering: call texture");
+        BenchCheck(calls[i].firstVertex == vertex, "ordering: call start");
+        BenchCheck(calls[i].vertexCount == expectedCounts[i] * 4, "ordering: call length");
+        vertex += calls[i].vertexCount;
+    }
+    BenchCheck(batch.frameQuads == 7 && batch.frameDrawCalls == 4 && batch.frameFlushes == 1, "ordering: counters");
+}
+
+static void CheckCorners(void)
+{
+    SpriteBatch batch;
+    SpriteBatchInit(&batch, 4, nullptr);
+    SpriteBatchTexture(&batch, 9, 0.25f, 0.5f, 0.75f, 1.0f, 10, 20, 30, 40, Tag(1), 0);
+    SpriteBatchBuild(&batch);
+
+    // RL_QUADS winding: top-left, bottom-left, bottom-right, top-right
+    const SpriteVertex expected[4] = {
+        { 10, 20, 0.25f, 0.5f, Tag(1) },
+        { 10, 60, 0.25f, 1.0f, Tag(1) },
+        { 40, 60, 0.75f, 1.0f, Tag(1) },
+        { 40, 20, 0.75f, 0.5f, Tag(1) },
+    };
+    BenchCheck(batch.vertexCount == 4, "corners: vertex count");
+    for (int i = 0; i < 4 && i < batch.vertexCount; i++)
+    {
+        const SpriteVertex &v = batch.vertices[i];
+        BenchCheck(v.x == expected[i].x && v.y == expected[i].y && v.u == expected[i].u && v.v == expected[i].v,
+              "corners: position and uv");
+    }
+}
+
+static void CheckEarlyFlush(void)
+{
+    SpriteBatch batch;
+    SpriteBatchInit(&batch, 4, CaptureSubmit);
+    submittedVertices.clear();
+    submittedCalls.clear();
+
+    for (int i = 0; i < 10; i++) SpriteBatchRect(&batch, (float)i, 0, 1, 1, Tag(i), 9 - i);
+    SpriteBatchFlush(&batch);
+
+    // Full batches go out as they fill, each one sorted on its own
+    BenchCheck(submittedVertices.size() == 3, "early flush: 4 + 4 + 2 quads");
+    const int expected[] = { 3, 2, 1, 0, 7, 6, 5, 4, 9, 8 };
+    int quad = 0;
+    for (const std::vector<SpriteVertex> &stream : submittedVertices)
+    {
+        for (size_t i = 0; i < stream.size(); i += 4, quad++)
+        {
+            BenchCheck(quad < 10 && stream[i].color.r == expected[quad], "early flush: order inside each flush");
+        }
+    }
+    BenchCheck(batch.frameQuads == 10 && batch.frameFlushes == 3 && batch.frameDrawCalls == 3, "early flush: counters");
+
+    SpriteBatchBegin(&batch);
+    BenchCheck(batch.frameQuads == 0 && batch.frameDrawCalls == 0, "begin: counters reset");
+}
+
+static double BuildNanoseconds(const std::vector<int> &layers, int quadCount)
+{
+    SpriteBatch batch;
+    SpriteBatchInit(&batch, quadCount, nullptr);
+
+    const int frames = BENCH_TOTAL_QUADS / quadCount;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        SpriteBatchBegin(&batch);
+        for (int i = 0; i < quadCount; i++)
+        {
+            SpriteBatchRect(&batch, (float)(i & 1023), (float)(i >> 10), 1, 1, Tag(i), layers[i]);
+        }
+        SpriteBatchFlush(&batch);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((double)quadCount * frames);
+}
+
+int main(void)
+{
+    CheckOrdering();
+    CheckCorners();
+    CheckEarlyFlush();
+
+    // Layered in submission order (tiles, then sprites) versus every quad on a random layer
+    printf("%9s %18s %18s\n", "quads", "in layer order", "shuffled layers");
+    std::mt19937 rng(5);
+    for (int quadCount : BENCH_SIZES)
+    {
+        std::vector<int> inOrder(quadCount), shuffled(quadCount);
+        for (int i = 0; i < quadCount; i++)
+        {
+            inOrder[i] = (int)((int64_t)i * 4 / quadCount);
+            shuffled[i] = (int)(rng() % 4);
+        }
+        printf("%9d %13.2f ns/q %13.2f ns/q\n", quadCount, BuildNanoseconds(inOrder, quadCount),
+               BuildNanoseconds(shuffled, quadCount));
+    }
+
+    if (BenchFailed()) return EXIT_FAILURE;
+    printf("OK: vertex streams match\n");
+    return EXIT_SUCCESS;
+}
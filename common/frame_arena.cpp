@@ -0,0 +1,67 @@
+// frame_arena.cpp
+#include "frame_arena.h"
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static inline uintptr_t AlignUp(uintptr_t value, size_t align)
+{
+    return (value + align - 1) & ~(uintptr_t)(align - 1);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void FrameArenaInit(FrameArena *arena, size_t capacity)
+{
+    FrameArenaFree(arena);
+    if (capacity > 0) arena->block.reset(new uint8_t[capacity]);
+    arena->capacity = capacity;
+    arena->overflows = 0;
+    arena->peak = 0;
+}
+
+void FrameArenaFree(FrameArena *arena)
+{
+    arena->overflow.clear();
+    arena->block.reset();
+    arena->capacity = 0;
+    arena->used = 0;
+    arena->frameBytes = 0;
+}
+
+void FrameArenaReset(FrameArena *arena)
+{
+    // Overflowed: the next frame gets a block that would have held all of this one
+    if (!arena->overflow.empty())
+    {
+        arena->overflow.clear();
+        arena->capacity = arena->peak + arena->peak/4;
+        arena->block.reset(new uint8_t[arena->capacity]);
+    }
+    arena->used = 0;
+    arena->frameBytes = 0;
+}
+
+void *FrameArenaAlloc(FrameArena *arena, size_t size, size_t align)
+{
+    // Aligned on the address, new[] only promises alignof(max_align_t)
+    uintptr_t at = (uintptr_t)arena->block.get() + arena->used;
+    size_t padding = (size_t)(AlignUp(at, align) - at);
+    bool fits = arena->block != nullptr && arena->used + padding + size <= arena->capacity;
+
+    // Past the block the padding is counted at its worst, so a block of the peak
+    // size holds the frame whatever the addresses
+    arena->frameBytes += (fits ? padding : align - 1) + size;
+    if (arena->frameBytes > arena->peak) arena->peak = arena->frameBytes;
+    if (fits)
+    {
+        arena->used += padding + size;
+        return (void *)(at + padding);
+    }
+
+    // Missed the block: a chunk of its own until the next reset
+    arena->overflows++;
+    arena->overflow.emplace_back(new uint8_t[size + align]);
+    return (void *)AlignUp((uintptr_t)arena->overflow.back().get(), align);
+}
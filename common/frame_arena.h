@@ -0,0 +1,56 @@
+// frame_arena.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Bump allocator for scratch data that lives one frame (or one step, or one call):
+// FrameArenaAlloc moves a pointer through a block, FrameArenaReset at the start of
+// the next frame takes it all back at once. Nothing is freed one by one and nothing
+// runs destructors, so it holds plain data only.
+//
+// A frame that wants more than the block holds gets an overflow chunk from the heap;
+// the next reset replaces the block with one of the frame's peak size. After the
+// first frames of each kind, frames allocate nothing. The arena owns its memory, so
+// it can sit in a struct that is destroyed normally.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr size_t FRAME_ARENA_ALIGN = 16;       // Default alignment, enough for SSE loads
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct FrameArena {
+    std::unique_ptr<uint8_t[]> block;
+    size_t capacity = 0;
+    size_t used = 0;                   // This frame, in the block
+    size_t frameBytes = 0;             // This frame, the overflow included
+    size_t peak = 0;                   // Largest frameBytes so far
+    std::vector<std::unique_ptr<uint8_t[]>> overflow;  // Chunks of this frame that missed the block
+    int overflows = 0;                 // Allocations that missed the block, over all frames
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+void FrameArenaInit(FrameArena *arena, size_t capacity);
+void FrameArenaFree(FrameArena *arena);
+// Takes back everything allocated since the last reset
+void FrameArenaReset(FrameArena *arena);
+
+// size bytes aligned to align (a power of two); never null
+void *FrameArenaAlloc(FrameArena *arena, size_t size, size_t align = FRAME_ARENA_ALIGN);
+
+// count uninitialized T
+template <typename T>
+T *FrameArenaArray(FrameArena *arena, size_t count)
+{
+    static_assert(std::is_trivially_destructible<T>::value, "the arena runs no destructors");
+    return (T *)FrameArenaAlloc(arena, count*sizeof(T), alignof(T) > FRAME_ARENA_ALIGN ? alignof(T) : FRAME_ARENA_ALIGN);
+}
@@ -0,0 +1,47 @@
+# Runs a game on the headless renderer and compares its last frame with a golden image.
+#
+#   cmake -DGAME=<exe> -DDIFF=<headless_diff> -DGOLDEN=<png> -DFRAMES=<n> -DOUT=<dir>
+#         [-DUPDATE=ON] -P golden_test.cmake
+#
+# With UPDATE=ON the frame replaces the golden instead. The run's per-frame statistics
+# are left in <dir>/stats.csv.
+
+foreach(var GAME DIFF GOLDEN FRAMES OUT)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "golden_test.cmake needs -D${var}=")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE ${OUT})
+file(MAKE_DIRECTORY ${OUT})
+
+set(ENV{HEADLESS_FRAMES} ${FRAMES})
+set(ENV{HEADLESS_DUMP} ${OUT})
+set(ENV{HEADLESS_DUMP_EVERY} 0)
+set(ENV{HEADLESS_STATS} ${OUT}/stats.csv)
+set(ENV{HEADLESS_INPUT} 1)
+execute_process(COMMAND ${GAME} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${GAME} exited with ${result}")
+endif()
+
+# The last frame only, frame_NNNNN.png
+math(EXPR last "${FRAMES} - 1")
+string(LENGTH "${last}" digits)
+math(EXPR zeros "5 - ${digits}")
+string(REPEAT "0" ${zeros} padding)
+set(frame ${OUT}/frame_${padding}${last}.png)
+if(NOT EXISTS ${frame})
+    message(FATAL_ERROR "${GAME} wrote no ${frame}")
+endif()
+
+if(UPDATE)
+    execute_process(COMMAND ${CMAKE_COMMAND} -E copy ${frame} ${GOLDEN})
+    message(STATUS "Updated ${GOLDEN}")
+    return()
+endif()
+
+execute_process(COMMAND ${DIFF} ${GOLDEN} ${frame} 0 ${OUT}/diff.png RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${frame} does not match ${GOLDEN}, see ${OUT}/diff.png")
+endif()
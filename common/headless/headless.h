@@ -0,0 +1,89 @@
+// headless.h
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Software stand-in for raylib's window, renderer and input, selected with
+// -DRAYLIB_GAMES_HEADLESS_RENDER=ON. The games run their normal frame loop into a CPU
+// framebuffer, on machines without a GPU or display. A run is steered by environment
+// variables:
+//
+//   HEADLESS_FRAMES=600        WindowShouldClose() turns true after this many frames
+//   HEADLESS_DUMP=dir          writes frames as dir/frame_NNNNN.png (the directory must exist)
+//   HEADLESS_DUMP_EVERY=0      every Nth frame, 0 for the last frame only
+//   HEADLESS_STATS=file.csv    per-frame draw calls, shapes, triangles, pixels and render ms
+//   HEADLESS_INPUT=1           seed of the scripted keyboard and mouse, 0 for no input
+//
+// Time advances exactly 1/fps per frame and GetRandomValue is seeded, so a run draws
+// the same frames every time. CloseWindow prints a summary of the render cost.
+//
+// Rasterization snaps vertices to 1/16 pixel and fills by pixel center with a top-left
+// rule, so frames do not depend on compiler flags. Textures are sampled nearest, and
+// blending is raylib's default alpha blend.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int HEADLESS_DEFAULT_FRAMES = 600;
+constexpr int HEADLESS_DEFAULT_FPS = 60;
+constexpr unsigned int HEADLESS_TEXTURE_WHITE = 1;   // rlGetTextureIdDefault()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct HeadlessFrameStats {
+    int drawCalls;                     // Batches a GPU would draw: texture and mode changes
+    int shapes;                        // Draw calls of the API, each sprite batch vertex run counts once
+    int triangles;
+    int64_t pixels;                    // Pixels shaded
+    double renderMs;                   // BeginDrawing to EndDrawing, on the CPU
+};
+
+struct HeadlessWindow {
+    bool ready = false;
+    int width = 0;
+    int height = 0;
+    std::string title;
+    int targetFps = HEADLESS_DEFAULT_FPS;
+    int frame = 0;                     // Frames finished by EndDrawing
+
+    // From the environment at InitWindow
+    int maxFrames = HEADLESS_DEFAULT_FRAMES;
+    std::string dumpDir;
+    int dumpEvery = 0;
+    std::string statsPath;
+    uint32_t inputSeed = 1;
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+extern HeadlessWindow headlessWindow;
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Framebuffer and counters (headless_raster.cpp)
+void HeadlessRasterInit(int width, int height);
+void HeadlessRasterClose(void);
+const Color *HeadlessFramebuffer(void);
+const std::vector<HeadlessFrameStats> &HeadlessFrames(void);
+// Textures live in the renderer, ids start at HEADLESS_TEXTURE_WHITE
+unsigned int HeadlessTextureCreate(int width, int height, const Color *pixels);
+void HeadlessTextureDestroy(unsigned int id);
+// Brackets one API draw call, so its primitives count as one shape; rlBegin/rlEnd
+// outside a bracket count one shape each
+void HeadlessShapeBegin(void);
+void HeadlessShapeEnd(void);
+
+// Scripted input, advanced once per frame by EndDrawing (headless_raylib.cpp)
+void HeadlessInputNextFrame(void);
+
+// 8-bit PNG files (headless_png.cpp): RGB written, RGB and RGBA read back. The
+// writer compresses with fixed-Huffman deflate; the reader takes any zlib stream.
+bool HeadlessWritePng(const char *path, const Color *pixels, int width, int height);
+bool HeadlessReadPng(const char *path, std::vector<Color> *pixels, int *width, int *height);
@@ -0,0 +1,510 @@
+// headless_png.cpp
+// PNG frame dumps without zlib: a small LZ77 + fixed-Huffman deflate for writing and a
+// complete inflate for reading golden images back, whatever tool saved them
+#include "headless.h"
+#include <cstdio>
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int LZ_WINDOW = 32768;
+constexpr int LZ_HASH_BITS = 15;
+constexpr int LZ_MIN_MATCH = 3;
+constexpr int LZ_MAX_MATCH = 258;
+constexpr int LZ_CHAIN_DEPTH = 32;
+
+static const uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+                                          67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DIST_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                        1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const uint8_t CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+//------------------------------------------------------------------------------------
+// Checksums
+//------------------------------------------------------------------------------------
+static uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc = 0)
+{
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready)
+    {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        ready = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t Adler32(const uint8_t *data, size_t size)
+{
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+//------------------------------------------------------------------------------------
+// Deflate, fixed Huffman codes
+//------------------------------------------------------------------------------------
+struct BitWriter {
+    std::vector<uint8_t> *out;
+    uint32_t bits;
+    int count;
+};
+
+static void PutBits(BitWriter *writer, uint32_t value, int count)
+{
+    writer->bits |= value << writer->count;
+    writer->count += count;
+    while (writer->count >= 8)
+    {
+        writer->out->push_back((uint8_t)writer->bits);
+        writer->bits >>= 8;
+        writer->count -= 8;
+    }
+}
+
+// Huffman codes go out most significant bit first
+static void PutCode(BitWriter *writer, uint32_t code, int length)
+{
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+    PutBits(writer, reversed, length);
+}
+
+static void PutLiteral(BitWriter *writer, int symbol)
+{
+    if (symbol < 144) PutCode(writer, 0x30 + symbol, 8);
+    else if (symbol < 256) PutCode(writer, 0x190 + symbol - 144, 9);
+    else if (symbol < 280) PutCode(writer, symbol - 256, 7);
+    else PutCode(writer, 0xc0 + symbol - 280, 8);
+}
+
+static void PutMatch(BitWriter *writer, int length, int distance)
+{
+    int code = 28;
+    while (LENGTH_BASE[code] > length) code--;
+    PutLiteral(writer, 257 + code);
+    PutBits(writer, length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+    code = 29;
+    while (DIST_BASE[code] > distance) code--;
+    PutCode(writer, code, 5);
+    PutBits(writer, distance - DIST_BASE[code], DIST_EXTRA[code]);
+}
+
+static uint32_t Hash3(const uint8_t *p)
+{
+    return ((p[0] << 16 | p[1] << 8 | p[2])*2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// zlib stream of one fixed-Huffman block
+static void Deflate(const std::vector<uint8_t> &data, std::vector<uint8_t> *out)
+{
+    out->push_back(0x78);
+    out->push_back(0x01);
+    BitWriter writer = { out, 0, 0 };
+    PutBits(&writer, 1, 1);            // Final block
+    PutBits(&writer, 1, 2);            // Fixed codes
+
+    std::vector<int32_t> head((size_t)1 << LZ_HASH_BITS, -1);
+    std::vector<int32_t> prev(LZ_WINDOW, -1);
+    const uint8_t *bytes = data.data();
+    int size = (int)data.size();
+
+    auto insert = [&](int at) {
+        if (at + LZ_MIN_MATCH > size) return;
+        uint32_t hash = Hash3(bytes + at);
+        prev[at & (LZ_WINDOW - 1)] = head[hash];
+        head[hash] = at;
+    };
+
+    int at = 0;
+    while (at < size)
+    {
+        int bestLength = 0, bestDistance = 0;
+        if (at + LZ_MIN_MATCH <= size)
+        {
+            int limit = (size - at < LZ_MAX_MATCH) ? size - at : LZ_MAX_MATCH;
+            int candidate = head[Hash3(bytes + at)];
+            for (int depth = 0; depth < LZ_CHAIN_DEPTH && candidate >= 0 && at - candidate <= LZ_WINDOW - 1; depth++)
+            {
+                int length = 0;
+                while (length < limit && bytes[candidate + length] == bytes[at + length]) length++;
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    bestDistance = at - candidate;
+                    if (length == limit) break;
+                }
+                int next = prev[candidate & (LZ_WINDOW - 1)];
+                if (next >= candidate) break;
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= LZ_MIN_MATCH)
+        {
+            PutMatch(&writer, bestLength, bestDistance);
+            for (int i = 0; i < bestLength; i++) insert(at + i);
+            at += bestLength;
+        }
+        else
+        {
+            PutLiteral(&writer, bytes[at]);
+            insert(at);
+            at++;
+        }
+    }
+
+    PutLiteral(&writer, 256);
+    if (writer.count > 0) PutBits(&writer, 0, 8 - writer.count);
+
+    uint32_t adler = Adler32(bytes, data.size());
+    for (int shift = 24; shift >= 0; shift -= 8) out->push_back((uint8_t)(adler >> shift));
+}
+
+//------------------------------------------------------------------------------------
+// Inflate, all block types
+//------------------------------------------------------------------------------------
+struct BitReader {
+    const uint8_t *data;
+    size_t size;
+    size_t at;
+    uint32_t bits;
+    int count;
+    bool error;
+};
+
+struct Huffman {
+    uint16_t counts[16];
+    uint16_t symbols[288];
+};
+
+static uint32_t GetBits(BitReader *reader, int count)
+{
+    while (reader->count < count)
+    {
+        if (reader->at == reader->size)
+        {
+            reader->error = true;
+            return 0;
+        }
+        reader->bits |= (uint32_t)reader->data[reader->at++] << reader->count;
+        reader->count += 8;
+    }
+    uint32_t value = reader->bits & ((1u << count) - 1);
+    reader->bits >>= count;
+    reader->count -= count;
+    return value;
+}
+
+static bool BuildHuffman(Huffman *huffman, const uint8_t *lengths, int count)
+{
+    memset(huffman->counts, 0, sizeof(huffman->counts));
+    for (int i = 0; i < count; i++) huffman->counts[lengths[i]]++;
+    huffman->counts[0] = 0;
+
+    uint16_t offsets[16] = {};
+    for (int length = 1; length < 15; length++) offsets[length + 1] = offsets[length] + huffman->counts[length];
+    for (int i = 0; i < count; i++)
+    {
+        if (lengths[i] != 0) huffman->symbols[offsets[lengths[i]]++] = (uint16_t)i;
+    }
+
+    // Over-subscribed code sets are corrupt
+    int left = 1;
+    for (int length = 1; length < 16; length++)
+    {
+        left = (left << 1) - huffman->counts[length];
+        if (left < 0) return false;
+    }
+    return true;
+}
+
+// Canonical decode, one bit at a time
+static int DecodeSymbol(BitReader *reader, const Huffman *huffman)
+{
+    int code = 0, first = 0, index = 0;
+    for (int length = 1; length < 16; length++)
+    {
+        code |= (int)GetBits(reader, 1);
+        int count = huffman->counts[length];
+        if (code - first < count) return huffman->symbols[index + code - first];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    reader->error = true;
+    return -1;
+}
+
+static bool InflateCodes(BitReader *reader, const Huffman *lengths, const Huffman *distances, std::vector<uint8_t> *out)
+{
+    for (;;)
+    {
+        int symbol = DecodeSymbol(reader, lengths);
+        if (reader->error || symbol < 0) return false;
+        if (symbol < 256) out->push_back((uint8_t)symbol);
+        else if (symbol == 256) return true;
+        else
+        {
+            symbol -= 257;
+            if (symbol >= 29) return false;
+            int length = LENGTH_BASE[symbol] + (int)GetBits(reader, LENGTH_EXTRA[symbol]);
+            int code = DecodeSymbol(reader, distances);
+            if (reader->error || code < 0 || code >= 30) return false;
+            size_t distance = DIST_BASE[code] + GetBits(reader, DIST_EXTRA[code]);
+            if (distance > out->size()) return false;
+            size_t from = out->size() - distance;
+            for (int i = 0; i < length; i++) out->push_back((*out)[from + i]);
+        }
+    }
+}
+
+static bool Inflate(const uint8_t *data, size_t size, std::vector<uint8_t> *out)
+{
+    if (size < 2 || (data[0] & 0x0f) != 8 || ((data[0] << 8) | data[1]) % 31 != 0) return false;
+    BitReader reader = { data, size, 2, 0, 0, false };
+
+    bool last = false;
+    while (!last)
+    {
+        last = GetBits(&reader, 1) != 0;
+        uint32_t type = GetBits(&reader, 2);
+        if (reader.error) return false;
+
+        if (type == 0)
+        {
+            reader.bits = 0;
+            reader.count = 0;
+            if (reader.at + 4 > size) return false;
+            uint32_t length = data[reader.at] | (data[reader.at + 1] << 8);
+            uint32_t check = data[reader.at + 2] | (data[reader.at + 3] << 8);
+            reader.at += 4;
+            if ((length ^ 0xffff) != check || reader.at + length > size) return false;
+            out->insert(out->end(), data + reader.at, data + reader.at + length);
+            reader.at += length;
+        }
+        else if (type == 1)
+        {
+            uint8_t lengths[288 + 30];
+            for (int i = 0; i < 144; i++) lengths[i] = 8;
+            for (int i = 144; i < 256; i++) lengths[i] = 9;
+            for (int i = 256; i < 280; i++) lengths[i] = 7;
+            for (int i = 280; i < 288; i++) lengths[i] = 8;
+            for (int i = 288; i < 318; i++) lengths[i] = 5;
+            Huffman literals, distances;
+            BuildHuffman(&literals, lengths, 288);
+            BuildHuffman(&distances, lengths + 288, 30);
+            if (!InflateCodes(&reader, &literals, &distances, out)) return false;
+        }
+        else if (type == 2)
+        {
+            int literalCount = (int)GetBits(&reader, 5) + 257;
+            int distanceCount = (int)GetBits(&reader, 5) + 1;
+            int codeCount = (int)GetBits(&reader, 4) + 4;
+            if (literalCount > 286 || distanceCount > 30) return false;
+
+            uint8_t lengths[320] = {};
+            for (int i = 0; i < codeCount; i++) lengths[CODE_LENGTH_ORDER[i]] = (uint8_t)GetBits(&reader, 3);
+            Huffman codeLengths;
+            if (!BuildHuffman(&codeLengths, lengths, 19)) return false;
+
+            memset(lengths, 0, sizeof(lengths));
+            int filled = 0;
+            while (filled < literalCount + distanceCount)
+            {
+                int symbol = DecodeSymbol(&reader, &codeLengths);
+                if (reader.error || symbol < 0) return false;
+                if (symbol < 16)
+                {
+                    lengths[filled++] = (uint8_t)symbol;
+                    continue;
+                }
+
+                uint8_t value = 0;
+                int repeat;
+                if (symbol == 16)
+                {
+                    if (filled == 0) return false;
+                    value = lengths[filled - 1];
+                    repeat = 3 + (int)GetBits(&reader, 2);
+                }
+                else if (symbol == 17) repeat = 3 + (int)GetBits(&reader, 3);
+                else repeat = 11 + (int)GetBits(&reader, 7);
+                if (filled + repeat > literalCount + distanceCount) return false;
+                while (repeat-- > 0) lengths[filled++] = value;
+            }
+
+            Huffman literals, distances;
+            if (!BuildHuffman(&literals, lengths, literalCount) || !BuildHuffman(&distances, lengths + literalCount, distanceCount)) return false;
+            if (!InflateCodes(&reader, &literals, &distances, out)) return false;
+        }
+        else return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static void PutU32(std::vector<uint8_t> *out, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) out->push_back((uint8_t)(value >> shift));
+}
+
+static uint32_t GetU32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void PutChunk(std::vector<uint8_t> *file, const char *type, const std::vector<uint8_t> &data)
+{
+    PutU32(file, (uint32_t)data.size());
+    size_t start = file->size();
+    file->insert(file->end(), type, type + 4);
+    file->insert(file->end(), data.begin(), data.end());
+    PutU32(file, Crc32(file->data() + start, file->size() - start));
+}
+
+static int Paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return (pb <= pc) ? b : c;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+bool HeadlessWritePng(const char *path, const Color *pixels, int width, int height)
+{
+    // Filter type 0 on every row: flat game frames compress well enough as they are
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)(width*3 + 1)*height);
+    for (int y = 0; y < height; y++)
+    {
+        raw.push_back(0);
+        for (int x = 0; x < width; x++)
+        {
+            const Color &pixel = pixels[(size_t)y*width + x];
+            raw.push_back(pixel.r);
+            raw.push_back(pixel.g);
+            raw.push_back(pixel.b);
+        }
+    }
+
+    std::vector<uint8_t> header;
+    PutU32(&header, (uint32_t)width);
+    PutU32(&header, (uint32_t)height);
+    const uint8_t format[5] = { 8, 2, 0, 0, 0 };      // 8-bit RGB, no interlace
+    header.insert(header.end(), format, format + 5);
+
+    std::vector<uint8_t> compressed;
+    Deflate(raw, &compressed);
+
+    std::vector<uint8_t> file(PNG_SIGNATURE, PNG_SIGNATURE + 8);
+    PutChunk(&file, "IHDR", header);
+    PutChunk(&file, "IDAT", compressed);
+    PutChunk(&file, "IEND", {});
+
+    FILE *out = fopen(path, "wb");
+    if (out == nullptr) return false;
+    bool ok = fwrite(file.data(), 1, file.size(), out) == file.size();
+    return (fclose(out) == 0) && ok;
+}
+
+bool HeadlessReadPng(const char *path, std::vector<Color> *pixels, int *width, int *height)
+{
+    FILE *in = fopen(path, "rb");
+    if (in == nullptr) return false;
+    std::vector<uint8_t> file;
+    uint8_t buffer[65536];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), in)) > 0) file.insert(file.end(), buffer, buffer + got);
+    fclose(in);
+
+    if (file.size() < 8 || memcmp(file.data(), PNG_SIGNATURE, 8) != 0) return false;
+
+    int w = 0, h = 0, channels = 0;
+    std::vector<uint8_t> compressed;
+    for (size_t at = 8; at + 12 <= file.size(); )
+    {
+        uint32_t length = GetU32(&file[at]);
+        if (at + 12 + (size_t)length > file.size()) return false;
+        const uint8_t *type = &file[at + 4];
+        const uint8_t *data = &file[at + 8];
+
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13)
+        {
+            w = (int)GetU32(data);
+            h = (int)GetU32(data + 4);
+            // 8-bit RGB or RGBA, not interlaced
+            if (data[8] != 8 || data[12] != 0) return false;
+            if (data[9] == 2) channels = 3;
+            else if (data[9] == 6) channels = 4;
+            else return false;
+        }
+        else if (memcmp(type, "IDAT", 4) == 0) compressed.insert(compressed.end(), data, data + length);
+        else if (memcmp(type, "IEND", 4) == 0) break;
+        at += 12 + length;
+    }
+    if (w <= 0 || h <= 0 || channels == 0) return false;
+
+    std::vector<uint8_t> raw;
+    size_t stride = (size_t)w*channels;
+    if (!Inflate(compressed.data(), compressed.size(), &raw) || raw.size() < (stride + 1)*h) return false;
+
+    // Undo the row filters in place
+    for (int y = 0; y < h; y++)
+    {
+        uint8_t filter = raw[y*(stride + 1)];
+        uint8_t *row = &raw[y*(stride + 1) + 1];
+        const uint8_t *up = (y > 0) ? &raw[(y - 1)*(stride + 1) + 1] : nullptr;
+        for (size_t i = 0; i < stride; i++)
+        {
+            int a = (i >= (size_t)channels) ? row[i - channels] : 0;
+            int b = (up != nullptr) ? up[i] : 0;
+            int c = (up != nullptr && i >= (size_t)channels) ? up[i - channels] : 0;
+            switch (filter)
+            {
+                case 0: break;
+                case 1: row[i] = (uint8_t)(row[i] + a); break;
+                case 2: row[i] = (uint8_t)(row[i] + b); break;
+                case 3: row[i] = (uint8_t)(row[i] + (a + b)/2); break;
+                case 4: row[i] = (uint8_t)(row[i] + Paeth(a, b, c)); break;
+                default: return false;
+            }
+        }
+    }
+
+    pixels->resize((size_t)w*h);
+    for (int y = 0; y < h; y++)
+    {
+        const uint8_t *row = &raw[y*(stride + 1) + 1];
+        for (int x = 0; x < w; x++)
+        {
+            const uint8_t *p = row + (size_t)x*channels;
+            (*pixels)[(size_t)y*w + x] = { p[0], p[1], p[2], (uint8_t)((channels == 4) ? p[3] : 255) };
+        }
+    }
+    *width = w;
+    *height = h;
+    return true;
+}
@@ -0,0 +1,621 @@
+// headless_raster.cpp
+// Software renderer behind the headless raylib: rlgl immediate mode, the shape and
+// texture calls the games use, and per-frame render statistics and PNG dumps
+#include "headless.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int SUBPIXEL_BITS = 4;                       // Vertices snap to 1/16 pixel
+constexpr int SUBPIXEL = 1 << SUBPIXEL_BITS;
+constexpr int CIRCLE_SEGMENTS = 36;
+constexpr float DEG2RAD = 3.14159265358979323846f/180.0f;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct RasterVertex {
+    float x;                           // Screen space, after the 2D camera
+    float y;
+    float u;
+    float v;
+    Color color;
+};
+
+struct RasterTexture {
+    int width;
+    int height;
+    std::vector<Color> pixels;         // Empty once destroyed
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static int screenWidth = 0;
+static int screenHeight = 0;
+static std::vector<Color> framebuffer;
+static std::vector<RasterTexture> textures;           // Texture id is index + 1
+
+// rlgl immediate-mode state
+static int primitiveMode = 0;
+static std::vector<RasterVertex> primitive;
+static Color vertexColor = { 255, 255, 255, 255 };
+static float vertexU = 0.0f;
+static float vertexV = 0.0f;
+static unsigned int boundTexture = HEADLESS_TEXTURE_WHITE;
+static bool cameraActive = false;
+static Camera2D camera = {};
+
+// A GPU batch stays open while texture and primitive type stay the same
+static bool batchOpen = false;
+static unsigned int batchTexture = 0;
+static int batchMode = 0;
+static int shapeNesting = 0;
+
+static HeadlessFrameStats frameStats = {};
+static std::vector<HeadlessFrameStats> frames;
+static std::chrono::steady_clock::time_point frameStart;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static Color Modulate(Color texel, Color tint)
+{
+    return { (unsigned char)((texel.r*tint.r + 127)/255), (unsigned char)((texel.g*tint.g + 127)/255),
+             (unsigned char)((texel.b*tint.b + 127)/255), (unsigned char)((texel.a*tint.a + 127)/255) };
+}
+
+// glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on every channel, like raylib's default
+static void Blend(Color *dst, Color src)
+{
+    if (src.a == 255)
+    {
+        *dst = src;
+        return;
+    }
+    if (src.a == 0) return;
+    int a = src.a, ia = 255 - src.a;
+    dst->r = (unsigned char)((src.r*a + dst->r*ia + 127)/255);
+    dst->g = (unsigned char)((src.g*a + dst->g*ia + 127)/255);
+    dst->b = (unsigned char)((src.b*a + dst->b*ia + 127)/255);
+    dst->a = (unsigned char)((src.a*a + dst->a*ia + 127)/255);
+}
+
+static const RasterTexture *FindTexture(unsigned int id)
+{
+    if (id == 0 || id > textures.size() || textures[id - 1].pixels.empty()) return nullptr;
+    return &textures[id - 1];
+}
+
+static Color Sample(const RasterTexture *texture, float u, float v)
+{
+    int x = (int)floorf(u*texture->width);
+    int y = (int)floorf(v*texture->height);
+    x = (x < 0) ? 0 : (x >= texture->width) ? texture->width - 1 : x;
+    y = (y < 0) ? 0 : (y >= texture->height) ? texture->height - 1 : y;
+    return texture->pixels[(size_t)y*texture->width + x];
+}
+
+static void CountBatch(unsigned int texture, int mode)
+{
+    if (!batchOpen || texture != batchTexture || mode != batchMode) frameStats.drawCalls++;
+    batchOpen = true;
+    batchTexture = texture;
+    batchMode = mode;
+}
+
+// Edge functions in 28.4 fixed point over pixel centers. The top-left rule gives
+// pixels on a shared edge to exactly one of the two triangles.
+static void RasterTriangle(RasterVertex a, RasterVertex b, RasterVertex c, const RasterTexture *texture)
+{
+    int64_t x0 = lroundf(a.x*SUBPIXEL), y0 = lroundf(a.y*SUBPIXEL);
+    int64_t x1 = lroundf(b.x*SUBPIXEL), y1 = lroundf(b.y*SUBPIXEL);
+    int64_t x2 = lroundf(c.x*SUBPIXEL), y2 = lroundf(c.y*SUBPIXEL);
+
+    int64_t area = (x1 - x0)*(y2 - y0) - (y1 - y0)*(x2 - x0);
+    if (area == 0) return;
+    if (area < 0)
+    {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+        std::swap(b, c);
+        area = -area;
+    }
+    frameStats.triangles++;
+
+    int64_t minX = std::min(x0, std::min(x1, x2)) >> SUBPIXEL_BITS;
+    int64_t maxX = (std::max(x0, std::max(x1, x2)) + SUBPIXEL - 1) >> SUBPIXEL_BITS;
+    int64_t minY = std::min(y0, std::min(y1, y2)) >> SUBPIXEL_BITS;
+    int64_t maxY = (std::max(y0, std::max(y1, y2)) + SUBPIXEL - 1) >> SUBPIXEL_BITS;
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > screenWidth - 1) maxX = screenWidth - 1;
+    if (maxY > screenHeight - 1) maxY = screenHeight - 1;
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge i is opposite vertex i, its value is vertex i's barycentric weight times area
+    const int64_t ex[3] = { x2 - x1, x0 - x2, x1 - x0 };
+    const int64_t ey[3] = { y2 - y1, y0 - y2, y1 - y0 };
+    const int64_t ox[3] = { x1, x2, x0 };
+    const int64_t oy[3] = { y1, y2, y0 };
+    int64_t row[3], bias[3];
+    int64_t px = minX*SUBPIXEL + SUBPIXEL/2, py = minY*SUBPIXEL + SUBPIXEL/2;
+    for (int i = 0; i < 3; i++)
+    {
+        bool topLeft = (ey[i] < 0) || (ey[i] == 0 && ex[i] > 0);
+        bias[i] = topLeft ? 0 : -1;
+        row[i] = ex[i]*(py - oy[i]) - ey[i]*(px - ox[i]);
+    }
+
+    bool sameColor = memcmp(&a.color, &b.color, sizeof(Color)) == 0 && memcmp(&a.color, &c.color, sizeof(Color)) == 0;
+    bool flat = sameColor && texture == nullptr;
+    double inverseArea = 1.0/(double)area;
+
+    for (int64_t y = minY; y <= maxY; y++)
+    {
+        int64_t w[3] = { row[0], row[1], row[2] };
+        Color *out = &framebuffer[(size_t)y*screenWidth + minX];
+        for (int64_t x = minX; x <= maxX; x++, out++)
+        {
+            if (w[0] + bias[0] >= 0 && w[1] + bias[1] >= 0 && w[2] + bias[2] >= 0)
+            {
+                Color color = a.color;
+                if (!flat)
+                {
+                    double l0 = w[0]*inverseArea, l1 = w[1]*inverseArea, l2 = w[2]*inverseArea;
+                    if (!sameColor)
+                    {
+                        color.r = (unsigned char)(l0*a.color.r + l1*b.color.r + l2*c.color.r + 0.5);
+                        color.g = (unsigned char)(l0*a.color.g + l1*b.color.g + l2*c.color.g + 0.5);
+                        color.b = (unsigned char)(l0*a.color.b + l1*b.color.b + l2*c.color.b + 0.5);
+                        color.a = (unsigned char)(l0*a.color.a + l1*b.color.a + l2*c.color.a + 0.5);
+                    }
+                    if (texture != nullptr) color = Modulate(Sample(texture, (float)(l0*a.u + l1*b.u + l2*c.u), (float)(l0*a.v + l1*b.v + l2*c.v)), color);
+                }
+                Blend(out, color);
+                frameStats.pixels++;
+            }
+            for (int i = 0; i < 3; i++) w[i] -= ey[i]*SUBPIXEL;
+        }
+        for (int i = 0; i < 3; i++) row[i] += ex[i]*SUBPIXEL;
+    }
+}
+
+// One pixel wide, stepping along the major axis through pixel centers
+static void RasterLine(RasterVertex a, RasterVertex b)
+{
+    float dx = b.x - a.x, dy = b.y - a.y;
+    int steps = (int)ceilf(std::max(fabsf(dx), fabsf(dy)));
+    if (steps == 0) steps = 1;
+    frameStats.triangles += 2;         // What a GPU line costs
+    for (int i = 0; i < steps; i++)
+    {
+        int x = (int)floorf(a.x + dx*(i + 0.5f)/steps);
+        int y = (int)floorf(a.y + dy*(i + 0.5f)/steps);
+        if (x < 0 || y < 0 || x >= screenWidth || y >= screenHeight) continue;
+        Blend(&framebuffer[(size_t)y*screenWidth + x], a.color);
+        frameStats.pixels++;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Framebuffer and counters
+//------------------------------------------------------------------------------------
+void HeadlessRasterInit(int width, int height)
+{
+    screenWidth = width;
+    screenHeight = height;
+    framebuffer.assign((size_t)width*height, { 0, 0, 0, 255 });
+    frames.clear();
+    textures.clear();
+    const Color white = { 255, 255, 255, 255 };
+    HeadlessTextureCreate(1, 1, &white);
+}
+
+void HeadlessRasterClose(void)
+{
+    framebuffer.clear();
+    framebuffer.shrink_to_fit();
+    textures.clear();
+}
+
+const Color *HeadlessFramebuffer(void)
+{
+    return framebuffer.data();
+}
+
+const std::vector<HeadlessFrameStats> &HeadlessFrames(void)
+{
+    return frames;
+}
+
+unsigned int HeadlessTextureCreate(int width, int height, const Color *pixels)
+{
+    RasterTexture texture = { width, height, std::vector<Color>(pixels, pixels + (size_t)width*height) };
+    textures.push_back(std::move(texture));
+    return (unsigned int)textures.size();
+}
+
+void HeadlessTextureDestroy(unsigned int id)
+{
+    if (id <= HEADLESS_TEXTURE_WHITE || id > textures.size()) return;
+    textures[id - 1].pixels.clear();
+    textures[id - 1].pixels.shrink_to_fit();
+}
+
+void HeadlessShapeBegin(void)
+{
+    if (shapeNesting++ == 0) frameStats.shapes++;
+}
+
+void HeadlessShapeEnd(void)
+{
+    shapeNesting--;
+}
+
+//------------------------------------------------------------------------------------
+// rlgl immediate mode
+//------------------------------------------------------------------------------------
+void rlBegin(int mode)
+{
+    primitiveMode = mode;
+    primitive.clear();
+}
+
+void rlEnd(void)
+{
+    if (shapeNesting == 0) frameStats.shapes++;
+    const RasterTexture *texture = FindTexture(boundTexture);
+    if (boundTexture == HEADLESS_TEXTURE_WHITE) texture = nullptr;
+    CountBatch(boundTexture, primitiveMode);
+
+    const RasterVertex *v = primitive.data();
+    size_t count = primitive.size();
+    if (primitiveMode == RL_QUADS)
+    {
+        for (size_t i = 0; i + 3 < count; i += 4)
+        {
+            RasterTriangle(v[i], v[i + 1], v[i + 2], texture);
+            RasterTriangle(v[i], v[i + 2], v[i + 3], texture);
+        }
+    }
+    else if (primitiveMode == RL_TRIANGLES)
+    {
+        for (size_t i = 0; i + 2 < count; i += 3) RasterTriangle(v[i], v[i + 1], v[i + 2], texture);
+    }
+    else if (primitiveMode == RL_LINES)
+    {
+        for (size_t i = 0; i + 1 < count; i += 2) RasterLine(v[i], v[i + 1]);
+    }
+    primitive.clear();
+}
+
+// GetCameraMatrix2D: around the target, rotated, zoomed, then moved to the offset
+void rlVertex2f(float x, float y)
+{
+    if (cameraActive)
+    {
+        float dx = x - camera.target.x, dy = y - camera.target.y;
+        float c = cosf(camera.rotation*DEG2RAD), s = sinf(camera.rotation*DEG2RAD);
+        x = (dx*c - dy*s)*camera.zoom + camera.offset.x;
+        y = (dx*s + dy*c)*camera.zoom + camera.offset.y;
+    }
+    primitive.push_back({ x, y, vertexU, vertexV, vertexColor });
+}
+
+void rlTexCoord2f(float x, float y)
+{
+    vertexU = x;
+    vertexV = y;
+}
+
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    vertexColor = { r, g, b, a };
+}
+
+void rlSetTexture(unsigned int id)
+{
+    boundTexture = (id == 0) ? HEADLESS_TEXTURE_WHITE : id;
+}
+
+unsigned int rlGetTextureIdDefault(void)
+{
+    return HEADLESS_TEXTURE_WHITE;
+}
+
+bool rlCheckRenderBatchLimit(int vCount)
+{
+    (void)vCount;
+    return false;
+}
+
+void rlDrawRenderBatchActive(void)
+{
+    batchOpen = false;
+}
+
+//------------------------------------------------------------------------------------
+// Frame
+//------------------------------------------------------------------------------------
+void ClearBackground(Color color)
+{
+    for (Color &pixel : framebuffer) pixel = color;
+    frameStats.pixels += (int64_t)framebuffer.size();
+}
+
+void BeginDrawing(void)
+{
+    frameStats = {};
+    batchOpen = false;
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void EndDrawing(void)
+{
+    rlDrawRenderBatchActive();
+    frameStats.renderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+    frames.push_back(frameStats);
+
+    const HeadlessWindow &window = headlessWindow;
+    bool last = window.frame + 1 >= window.maxFrames;
+    bool every = window.dumpEvery > 0 && (window.frame + 1) % window.dumpEvery == 0;
+    if (!window.dumpDir.empty() && (last || every))
+    {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/frame_%05d.png", window.dumpDir.c_str(), window.frame);
+        if (!HeadlessWritePng(path, framebuffer.data(), screenWidth, screenHeight)) TraceLog(LOG_WARNING, "HEADLESS: Failed to write %s", path);
+    }
+
+    HeadlessInputNextFrame();
+    headlessWindow.frame++;
+}
+
+void BeginMode2D(Camera2D mode)
+{
+    rlDrawRenderBatchActive();
+    camera = mode;
+    cameraActive = true;
+}
+
+void EndMode2D(void)
+{
+    rlDrawRenderBatchActive();
+    cameraActive = false;
+}
+
+//------------------------------------------------------------------------------------
+// Shapes
+//------------------------------------------------------------------------------------
+void DrawPixel(int posX, int posY, Color color)
+{
+    DrawRectangle(posX, posY, 1, 1, color);
+}
+
+void DrawLine(int startPosX, int startPosY, int endPosX, int endPosY, Color color)
+{
+    HeadlessShapeBegin();
+    rlSetTexture(0);
+    rlBegin(RL_LINES);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlVertex2f(startPosX + 0.5f, startPosY + 0.5f);
+    rlVertex2f(endPosX + 0.5f, endPosY + 0.5f);
+    rlEnd();
+    HeadlessShapeEnd();
+}
+
+void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+    HeadlessShapeBegin();
+    rlSetTexture(0);
+    rlBegin(RL_TRIANGLES);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlVertex2f(v1.x, v1.y);
+    rlVertex2f(v2.x, v2.y);
+    rlVertex2f(v3.x, v3.y);
+    rlEnd();
+    HeadlessShapeEnd();
+}
+
+void DrawRectangle(int posX, int posY, int width, int height, Color color)
+{
+    DrawRectangleRec({ (float)posX, (float)posY, (float)width, (float)height }, color);
+}
+
+void DrawRectangleV(Vector2 position, Vector2 size, Color color)
+{
+    DrawRectangleRec({ position.x, position.y, size.x, size.y }, color);
+}
+
+void DrawRectangleRec(Rectangle rec, Color color)
+{
+    HeadlessShapeBegin();
+    rlSetTexture(0);
+    rlBegin(RL_QUADS);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlVertex2f(rec.x, rec.y);
+    rlVertex2f(rec.x, rec.y + rec.height);
+    rlVertex2f(rec.x + rec.width, rec.y + rec.height);
+    rlVertex2f(rec.x + rec.width, rec.y);
+    rlEnd();
+    HeadlessShapeEnd();
+}
+
+// A cross of three rectangles and a fan in each corner, the shape raylib draws
+void DrawRectangleRounded(Rectangle rec, float roundness, int segments, Color color)
+{
+    if (roundness <= 0.0f || rec.width < 1 || rec.height < 1)
+    {
+        DrawRectangleRec(rec, color);
+        return;
+    }
+    if (roundness > 1.0f) roundness = 1.0f;
+    float radius = (rec.width > rec.height) ? (rec.height*roundness)/2 : (rec.width*roundness)/2;
+    if (radius <= 0.0f)
+    {
+        DrawRectangleRec(rec, color);
+        return;
+    }
+    if (segments < 4) segments = 4;
+
+    HeadlessShapeBegin();
+    DrawRectangleRec({ rec.x + radius, rec.y, rec.width - 2*radius, rec.height }, color);
+    DrawRectangleRec({ rec.x, rec.y + radius, radius, rec.height - 2*radius }, color);
+    DrawRectangleRec({ rec.x + rec.width - radius, rec.y + radius, radius, rec.height - 2*radius }, color);
+
+    const Vector2 centers[4] = { { rec.x + radius, rec.y + radius }, { rec.x + rec.width - radius, rec.y + radius },
+                                 { rec.x + rec.width - radius, rec.y + rec.height - radius }, { rec.x + radius, rec.y + rec.height - radius } };
+    const float startAngles[4] = { 180.0f, 270.0f, 0.0f, 90.0f };
+    float step = 90.0f/segments;
+
+    rlSetTexture(0);
+    rlBegin(RL_TRIANGLES);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    for (int corner = 0; corner < 4; corner++)
+    {
+        float angle = startAngles[corner];
+        for (int i = 0; i < segments; i++, angle += step)
+        {
+            rlVertex2f(centers[corner].x, centers[corner].y);
+            rlVertex2f(centers[corner].x + cosf(DEG2RAD*(angle + step))*radius, centers[corner].y + sinf(DEG2RAD*(angle + step))*radius);
+            rlVertex2f(centers[corner].x + cosf(DEG2RAD*angle)*radius, centers[corner].y + sinf(DEG2RAD*angle)*radius);
+        }
+    }
+    rlEnd();
+    HeadlessShapeEnd();
+}
+
+void DrawRectangleLines(int posX, int posY, int width, int height, Color color)
+{
+    HeadlessShapeBegin();
+    DrawRectangle(posX, posY, width, 1, color);
+    DrawRectangle(posX + width - 1, posY + 1, 1, height - 2, color);
+    DrawRectangle(posX, posY + height - 1, width, 1, color);
+    DrawRectangle(posX, posY + 1, 1, height - 2, color);
+    HeadlessShapeEnd();
+}
+
+void DrawCircle(int centerX, int centerY, float radius, Color color)
+{
+    HeadlessShapeBegin();
+    rlSetTexture(0);
+    rlBegin(RL_TRIANGLES);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    float step = 360.0f/CIRCLE_SEGMENTS;
+    for (int i = 0; i < CIRCLE_SEGMENTS; i++)
+    {
+        float angle = i*step;
+        rlVertex2f((float)centerX, (float)centerY);
+        rlVertex2f(centerX + cosf(DEG2RAD*(angle + step))*radius, centerY + sinf(DEG2RAD*(angle + step))*radius);
+        rlVertex2f(centerX + cosf(DEG2RAD*angle)*radius, centerY + sinf(DEG2RAD*angle)*radius);
+    }
+    rlEnd();
+    HeadlessShapeEnd();
+}
+
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2)
+{
+    return (rec1.x < (rec2.x + rec2.width) && (rec1.x + rec1.width) > rec2.x) &&
+           (rec1.y < (rec2.y + rec2.height) && (rec1.y + rec1.height) > rec2.y);
+}
+
+Color Fade(Color color, float alpha)
+{
+    if (alpha < 0.0f) alpha = 0.0f;
+    else if (alpha > 1.0f) alpha = 1.0f;
+    color.a = (unsigned char)(255.0f*alpha);
+    return color;
+}
+
+//------------------------------------------------------------------------------------
+// Textures
+//------------------------------------------------------------------------------------
+Texture2D LoadTextureFromImage(Image image)
+{
+    Texture2D texture = {};
+    if (image.data == nullptr || image.width <= 0 || image.height <= 0) return texture;
+
+    std::vector<Color> pixels((size_t)image.width*image.height);
+    const unsigned char *data = (const unsigned char *)image.data;
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        switch (image.format)
+        {
+            case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: pixels[i] = { data[i], data[i], data[i], 255 }; break;
+            case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: pixels[i] = { data[i*2], data[i*2], data[i*2], data[i*2 + 1] }; break;
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8: pixels[i] = { data[i*3], data[i*3 + 1], data[i*3 + 2], 255 }; break;
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: pixels[i] = { data[i*4], data[i*4 + 1], data[i*4 + 2], data[i*4 + 3] }; break;
+            default:
+                TraceLog(LOG_WARNING, "HEADLESS: Texture format %d not supported", image.format);
+                return texture;
+        }
+    }
+
+    texture.id = HeadlessTextureCreate(image.width, image.height, pixels.data());
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.mipmaps = 1;
+    texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return texture;
+}
+
+void UnloadTexture(Texture2D texture)
+{
+    HeadlessTextureDestroy(texture.id);
+}
+
+void DrawTexture(Texture2D texture, int posX, int posY, Color tint)
+{
+    DrawTexturePro(texture, { 0, 0, (float)texture.width, (float)texture.height },
+                   { (float)posX, (float)posY, (float)texture.width, (float)texture.height }, { 0, 0 }, 0.0f, tint);
+}
+
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (texture.id == 0 || texture.width <= 0 || texture.height <= 0) return;
+
+    bool flipX = false;
+    if (source.width < 0)
+    {
+        flipX = true;
+        source.width = -source.width;
+    }
+    if (source.height < 0) source.y -= source.height;
+
+    // Corners around the origin, rotated, then placed at dest
+    float c = cosf(rotation*DEG2RAD), s = sinf(rotation*DEG2RAD);
+    float dx = -origin.x, dy = -origin.y;
+    Vector2 corners[4] = { { dx, dy }, { dx, dy + dest.height }, { dx + dest.width, dy + dest.height }, { dx + dest.width, dy } };
+    for (Vector2 &corner : corners)
+    {
+        Vector2 p = corner;
+        corner = { dest.x + p.x*c - p.y*s, dest.y + p.x*s + p.y*c };
+    }
+
+    float width = (float)texture.width, height = (float)texture.height;
+    float left = source.x/width, right = (source.x + source.width)/width;
+    if (flipX) std::swap(left, right);
+    float top = source.y/height, bottom = (source.y + source.height)/height;
+
+    HeadlessShapeBegin();
+    rlSetTexture(texture.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+    rlTexCoord2f(left, top);
+    rlVertex2f(corners[0].x, corners[0].y);
+    rlTexCoord2f(left, bottom);
+    rlVertex2f(corners[1].x, corners[1].y);
+    rlTexCoord2f(right, bottom);
+    rlVertex2f(corners[2].x, corners[2].y);
+    rlTexCoord2f(right, top);
+    rlVertex2f(corners[3].x, corners[3].y);
+    rlEnd();
+    rlSetTexture(0);
+    HeadlessShapeEnd();
+}
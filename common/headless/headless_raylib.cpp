@@ -0,0 +1,539 @@
+// headless_raylib.cpp
+// Window, timing, files, scripted input and silent audio for the headless raylib,
+// and the render-cost report written when the run ends
+#include "headless.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int MAX_KEYS = 512;
+constexpr int MAX_KEY_QUEUE = 16;
+constexpr int INPUT_KEY_FRAMES = 8;             // A scripted key is held this long
+constexpr int INPUT_MOUSE_FRAMES = 32;          // The button changes state at most this often
+constexpr int INPUT_MOUSE_STEP = 12;            // Pixels per frame of the mouse walk
+constexpr uint32_t RANDOM_SEED = 0x2545f491u;
+
+// Keys the script holds, KEY_NULL lets go
+static const int SCRIPT_KEYS[] = { KEY_NULL, KEY_LEFT, KEY_RIGHT, KEY_UP, KEY_DOWN, KEY_SPACE };
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct ScriptedInput {
+    uint32_t state;                    // xorshift32, 0 when there is no script
+    bool keys[MAX_KEYS];
+    bool previousKeys[MAX_KEYS];
+    int queue[MAX_KEY_QUEUE];          // Presses this frame, for GetKeyPressed
+    int queueCount;
+    int queueRead;
+    Vector2 mouse;
+    bool mouseDown;
+    bool previousMouseDown;
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+HeadlessWindow headlessWindow;
+
+static ScriptedInput input = {};
+static uint32_t randomState = RANDOM_SEED;
+static int logLevel = LOG_INFO;
+static bool reported = false;
+static bool reportRegistered = false;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static uint32_t XorShift(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int EnvInt(const char *name, int fallback)
+{
+    const char *value = getenv(name);
+    return (value != nullptr && *value != '\0') ? atoi(value) : fallback;
+}
+
+static std::string EnvString(const char *name)
+{
+    const char *value = getenv(name);
+    return (value != nullptr) ? value : "";
+}
+
+// Summary on stdout and the per-frame CSV, once, from CloseWindow or at exit
+static void Report(void)
+{
+    if (reported || !headlessWindow.ready) return;
+    reported = true;
+
+    const std::vector<HeadlessFrameStats> &frames = HeadlessFrames();
+    if (frames.empty()) return;
+
+    std::vector<double> times;
+    double drawCalls = 0.0, shapes = 0.0, triangles = 0.0, pixels = 0.0;
+    for (const HeadlessFrameStats &frame : frames)
+    {
+        times.push_back(frame.renderMs);
+        drawCalls += frame.drawCalls;
+        shapes += frame.shapes;
+        triangles += frame.triangles;
+        pixels += (double)frame.pixels;
+    }
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double time : times) total += time;
+    double count = (double)frames.size();
+
+    printf("HEADLESS: %s, %d frames\n", headlessWindow.title.c_str(), (int)frames.size());
+    printf("HEADLESS: render ms avg %.3f p50 %.3f max %.3f\n", total/count, times[times.size()/2], times.back());
+    printf("HEADLESS: per frame %.1f draw calls, %.1f shapes, %.0f triangles, %.0f pixels\n",
+           drawCalls/count, shapes/count, triangles/count, pixels/count);
+
+    if (headlessWindow.statsPath.empty()) return;
+    FILE *file = fopen(headlessWindow.statsPath.c_str(), "w");
+    if (file == nullptr)
+    {
+        TraceLog(LOG_WARNING, "HEADLESS: Failed to write %s", headlessWindow.statsPath.c_str());
+        return;
+    }
+    fprintf(file, "frame,draw_calls,shapes,triangles,pixels,render_ms\n");
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        const HeadlessFrameStats &frame = frames[i];
+        fprintf(file, "%d,%d,%d,%d,%lld,%.4f\n", (int)i, frame.drawCalls, frame.shapes, frame.triangles, (long long)frame.pixels, frame.renderMs);
+    }
+    fclose(file);
+}
+
+//------------------------------------------------------------------------------------
+// Window and timing
+//------------------------------------------------------------------------------------
+void InitWindow(int width, int height, const char *title)
+{
+    HeadlessWindow &window = headlessWindow;
+    window.width = width;
+    window.height = height;
+    window.title = title;
+    window.frame = 0;
+    window.maxFrames = EnvInt("HEADLESS_FRAMES", HEADLESS_DEFAULT_FRAMES);
+    window.dumpDir = EnvString("HEADLESS_DUMP");
+    window.dumpEvery = EnvInt("HEADLESS_DUMP_EVERY", 0);
+    window.statsPath = EnvString("HEADLESS_STATS");
+    window.inputSeed = (uint32_t)EnvInt("HEADLESS_INPUT", 1);
+
+    HeadlessRasterInit(width, height);
+    input = {};
+    input.state = window.inputSeed;
+    input.mouse = { width/2.0f, height/2.0f };
+    randomState = RANDOM_SEED;
+    reported = false;
+
+    if (!reportRegistered) atexit(Report);
+    reportRegistered = true;
+    window.ready = true;
+    TraceLog(LOG_INFO, "HEADLESS: %s, %dx%d, %d frames, input seed %u", title, width, height, window.maxFrames, window.inputSeed);
+}
+
+void CloseWindow(void)
+{
+    Report();
+    HeadlessRasterClose();
+    headlessWindow.ready = false;
+}
+
+bool WindowShouldClose(void)
+{
+    return headlessWindow.frame >= headlessWindow.maxFrames;
+}
+
+bool IsWindowReady(void)
+{
+    return headlessWindow.ready;
+}
+
+void SetConfigFlags(unsigned int flags)
+{
+    (void)flags;
+}
+
+int GetScreenWidth(void)
+{
+    return headlessWindow.width;
+}
+
+int GetScreenHeight(void)
+{
+    return headlessWindow.height;
+}
+
+// Unlimited has no meaning without a clock, it runs at the default rate
+void SetTargetFPS(int fps)
+{
+    headlessWindow.targetFps = (fps > 0) ? fps : HEADLESS_DEFAULT_FPS;
+}
+
+float GetFrameTime(void)
+{
+    return 1.0f/headlessWindow.targetFps;
+}
+
+double GetTime(void)
+{
+    return (double)headlessWindow.frame/headlessWindow.targetFps;
+}
+
+int GetFPS(void)
+{
+    return headlessWindow.targetFps;
+}
+
+int GetRandomValue(int min, int max)
+{
+    if (min > max) std::swap(min, max);
+    uint32_t range = (uint32_t)((int64_t)max - min) + 1;
+    uint32_t value = XorShift(&randomState);
+    return (range == 0) ? (int)value : (int)(min + (int64_t)(value % range));
+}
+
+void SetRandomSeed(unsigned int seed)
+{
+    randomState = (seed != 0) ? seed : RANDOM_SEED;
+}
+
+void TraceLog(int level, const char *text, ...)
+{
+    if (level < logLevel) return;
+    static const char *prefixes[] = { "", "TRACE: ", "DEBUG: ", "INFO: ", "WARNING: ", "ERROR: ", "FATAL: ", "" };
+    printf("%s", prefixes[(level >= LOG_ALL && level <= LOG_NONE) ? level : LOG_INFO]);
+
+    va_list args;
+    va_start(args, text);
+    vprintf(text, args);
+    va_end(args);
+    printf("\n");
+    if (level == LOG_FATAL) exit(EXIT_FAILURE);
+}
+
+void SetTraceLogLevel(int level)
+{
+    logLevel = level;
+}
+
+const char *GetApplicationDirectory(void)
+{
+    static char directory[4096];
+    ssize_t length = readlink("/proc/self/exe", directory, sizeof(directory) - 1);
+    if (length <= 0)
+    {
+        strcpy(directory, "./");
+        return directory;
+    }
+    directory[length] = '\0';
+    char *slash = strrchr(directory, '/');
+    if (slash != nullptr) slash[1] = '\0';
+    return directory;
+}
+
+unsigned char *LoadFileData(const char *fileName, int *dataSize)
+{
+    *dataSize = 0;
+    FILE *file = fopen(fileName, "rb");
+    if (file == nullptr)
+    {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", fileName);
+        return nullptr;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *data = (size > 0) ? (unsigned char *)RL_MALLOC(size) : nullptr;
+    if (data != nullptr && fread(data, 1, size, file) == (size_t)size) *dataSize = (int)size;
+    else
+    {
+        RL_FREE(data);
+        data = nullptr;
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to read file", fileName);
+    }
+    fclose(file);
+    return data;
+}
+
+void UnloadFileData(unsigned char *data)
+{
+    RL_FREE(data);
+}
+
+bool FileExists(const char *fileName)
+{
+    return access(fileName, F_OK) == 0;
+}
+
+const char *GetFileExtension(const char *fileName)
+{
+    const char *dot = strrchr(fileName, '.');
+    return (dot == nullptr || dot == fileName) ? nullptr : dot;
+}
+
+//------------------------------------------------------------------------------------
+// Input, scripted
+//------------------------------------------------------------------------------------
+void HeadlessInputNextFrame(void)
+{
+    memcpy(input.previousKeys, input.keys, sizeof(input.keys));
+    input.previousMouseDown = input.mouseDown;
+    input.queueCount = 0;
+    input.queueRead = 0;
+    if (input.state == 0) return;
+
+    int frame = headlessWindow.frame + 1;
+    if (frame % INPUT_KEY_FRAMES == 0)
+    {
+        memset(input.keys, 0, sizeof(input.keys));
+        int key = SCRIPT_KEYS[XorShift(&input.state) % (sizeof(SCRIPT_KEYS)/sizeof(SCRIPT_KEYS[0]))];
+        if (key != KEY_NULL)
+        {
+            input.keys[key] = true;
+            if (!input.previousKeys[key]) input.queue[input.queueCount++] = key;
+        }
+    }
+
+    // A random walk inside the window, mostly with the button held
+    int stepX = (int)(XorShift(&input.state) % (2*INPUT_MOUSE_STEP + 1)) - INPUT_MOUSE_STEP;
+    int stepY = (int)(XorShift(&input.state) % (2*INPUT_MOUSE_STEP + 1)) - INPUT_MOUSE_STEP;
+    input.mouse.x = std::min(std::max(input.mouse.x + stepX, 0.0f), (float)(headlessWindow.width - 1));
+    input.mouse.y = std::min(std::max(input.mouse.y + stepY, 0.0f), (float)(headlessWindow.height - 1));
+    if (frame % INPUT_MOUSE_FRAMES == 0) input.mouseDown = (XorShift(&input.state) % 4) != 0;
+}
+
+bool IsKeyPressed(int key)
+{
+    return key > 0 && key < MAX_KEYS && input.keys[key] && !input.previousKeys[key];
+}
+
+bool IsKeyDown(int key)
+{
+    return key > 0 && key < MAX_KEYS && input.keys[key];
+}
+
+bool IsKeyReleased(int key)
+{
+    return key > 0 && key < MAX_KEYS && !input.keys[key] && input.previousKeys[key];
+}
+
+bool IsKeyUp(int key)
+{
+    return !IsKeyDown(key);
+}
+
+int GetKeyPressed(void)
+{
+    return (input.queueRead < input.queueCount) ? input.queue[input.queueRead++] : 0;
+}
+
+bool IsMouseButtonPressed(int button)
+{
+    return button == MOUSE_BUTTON_LEFT && input.mouseDown && !input.previousMouseDown;
+}
+
+bool IsMouseButtonDown(int button)
+{
+    return button == MOUSE_BUTTON_LEFT && input.mouseDown;
+}
+
+bool IsMouseButtonReleased(int button)
+{
+    return button == MOUSE_BUTTON_LEFT && !input.mouseDown && input.previousMouseDown;
+}
+
+Vector2 GetMousePosition(void)
+{
+    return input.mouse;
+}
+
+int GetMouseX(void)
+{
+    return (int)input.mouse.x;
+}
+
+int GetMouseY(void)
+{
+    return (int)input.mouse.y;
+}
+
+//------------------------------------------------------------------------------------
+// Audio, silent
+//------------------------------------------------------------------------------------
+void InitAudioDevice(void)
+{
+    TraceLog(LOG_INFO, "AUDIO: Headless build, no audio device");
+}
+
+void CloseAudioDevice(void)
+{
+}
+
+bool IsAudioDeviceReady(void)
+{
+    return false;
+}
+
+Wave LoadWave(const char *fileName)
+{
+    TraceLog(LOG_WARNING, "WAVE: [%s] Headless build does not decode audio", fileName);
+    return Wave{};
+}
+
+Wave LoadWaveFromMemory(const char *fileType, const unsigned char *fileData, int dataSize)
+{
+    (void)fileData;
+    (void)dataSize;
+    TraceLog(LOG_WARNING, "WAVE: [%s] Headless build does not decode audio", fileType);
+    return Wave{};
+}
+
+Wave WaveCopy(Wave wave)
+{
+    Wave copy = wave;
+    size_t size = (size_t)wave.frameCount*wave.channels*wave.sampleSize/8;
+    copy.data = (wave.data != nullptr && size > 0) ? RL_MALLOC(size) : nullptr;
+    if (copy.data != nullptr) memcpy(copy.data, wave.data, size);
+    else copy.frameCount = 0;
+    return copy;
+}
+
+// Through float: nearest-frame resampling, mono and stereo either way
+void WaveFormat(Wave *wave, int sampleRate, int sampleSize, int channels)
+{
+    if (wave->data == nullptr || wave->frameCount == 0 || channels < 1 ||
+        (sampleSize != 8 && sampleSize != 16 && sampleSize != 32)) return;
+
+    std::vector<float> samples((size_t)wave->frameCount*wave->channels);
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        if (wave->sampleSize == 8) samples[i] = (((unsigned char *)wave->data)[i] - 127)/127.0f;
+        else if (wave->sampleSize == 16) samples[i] = ((short *)wave->data)[i]/32767.0f;
+        else samples[i] = ((float *)wave->data)[i];
+    }
+
+    unsigned int frameCount = (unsigned int)((double)wave->frameCount*sampleRate/wave->sampleRate);
+    void *data = RL_MALLOC((size_t)frameCount*channels*sampleSize/8);
+    for (unsigned int frame = 0; frame < frameCount; frame++)
+    {
+        size_t from = std::min((size_t)((double)frame*wave->sampleRate/sampleRate), (size_t)wave->frameCount - 1);
+        for (int channel = 0; channel < channels; channel++)
+        {
+            float sample = samples[from*wave->channels + std::min((unsigned int)channel, wave->channels - 1)];
+            sample = std::min(std::max(sample, -1.0f), 1.0f);
+            size_t at = (size_t)frame*channels + channel;
+            if (sampleSize == 8) ((unsigned char *)data)[at] = (unsigned char)(sample*127.0f + 127.0f);
+            else if (sampleSize == 16) ((short *)data)[at] = (short)(sample*32767.0f);
+            else ((float *)data)[at] = sample;
+        }
+    }
+
+    RL_FREE(wave->data);
+    wave->data = data;
+    wave->frameCount = frameCount;
+    wave->sampleRate = sampleRate;
+    wave->sampleSize = sampleSize;
+    wave->channels = channels;
+}
+
+void UnloadWave(Wave wave)
+{
+    RL_FREE(wave.data);
+}
+
+Sound LoadSoundFromWave(Wave wave)
+{
+    Sound sound = {};
+    sound.frameCount = wave.frameCount;
+    return sound;
+}
+
+void UnloadSound(Sound sound)
+{
+    (void)sound;
+}
+
+void PlaySound(Sound sound)
+{
+    (void)sound;
+}
+
+void SetSoundVolume(Sound sound, float volume)
+{
+    (void)sound;
+    (void)volume;
+}
+
+Music LoadMusicStreamFromMemory(const char *fileType, const unsigned char *data, int dataSize)
+{
+    (void)data;
+    (void)dataSize;
+    TraceLog(LOG_WARNING, "STREAM: [%s] Headless build does not decode audio", fileType);
+    return Music{};
+}
+
+void UnloadMusicStream(Music music)
+{
+    (void)music;
+}
+
+void PlayMusicStream(Music music)
+{
+    (void)music;
+}
+
+void UpdateMusicStream(Music music)
+{
+    (void)music;
+}
+
+AudioStream LoadAudioStream(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels)
+{
+    AudioStream stream = {};
+    stream.sampleRate = sampleRate;
+    stream.sampleSize = sampleSize;
+    stream.channels = channels;
+    return stream;
+}
+
+void UnloadAudioStream(AudioStream stream)
+{
+    (void)stream;
+}
+
+void PlayAudioStream(AudioStream stream)
+{
+    (void)stream;
+}
+
+void StopAudioStream(AudioStream stream)
+{
+    (void)stream;
+}
+
+void SetAudioStreamBufferSizeDefault(int size)
+{
+    (void)size;
+}
+
+void SetAudioStreamCallback(AudioStream stream, AudioCallback callback)
+{
+    (void)stream;
+    (void)callback;
+}
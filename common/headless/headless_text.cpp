@@ -0,0 +1,232 @@
+// headless_text.cpp
+// Text for the headless raylib: a built-in 5x7 bitmap font stands in for both raylib's
+// default font and any TrueType font, laid out with raylib's own formulas
+#include "headless.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int FONT_FIRST = 32;
+constexpr int FONT_GLYPHS = 95;                 // ASCII 32 to 126
+constexpr int FONT_BASE_SIZE = 10;              // Like raylib's default font
+constexpr int GLYPH_WIDTH = 5;
+constexpr int GLYPH_TOP = 1;                    // Blank rows above the 7 glyph rows
+constexpr int ATLAS_COLUMNS = 16;
+constexpr int ATLAS_CELL_WIDTH = GLYPH_WIDTH + 1;
+constexpr int ATLAS_CELL_HEIGHT = FONT_BASE_SIZE + 1;
+constexpr int TEXT_FORMAT_BUFFERS = 4;          // Like raylib's MAX_TEXTFORMAT_BUFFERS
+constexpr int TEXT_FORMAT_LENGTH = 1024;
+
+// One byte per column, bit 0 is the top row
+static const unsigned char FONT_5X7[FONT_GLYPHS][GLYPH_WIDTH] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5f, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7f, 0x14, 0x7f, 0x14 },
+    { 0x24, 0x2a, 0x7f, 0x2a, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 },
+    { 0x00, 0x1c, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1c, 0x00 }, { 0x08, 0x2a, 0x1c, 0x2a, 0x08 }, { 0x08, 0x08, 0x3e, 0x08, 0x08 },
+    { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x60, 0x60, 0x00, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 },
+    { 0x3e, 0x51, 0x49, 0x45, 0x3e }, { 0x00, 0x42, 0x7f, 0x40, 0x00 }, { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4b, 0x31 },
+    { 0x18, 0x14, 0x12, 0x7f, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3c, 0x4a, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 },
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1e }, { 0x00, 0x36, 0x36, 0x00, 0x00 }, { 0x00, 0x56, 0x36, 0x00, 0x00 },
+    { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 },
+    { 0x32, 0x49, 0x79, 0x41, 0x3e }, { 0x7e, 0x11, 0x11, 0x11, 0x7e }, { 0x7f, 0x49, 0x49, 0x49, 0x36 }, { 0x3e, 0x41, 0x41, 0x41, 0x22 },
+    { 0x7f, 0x41, 0x41, 0x22, 0x1c }, { 0x7f, 0x49, 0x49, 0x49, 0x41 }, { 0x7f, 0x09, 0x09, 0x01, 0x01 }, { 0x3e, 0x41, 0x41, 0x51, 0x32 },
+    { 0x7f, 0x08, 0x08, 0x08, 0x7f }, { 0x00, 0x41, 0x7f, 0x41, 0x00 }, { 0x20, 0x40, 0x41, 0x3f, 0x01 }, { 0x7f, 0x08, 0x14, 0x22, 0x41 },
+    { 0x7f, 0x40, 0x40, 0x40, 0x40 }, { 0x7f, 0x02, 0x04, 0x02, 0x7f }, { 0x7f, 0x04, 0x08, 0x10, 0x7f }, { 0x3e, 0x41, 0x41, 0x41, 0x3e },
+    { 0x7f, 0x09, 0x09, 0x09, 0x06 }, { 0x3e, 0x41, 0x51, 0x21, 0x5e }, { 0x7f, 0x09, 0x19, 0x29, 0x46 }, { 0x46, 0x49, 0x49, 0x49, 0x31 },
+    { 0x01, 0x01, 0x7f, 0x01, 0x01 }, { 0x3f, 0x40, 0x40, 0x40, 0x3f }, { 0x1f, 0x20, 0x40, 0x20, 0x1f }, { 0x7f, 0x20, 0x18, 0x20, 0x7f },
+    { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x03, 0x04, 0x78, 0x04, 0x03 }, { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7f, 0x41, 0x41, 0x00 },
+    { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7f, 0x00 }, { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 },
+    { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 }, { 0x7f, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 },
+    { 0x38, 0x44, 0x44, 0x48, 0x7f }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x08, 0x7e, 0x09, 0x01, 0x02 }, { 0x08, 0x14, 0x54, 0x54, 0x3c },
+    { 0x7f, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7d, 0x40, 0x00 }, { 0x20, 0x40, 0x44, 0x3d, 0x00 }, { 0x00, 0x7f, 0x10, 0x28, 0x44 },
+    { 0x00, 0x41, 0x7f, 0x40, 0x00 }, { 0x7c, 0x04, 0x18, 0x04, 0x78 }, { 0x7c, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 },
+    { 0x7c, 0x14, 0x14, 0x14, 0x08 }, { 0x08, 0x14, 0x14, 0x18, 0x7c }, { 0x7c, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 },
+    { 0x04, 0x3f, 0x44, 0x40, 0x20 }, { 0x3c, 0x40, 0x40, 0x20, 0x7c }, { 0x1c, 0x20, 0x40, 0x20, 0x1c }, { 0x3c, 0x40, 0x30, 0x40, 0x3c },
+    { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0c, 0x50, 0x50, 0x50, 0x3c }, { 0x44, 0x64, 0x54, 0x4c, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 },
+    { 0x00, 0x00, 0x7f, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x08, 0x04, 0x08, 0x10, 0x08 }
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static Font defaultFont = {};
+static Rectangle defaultRecs[FONT_GLYPHS];
+static GlyphInfo defaultGlyphs[FONT_GLYPHS];
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// The atlas is built on first use, after InitWindow made the renderer
+static void LoadDefaultFont(void)
+{
+    int rows = (FONT_GLYPHS + ATLAS_COLUMNS - 1)/ATLAS_COLUMNS;
+    int width = ATLAS_COLUMNS*ATLAS_CELL_WIDTH, height = rows*ATLAS_CELL_HEIGHT;
+    std::vector<Color> pixels((size_t)width*height, { 255, 255, 255, 0 });
+
+    for (int glyph = 0; glyph < FONT_GLYPHS; glyph++)
+    {
+        int cellX = (glyph % ATLAS_COLUMNS)*ATLAS_CELL_WIDTH;
+        int cellY = (glyph/ATLAS_COLUMNS)*ATLAS_CELL_HEIGHT;
+        for (int x = 0; x < GLYPH_WIDTH; x++)
+        {
+            for (int y = 0; y < 7; y++)
+            {
+                if (FONT_5X7[glyph][x] & (1 << y)) pixels[(size_t)(cellY + GLYPH_TOP + y)*width + cellX + x].a = 255;
+            }
+        }
+        defaultRecs[glyph] = { (float)cellX, (float)cellY, (float)GLYPH_WIDTH, (float)FONT_BASE_SIZE };
+        defaultGlyphs[glyph] = { FONT_FIRST + glyph, 0, 0, 0, {} };
+    }
+
+    defaultFont.baseSize = FONT_BASE_SIZE;
+    defaultFont.glyphCount = FONT_GLYPHS;
+    defaultFont.glyphPadding = 0;
+    defaultFont.texture = { HeadlessTextureCreate(width, height, pixels.data()), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    defaultFont.recs = defaultRecs;
+    defaultFont.glyphs = defaultGlyphs;
+}
+
+// Bytes outside printable ASCII draw as '?'
+static int GlyphIndex(Font font, int codepoint)
+{
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        if (font.glyphs[i].value == codepoint) return i;
+    }
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        if (font.glyphs[i].value == '?') return i;
+    }
+    return 0;
+}
+
+static void DrawGlyph(Font font, int index, Vector2 position, float fontSize, Color tint)
+{
+    float scale = fontSize/font.baseSize;
+    const GlyphInfo &glyph = font.glyphs[index];
+    const Rectangle &rec = font.recs[index];
+    float padding = (float)font.glyphPadding;
+
+    Rectangle dest = { position.x + glyph.offsetX*scale - padding*scale, position.y + glyph.offsetY*scale - padding*scale,
+                       (rec.width + 2.0f*padding)*scale, (rec.height + 2.0f*padding)*scale };
+    Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding };
+    DrawTexturePro(font.texture, source, dest, { 0, 0 }, 0.0f, tint);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+Font GetFontDefault(void)
+{
+    if (defaultFont.texture.id == 0) LoadDefaultFont();
+    return defaultFont;
+}
+
+Font LoadFontEx(const char *fileName, int fontSize, int *codepoints, int codepointCount)
+{
+    (void)fontSize;
+    (void)codepoints;
+    (void)codepointCount;
+    TraceLog(LOG_WARNING, "FONT: [%s] Headless build draws the built-in bitmap font instead", fileName);
+    return GetFontDefault();
+}
+
+void UnloadFont(Font font)
+{
+    if (font.texture.id == 0 || font.texture.id == defaultFont.texture.id) return;
+    UnloadTexture(font.texture);
+    RL_FREE(font.recs);
+    for (int i = 0; i < font.glyphCount; i++) RL_FREE(font.glyphs[i].image.data);
+    RL_FREE(font.glyphs);
+}
+
+void DrawFPS(int posX, int posY)
+{
+    DrawText(TextFormat("%2i FPS", GetFPS()), posX, posY, 20, LIME);
+}
+
+void DrawText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (fontSize < FONT_BASE_SIZE) fontSize = FONT_BASE_SIZE;
+    int spacing = fontSize/FONT_BASE_SIZE;
+    DrawTextEx(GetFontDefault(), text, { (float)posX, (float)posY }, (float)fontSize, (float)spacing, color);
+}
+
+void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    if (font.texture.id == 0) font = GetFontDefault();
+    float scale = fontSize/font.baseSize;
+    float offsetX = 0.0f;
+    int offsetY = 0;
+
+    HeadlessShapeBegin();
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '\n')
+        {
+            offsetY += (int)((font.baseSize + font.baseSize/2)*scale);
+            offsetX = 0.0f;
+            continue;
+        }
+
+        int index = GlyphIndex(font, (unsigned char)*c);
+        if (*c != ' ' && *c != '\t') DrawGlyph(font, index, { position.x + offsetX, position.y + offsetY }, fontSize, tint);
+        float advance = (font.glyphs[index].advanceX == 0) ? font.recs[index].width : (float)font.glyphs[index].advanceX;
+        offsetX += advance*scale + spacing;
+    }
+    HeadlessShapeEnd();
+}
+
+int MeasureText(const char *text, int fontSize)
+{
+    if (fontSize < FONT_BASE_SIZE) fontSize = FONT_BASE_SIZE;
+    int spacing = fontSize/FONT_BASE_SIZE;
+    return (int)MeasureTextEx(GetFontDefault(), text, (float)fontSize, (float)spacing).x;
+}
+
+Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing)
+{
+    if (font.texture.id == 0) font = GetFontDefault();
+    float scale = fontSize/font.baseSize;
+    float width = 0.0f, widest = 0.0f, height = fontSize;
+    int letters = 0, mostLetters = 0;
+
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '\n')
+        {
+            if (width > widest) widest = width;
+            width = 0.0f;
+            letters = 0;
+            height += fontSize*1.5f;
+            continue;
+        }
+
+        int index = GlyphIndex(font, (unsigned char)*c);
+        letters++;
+        if (letters > mostLetters) mostLetters = letters;
+        if (font.glyphs[index].advanceX != 0) width += font.glyphs[index].advanceX;
+        else width += font.recs[index].width + font.glyphs[index].offsetX;
+    }
+    if (width > widest) widest = width;
+
+    if (mostLetters == 0) return { 0.0f, height };
+    return { widest*scale + (mostLetters - 1)*spacing, height };
+}
+
+const char *TextFormat(const char *text, ...)
+{
+    static char buffers[TEXT_FORMAT_BUFFERS][TEXT_FORMAT_LENGTH];
+    static int next = 0;
+
+    char *buffer = buffers[next];
+    next = (next + 1) % TEXT_FORMAT_BUFFERS;
+
+    va_list args;
+    va_start(args, text);
+    vsnprintf(buffer, TEXT_FORMAT_LENGTH, text, args);
+    va_end(args);
+    return buffer;
+}
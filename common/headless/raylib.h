@@ -0,0 +1,307 @@
+// raylib.h (headless)
+// The part of the raylib 5.0 API the games use, implemented by the software renderer
+// in this folder (RAYLIB_GAMES_HEADLESS_RENDER). Types, constants and signatures match
+// raylib, so the games build against either unchanged. See headless.h for how a run
+// is configured.
+#pragma once
+#include <cstdlib>
+
+#define RAYLIB_VERSION "5.0-headless"
+#define RAYLIB_HEADLESS
+
+#define CLITERAL(type) type
+
+#define RL_MALLOC(sz) malloc(sz)
+#define RL_CALLOC(n, sz) calloc(n, sz)
+#define RL_REALLOC(ptr, sz) realloc(ptr, sz)
+#define RL_FREE(ptr) free(ptr)
+
+//----------------------------------------------------------------------------------
+// Colors
+//----------------------------------------------------------------------------------
+#define LIGHTGRAY  CLITERAL(Color){ 200, 200, 200, 255 }
+#define GRAY       CLITERAL(Color){ 130, 130, 130, 255 }
+#define DARKGRAY   CLITERAL(Color){ 80, 80, 80, 255 }
+#define YELLOW     CLITERAL(Color){ 253, 249, 0, 255 }
+#define GOLD       CLITERAL(Color){ 255, 203, 0, 255 }
+#define ORANGE     CLITERAL(Color){ 255, 161, 0, 255 }
+#define PINK       CLITERAL(Color){ 255, 109, 194, 255 }
+#define RED        CLITERAL(Color){ 230, 41, 55, 255 }
+#define MAROON     CLITERAL(Color){ 190, 33, 55, 255 }
+#define GREEN      CLITERAL(Color){ 0, 228, 48, 255 }
+#define LIME       CLITERAL(Color){ 0, 158, 47, 255 }
+#define DARKGREEN  CLITERAL(Color){ 0, 117, 44, 255 }
+#define SKYBLUE    CLITERAL(Color){ 102, 191, 255, 255 }
+#define BLUE       CLITERAL(Color){ 0, 121, 241, 255 }
+#define DARKBLUE   CLITERAL(Color){ 0, 82, 172, 255 }
+#define PURPLE     CLITERAL(Color){ 200, 122, 255, 255 }
+#define VIOLET     CLITERAL(Color){ 135, 60, 190, 255 }
+#define DARKPURPLE CLITERAL(Color){ 112, 31, 126, 255 }
+#define BEIGE      CLITERAL(Color){ 211, 176, 131, 255 }
+#define BROWN      CLITERAL(Color){ 127, 106, 79, 255 }
+#define DARKBROWN  CLITERAL(Color){ 76, 63, 47, 255 }
+#define WHITE      CLITERAL(Color){ 255, 255, 255, 255 }
+#define BLACK      CLITERAL(Color){ 0, 0, 0, 255 }
+#define BLANK      CLITERAL(Color){ 0, 0, 0, 0 }
+#define MAGENTA    CLITERAL(Color){ 255, 0, 255, 255 }
+#define RAYWHITE   CLITERAL(Color){ 245, 245, 245, 255 }
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+#define RL_VECTOR2_TYPE
+
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+#define RL_COLOR_TYPE
+
+typedef struct Rectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+#define RL_RECTANGLE_TYPE
+
+typedef struct Image {
+    void *data;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Image;
+
+typedef struct Texture {
+    unsigned int id;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Texture;
+typedef Texture Texture2D;
+
+typedef struct GlyphInfo {
+    int value;
+    int offsetX;
+    int offsetY;
+    int advanceX;
+    Image image;
+} GlyphInfo;
+
+typedef struct Font {
+    int baseSize;
+    int glyphCount;
+    int glyphPadding;
+    Texture2D texture;
+    Rectangle *recs;
+    GlyphInfo *glyphs;
+} Font;
+
+typedef struct Camera2D {
+    Vector2 offset;
+    Vector2 target;
+    float rotation;
+    float zoom;
+} Camera2D;
+
+typedef struct Wave {
+    unsigned int frameCount;
+    unsigned int sampleRate;
+    unsigned int sampleSize;
+    unsigned int channels;
+    void *data;
+} Wave;
+
+typedef struct rAudioBuffer rAudioBuffer;
+typedef struct rAudioProcessor rAudioProcessor;
+
+typedef struct AudioStream {
+    rAudioBuffer *buffer;
+    rAudioProcessor *processor;
+    unsigned int sampleRate;
+    unsigned int sampleSize;
+    unsigned int channels;
+} AudioStream;
+
+typedef struct Sound {
+    AudioStream stream;
+    unsigned int frameCount;
+} Sound;
+
+typedef struct Music {
+    AudioStream stream;
+    unsigned int frameCount;
+    bool looping;
+    int ctxType;
+    void *ctxData;
+} Music;
+
+typedef void (*AudioCallback)(void *bufferData, unsigned int frames);
+
+//----------------------------------------------------------------------------------
+// Enumerators Definition
+//----------------------------------------------------------------------------------
+typedef enum {
+    FLAG_VSYNC_HINT = 0x00000040,
+    FLAG_FULLSCREEN_MODE = 0x00000002,
+    FLAG_WINDOW_RESIZABLE = 0x00000004,
+    FLAG_WINDOW_HIDDEN = 0x00000080,
+    FLAG_MSAA_4X_HINT = 0x00000020
+} ConfigFlags;
+
+typedef enum {
+    LOG_ALL = 0,
+    LOG_TRACE,
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR,
+    LOG_FATAL,
+    LOG_NONE
+} TraceLogLevel;
+
+typedef enum {
+    KEY_NULL = 0,
+    KEY_APOSTROPHE = 39, KEY_COMMA = 44, KEY_MINUS = 45, KEY_PERIOD = 46, KEY_SLASH = 47,
+    KEY_ZERO = 48, KEY_ONE, KEY_TWO, KEY_THREE, KEY_FOUR, KEY_FIVE, KEY_SIX, KEY_SEVEN, KEY_EIGHT, KEY_NINE,
+    KEY_SEMICOLON = 59, KEY_EQUAL = 61,
+    KEY_A = 65, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M,
+    KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
+    KEY_SPACE = 32,
+    KEY_ESCAPE = 256, KEY_ENTER, KEY_TAB, KEY_BACKSPACE, KEY_INSERT, KEY_DELETE,
+    KEY_RIGHT = 262, KEY_LEFT, KEY_DOWN, KEY_UP,
+    KEY_F1 = 290, KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6, KEY_F7, KEY_F8, KEY_F9, KEY_F10, KEY_F11, KEY_F12,
+    KEY_LEFT_SHIFT = 340, KEY_LEFT_CONTROL, KEY_LEFT_ALT
+} KeyboardKey;
+
+typedef enum {
+    MOUSE_BUTTON_LEFT = 0,
+    MOUSE_BUTTON_RIGHT = 1,
+    MOUSE_BUTTON_MIDDLE = 2
+} MouseButton;
+#define MOUSE_LEFT_BUTTON   MOUSE_BUTTON_LEFT
+#define MOUSE_RIGHT_BUTTON  MOUSE_BUTTON_RIGHT
+#define MOUSE_MIDDLE_BUTTON MOUSE_BUTTON_MIDDLE
+
+typedef enum {
+    PIXELFORMAT_UNCOMPRESSED_GRAYSCALE = 1,
+    PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA,
+    PIXELFORMAT_UNCOMPRESSED_R5G6B5,
+    PIXELFORMAT_UNCOMPRESSED_R8G8B8,
+    PIXELFORMAT_UNCOMPRESSED_R5G5B5A1,
+    PIXELFORMAT_UNCOMPRESSED_R4G4B4A4,
+    PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+} PixelFormat;
+
+//------------------------------------------------------------------------------------
+// Window and timing (headless_raylib.cpp)
+//------------------------------------------------------------------------------------
+void InitWindow(int width, int height, const char *title);
+void CloseWindow(void);
+bool WindowShouldClose(void);
+bool IsWindowReady(void);
+void SetConfigFlags(unsigned int flags);
+int GetScreenWidth(void);
+int GetScreenHeight(void);
+void SetTargetFPS(int fps);
+float GetFrameTime(void);
+double GetTime(void);
+int GetFPS(void);
+int GetRandomValue(int min, int max);
+void SetRandomSeed(unsigned int seed);
+void TraceLog(int logLevel, const char *text, ...);
+void SetTraceLogLevel(int logLevel);
+const char *GetApplicationDirectory(void);
+unsigned char *LoadFileData(const char *fileName, int *dataSize);
+void UnloadFileData(unsigned char *data);
+bool FileExists(const char *fileName);
+const char *GetFileExtension(const char *fileName);
+
+//------------------------------------------------------------------------------------
+// Input, scripted (headless_raylib.cpp)
+//------------------------------------------------------------------------------------
+bool IsKeyPressed(int key);
+bool IsKeyDown(int key);
+bool IsKeyReleased(int key);
+bool IsKeyUp(int key);
+int GetKeyPressed(void);
+bool IsMouseButtonPressed(int button);
+bool IsMouseButtonDown(int button);
+bool IsMouseButtonReleased(int button);
+Vector2 GetMousePosition(void);
+int GetMouseX(void);
+int GetMouseY(void);
+
+//------------------------------------------------------------------------------------
+// Drawing (headless_raster.cpp)
+//------------------------------------------------------------------------------------
+void ClearBackground(Color color);
+void BeginDrawing(void);
+void EndDrawing(void);
+void BeginMode2D(Camera2D camera);
+void EndMode2D(void);
+
+void DrawPixel(int posX, int posY, Color color);
+void DrawLine(int startPosX, int startPosY, int endPosX, int endPosY, Color color);
+void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+void DrawRectangle(int posX, int posY, int width, int height, Color color);
+void DrawRectangleV(Vector2 position, Vector2 size, Color color);
+void DrawRectangleRec(Rectangle rec, Color color);
+void DrawRectangleRounded(Rectangle rec, float roundness, int segments, Color color);
+void DrawRectangleLines(int posX, int posY, int width, int height, Color color);
+void DrawCircle(int centerX, int centerY, float radius, Color color);
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2);
+Color Fade(Color color, float alpha);
+
+Texture2D LoadTextureFromImage(Image image);
+void UnloadTexture(Texture2D texture);
+void DrawTexture(Texture2D texture, int posX, int posY, Color tint);
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+
+//------------------------------------------------------------------------------------
+// Text, with a built-in bitmap font (headless_text.cpp)
+//------------------------------------------------------------------------------------
+Font GetFontDefault(void);
+// No TrueType rasterizer headless: logs a warning and returns the default font
+Font LoadFontEx(const char *fileName, int fontSize, int *codepoints, int codepointCount);
+void UnloadFont(Font font);
+void DrawFPS(int posX, int posY);
+void DrawText(const char *text, int posX, int posY, int fontSize, Color color);
+void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint);
+int MeasureText(const char *text, int fontSize);
+Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing);
+const char *TextFormat(const char *text, ...);
+
+//------------------------------------------------------------------------------------
+// Audio, silent: nothing is decoded and no device opens (headless_raylib.cpp)
+//------------------------------------------------------------------------------------
+void InitAudioDevice(void);
+void CloseAudioDevice(void);
+bool IsAudioDeviceReady(void);
+Wave LoadWave(const char *fileName);
+Wave LoadWaveFromMemory(const char *fileType, const unsigned char *fileData, int dataSize);
+Wave WaveCopy(Wave wave);
+void WaveFormat(Wave *wave, int sampleRate, int sampleSize, int channels);
+void UnloadWave(Wave wave);
+Sound LoadSoundFromWave(Wave wave);
+void UnloadSound(Sound sound);
+void PlaySound(Sound sound);
+void SetSoundVolume(Sound sound, float volume);
+Music LoadMusicStreamFromMemory(const char *fileType, const unsigned char *data, int dataSize);
+void UnloadMusicStream(Music music);
+void PlayMusicStream(Music music);
+void UpdateMusicStream(Music music);
+AudioStream LoadAudioStream(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels);
+void UnloadAudioStream(AudioStream stream);
+void PlayAudioStream(AudioStream stream);
+void StopAudioStream(AudioStream stream);
+void SetAudioStreamBufferSizeDefault(int size);
+void SetAudioStreamCallback(AudioStream stream, AudioCallback callback);
@@ -0,0 +1,18 @@
+// rlgl.h (headless)
+// The immediate-mode part of rlgl that sprite_batch_rlgl.cpp uses, drawn by the
+// software renderer (headless_raster.cpp)
+#pragma once
+
+#define RL_LINES     0x0001
+#define RL_TRIANGLES 0x0004
+#define RL_QUADS     0x0007
+
+void rlBegin(int mode);
+void rlEnd(void);
+void rlVertex2f(float x, float y);
+void rlTexCoord2f(float x, float y);
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+void rlSetTexture(unsigned int id);
+unsigned int rlGetTextureIdDefault(void);
+bool rlCheckRenderBatchLimit(int vCount);
+void rlDrawRenderBatchActive(void);
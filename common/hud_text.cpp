@@ -0,0 +1,107 @@
+// hud_text.cpp
+#include "hud_text.h"
+#include <cstdio>
+#include <cstring>
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static const HudGlyph &Glyph(const HudFont *font, unsigned char c)
+{
+    if (c >= HUD_FONT_FIRST && c < HUD_FONT_FIRST + HUD_FONT_GLYPHS) return font->glyphs[c - HUD_FONT_FIRST];
+    return font->fallback;
+}
+
+// DrawTextEx's pen walk and MeasureTextEx's width in one pass, with the operations in
+// raylib's order so the results match it exactly
+static void Layout(HudText *hud)
+{
+    const HudFont *font = hud->font;
+    float scale = hud->fontSize/font->baseSize;
+    float padding = font->padding;
+    float textureWidth = (float)font->textureWidth, textureHeight = (float)font->textureHeight;
+    float penX = 0.0f, width = 0.0f;
+    int letters = 0;
+
+    hud->quadCount = 0;
+    for (const char *c = hud->text; *c != '\0'; c++)
+    {
+        const HudGlyph &glyph = Glyph(font, (unsigned char)*c);
+        if (*c != ' ' && *c != '\t')
+        {
+            float sourceX = glyph.x - padding, sourceY = glyph.y - padding;
+            float sourceWidth = glyph.width + 2.0f*padding, sourceHeight = glyph.height + 2.0f*padding;
+            HudQuad &quad = hud->quads[hud->quadCount++];
+            quad.penX = penX;
+            quad.offsetX = glyph.offsetX*scale;
+            quad.offsetY = glyph.offsetY*scale;
+            quad.width = sourceWidth*scale;
+            quad.height = sourceHeight*scale;
+            quad.u0 = sourceX/textureWidth;
+            quad.v0 = sourceY/textureHeight;
+            quad.u1 = (sourceX + sourceWidth)/textureWidth;
+            quad.v1 = (sourceY + sourceHeight)/textureHeight;
+        }
+
+        float advance = (glyph.advanceX == 0.0f) ? glyph.width : glyph.advanceX;
+        penX += advance*scale + hud->spacing;
+        if (glyph.advanceX != 0.0f) width += glyph.advanceX;
+        else width += glyph.width + glyph.offsetX;
+        letters++;
+    }
+
+    hud->padding = padding*scale;
+    hud->width = (letters == 0) ? 0.0f : width*scale + (letters - 1)*hud->spacing;
+    hud->height = hud->fontSize;
+    hud->layouts++;
+}
+
+static bool SameStyle(const HudText *hud, const HudFont *font, float fontSize, float spacing)
+{
+    return hud->font == font && hud->fontSize == fontSize && hud->spacing == spacing;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+bool HudTextSet(HudText *hud, const HudFont *font, const char *text, float fontSize, float spacing)
+{
+    hud->format = nullptr;
+    if (hud->layouts > 0 && SameStyle(hud, font, fontSize, spacing) && strncmp(hud->text, text, HUD_TEXT_LENGTH - 1) == 0) return false;
+
+    hud->font = font;
+    hud->fontSize = fontSize;
+    hud->spacing = spacing;
+    strncpy(hud->text, text, HUD_TEXT_LENGTH - 1);
+    hud->text[HUD_TEXT_LENGTH - 1] = '\0';
+    Layout(hud);
+    return true;
+}
+
+bool HudTextSetInt(HudText *hud, const HudFont *font, const char *format, int value, float fontSize, float spacing)
+{
+    if (hud->layouts > 0 && hud->format == format && hud->value == value && SameStyle(hud, font, fontSize, spacing)) return false;
+
+    hud->font = font;
+    hud->fontSize = fontSize;
+    hud->spacing = spacing;
+    hud->format = format;
+    hud->value = value;
+    snprintf(hud->text, HUD_TEXT_LENGTH, format, value);
+    Layout(hud);
+    return true;
+}
+
+void HudTextDraw(SpriteBatch *batch, const HudText *hud, float x, float y, Color tint, int layer)
+{
+    if (hud->font == nullptr) return;
+
+    unsigned int texture = hud->font->texture;
+    for (int i = 0; i < hud->quadCount; i++)
+    {
+        const HudQuad &quad = hud->quads[i];
+        SpriteBatchTexture(batch, texture, quad.u0, quad.v0, quad.u1, quad.v1,
+                           (x + quad.penX) + quad.offsetX - hud->padding, y + quad.offsetY - hud->padding,
+                           quad.width, quad.height, tint, layer);
+    }
+}
@@ -0,0 +1,91 @@
+// hud_text.h
+#pragma once
+#include "sprite_batch.h"
+
+//----------------------------------------------------------------------------------
+// Cached HUD strings. A HudText keeps the glyph quads of the last string it was given
+// and lays them out again only when that string (or, for HudTextSetInt, the value)
+// changes; drawing then just places the quads into a SpriteBatch, so every HUD line of
+// a frame goes out in one flush. Layout follows raylib's DrawTextEx and MeasureTextEx
+// float for float, so the quads land on the same pixels. One line of ASCII; other
+// bytes draw as the font's fallback glyph. No raylib here, hud_text_raylib.cpp turns a
+// raylib Font into a HudFont.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int HUD_FONT_FIRST = 32;
+constexpr int HUD_FONT_GLYPHS = 95;            // ASCII 32 to 126
+constexpr int HUD_TEXT_LENGTH = 64;            // Bytes kept by a HudText, longer text is cut
+constexpr int HUD_DEFAULT_FONT_SIZE = 10;      // raylib's default font, see HudDefaultSize
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// A glyph's GlyphInfo metrics and atlas rectangle, in font pixels
+struct HudGlyph {
+    float offsetX, offsetY;
+    float advanceX;                    // 0 to advance by the rectangle width
+    float x, y, width, height;
+};
+
+struct HudFont {
+    unsigned int texture;
+    int textureWidth;
+    int textureHeight;
+    float baseSize;
+    float padding;                     // Font glyphPadding
+    HudGlyph glyphs[HUD_FONT_GLYPHS];
+    HudGlyph fallback;                 // Any byte outside the table, raylib's '?'
+};
+
+// One drawn glyph, relative to the text position
+struct HudQuad {
+    float penX;                        // Pen position, the glyph offsets apply from there
+    float offsetX, offsetY;            // Scaled glyph offsets
+    float width, height;
+    float u0, v0, u1, v1;
+};
+
+struct HudText {
+    const HudFont *font = nullptr;
+    char text[HUD_TEXT_LENGTH] = {};
+    float fontSize = 0.0f;
+    float spacing = 0.0f;
+
+    // Last HudTextSetInt call, so an unchanged value is not even formatted
+    const char *format = nullptr;
+    int value = 0;
+
+    HudQuad quads[HUD_TEXT_LENGTH];
+    int quadCount = 0;                 // Spaces and tabs take no quad
+    float padding = 0.0f;              // Scaled font padding
+    float width = 0.0f;                // What MeasureTextEx gives for the text
+    float height = 0.0f;
+    int layouts = 0;                   // Times the text was laid out
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Keeps text at fontSize and spacing (DrawTextEx arguments) and lays it out when any
+// of them or the font differ from the last call. Returns whether it laid out.
+bool HudTextSet(HudText *hud, const HudFont *font, const char *text, float fontSize, float spacing);
+// Same for a printf format with one int, formatted only when value or format change
+bool HudTextSetInt(HudText *hud, const HudFont *font, const char *format, int value, float fontSize, float spacing);
+
+// Adds the quads with (x, y) as DrawTextEx's position
+void HudTextDraw(SpriteBatch *batch, const HudText *hud, float x, float y, Color tint, int layer);
+
+// DrawText's rules for raylib's default font: sizes under 10 grow to 10, spacing is a
+// tenth of the size
+inline float HudDefaultSize(int fontSize)
+{
+    return (float)((fontSize < HUD_DEFAULT_FONT_SIZE) ? HUD_DEFAULT_FONT_SIZE : fontSize);
+}
+
+inline float HudDefaultSpacing(int fontSize)
+{
+    return (float)(((fontSize < HUD_DEFAULT_FONT_SIZE) ? HUD_DEFAULT_FONT_SIZE : fontSize)/HUD_DEFAULT_FONT_SIZE);
+}
@@ -0,0 +1,42 @@
+// hud_text_raylib.cpp
+// HudFont from a raylib Font, the only part of the HUD text that needs raylib
+#include "raylib.h"
+#include "hud_text_raylib.h"
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// GetGlyphIndex: the glyph of codepoint, else '?', else the first one
+static int GlyphIndex(Font font, int codepoint)
+{
+    int fallback = 0;
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        if (font.glyphs[i].value == codepoint) return i;
+        if (font.glyphs[i].value == '?') fallback = i;
+    }
+    return fallback;
+}
+
+static HudGlyph MakeGlyph(Font font, int index)
+{
+    const GlyphInfo &glyph = font.glyphs[index];
+    const Rectangle &rec = font.recs[index];
+    return { (float)glyph.offsetX, (float)glyph.offsetY, (float)glyph.advanceX, rec.x, rec.y, rec.width, rec.height };
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void HudFontFromRaylib(HudFont *hud, Font font)
+{
+    if (font.texture.id == 0) font = GetFontDefault();
+
+    hud->texture = font.texture.id;
+    hud->textureWidth = font.texture.width;
+    hud->textureHeight = font.texture.height;
+    hud->baseSize = (float)font.baseSize;
+    hud->padding = (float)font.glyphPadding;
+    for (int i = 0; i < HUD_FONT_GLYPHS; i++) hud->glyphs[i] = MakeGlyph(font, GlyphIndex(font, HUD_FONT_FIRST + i));
+    hud->fallback = MakeGlyph(font, GlyphIndex(font, '?'));
+}
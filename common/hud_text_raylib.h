@@ -0,0 +1,13 @@
+// hud_text_raylib.h
+// HudFont from a raylib Font
+#pragma once
+#include "raylib.h"
+#include "hud_text.h"
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Copies the metrics of font's ASCII glyphs, looked up like DrawTextEx does; a font
+// without a texture stands for raylib's default one, as in DrawTextEx. The font must
+// stay loaded while its HudFont draws.
+void HudFontFromRaylib(HudFont *hud, Font font);
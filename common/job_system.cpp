@@ -0,0 +1,321 @@
+// job_system.cpp
+#include "job_system.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+// Deque of the worker thread running this code, null on threads outside any system
+static thread_local JobWorker *currentWorker = nullptr;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static inline void CpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+static inline uint64_t PackRange(int begin, int end)
+{
+    return (uint64_t)(uint32_t)begin | ((uint64_t)(uint32_t)end << 32);
+}
+
+// The deque the calling thread pushes to: its own on a worker, deque 0 from outside
+static JobWorker *Owner(JobSystem *system)
+{
+    JobWorker *worker = currentWorker;
+    return (worker != nullptr && worker->system == system) ? worker : &system->workers[0];
+}
+
+static void WakeOne(JobSystem *system)
+{
+    if (system->sleepers.load(std::memory_order_seq_cst) == 0) return;
+    {
+        std::lock_guard<std::mutex> guard(system->lock);
+        system->wakeups++;
+    }
+    system->wake.notify_one();
+}
+
+// Owner only. The seq_cst store of bottom orders the push before the sleepers check
+// in WakeOne, against a worker announcing itself asleep and then looking for work.
+static bool Push(JobWorker *worker, JobTask *task, int begin, int end)
+{
+    int64_t bottom = worker->bottom.load(std::memory_order_relaxed);
+    int64_t top = worker->top.load(std::memory_order_acquire);
+    if (bottom - top >= JOB_DEQUE_SIZE) return false;
+
+    JobSlot &slot = worker->slots[bottom & (JOB_DEQUE_SIZE - 1)];
+    slot.task.store(task, std::memory_order_relaxed);
+    slot.range.store(PackRange(begin, end), std::memory_order_relaxed);
+    worker->bottom.store(bottom + 1, std::memory_order_seq_cst);
+    WakeOne(worker->system);
+    return true;
+}
+
+// Owner only, newest job first. Taking the last job races the thieves for top.
+static bool Pop(JobWorker *worker, JobTask **task, uint64_t *range)
+{
+    int64_t bottom = worker->bottom.load(std::memory_order_relaxed) - 1;
+    worker->bottom.store(bottom, std::memory_order_seq_cst);
+    int64_t top = worker->top.load(std::memory_order_seq_cst);
+    if (top > bottom)
+    {
+        worker->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    JobSlot &slot = worker->slots[bottom & (JOB_DEQUE_SIZE - 1)];
+    *task = slot.task.load(std::memory_order_relaxed);
+    *range = slot.range.load(std::memory_order_relaxed);
+    if (top < bottom) return true;
+
+    bool won = worker->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    worker->bottom.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+}
+
+// Any thread, oldest job first
+static bool Steal(JobWorker *victim, JobTask **task, uint64_t *range)
+{
+    int64_t top = victim->top.load(std::memory_order_seq_cst);
+    int64_t bottom = victim->bottom.load(std::memory_order_seq_cst);
+    if (top >= bottom) return false;
+
+    JobSlot &slot = victim->slots[top & (JOB_DEQUE_SIZE - 1)];
+    *task = slot.task.load(std::memory_order_relaxed);
+    *range = slot.range.load(std::memory_order_relaxed);
+    return victim->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+static void RunPiece(JobWorker *worker, JobTask *task, int begin, int end);
+
+static void FinishTask(JobWorker *worker, JobTask *task);
+
+// A task whose dependencies are met: its whole range as one job
+static void QueueTask(JobWorker *worker, JobTask *task)
+{
+    if (task->begin >= task->end) FinishTask(worker, task);
+    else if (!Push(worker, task, task->begin, task->end)) RunPiece(worker, task, task->begin, task->end);
+}
+
+// The last piece of a task is done: release its successors, then count it off. The
+// waiter may reuse the task once the counter drops, so nothing reads it afterwards.
+static void FinishTask(JobWorker *worker, JobTask *task)
+{
+    for (int i = 0; i < task->successorCount; i++)
+    {
+        JobTask *next = task->successors[i];
+        if (next->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) QueueTask(worker, next);
+    }
+    task->counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+// Hands the upper halves of the piece to the deque until it is down to the grain,
+// then runs it. A full deque runs the rest in one call.
+static void RunPiece(JobWorker *worker, JobTask *task, int begin, int end)
+{
+    while (end - begin > task->grain)
+    {
+        int middle = begin + (end - begin)/2;
+        task->pieces.fetch_add(1, std::memory_order_relaxed);
+        if (!Push(worker, task, middle, end))
+        {
+            task->pieces.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        end = middle;
+    }
+
+    task->func(task->user, begin, end);
+    worker->jobsRun.store(worker->jobsRun.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (task->pieces.fetch_sub(1, std::memory_order_acq_rel) == 1) FinishTask(worker, task);
+}
+
+// Own deque first, then the others from a random one on
+static bool RunOne(JobWorker *worker)
+{
+    JobTask *task;
+    uint64_t range;
+    bool found = Pop(worker, &task, &range);
+
+    JobSystem *system = worker->system;
+    if (!found && system->workerCount > 1)
+    {
+        worker->random ^= worker->random << 13;
+        worker->random ^= worker->random >> 17;
+        worker->random ^= worker->random << 5;
+        int first = (int)(worker->random % (uint32_t)system->workerCount);
+        for (int i = 0; i < system->workerCount && !found; i++)
+        {
+            JobWorker *victim = &system->workers[(first + i) % system->workerCount];
+            if (victim != worker && Steal(victim, &task, &range))
+            {
+                found = true;
+                worker->steals.store(worker->steals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+    }
+    if (!found) return false;
+
+    RunPiece(worker, task, (int)(uint32_t)range, (int)(uint32_t)(range >> 32));
+    return true;
+}
+
+static bool AnyWork(JobSystem *system)
+{
+    for (int i = 0; i < system->workerCount; i++)
+    {
+        const JobWorker &worker = system->workers[i];
+        if (worker.top.load(std::memory_order_seq_cst) < worker.bottom.load(std::memory_order_seq_cst)) return true;
+    }
+    return false;
+}
+
+static void WorkerLoop(JobWorker *worker)
+{
+    currentWorker = worker;
+    JobSystem *system = worker->system;
+    int idle = 0;
+
+    while (true)
+    {
+        if (RunOne(worker))
+        {
+            idle = 0;
+            continue;
+        }
+        if (++idle < JOB_SPIN_ROUNDS)
+        {
+            CpuRelax();
+            continue;
+        }
+        idle = 0;
+
+        // Announce the sleep, then look once more: a push either sees the sleeper and
+        // wakes it, or happened before the look and is found by it
+        std::unique_lock<std::mutex> guard(system->lock);
+        if (system->quit) break;
+        uint64_t seen = system->wakeups;
+        system->sleepers.fetch_add(1, std::memory_order_seq_cst);
+        guard.unlock();
+        bool work = AnyWork(system);
+        guard.lock();
+        if (!work) system->wake.wait(guard, [&]{ return system->quit || system->wakeups != seen; });
+        system->sleepers.fetch_sub(1, std::memory_order_relaxed);
+        if (system->quit) break;
+    }
+
+    currentWorker = nullptr;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void JobSystemInit(JobSystem *system, int threads)
+{
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, JOB_MAX_WORKERS));
+
+    system->workerCount = threads;
+    system->workers.reset(new JobWorker[threads]);
+    system->quit = false;
+    for (int i = 0; i < threads; i++)
+    {
+        system->workers[i].system = system;
+        system->workers[i].index = i;
+        system->workers[i].random = 0x9e3779b9u*(uint32_t)(i + 1);
+    }
+    for (int i = 1; i < threads; i++) system->threads.emplace_back(WorkerLoop, &system->workers[i]);
+}
+
+void JobSystemShutdown(JobSystem *system)
+{
+    {
+        std::lock_guard<std::mutex> guard(system->lock);
+        system->quit = true;
+    }
+    system->wake.notify_all();
+    for (std::thread &thread : system->threads) thread.join();
+    system->threads.clear();
+    system->workers.reset();
+    system->workerCount = 0;
+}
+
+void JobTaskInit(JobTask *task, JobFunc func, void *user, int begin, int end, int grain)
+{
+    task->func = func;
+    task->user = user;
+    task->begin = begin;
+    task->end = end;
+    task->grain = std::max(1, grain);
+    task->successorCount = 0;
+    task->dependencyCount = 0;
+}
+
+bool JobTaskDepends(JobTask *task, JobTask *on)
+{
+    if (on->successorCount == JOB_MAX_SUCCESSORS) return false;
+    on->successors[on->successorCount++] = task;
+    task->dependencyCount++;
+    return true;
+}
+
+void JobSystemRun(JobSystem *system, JobTask *tasks, int count, JobCounter *counter)
+{
+    if (count <= 0) return;
+
+    // Every task is armed before any is queued, since a finished one arms nothing
+    counter->pending.fetch_add(count, std::memory_order_relaxed);
+    for (int i = 0; i < count; i++)
+    {
+        tasks[i].counter = counter;
+        tasks[i].dependencies.store(tasks[i].dependencyCount, std::memory_order_relaxed);
+        tasks[i].pieces.store(1, std::memory_order_relaxed);
+    }
+
+    JobWorker *worker = Owner(system);
+    for (int i = 0; i < count; i++)
+    {
+        if (tasks[i].dependencyCount == 0) QueueTask(worker, &tasks[i]);
+    }
+}
+
+void JobSystemWait(JobSystem *system, JobCounter *counter)
+{
+    JobWorker *worker = Owner(system);
+    int idle = 0;
+    while (counter->pending.load(std::memory_order_acquire) != 0)
+    {
+        if (RunOne(worker)) idle = 0;
+        else if (++idle < JOB_SPIN_ROUNDS) CpuRelax();
+        else std::this_thread::yield();
+    }
+}
+
+bool JobCounterDone(const JobCounter *counter)
+{
+    return counter->pending.load(std::memory_order_acquire) == 0;
+}
+
+void JobParallelFor(JobSystem *system, int count, int grain, JobFunc func, void *user)
+{
+    if (count <= 0) return;
+    // Nothing to share it with
+    if (system->workerCount == 1 || count <= grain)
+    {
+        func(user, 0, count);
+        return;
+    }
+
+    JobTask task;
+    JobTaskInit(&task, func, user, 0, count, grain);
+    JobCounter counter;
+    JobSystemRun(system, &task, 1, &counter);
+    JobSystemWait(system, &counter);
+}
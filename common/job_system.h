@@ -0,0 +1,126 @@
+// job_system.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Work-stealing job system shared by the games' parallel loops. Every worker owns a
+// deque: it pushes and pops jobs at the bottom, idle workers steal from the top of
+// the others'. A job is a piece [begin, end) of a task's range; a piece longer than
+// the task's grain pushes its upper half and carries on with the lower one, so a
+// parallel for only splits as far as idle workers take the halves.
+//
+// Tasks can wait on other tasks (JobTaskDepends): each counts its unfinished
+// predecessors and is queued when that reaches zero, which is how a frame's jobs form
+// a graph. A JobCounter counts the tasks of a run still unfinished; waiting on it runs
+// jobs meanwhile instead of blocking.
+//
+// Deque 0 belongs to the thread driving the system: work is started by one thread at
+// a time from outside the jobs (the game loop), and by the jobs themselves. Tasks and
+// counters belong to the caller and must stay put until the counter is done. Queuing
+// and running jobs allocates nothing.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int JOB_MAX_WORKERS = 64;
+constexpr int JOB_DEQUE_SIZE = 1024;           // Jobs per worker, a power of two; a full deque runs a piece whole
+constexpr int JOB_MAX_SUCCESSORS = 8;          // Tasks waiting on one task
+constexpr int JOB_SPIN_ROUNDS = 64;            // Empty steal rounds before an idle worker sleeps
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Runs items [begin, end) of a task
+typedef void (*JobFunc)(void *user, int begin, int end);
+
+// Tasks of a run still unfinished
+struct JobCounter {
+    std::atomic<int> pending{0};
+};
+
+struct JobTask {
+    JobFunc func = nullptr;
+    void *user = nullptr;
+    int begin = 0;
+    int end = 0;
+    int grain = 1;                     // Pieces of up to this many items are not split
+
+    // Graph, set up with JobTaskDepends
+    JobTask *successors[JOB_MAX_SUCCESSORS];
+    int successorCount = 0;
+    int dependencyCount = 0;
+
+    // Set by JobSystemRun
+    std::atomic<int> dependencies{0};  // Predecessors not finished yet
+    std::atomic<int> pieces{0};        // Pieces queued or running
+    JobCounter *counter = nullptr;
+};
+
+// A deque slot; its fields are atomics because a thief may read a slot the owner is
+// overwriting, in which case the thief's claim on top fails and the value is dropped
+struct JobSlot {
+    std::atomic<JobTask *> task{nullptr};
+    std::atomic<uint64_t> range{0};    // begin in the low half, end in the high half
+};
+
+// Chase-Lev deque: the owner works at bottom, thieves take from top. Padded rather
+// than aligned, since C++14 new[] ignores extended alignment.
+struct JobWorker {
+    std::atomic<int64_t> top{0};
+    char topPad[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom{0};
+    char bottomPad[64 - sizeof(std::atomic<int64_t>)];
+    JobSlot slots[JOB_DEQUE_SIZE];
+    struct JobSystem *system = nullptr;
+    int index = 0;
+    uint32_t random = 0;               // Victim order, owner only
+
+    // Counters, written by the owner
+    std::atomic<uint64_t> jobsRun{0};
+    std::atomic<uint64_t> steals{0};
+};
+
+struct JobSystem {
+    int workerCount = 0;               // Including the driving thread
+    std::unique_ptr<JobWorker[]> workers;
+    std::vector<std::thread> threads;  // Workers 1..workerCount-1
+
+    // Idle workers sleep until a push wakes one
+    std::atomic<int> sleepers{0};
+    std::mutex lock;
+    std::condition_variable wake;
+    uint64_t wakeups = 0;              // Under lock
+    bool quit = false;                 // Under lock
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// threads workers in all, the calling thread included (0 for one per core, at most
+// JOB_MAX_WORKERS)
+void JobSystemInit(JobSystem *system, int threads);
+void JobSystemShutdown(JobSystem *system);
+
+// Task over items [begin, end) split down to grain; no dependencies
+void JobTaskInit(JobTask *task, JobFunc func, void *user, int begin, int end, int grain);
+// task starts only once 'on' has finished; both must be in the same JobSystemRun.
+// Returns false when 'on' already has JOB_MAX_SUCCESSORS.
+bool JobTaskDepends(JobTask *task, JobTask *on);
+
+// Queues tasks[0..count) as one run counted by counter, those without dependencies at
+// once. A task with an empty range finishes without calling func.
+void JobSystemRun(JobSystem *system, JobTask *tasks, int count, JobCounter *counter);
+// Runs jobs until every task counted by counter has finished
+void JobSystemWait(JobSystem *system, JobCounter *counter);
+bool JobCounterDone(const JobCounter *counter);
+
+// func over [0, count) in pieces of up to grain items, returning when all are done;
+// one call for the whole range when there are no other workers or it fits the grain
+void JobParallelFor(JobSystem *system, int count, int grain, JobFunc func, void *user);
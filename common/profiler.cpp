@@ -0,0 +1,267 @@
+// profiler.cpp
+#include "profiler.h"
+
+#if defined(PROFILER_ENABLED)
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+// Rings live in static storage, so a thread's first zone claims one without allocating
+// or locking. A thread keeps its ring after it exits; PROFILER_MAX_THREADS bounds that.
+static ProfileRing rings[PROFILER_MAX_THREADS];
+static std::atomic<int> ringCount{0};
+static thread_local int threadRing = -1;      // -1 unclaimed, -2 none left
+
+// Consumer side, only touched by the thread calling ProfilerFrameMark
+static ProfileZoneStat zones[PROFILER_MAX_ZONES];
+static uint64_t zoneFrameNs[PROFILER_MAX_ZONES];
+static float zoneWindowPeak[PROFILER_MAX_ZONES];
+static int zoneCount = 0;
+static int peakFrame = 0;
+
+static uint64_t lastFrameMark = 0;
+static int frameRing = 0;                     // Ring of the thread that marks frames
+static float frameMs = 0.0f;
+
+static ProfilerAllocFunc allocCounter = nullptr;
+static uint64_t allocTotal = 0;               // Totals at the last frame mark
+static uint64_t allocBytesTotal = 0;
+static uint64_t frameAllocs = 0;              // Made during the last frame
+static uint64_t frameAllocBytes = 0;
+
+static std::vector<ProfileEvent> captureEvents;
+static std::vector<int> captureThreads;       // Ring index of each captured event
+static std::string capturePath;
+static int captureFramesLeft = 0;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static int FindZone(const char *name)
+{
+    for (int i = 0; i < zoneCount; i++)
+    {
+        if (zones[i].name == name) return i;
+    }
+    if (zoneCount == PROFILER_MAX_ZONES) return -1;
+
+    zones[zoneCount] = { name, 0, 0.0f, 0.0f, 0.0f };
+    zoneFrameNs[zoneCount] = 0;
+    zoneWindowPeak[zoneCount] = 0.0f;
+    return zoneCount++;
+}
+
+static void CaptureEvent(const ProfileEvent &event, int thread)
+{
+    captureEvents.push_back(event);
+    captureThreads.push_back(thread);
+}
+
+// Moves every finished zone out of the rings
+static void DrainRings(void)
+{
+    int count = ringCount.load(std::memory_order_acquire);
+    if (count > PROFILER_MAX_THREADS) count = PROFILER_MAX_THREADS;
+
+    for (int r = 0; r < count; r++)
+    {
+        ProfileRing &ring = rings[r];
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+
+        for (; tail != head; tail++)
+        {
+            const ProfileEvent &event = ring.events[tail & (PROFILER_RING_EVENTS - 1)];
+            int zone = FindZone(event.name);
+            if (zone >= 0)
+            {
+                zones[zone].calls++;
+                zoneFrameNs[zone] += event.end - event.start;
+            }
+            if (captureFramesLeft > 0) CaptureEvent(event, r);
+        }
+        ring.tail.store(tail, std::memory_order_release);
+    }
+}
+
+static void WriteJsonString(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (; *text; text++)
+    {
+        if (*text == '"' || *text == '\\') fputc('\\', file);
+        if ((unsigned char)*text >= 0x20) fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+uint64_t ProfilerNow(void)
+{
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+ProfileRing *ProfilerThreadRing(void)
+{
+    if (threadRing == -1)
+    {
+        int index = ringCount.fetch_add(1, std::memory_order_relaxed);
+        if (index < PROFILER_MAX_THREADS)
+        {
+            rings[index].threadIndex = index;
+            threadRing = index;
+        }
+        else threadRing = -2;
+    }
+    return (threadRing >= 0) ? &rings[threadRing] : nullptr;
+}
+
+void ProfilerFrameMark(void)
+{
+    uint64_t now = ProfilerNow();
+    if (lastFrameMark == 0) lastFrameMark = now;
+
+    ProfileRing *ring = ProfilerThreadRing();
+    if (ring != nullptr) frameRing = ring->threadIndex;
+
+    for (int i = 0; i < zoneCount; i++)
+    {
+        zones[i].calls = 0;
+        zoneFrameNs[i] = 0;
+    }
+    DrainRings();
+
+    frameMs = (float)(now - lastFrameMark)*1e-6f;
+
+    if (allocCounter != nullptr)
+    {
+        uint64_t allocs = 0, bytes = 0;
+        allocCounter(&allocs, &bytes);
+        frameAllocs = allocs - allocTotal;
+        frameAllocBytes = bytes - allocBytesTotal;
+        allocTotal = allocs;
+        allocBytesTotal = bytes;
+    }
+
+    // The first peak window starts with the first frame
+    bool newWindow = (++peakFrame >= PROFILER_PEAK_FRAMES);
+    if (newWindow) peakFrame = 0;
+    for (int i = 0; i < zoneCount; i++)
+    {
+        ProfileZoneStat &zone = zones[i];
+        zone.ms = (float)zoneFrameNs[i]*1e-6f;
+        zone.avgMs += (zone.ms - zone.avgMs)*(1.0f/16.0f);
+        if (zone.ms > zoneWindowPeak[i]) zoneWindowPeak[i] = zone.ms;
+        if (zone.ms > zone.peakMs) zone.peakMs = zone.ms;
+        if (newWindow)
+        {
+            zone.peakMs = zoneWindowPeak[i];
+            zoneWindowPeak[i] = 0.0f;
+        }
+    }
+
+    if (captureFramesLeft > 0)
+    {
+        // The frame itself, on the thread that marks frames
+        CaptureEvent({ "Frame", lastFrameMark, now }, frameRing);
+        if (--captureFramesLeft == 0) ProfilerExportChromeTrace(capturePath.c_str());
+    }
+
+    lastFrameMark = now;
+}
+
+int ProfilerZoneStats(const ProfileZoneStat **stats)
+{
+    *stats = zones;
+    return zoneCount;
+}
+
+float ProfilerFrameMs(void)
+{
+    return frameMs;
+}
+
+uint32_t ProfilerDroppedEvents(void)
+{
+    int count = ringCount.load(std::memory_order_acquire);
+    if (count > PROFILER_MAX_THREADS) count = PROFILER_MAX_THREADS;
+
+    uint32_t dropped = 0;
+    for (int r = 0; r < count; r++) dropped += rings[r].dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+void ProfilerSetAllocCounter(ProfilerAllocFunc counter)
+{
+    allocCounter = counter;
+    frameAllocs = 0;
+    frameAllocBytes = 0;
+    if (counter != nullptr) counter(&allocTotal, &allocBytesTotal);
+}
+
+bool ProfilerFrameAllocs(uint64_t *allocations, uint64_t *bytes)
+{
+    *allocations = frameAllocs;
+    *bytes = frameAllocBytes;
+    return allocCounter != nullptr;
+}
+
+void ProfilerCaptureStart(int frames, const char *path)
+{
+    if (frames <= 0) return;
+
+    captureEvents.clear();
+    captureThreads.clear();
+    captureEvents.reserve((size_t)frames*64);
+    captureThreads.reserve((size_t)frames*64);
+    capturePath = path;
+    captureFramesLeft = frames;
+}
+
+bool ProfilerCapturing(void)
+{
+    return captureFramesLeft > 0;
+}
+
+bool ProfilerExportChromeTrace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "PROFILER: Failed to write trace %s\n", path);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    int count = ringCount.load(std::memory_order_acquire);
+    if (count > PROFILER_MAX_THREADS) count = PROFILER_MAX_THREADS;
+    for (int r = 0; r < count; r++)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}", (r > 0) ? ",\n" : "",
+                r, (r == frameRing) ? "Main" : "Thread", r);
+    }
+
+    // Complete events; the viewer nests them by time
+    for (size_t i = 0; i < captureEvents.size(); i++)
+    {
+        const ProfileEvent &event = captureEvents[i];
+        fprintf(file, "%s{\"name\":", (count > 0 || i > 0) ? ",\n" : "");
+        WriteJsonString(file, event.name);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", captureThreads[i],
+                (double)event.start*1e-3, (double)(event.end - event.start)*1e-3);
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = (fclose(file) == 0);
+    if (ok) printf("PROFILER: Wrote %d zones to %s\n", (int)captureEvents.size(), path);
+    return ok;
+}
+
+#endif
@@ -0,0 +1,132 @@
+// profiler.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Frame profiler. Zones are only recorded when PROFILER_ENABLED is defined (the CMake
+// build does that unless RAYLIB_GAMES_PROFILER is OFF); otherwise every macro and
+// function below compiles to nothing.
+//
+//   PROFILE_ZONE("Name");       // times the rest of the enclosing scope
+//   ProfilerFrameMark();        // once per frame, on the main thread
+//
+// Each thread writes finished zones into its own ring without locks; the main thread
+// drains every ring in ProfilerFrameMark into per-zone statistics and, during a
+// capture, into a Chrome trace (chrome://tracing or ui.perfetto.dev).
+// Zone names must be string literals: they are compared and stored by pointer.
+//----------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int PROFILER_MAX_THREADS = 32;
+constexpr int PROFILER_RING_EVENTS = 4096;     // Per thread, a power of two
+constexpr int PROFILER_MAX_ZONES = 64;         // Distinct names in the statistics
+constexpr int PROFILER_CAPTURE_FRAMES = 120;   // Frames an F9 capture records
+constexpr int PROFILER_PEAK_FRAMES = 60;       // Window of the reported peak time
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct ProfileEvent {
+    const char *name;
+    uint64_t start;                    // Nanoseconds since the profiler started
+    uint64_t end;
+};
+
+// Single producer (the owning thread), single consumer (ProfilerFrameMark)
+struct ProfileRing {
+    alignas(64) std::atomic<uint32_t> head{0};     // Next write, owned by the producer
+    alignas(64) std::atomic<uint32_t> tail{0};     // Next read, owned by the consumer
+    std::atomic<uint32_t> dropped{0};              // Zones lost to a full ring, written by the producer
+    int threadIndex = 0;
+    ProfileEvent events[PROFILER_RING_EVENTS];
+};
+
+// Inclusive zone times, summed over all calls in a frame
+struct ProfileZoneStat {
+    const char *name;
+    int calls;                         // In the last frame
+    float ms;                          // Last frame
+    float avgMs;                       // Smoothed over about 16 frames
+    float peakMs;                      // Highest frame of the last PROFILER_PEAK_FRAMES
+};
+
+// Reads the running totals of heap allocations and their bytes (AllocTrackerCount)
+typedef void (*ProfilerAllocFunc)(uint64_t *allocations, uint64_t *bytes);
+
+#if defined(PROFILER_ENABLED)
+
+//----------------------------------------------------------------------------------
+// Function declarations
+//----------------------------------------------------------------------------------
+uint64_t ProfilerNow(void);
+ProfileRing *ProfilerThreadRing(void);                 // nullptr past PROFILER_MAX_THREADS
+void ProfilerFrameMark(void);
+int ProfilerZoneStats(const ProfileZoneStat **stats);  // Returns the count
+float ProfilerFrameMs(void);
+uint32_t ProfilerDroppedEvents(void);
+
+// With a counter set, every frame mark also takes the allocations made since the last
+// one, for the overlay. ProfilerFrameAllocs returns false while no counter is set.
+void ProfilerSetAllocCounter(ProfilerAllocFunc counter);
+bool ProfilerFrameAllocs(uint64_t *allocations, uint64_t *bytes);
+
+// Records the next frames into a trace, written to path when they are done
+void ProfilerCaptureStart(int frames, const char *path);
+bool ProfilerCapturing(void);
+bool ProfilerExportChromeTrace(const char *path);      // Writes the current capture
+
+// Overlay and keys (F3 overlay, F9 capture), defined with raylib in profiler_overlay.cpp
+void ProfilerUpdateKeys(const char *tracePath);
+void ProfilerDrawOverlay(int x, int y);
+
+//----------------------------------------------------------------------------------
+// Scoped zone
+//----------------------------------------------------------------------------------
+struct ProfileScope {
+    const char *name;
+    uint64_t start;
+
+    explicit ProfileScope(const char *zoneName) : name(zoneName), start(ProfilerNow()) {}
+    ~ProfileScope()
+    {
+        ProfileRing *ring = ProfilerThreadRing();
+        if (ring == nullptr) return;
+
+        uint32_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->tail.load(std::memory_order_acquire) >= (uint32_t)PROFILER_RING_EVENTS)
+        {
+            ring->dropped.store(ring->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        ring->events[head & (PROFILER_RING_EVENTS - 1)] = { name, start, ProfilerNow() };
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+
+inline void ProfilerFrameMark(void) {}
+inline int ProfilerZoneStats(const ProfileZoneStat **stats) { *stats = nullptr; return 0; }
+inline float ProfilerFrameMs(void) { return 0.0f; }
+inline uint32_t ProfilerDroppedEvents(void) { return 0; }
+inline void ProfilerSetAllocCounter(ProfilerAllocFunc) {}
+inline bool ProfilerFrameAllocs(uint64_t *, uint64_t *) { return false; }
+inline void ProfilerCaptureStart(int, const char *) {}
+inline bool ProfilerCapturing(void) { return false; }
+inline bool ProfilerExportChromeTrace(const char *) { return false; }
+inline void ProfilerUpdateKeys(const char *) {}
+inline void ProfilerDrawOverlay(int, int) {}
+
+#endif
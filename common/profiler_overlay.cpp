@@ -0,0 +1,65 @@
+// profiler_overlay.cpp
+// In-game view of the profiler statistics, the only part of the profiler that needs raylib
+#include "raylib.h"
+#include "profiler.h"
+
+#if defined(PROFILER_ENABLED)
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+constexpr int OVERLAY_FONT_SIZE = 10;
+constexpr int OVERLAY_LINE = 12;
+constexpr int OVERLAY_WIDTH = 250;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static bool overlayVisible = false;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void ProfilerUpdateKeys(const char *tracePath)
+{
+    if (IsKeyPressed(KEY_F3)) overlayVisible = !overlayVisible;
+    if (IsKeyPressed(KEY_F9) && !ProfilerCapturing()) ProfilerCaptureStart(PROFILER_CAPTURE_FRAMES, tracePath);
+}
+
+void ProfilerDrawOverlay(int x, int y)
+{
+    if (!overlayVisible && !ProfilerCapturing()) return;
+
+    const ProfileZoneStat *zones = nullptr;
+    int count = ProfilerZoneStats(&zones);
+    if (!overlayVisible) count = 0;
+
+    uint64_t allocs = 0, allocBytes = 0;
+    bool tracked = overlayVisible && ProfilerFrameAllocs(&allocs, &allocBytes);
+
+    int lines = ((count > 0) ? count + 2 : 1) + (tracked ? 1 : 0);
+    DrawRectangle(x, y, OVERLAY_WIDTH, lines*OVERLAY_LINE + 8, Fade(BLACK, 0.7f));
+
+    int line = y + 4;
+    DrawText(TextFormat("frame %6.2f ms%s", ProfilerFrameMs(), ProfilerCapturing() ? "  [capturing]" : ""), x + 4, line, OVERLAY_FONT_SIZE, ProfilerCapturing() ? RED : WHITE);
+    line += OVERLAY_LINE;
+    if (tracked)
+    {
+        // A steady frame allocates nothing, anything else stands out
+        DrawText(TextFormat("allocs %5llu  %10llu bytes", (unsigned long long)allocs, (unsigned long long)allocBytes), x + 4, line, OVERLAY_FONT_SIZE, (allocs > 0) ? YELLOW : WHITE);
+        line += OVERLAY_LINE;
+    }
+    if (count > 0)
+    {
+        DrawText("zone                 avg     peak  calls", x + 4, line, OVERLAY_FONT_SIZE, GRAY);
+        line += OVERLAY_LINE;
+    }
+
+    for (int i = 0; i < count; i++, line += OVERLAY_LINE)
+    {
+        const ProfileZoneStat &zone = zones[i];
+        DrawText(TextFormat("%-18.18s %6.3f %8.3f %5d", zone.name, zone.avgMs, zone.peakMs, zone.calls), x + 4, line, OVERLAY_FONT_SIZE, WHITE);
+    }
+}
+
+#endif
@@ -0,0 +1,137 @@
+// sprite_batch.cpp
+#include "sprite_batch.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// Counting sort over the distinct keys of the batch, stable and linear. Returns false
+// (order untouched) when there are more than SPRITE_SORT_BUCKETS keys.
+static bool BucketOrder(SpriteBatch *batch)
+{
+    const SpriteQuad *quads = batch->quads.data();
+    const int count = batch->quadCount;
+
+    uint64_t keys[SPRITE_SORT_BUCKETS];
+    int sizes[SPRITE_SORT_BUCKETS];
+    int keyCount = 0;
+    int last = 0;
+
+    batch->buckets.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        // Neighbouring quads usually share a key, try the last one first
+        uint64_t key = quads[i].key;
+        if (keyCount == 0 || keys[last] != key)
+        {
+            last = 0;
+            while (last < keyCount && keys[last] != key) last++;
+            if (last == keyCount)
+            {
+                if (keyCount == SPRITE_SORT_BUCKETS) return false;
+                keys[keyCount] = key;
+                sizes[keyCount++] = 0;
+            }
+        }
+        batch->buckets[i] = (uint8_t)last;
+        sizes[last]++;
+    }
+
+    // Start of every bucket in key order
+    int rank[SPRITE_SORT_BUCKETS];
+    for (int k = 0; k < keyCount; k++) rank[k] = k;
+    std::sort(rank, rank + keyCount, [&keys](int a, int b) { return keys[a] < keys[b]; });
+
+    int offset[SPRITE_SORT_BUCKETS];
+    int total = 0;
+    for (int r = 0; r < keyCount; r++)
+    {
+        offset[rank[r]] = total;
+        total += sizes[rank[r]];
+    }
+
+    batch->order.resize(count);
+    for (int i = 0; i < count; i++) batch->order[offset[batch->buckets[i]]++] = (uint32_t)i;
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void SpriteBatchInit(SpriteBatch *batch, int capacity, SpriteSubmitFunc submit)
+{
+    batch->capacity = std::max(1, capacity);
+    batch->submit = submit;
+
+    batch->quads.resize(batch->capacity);
+    batch->quadCount = 0;
+    batch->order.reserve(batch->capacity);
+    batch->buckets.reserve(batch->capacity);
+    batch->vertices.resize((size_t)batch->capacity * 4);
+    batch->vertexCount = 0;
+    batch->calls.reserve(batch->capacity);
+
+    SpriteBatchBegin(batch);
+}
+
+void SpriteBatchBegin(SpriteBatch *batch)
+{
+    batch->quadCount = 0;
+    batch->frameQuads = 0;
+    batch->frameDrawCalls = 0;
+    batch->frameFlushes = 0;
+}
+
+void SpriteBatchBuild(SpriteBatch *batch)
+{
+    const SpriteQuad *quads = batch->quads.data();
+    const int count = batch->quadCount;
+
+    batch->vertexCount = count * 4;
+    batch->calls.clear();
+
+    // Games mostly submit in layer order already, then the quads are read in place
+    bool sorted = std::is_sorted(quads, quads + count,
+                                 [](const SpriteQuad &a, const SpriteQuad &b) { return a.key < b.key; });
+    if (!sorted && !BucketOrder(batch))
+    {
+        // Many distinct keys: indices sorted by (key, index), stable without a buffer
+        batch->order.resize(count);
+        for (int i = 0; i < count; i++) batch->order[i] = (uint32_t)i;
+        std::sort(batch->order.begin(), batch->order.end(), [quads](uint32_t a, uint32_t b) {
+            return (quads[a].key != quads[b].key) ? quads[a].key < quads[b].key : a < b;
+        });
+    }
+
+    SpriteVertex *vertex = batch->vertices.data();
+    for (int i = 0; i < count; i++, vertex += 4)
+    {
+        const SpriteQuad &q = quads[sorted ? i : batch->order[i]];
+        unsigned int texture = (unsigned int)(q.key & 0xffffffffu);
+
+        // A texture change starts a draw call, a layer change alone does not
+        if (batch->calls.empty() || batch->calls.back().texture != texture)
+        {
+            batch->calls.push_back({ texture, i * 4, 0 });
+        }
+        batch->calls.back().vertexCount += 4;
+
+        vertex[0] = { q.x, q.y, q.u0, q.v0, q.color };
+        vertex[1] = { q.x, q.y + q.height, q.u0, q.v1, q.color };
+        vertex[2] = { q.x + q.width, q.y + q.height, q.u1, q.v1, q.color };
+        vertex[3] = { q.x + q.width, q.y, q.u1, q.v0, q.color };
+    }
+}
+
+void SpriteBatchFlush(SpriteBatch *batch)
+{
+    if (batch->quadCount == 0) return;
+
+    SpriteBatchBuild(batch);
+    if (batch->submit != nullptr) batch->submit(batch);
+
+    batch->frameQuads += batch->quadCount;
+    batch->frameDrawCalls += (int)batch->calls.size();
+    batch->frameFlushes++;
+    batch->quadCount = 0;
+}
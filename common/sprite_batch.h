@@ -0,0 +1,125 @@
+// sprite_batch.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Color matches raylib's definition. When drawing, include raylib.h before this
+// header (raylib.h defines RL_COLOR_TYPE), so the batching stays usable headless.
+//----------------------------------------------------------------------------------
+#if !defined(RL_COLOR_TYPE)
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+#define RL_COLOR_TYPE
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Texture id of plain colored quads, submitted with rlgl's default white texture
+constexpr unsigned int SPRITE_NO_TEXTURE = 0;
+
+// Distinct (layer, texture) pairs per flush sorted in linear time, more fall back to
+// a comparison sort
+constexpr int SPRITE_SORT_BUCKETS = 64;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// One corner, in rlgl's RL_QUADS order: top-left, bottom-left, bottom-right, top-right
+struct SpriteVertex {
+    float x;
+    float y;
+    float u;
+    float v;
+    Color color;
+};
+
+struct SpriteQuad {
+    uint64_t key;                      // Layer in the high half, texture in the low half
+    float x, y, width, height;
+    float u0, v0, u1, v1;
+    Color color;
+};
+
+// A run of vertices sharing one texture; layers only order the runs
+struct SpriteDrawCall {
+    unsigned int texture;
+    int firstVertex;
+    int vertexCount;
+};
+
+struct SpriteBatch;
+// Receives every built batch: rlgl for the games, anything else headless
+typedef void (*SpriteSubmitFunc)(const SpriteBatch *batch);
+
+//----------------------------------------------------------------------------------
+// Gathers quads for one frame into preallocated buffers, orders them by layer and
+// then texture (submission order is kept inside a texture of a layer) and builds one
+// vertex stream with a draw call per texture run. A full batch is flushed early, so
+// ordering then only holds inside each flush.
+//----------------------------------------------------------------------------------
+struct SpriteBatch {
+    int capacity = 0;                  // Quads per flush
+    SpriteSubmitFunc submit = nullptr;
+
+    // Pending quads, quadCount of the capacity entries are in use
+    std::vector<SpriteQuad> quads;
+    int quadCount = 0;
+    // Sort scratch: quad indices in draw order, and the bucket of each quad
+    std::vector<uint32_t> order;
+    std::vector<uint8_t> buckets;
+
+    // Built stream, vertexCount of the capacity * 4 entries are in use
+    std::vector<SpriteVertex> vertices;
+    int vertexCount = 0;
+    std::vector<SpriteDrawCall> calls;
+
+    // Counters since SpriteBatchBegin
+    int frameQuads = 0;
+    int frameDrawCalls = 0;
+    int frameFlushes = 0;
+};
+
+//------------------------------------------------------------------------------------
+// Function declarations
+//------------------------------------------------------------------------------------
+// Reserves room for 'capacity' quads, nothing is allocated while drawing
+void SpriteBatchInit(SpriteBatch *batch, int capacity, SpriteSubmitFunc submit);
+// Starts a frame: clears the counters and any quads left over
+void SpriteBatchBegin(SpriteBatch *batch);
+
+// Sorts the pending quads and fills vertices and calls, without submitting
+void SpriteBatchBuild(SpriteBatch *batch);
+// Builds, hands the result to the submit function and empties the batch
+void SpriteBatchFlush(SpriteBatch *batch);
+
+// Submit function drawing through rlgl (sprite_batch_rlgl.cpp, needs raylib)
+void SpriteBatchSubmitRlgl(const SpriteBatch *batch);
+
+//------------------------------------------------------------------------------------
+// Quad submission, inline since games issue one call per tile or cell
+//------------------------------------------------------------------------------------
+// Layers compare as signed values, textures break ties
+inline uint64_t SpriteKey(int layer, unsigned int texture)
+{
+    return ((uint64_t)((uint32_t)layer ^ 0x80000000u) << 32) | texture;
+}
+
+// Part [u0, v0]-[u1, v1] (normalized) of a texture into a rectangle, tinted
+inline void SpriteBatchTexture(SpriteBatch *batch, unsigned int texture, float u0, float v0, float u1, float v1,
+                               float x, float y, float width, float height, Color tint, int layer)
+{
+    if (batch->quadCount == batch->capacity) SpriteBatchFlush(batch);
+    batch->quads[batch->quadCount++] = { SpriteKey(layer, texture), x, y, width, height, u0, v0, u1, v1, tint };
+}
+
+// Same arguments as DrawRectangle, plus the layer (lower layers are drawn first)
+inline void SpriteBatchRect(SpriteBatch *batch, float x, float y, float width, float height, Color color, int layer)
+{
+    SpriteBatchTexture(batch, SPRITE_NO_TEXTURE, 0.0f, 0.0f, 1.0f, 1.0f, x, y, width, height, color, layer);
+}
@@ -0,0 +1,44 @@
+// sprite_batch_rlgl.cpp
+// rlgl submission of a built SpriteBatch, the only part of the batching that needs raylib
+#include "raylib.h"
+#include "rlgl.h"
+#include "sprite_batch.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// Vertices handed to rlgl between limit checks, well under its default batch size
+constexpr int RLGL_CHUNK_VERTICES = 4096;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+void SpriteBatchSubmitRlgl(const SpriteBatch *batch)
+{
+    for (const SpriteDrawCall &call : batch->calls)
+    {
+        unsigned int texture = (call.texture == SPRITE_NO_TEXTURE) ? rlGetTextureIdDefault() : call.texture;
+        rlSetTexture(texture);
+
+        // rlgl merges consecutive quads with one texture into a single draw, the chunks
+        // only let it flush its own vertex buffer when it fills up
+        for (int first = 0; first < call.vertexCount; first += RLGL_CHUNK_VERTICES)
+        {
+            int count = call.vertexCount - first;
+            if (count > RLGL_CHUNK_VERTICES) count = RLGL_CHUNK_VERTICES;
+            rlCheckRenderBatchLimit(count);
+
+            rlBegin(RL_QUADS);
+            const SpriteVertex *vertex = &batch->vertices[call.firstVertex + first];
+            for (int i = 0; i < count; i++, vertex++)
+            {
+                rlColor4ub(vertex->color.r, vertex->color.g, vertex->color.b, vertex->color.a);
+                rlTexCoord2f(vertex->u, vertex->v);
+                rlVertex2f(vertex->x, vertex->y);
+            }
+            rlEnd();
+        }
+    }
+
+    rlSetTexture(0);
+}
@@ -0,0 +1,196 @@
+// asset_packer.cpp
+// Offline baker for AssetPack archives: fonts become glyph atlases, short sounds
+// become 16-bit PCM, music keeps its compressed file to be streamed. Uses raylib's
+// loaders but opens no window.
+// Build from the common folder (with raylib installed):
+//   g++ -O2 -std=c++14 -I. tools/asset_packer.cpp asset_pack.cpp -lraylib -lm -lpthread -o asset_packer
+//
+// Usage:
+//   asset_packer <out.pak> <entry>...
+// where every entry is one of
+//   font:<name>=<file.ttf>@<size>     95 ASCII glyphs at size pixels, like LoadFontEx
+//   wave:<name>=<sound file>          decoded to 16-bit PCM
+//   stream:<name>=<sound file>        kept as is, for LoadMusicStreamFromMemory
+//   raw:<name>=<file>
+#include "raylib.h"
+#include "asset_pack.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Some Defines -> converted to constexpr
+//----------------------------------------------------------------------------------
+// LoadFontEx defaults
+constexpr int FONT_GLYPHS = 95;
+constexpr int FONT_PADDING = 4;
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+static int Usage(void)
+{
+    fprintf(stderr, "usage: asset_packer <out.pak> <type>:<name>=<file>[@size]...\n");
+    fprintf(stderr, "       types: font (needs @size), wave, stream, raw\n");
+    return EXIT_FAILURE;
+}
+
+static void Append(std::vector<uint8_t> *bytes, const void *data, size_t size)
+{
+    const uint8_t *begin = (const uint8_t *)data;
+    bytes->insert(bytes->end(), begin, begin + size);
+}
+
+static bool ReadFile(const char *path, std::vector<uint8_t> *bytes)
+{
+    int size = 0;
+    unsigned char *data = LoadFileData(path, &size);
+    if (data == nullptr) return false;
+    bytes->assign(data, data + size);
+    UnloadFileData(data);
+    return true;
+}
+
+static bool BakeFont(const char *path, int fontSize, std::vector<uint8_t> *bytes)
+{
+    int dataSize = 0;
+    unsigned char *fileData = LoadFileData(path, &dataSize);
+    if (fileData == nullptr) return false;
+
+    GlyphInfo *glyphs = LoadFontData(fileData, dataSize, fontSize, nullptr, FONT_GLYPHS, FONT_DEFAULT);
+    UnloadFileData(fileData);
+    if (glyphs == nullptr) return false;
+
+    Rectangle *recs = nullptr;
+    Image atlas = GenImageFontAtlas(glyphs, &recs, FONT_GLYPHS, fontSize, FONT_PADDING, 0);
+    bool ok = (atlas.data != nullptr && recs != nullptr && atlas.format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA);
+
+    if (ok)
+    {
+        AssetFontHeader header = { fontSize, FONT_GLYPHS, FONT_PADDING, atlas.width, atlas.height, atlas.format };
+        Append(bytes, &header, sizeof(header));
+        for (int i = 0; i < FONT_GLYPHS; i++)
+        {
+            AssetGlyph glyph = { glyphs[i].value, glyphs[i].offsetX, glyphs[i].offsetY, glyphs[i].advanceX,
+                                 recs[i].x, recs[i].y, recs[i].width, recs[i].height };
+            Append(bytes, &glyph, sizeof(glyph));
+        }
+        Append(bytes, atlas.data, (size_t)atlas.width*atlas.height*2);
+    }
+
+    UnloadImage(atlas);
+    RL_FREE(recs);
+    UnloadFontData(glyphs, FONT_GLYPHS);
+    return ok;
+}
+
+static bool BakeWave(const char *path, std::vector<uint8_t> *bytes)
+{
+    Wave wave = LoadWave(path);
+    if (wave.data == nullptr || wave.frameCount == 0) return false;
+
+    // raylib decodes MP3 to 32-bit float, half the size plays the same
+    if (wave.sampleSize != 16) WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+
+    AssetWaveHeader header = { wave.frameCount, wave.sampleRate, wave.sampleSize, wave.channels };
+    Append(bytes, &header, sizeof(header));
+    Append(bytes, wave.data, (size_t)wave.frameCount*wave.channels*(wave.sampleSize/8));
+    UnloadWave(wave);
+    return true;
+}
+
+static bool BakeStream(const char *path, std::vector<uint8_t> *bytes)
+{
+    AssetStreamHeader header = {};
+    const char *extension = strrchr(path, '.');
+    if (extension == nullptr || strlen(extension) >= sizeof(header.fileType)) return false;
+    strcpy(header.fileType, extension);
+
+    std::vector<uint8_t> file;
+    if (!ReadFile(path, &file)) return false;
+    Append(bytes, &header, sizeof(header));
+    Append(bytes, file.data(), file.size());
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc < 3) return Usage();
+    SetTraceLogLevel(LOG_WARNING);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<AssetPackInput> inputs;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string spec = argv[i];
+        size_t colon = spec.find(':');
+        size_t equals = spec.find('=', (colon == std::string::npos) ? 0 : colon);
+        if (colon == std::string::npos || equals == std::string::npos) return Usage();
+
+        std::string type = spec.substr(0, colon);
+        AssetPackInput input;
+        input.name = spec.substr(colon + 1, equals - colon - 1);
+        std::string path = spec.substr(equals + 1);
+
+        bool ok = false;
+        if (type == "font")
+        {
+            size_t at = path.rfind('@');
+            int fontSize = (at != std::string::npos) ? atoi(path.c_str() + at + 1) : 0;
+            if (fontSize <= 0) return Usage();
+            path.resize(at);
+            input.type = ASSET_FONT;
+            ok = BakeFont(path.c_str(), fontSize, &input.bytes);
+        }
+        else if (type == "wave")
+        {
+            input.type = ASSET_WAVE;
+            ok = BakeWave(path.c_str(), &input.bytes);
+        }
+        else if (type == "stream")
+        {
+            // Already compressed, LZ would only cost load time
+            input.type = ASSET_STREAM;
+            input.compress = false;
+            ok = BakeStream(path.c_str(), &input.bytes);
+        }
+        else if (type == "raw")
+        {
+            input.type = ASSET_RAW;
+            ok = ReadFile(path.c_str(), &input.bytes);
+        }
+        else return Usage();
+
+        if (!ok)
+        {
+            fprintf(stderr, "asset_packer: failed to bake %s\n", spec.c_str());
+            return EXIT_FAILURE;
+        }
+        printf("%-8s %-24s %10d bytes  <- %s\n", type.c_str(), input.name.c_str(), (int)input.bytes.size(), path.c_str());
+        inputs.push_back(std::move(input));
+    }
+
+    if (!AssetPackWrite(argv[1], inputs)) return EXIT_FAILURE;
+
+    // Report what the codec did per entry
+    AssetPack pack;
+    if (!AssetPackOpen(&pack, argv[1])) return EXIT_FAILURE;
+    for (int i = 0; i < pack.entryCount; i++)
+    {
+        const AssetPackEntry &entry = pack.entries[i];
+        printf("  %-24s %10d -> %10d bytes (%s)\n", entry.name, (int)entry.size, (int)entry.packedSize,
+               (entry.codec == ASSET_CODEC_LZ) ? "lz" : "stored");
+    }
+    AssetPackClose(&pack);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("wrote %s in %.1f ms\n", argv[1], ms);
+    return EXIT_SUCCESS;
+}
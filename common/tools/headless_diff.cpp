@@ -0,0 +1,66 @@
+// headless_diff.cpp
+// Compares a frame dumped by a headless run against its golden image. Fails when the
+// sizes differ or any channel of any pixel is further off than the tolerance, and can
+// write a picture of where they differ.
+// Build from the common folder (with the headless raylib):
+//   g++ -O2 -std=c++14 -Iheadless tools/headless_diff.cpp headless/headless_png.cpp -o headless_diff
+//
+// Usage:
+//   headless_diff <golden.png> <frame.png> [tolerance] [diff.png]
+#include "headless.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || argc > 5)
+    {
+        fprintf(stderr, "usage: headless_diff <golden.png> <frame.png> [tolerance] [diff.png]\n");
+        return EXIT_FAILURE;
+    }
+    int tolerance = (argc > 3) ? atoi(argv[3]) : 0;
+
+    std::vector<Color> golden, frame;
+    int goldenWidth = 0, goldenHeight = 0, width = 0, height = 0;
+    if (!HeadlessReadPng(argv[1], &golden, &goldenWidth, &goldenHeight))
+    {
+        fprintf(stderr, "FAIL: cannot read %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    if (!HeadlessReadPng(argv[2], &frame, &width, &height))
+    {
+        fprintf(stderr, "FAIL: cannot read %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+    if (width != goldenWidth || height != goldenHeight)
+    {
+        printf("FAIL: frame is %dx%d, golden is %dx%d\n", width, height, goldenWidth, goldenHeight);
+        return EXIT_FAILURE;
+    }
+
+    // Differing pixels go red over a dimmed copy of the golden
+    std::vector<Color> diff(golden.size());
+    int64_t differing = 0;
+    int worst = 0;
+    for (size_t i = 0; i < golden.size(); i++)
+    {
+        int delta = std::max(abs(golden[i].r - frame[i].r), std::max(abs(golden[i].g - frame[i].g), abs(golden[i].b - frame[i].b)));
+        if (delta > worst) worst = delta;
+        if (delta > tolerance)
+        {
+            differing++;
+            diff[i] = { 255, 0, 0, 255 };
+        }
+        else diff[i] = { (unsigned char)(golden[i].r/4), (unsigned char)(golden[i].g/4), (unsigned char)(golden[i].b/4), 255 };
+    }
+    if (argc > 4 && !HeadlessWritePng(argv[4], diff.data(), width, height)) fprintf(stderr, "cannot write %s\n", argv[4]);
+
+    if (differing > 0)
+    {
+        printf("FAIL: %lld of %d pixels differ by more than %d (worst %d)\n", (long long)differing, width*height, tolerance, worst);
+        return EXIT_FAILURE;
+    }
+    printf("OK: %dx%d matches %s (worst difference %d)\n", width, height, argv[1], worst);
+    return EXIT_SUCCESS;
+}